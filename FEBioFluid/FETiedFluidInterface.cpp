@@ -119,7 +119,7 @@ void FETiedFluidSurface::UnpackLM(FEElement& el, vector<int>& lm)
     {
         int n = el.m_node[i];
         FENode& node = m_pMesh->Node(n);
-        vector<int>& id = node.m_ID;
+        FENodeDofArray<int>& id = node.m_ID;
         
         lm[4*i  ] = id[m_dofWE[0]];
         lm[4*i+1] = id[m_dofWE[1]];
@@ -278,7 +278,7 @@ void FETiedFluidInterface::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nseln; ++l)
                     {
-                        vector<int>& id = mesh.Node(sn[l]).m_ID;
+                        FENodeDofArray<int>& id = mesh.Node(sn[l]).m_ID;
                         lm[4*l  ] = id[m_dofWE[0]];
                         lm[4*l+1] = id[m_dofWE[1]];
                         lm[4*l+2] = id[m_dofWE[2]];
@@ -287,7 +287,7 @@ void FETiedFluidInterface::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nmeln; ++l)
                     {
-                        vector<int>& id = mesh.Node(mn[l]).m_ID;
+                        FENodeDofArray<int>& id = mesh.Node(mn[l]).m_ID;
                         lm[4*(l+nseln)  ] = id[m_dofWE[0]];
                         lm[4*(l+nseln)+1] = id[m_dofWE[1]];
                         lm[4*(l+nseln)+2] = id[m_dofWE[2]];
@@ -48,6 +48,7 @@ SOFTWARE.*/
 #include "plugin.h"
 #include "FEBioStdSolver.h"
 #include "FEBioRestart.h"
+#include "FEBioModel.h"
 
 namespace febio {
 
@@ -57,6 +58,32 @@ FECoreKernel* GetFECoreKernel()
 	return &FECoreKernel::GetInstance();
 }
 
+#ifndef MECH_ONLY
+//-----------------------------------------------------------------------------
+// Creates an independent copy of a model by reading its input file again.
+// The optimization module uses this to solve several models concurrently.
+static FEModel* CreateModelReplica(FEModel* fem)
+{
+	FEBioModel* src = dynamic_cast<FEBioModel*>(fem);
+	if (src == nullptr) return nullptr;
+
+	FEBioModel* replica = new FEBioModel;
+	replica->BlockLog();
+	bool bret = replica->Input(src->GetInputFileName().c_str());
+	replica->UnBlockLog();
+	if (bret == false)
+	{
+		delete replica;
+		return nullptr;
+	}
+
+	// the replica doesn't need a log file
+	replica->SetLogLevel(0);
+
+	return replica;
+}
+#endif
+
 //-----------------------------------------------------------------------------
 // import all modules
 void InitLibrary()
@@ -74,6 +101,7 @@ void InitLibrary()
 #ifndef MECH_ONLY
 	FEBioMix::InitModule();
 	FEBioOpt::InitModule();
+	FEBioOpt::SetModelReplicaFactory(CreateModelReplica);
 	FEBioFluid::InitModule();
 	FEBioFSI::InitModule();
     FEBioMultiphasicFSI::InitModule();
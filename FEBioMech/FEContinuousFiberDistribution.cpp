@@ -28,6 +28,56 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "FEContinuousFiberDistribution.h"
+#include <FECore/FEModel.h>
+
+//-----------------------------------------------------------------------------
+// A batch of fibers, stored as a structure of arrays. 
+struct FEFiberBatch
+{
+	enum { MAX_SIZE = 64 };
+
+	int		n;					// nr of fibers in batch
+	double	x[MAX_SIZE];		// fiber directions (global coordinates)
+	double	y[MAX_SIZE];
+	double	z[MAX_SIZE];
+	double	w[MAX_SIZE];		// integration weights (incl. fiber density)
+};
+
+//-----------------------------------------------------------------------------
+// Returns true if the parameters of a fiber density distribution don't depend 
+// on the material point or on time, so that the density can be evaluated once.
+static bool IsConstantDistribution(FEFiberDensityDistribution* pc)
+{
+	if (pc->Properties() != 0) return false;
+
+	FEModel* fem = pc->GetFEModel();
+	FEParameterList& PL = pc->GetParameterList();
+	FEParamIterator it = PL.first();
+	for (int i = 0; i < PL.Parameters(); ++i, ++it)
+	{
+		FEParam& p = *it;
+		if (fem->GetLoadController(&p)) return false;
+
+		for (int j = 0; j < p.dim(); ++j)
+		{
+			switch (p.type())
+			{
+			case FE_PARAM_DOUBLE_MAPPED: if (p.value<FEParamDouble>(j).isConst() == false) return false; break;
+			case FE_PARAM_VEC3D_MAPPED : if (p.value<FEParamVec3  >(j).isConst() == false) return false; break;
+			case FE_PARAM_MAT3D_MAPPED : if (p.value<FEParamMat3d >(j).isConst() == false) return false; break;
+			case FE_PARAM_MAT3DS_MAPPED: if (p.value<FEParamMat3ds>(j).isConst() == false) return false; break;
+			default:
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEContinuousFiberDistribution::m_bbatch = true;
+void FEContinuousFiberDistribution::SetBatchEvaluation(bool b) { m_bbatch = b; }
+bool FEContinuousFiberDistribution::BatchEvaluation() { return m_bbatch; }
 
 BEGIN_FECORE_CLASS(FEContinuousFiberDistribution, FEElasticMaterial)
 
@@ -46,6 +96,10 @@ FEContinuousFiberDistribution::FEContinuousFiberDistribution(FEModel* pfem) : FE
 	m_pFmat = 0;
 	m_pFDD = 0;
 	m_pFint = 0;
+
+	m_btable = false;
+	m_bconstR = false;
+	m_IFD = 1.0;
 }
 
 //-----------------------------------------------------------------------------
@@ -65,21 +119,70 @@ bool FEContinuousFiberDistribution::Init()
     // initialize base class
 	if (FEElasticMaterial::Init() == false) return false;
 
+	// store the integration points, if possible
+	BuildFiberTable();
+
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+// For integration schemes whose integration points don't depend on the material
+// point, the fiber directions and weights are stored, so they don't need to be
+// evaluated for each material point. If the fiber density is constant, it is 
+// evaluated here as well and included in the weights.
+void FEContinuousFiberDistribution::BuildFiberTable()
+{
+	m_fiber.clear();
+	m_weight.clear();
+	m_btable = m_pFint->HasFixedPoints();
+	m_bconstR = false;
+	m_IFD = 1.0;
+	if (m_btable == false) return;
+
+	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(nullptr);
+	if (it->IsValid())
+	{
+		do
+		{
+			m_fiber.push_back(it->m_fiber);
+			m_weight.push_back(it->m_weight);
+		} 
+		while (it->Next());
+	}
+	delete it;
+
+	m_bconstR = IsConstantDistribution(m_pFDD);
+	if (m_bconstR)
+	{
+		// The fiber density doesn't depend on the material point, so we can
+		// pass any material point. 
+		FEMaterialPoint mp;
+		double IFD = 0.0;
+		for (size_t i = 0; i < m_fiber.size(); ++i)
+		{
+			m_weight[i] *= m_pFDD->FiberDensity(mp, m_fiber[i]);
+			IFD += m_weight[i];
+		}
+		m_IFD = (IFD == 0.0 ? 1.0 : IFD);
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! Serialization
 void FEContinuousFiberDistribution::Serialize(DumpStream& ar)
 {	
 	FEElasticMaterial::Serialize(ar);
 	if (ar.IsShallow()) return;
+
+	if (ar.IsLoading()) BuildFiberTable();
 }
 
 //-----------------------------------------------------------------------------
 //! calculate stress at material point
 mat3ds FEContinuousFiberDistribution::Stress(FEMaterialPoint& mp)
 { 
+	if (m_bbatch) return BatchStress(mp);
+
 	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
     FEFiberMaterialPoint& fp = *mp.ExtractData<FEFiberMaterialPoint>();
 
@@ -124,6 +227,8 @@ mat3ds FEContinuousFiberDistribution::Stress(FEMaterialPoint& mp)
 //! calculate tangent stiffness at material point
 tens4ds FEContinuousFiberDistribution::Tangent(FEMaterialPoint& mp)
 {
+	if (m_bbatch) return BatchTangent(mp);
+
 	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
     FEFiberMaterialPoint& fp = *mp.ExtractData<FEFiberMaterialPoint>();
 
@@ -207,6 +312,16 @@ double FEContinuousFiberDistribution::StrainEnergyDensity(FEMaterialPoint& mp)
 //-----------------------------------------------------------------------------
 double FEContinuousFiberDistribution::IntegratedFiberDensity(FEMaterialPoint& mp)
 {
+	if (m_bbatch && m_btable)
+	{
+		if (m_bconstR) return m_IFD;
+
+		double IFD = 0;
+		for (size_t i = 0; i < m_fiber.size(); ++i) IFD += m_pFDD->FiberDensity(mp, m_fiber[i]) * m_weight[i];
+		if (IFD == 0.0) IFD = 1.0;
+		return IFD;
+	}
+
 	double IFD = 0;
 	// NOTE: Pass nullptr to GetIterator to avoid issues with GK rule!
 	FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(nullptr);
@@ -233,3 +348,222 @@ double FEContinuousFiberDistribution::IntegratedFiberDensity(FEMaterialPoint& mp
 
 	return IFD;
 }
+
+//-----------------------------------------------------------------------------
+// Evaluates the fiber directions (in global coordinates, including pre-stretch)
+// and the weights (including the fiber density) of all integration points, and 
+// passes them in batches to f.
+template <class F> void FEContinuousFiberDistribution::ForEachFiberBatch(FEMaterialPoint& mp, F f)
+{
+	FEFiberMaterialPoint& fp = *mp.ExtractData<FEFiberMaterialPoint>();
+
+	// get the local coordinate system
+	mat3d Q = GetLocalCS(mp);
+
+	FEFiberBatch b;
+	b.n = 0;
+	auto addFiber = [&](const vec3d& N, double w) {
+		if (w == 0.0) return;
+
+		// convert fiber to global coordinates
+		vec3d n0 = fp.FiberPreStretch(Q*N);
+
+		int i = b.n++;
+		b.x[i] = n0.x;
+		b.y[i] = n0.y;
+		b.z[i] = n0.z;
+		b.w[i] = w;
+		if (b.n == FEFiberBatch::MAX_SIZE) { f(b); b.n = 0; }
+	};
+
+	if (m_btable)
+	{
+		const int NF = (int)m_fiber.size();
+		if (m_bconstR)
+			for (int i = 0; i < NF; ++i) addFiber(m_fiber[i], m_weight[i]);
+		else
+			for (int i = 0; i < NF; ++i) addFiber(m_fiber[i], m_pFDD->FiberDensity(mp, m_fiber[i])*m_weight[i]);
+	}
+	else
+	{
+		FEFiberIntegrationSchemeIterator* it = m_pFint->GetIterator(&mp);
+		if (it->IsValid())
+		{
+			do
+			{
+				vec3d& N = it->m_fiber;
+				addFiber(N, m_pFDD->FiberDensity(mp, N)*it->m_weight);
+			}
+			while (it->Next());
+		}
+		delete it;
+	}
+
+	if (b.n > 0) f(b);
+}
+
+//-----------------------------------------------------------------------------
+// Batched evaluation of the stress. The fiber stress of loaded fibers is 2*Wl/J*(F*n0)x(F*n0),
+// so the sum over all fibers can be written as the push-forward of the material tensor 
+// A = sum(w*Wl*n0xn0), which is accumulated over the batches.
+mat3ds FEContinuousFiberDistribution::BatchStress(FEMaterialPoint& mp)
+{
+	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
+	mat3ds C = pt.RightCauchyGreen();
+
+	double In[FEFiberBatch::MAX_SIZE];
+	double Wl[FEFiberBatch::MAX_SIZE];
+	double h[FEFiberBatch::MAX_SIZE];
+
+	// material tensors of fiber and shear contributions (xx, yy, zz, xy, yz, xz)
+	double A[6] = { 0 }, H[6] = { 0 };
+	double mu = 0.0;
+
+	// stress of fibers that don't support batched evaluation
+	mat3ds s(0.0);
+
+	ForEachFiberBatch(mp, [&](const FEFiberBatch& b) {
+		const int n = b.n;
+		const double* x = b.x;
+		const double* y = b.y;
+		const double* z = b.z;
+		const double* w = b.w;
+
+		for (int i = 0; i < n; ++i)
+		{
+			In[i] = C.xx()*x[i]*x[i] + C.yy()*y[i]*y[i] + C.zz()*z[i]*z[i] + 2.0*(C.xy()*x[i]*y[i] + C.yz()*y[i]*z[i] + C.xz()*x[i]*z[i]);
+		}
+
+		if (m_pFmat->FiberResponse(mp, n, In, Wl, nullptr, h, mu) == false)
+		{
+			for (int i = 0; i < n; ++i) s += m_pFmat->FiberStress(mp, vec3d(x[i], y[i], z[i]))*w[i];
+			return;
+		}
+
+		for (int i = 0; i < n; ++i)
+		{
+			double a = w[i] * Wl[i];
+			A[0] += a*x[i]*x[i]; A[1] += a*y[i]*y[i]; A[2] += a*z[i]*z[i];
+			A[3] += a*x[i]*y[i]; A[4] += a*y[i]*z[i]; A[5] += a*x[i]*z[i];
+		}
+
+		if (mu != 0.0)
+		{
+			for (int i = 0; i < n; ++i)
+			{
+				double a = w[i] * h[i];
+				H[0] += a*x[i]*x[i]; H[1] += a*y[i]*y[i]; H[2] += a*z[i]*z[i];
+				H[3] += a*x[i]*y[i]; H[4] += a*y[i]*z[i]; H[5] += a*x[i]*z[i];
+			}
+		}
+	});
+
+	// push forward to current configuration
+	const mat3d& F = pt.m_F;
+	double J = pt.m_J;
+	mat3d Ft = F.transpose();
+	mat3ds Ns = (F*mat3ds(A[0], A[1], A[2], A[3], A[4], A[5])*Ft).sym();
+	s += Ns*(2.0 / J);
+
+	// add the contribution from shear
+	if (mu != 0.0)
+	{
+		mat3ds Hs = (F*mat3ds(H[0], H[1], H[2], H[3], H[4], H[5])*Ft).sym();
+		mat3ds BmI = pt.LeftCauchyGreen() - mat3dd(1);
+		s += (Hs*BmI).sym()*(mu / J);
+	}
+
+	// divide by IFD
+	return s / IntegratedFiberDensity(mp);
+}
+
+//-----------------------------------------------------------------------------
+// Batched evaluation of the tangent. The fiber tangent of loaded fibers is 4*Wll/J*NxN with
+// N = (F*n0)x(F*n0), which is accumulated in Voigt notation over the batches.
+tens4ds FEContinuousFiberDistribution::BatchTangent(FEMaterialPoint& mp)
+{
+	FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
+	mat3ds C = pt.RightCauchyGreen();
+	const mat3d& F = pt.m_F;
+	double J = pt.m_J;
+
+	double In[FEFiberBatch::MAX_SIZE];
+	double Wl[FEFiberBatch::MAX_SIZE];
+	double Wll[FEFiberBatch::MAX_SIZE];
+	double h[FEFiberBatch::MAX_SIZE];
+
+	// components of N in Voigt order (xx, yy, zz, xy, yz, xz)
+	double P[6][FEFiberBatch::MAX_SIZE];
+
+	// accumulated tangent (same storage as tens4ds) and spatial shear tensor
+	double T[tens4ds::NNZ] = { 0 };
+	double H[6] = { 0 };
+	double mu = 0.0;
+
+	// tangent of fibers that don't support batched evaluation
+	tens4ds c;
+	c.zero();
+
+	ForEachFiberBatch(mp, [&](const FEFiberBatch& b) {
+		const int n = b.n;
+		const double* x = b.x;
+		const double* y = b.y;
+		const double* z = b.z;
+		const double* w = b.w;
+
+		for (int i = 0; i < n; ++i)
+		{
+			In[i] = C.xx()*x[i]*x[i] + C.yy()*y[i]*y[i] + C.zz()*z[i]*z[i] + 2.0*(C.xy()*x[i]*y[i] + C.yz()*y[i]*z[i] + C.xz()*x[i]*z[i]);
+		}
+
+		if (m_pFmat->FiberResponse(mp, n, In, Wl, Wll, h, mu) == false)
+		{
+			for (int i = 0; i < n; ++i) c += m_pFmat->FiberTangent(mp, vec3d(x[i], y[i], z[i]))*w[i];
+			return;
+		}
+
+		// spatial fiber directions
+		for (int i = 0; i < n; ++i)
+		{
+			double nx = F[0][0]*x[i] + F[0][1]*y[i] + F[0][2]*z[i];
+			double ny = F[1][0]*x[i] + F[1][1]*y[i] + F[1][2]*z[i];
+			double nz = F[2][0]*x[i] + F[2][1]*y[i] + F[2][2]*z[i];
+			P[0][i] = nx*nx; P[1][i] = ny*ny; P[2][i] = nz*nz;
+			P[3][i] = nx*ny; P[4][i] = ny*nz; P[5][i] = nx*nz;
+		}
+
+		// T(I,J) += w*Wll*N(I)*N(J), stored in column major order
+		int k = 0;
+		for (int J = 0; J < 6; ++J)
+			for (int I = 0; I <= J; ++I, ++k)
+			{
+				double t = 0.0;
+				for (int i = 0; i < n; ++i) t += w[i] * Wll[i] * P[I][i] * P[J][i];
+				T[k] += t;
+			}
+
+		if (mu != 0.0)
+		{
+			for (int I = 0; I < 6; ++I)
+			{
+				double t = 0.0;
+				for (int i = 0; i < n; ++i) t += w[i] * h[i] * P[I][i];
+				H[I] += t;
+			}
+		}
+	});
+
+	tens4ds cf;
+	for (int k = 0; k < tens4ds::NNZ; ++k) cf.d[k] = T[k];
+	c += cf*(4.0 / J);
+
+	// add the contribution from shear
+	if (mu != 0.0)
+	{
+		mat3ds B = pt.LeftCauchyGreen();
+		c += dyad4s(mat3ds(H[0], H[1], H[2], H[3], H[4], H[5]), B)*(mu / J);
+	}
+
+	// divide by IFD
+	return c / IntegratedFiberDensity(mp);
+}
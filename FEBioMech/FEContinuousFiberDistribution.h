@@ -32,11 +32,13 @@ SOFTWARE.*/
 #include "FEFiberDensityDistribution.h"
 #include "FEFiberIntegrationScheme.h"
 #include "FEFiberMaterialPoint.h"
+#include "febiomech_api.h"
+#include <vector>
 
 //  This material is a container for a fiber material, a fiber density
 //  distribution, and an integration scheme.
 //
-class FEContinuousFiberDistribution : public FEElasticMaterial
+class FEBIOMECH_API FEContinuousFiberDistribution : public FEElasticMaterial
 {
 public:
     FEContinuousFiberDistribution(FEModel* pfem);
@@ -61,9 +63,36 @@ public:
 	//! Serialization
 	void Serialize(DumpStream& ar) override;
 
+public:
+	// Enable or disable the batched evaluation of the fiber integrals (on by default).
+	// This is mainly used for benchmarking.
+	static void SetBatchEvaluation(bool b);
+	static bool BatchEvaluation();
+
+	// get the fiber integration scheme
+	FEFiberIntegrationScheme* GetIntegrationScheme() { return m_pFint; }
+
 private:
 	double IntegratedFiberDensity(FEMaterialPoint& pt);
 
+	void BuildFiberTable();
+
+	template <class F> void ForEachFiberBatch(FEMaterialPoint& mp, F f);
+
+	mat3ds BatchStress(FEMaterialPoint& mp);
+
+	tens4ds BatchTangent(FEMaterialPoint& mp);
+
+private:
+	// integration points of schemes that don't depend on the material point
+	bool				m_btable;	// the table is used
+	bool				m_bconstR;	// fiber density is constant and included in m_weight
+	std::vector<vec3d>	m_fiber;	// fiber directions (local coordinates)
+	std::vector<double>	m_weight;	// integration weights
+	double				m_IFD;		// integrated fiber density (if constant)
+
+	static bool	m_bbatch;
+
 protected:
 	FEFiberMaterial*			m_pFmat;    // pointer to fiber material
 	FEFiberDensityDistribution* m_pFDD;     // pointer to fiber density distribution
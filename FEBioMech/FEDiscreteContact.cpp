@@ -65,6 +65,12 @@ FEDiscreteContact::FEDiscreteContact(FEModel* pfem) : FESurfaceConstraint(pfem),
 	m_naugmax = 100;
 	m_bfirst = true;
 	m_nsegup = 0;
+	m_cpp = nullptr;
+}
+
+FEDiscreteContact::~FEDiscreteContact()
+{
+	delete m_cpp;
 }
 
 bool FEDiscreteContact::Init()
@@ -117,7 +123,9 @@ void FEDiscreteContact::SetDiscreteSet(FEDiscreteSet* pset)
 
 void FEDiscreteContact::ProjectSurface(bool bsegup)
 {
-	FEClosestPointProjection cpp(m_surf);
+	// the projection is created once, after that Init() refits it (or rebuilds it if the surface changed)
+	if (m_cpp == nullptr) m_cpp = new FEClosestPointProjection(m_surf);
+	FEClosestPointProjection& cpp = *m_cpp;
 	cpp.SetTolerance(0.01);
 	cpp.SetSearchRadius(0.0);
 	cpp.HandleSpecialCases(true);
@@ -216,7 +224,7 @@ void FEDiscreteContact::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		NODE& nodeData = m_Node[i];
 
 		FENode& node = mesh.Node(nodeData.nid);
-		vector<int>& sLM = node.m_ID;
+		FENodeDofArray<int>& sLM = node.m_ID;
 
 		FESurfaceElement* pe = nodeData.pe;
 
@@ -342,7 +350,7 @@ void FEDiscreteContact::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp
 	{
 		NODE& nodeData = m_Node[i];
 
-		vector<int>& sLM = mesh.Node(nodeData.nid).m_ID;
+		FENodeDofArray<int>& sLM = mesh.Node(nodeData.nid).m_ID;
 
 		// see if this node's constraint is active
 		// that is, if it has a secondary element associated with it
@@ -687,7 +695,7 @@ void FEDiscreteContact::BuildMatrixProfile(FEGlobalMatrix& K)
 
 			for (int k=0; k<n; ++k)
 			{
-				vector<int>& id = mesh.Node(en[k]).m_ID;
+				FENodeDofArray<int>& id = mesh.Node(en[k]).m_ID;
 				lm[6*(k+1)  ] = id[dof_X];
 				lm[6*(k+1)+1] = id[dof_Y];
 				lm[6*(k+1)+2] = id[dof_Z];
@@ -708,6 +716,12 @@ END_FECORE_CLASS();
 FEDiscreteContact2::FEDiscreteContact2(FEModel* fem) : FESurfaceConstraint(fem), m_surf(fem)
 {
 	m_dom = 0;	
+	m_cpp = nullptr;
+}
+
+FEDiscreteContact2::~FEDiscreteContact2()
+{
+	delete m_cpp;
 }
 
 bool FEDiscreteContact2::Init()
@@ -804,7 +818,9 @@ void FEDiscreteContact2::Update(const FETimeInfo& tp)
 void FEDiscreteContact2::ProjectNodes()
 {
 	// setup closest point projection
-	FEClosestPointProjection cpp(m_surf);
+	// (the projection is created once, after that Init() refits it, or rebuilds it if the surface changed)
+	if (m_cpp == nullptr) m_cpp = new FEClosestPointProjection(m_surf);
+	FEClosestPointProjection& cpp = *m_cpp;
 	cpp.SetTolerance(0.01);
 	cpp.SetSearchRadius(0.0);
 	cpp.HandleSpecialCases(true);
@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include <FECore/FESurfaceConstraint.h>
 #include "FEContactSurface.h"
 #include "FEDeformableSpringDomain.h"
+#include <FECore/FEClosestPointProjection.h>
 
 //-----------------------------------------------------------------------------
 class FEDiscreteSet;
@@ -61,6 +62,7 @@ class FEBIOMECH_API FEDiscreteContact : public FESurfaceConstraint
 
 public:
 	FEDiscreteContact(FEModel* pfem);
+	~FEDiscreteContact();
 
 public:
 	bool Init() override;
@@ -87,6 +89,8 @@ protected:
 	double	m_normg0;
 	bool	m_bfirst;
 
+	FEClosestPointProjection*	m_cpp;	//!< projection onto the surface
+
 protected:
 	bool	m_blaugon;	//!< augmentation flag
 	double	m_altol;	//!< augmentation tolerance
@@ -113,6 +117,7 @@ class FEBIOMECH_API FEDiscreteContact2 : public FESurfaceConstraint
 
 public:
 	FEDiscreteContact2(FEModel* fem);
+	~FEDiscreteContact2();
 
 	bool Init() override;
 	void Activate() override;
@@ -134,5 +139,7 @@ protected:
 	FEDeformableSpringDomain2*	m_dom;
 	vector<NODE>	m_nodeData;
 
+	FEClosestPointProjection*	m_cpp;	//!< projection onto the surface
+
 	DECLARE_FECORE_CLASS();
 };
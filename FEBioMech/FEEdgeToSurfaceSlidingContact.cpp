@@ -88,7 +88,7 @@ void FEEdgeToSurfaceSlidingContactEdge::UnpackLM(FELineElement& el, vector<int>&
 	{
 		int n = el.m_node[i];
 		FENode& node = m_pMesh->Node(n);
-		vector<int>& id = node.m_ID;
+		FENodeDofArray<int>& id = node.m_ID;
 
 		lm[3 * i    ] = id[m_dofX];
 		lm[3 * i + 1] = id[m_dofY];
@@ -163,6 +163,12 @@ FEEdgeToSurfaceSlidingContact::FEEdgeToSurfaceSlidingContact(FEModel* fem) : FES
 	m_sradius = 0;
 
 	m_bfirst = true;
+	m_cpp = nullptr;
+}
+
+FEEdgeToSurfaceSlidingContact::~FEEdgeToSurfaceSlidingContact()
+{
+	delete m_cpp;
 }
 
 FESurface* FEEdgeToSurfaceSlidingContact::GetSurface()
@@ -196,7 +202,9 @@ bool FEEdgeToSurfaceSlidingContact::Init()
 
 void FEEdgeToSurfaceSlidingContact::ProjectSurface(bool bupseg, bool bmove)
 {
-	FEClosestPointProjection cpp(m_surf);
+	// the projection is created once, after that Init() refits it (or rebuilds it if the surface changed)
+	if (m_cpp == nullptr) m_cpp = new FEClosestPointProjection(m_surf);
+	FEClosestPointProjection& cpp = *m_cpp;
 	cpp.SetTolerance(m_stol);
 	cpp.SetSearchRadius(m_sradius);
 	cpp.HandleSpecialCases(true);
@@ -377,7 +385,7 @@ void FEEdgeToSurfaceSlidingContact::BuildMatrixProfile(FEGlobalMatrix& K)
 
 			for (int k = 0; k < n; ++k)
 			{
-				vector<int>& id = mesh.Node(en[k]).m_ID;
+				FENodeDofArray<int>& id = mesh.Node(en[k]).m_ID;
 				lm[6 * (k + 1)    ] = id[dof_X];
 				lm[6 * (k + 1) + 1] = id[dof_Y];
 				lm[6 * (k + 1) + 2] = id[dof_Z];
@@ -27,6 +27,7 @@ SOFTWARE.*/
 #include <FECore/FESurfaceConstraint.h>
 #include <FECore/FEEdge.h>
 #include "FEContactSurface.h"
+#include <FECore/FEClosestPointProjection.h>
 #include <set>
 
 //=======================================================================================
@@ -98,6 +99,7 @@ class FEEdgeToSurfaceSlidingContact : public FESurfaceConstraint
 {
 public:
 	FEEdgeToSurfaceSlidingContact(FEModel* fem);
+	~FEEdgeToSurfaceSlidingContact();
 
 public:
 	//! return the surface
@@ -144,5 +146,7 @@ protected:
 
 	bool m_bfirst;
 
+	FEClosestPointProjection*	m_cpp;	//!< projection onto the surface
+
 	DECLARE_FECORE_CLASS();
 };
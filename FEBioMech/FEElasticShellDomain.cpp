@@ -445,10 +445,8 @@ void FEElasticShellDomain::ElementBodyForceStiffness(FEBodyForce& BF, FEShellEle
 void FEElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
 {
     // repeat over all shell elements
-    int NS = (int)m_Elem.size();
-#pragma omp parallel for shared (NS)
-    for (int iel=0; iel<NS; ++iel)
-    {
+    LS.ForEachElement(*this, [&](int iel) {
+
 		FEShellElement& el = m_Elem[iel];
         
         // create the element's stiffness matrix
@@ -466,7 +464,7 @@ void FEElasticShellDomain::StiffnessMatrix(FELinearSystem& LS)
         
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-    }
+    });
 }
 
 //-----------------------------------------------------------------------------
@@ -907,7 +905,7 @@ void FEElasticShellDomain::UnpackLM(FEElement& el, vector<int>& lm)
 	for (int i=0; i<N; ++i)
 	{
 		FENode& node = m_pMesh->Node(el.m_node[i]);
-		vector<int>& id = node.m_ID;
+		FENodeDofArray<int>& id = node.m_ID;
 
 		// first the displacement dofs
 		lm[6*i  ] = id[m_dofU[0]];
@@ -419,11 +419,8 @@ void FEElasticSolidDomain::ElementMaterialStiffness(FESolidElement &el, matrix &
 void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 {
 	// repeat over all solid elements
-	int NE = Elements();
-	
-	#pragma omp parallel for shared (NE)
-	for (int iel=0; iel<NE; ++iel)
-	{
+	LS.ForEachElement(*this, [&](int iel) {
+
 		FESolidElement& el = m_Elem[iel];
 
 		if (el.isActive()) {
@@ -456,7 +453,7 @@ void FEElasticSolidDomain::StiffnessMatrix(FELinearSystem& LS)
 			// assemble element matrix in global stiffness matrix
 			LS.Assemble(ke);
 		}
-	}
+	});
 }
 
 //-----------------------------------------------------------------------------
@@ -681,7 +678,7 @@ void FEElasticSolidDomain::UnpackLM(FEElement& el, vector<int>& lm)
 	for (int i=0; i<N; ++i)
 	{
 		FENode& node = m_pMesh->Node(el.m_node[i]);
-		vector<int>& id = node.m_ID;
+		FENodeDofArray<int>& id = node.m_ID;
 
 		// first the displacement dofs
 		lm[3*i  ] = id[m_dofU[0]];
@@ -700,7 +697,7 @@ void FEElasticSolidDomain::UnpackLM(FEElement& el, vector<int>& lm)
     {
         if (sel.m_bitfc[i]) {
             FENode& node = m_pMesh->Node(el.m_node[i]);
-            vector<int>& id = node.m_ID;
+            FENodeDofArray<int>& id = node.m_ID;
             
             // first the displacement dofs
             lm[3*i  ] = id[m_dofSU[0]];
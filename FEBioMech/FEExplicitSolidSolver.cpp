@@ -54,6 +54,10 @@ SOFTWARE.*/
 BEGIN_FECORE_CLASS(FEExplicitSolidSolver, FESolver)
 	ADD_PARAMETER(m_mass_lumping, "mass_lumping");
 	ADD_PARAMETER(m_dyn_damping, "dyn_damping");
+	ADD_PARAMETER(m_bautodt, "auto_dt");
+	ADD_PARAMETER(m_dtscale, FE_RANGE_LEFT_OPEN(0.0, 1.0), "dt_scale");
+	ADD_PARAMETER(m_dtmin, FE_RANGE_GREATER_OR_EQUAL(0.0), "mass_scaling_dt");
+	ADD_PARAMETER(m_nsubsteps, FE_RANGE_GREATER_OR_EQUAL(0), "substeps");
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -69,6 +73,13 @@ FEExplicitSolidSolver::FEExplicitSolidSolver(FEModel* pfem) :
 
 	m_mass_lumping = HRZ_LUMPING;
 
+	m_bautodt = false;
+	m_dtscale = 0.9;
+	m_dtmin = 0.0;
+	m_dtc = 0.0;
+	m_dtcLog = 0.0;
+	m_nsubsteps = 1;
+
 	// Allocate degrees of freedom
 	// TODO: Can this be done in Init, since there is no error checking
 	if (pfem)
@@ -190,6 +201,10 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 						}
 					}
 
+					// apply mass scaling
+					double ms = m_ms[m_elemOffset[nd] + iel];
+					if (ms != 1.0) for (double& m : el_lumped_mass) m *= ms;
+
 					// assemble element matrix into inv_mass vector 
 					M.Assemble(el.m_node, lm, el_lumped_mass);
 				} // loop over elements
@@ -224,6 +239,10 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 							el_lumped_mass[i] += kab;
 						}
 					}
+					// apply mass scaling
+					double ms = m_ms[m_elemOffset[nd] + iel];
+					if (ms != 1.0) for (double& m : el_lumped_mass) m *= ms;
+
 					// assemble element matrix into inv_mass vector 
 					M.Assemble(el.m_node, lm, el_lumped_mass);
 				}
@@ -361,6 +380,10 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 						el_lumped_mass[3 * i + 2] = mab;
 					}
 
+					// apply mass scaling
+					double ms = m_ms[m_elemOffset[nd] + iel];
+					if (ms != 1.0) for (double& m : el_lumped_mass) m *= ms;
+
 					// assemble element matrix into inv_mass vector 
 					M.Assemble(el.m_node, lm, el_lumped_mass);
 				} // loop over elements
@@ -408,6 +431,10 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 						el_lumped_mass[i] = mab;
 					}
 
+					// apply mass scaling
+					double ms = m_ms[m_elemOffset[nd] + iel];
+					if (ms != 1.0) for (double& m : el_lumped_mass) m *= ms;
+
 					// assemble element matrix into inv_mass vector 
 					M.Assemble(el.m_node, lm, el_lumped_mass);
 				}
@@ -436,6 +463,166 @@ bool FEExplicitSolidSolver::CalculateMassMatrix()
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+//! Calculate the critical time step of an element. This is the time it takes
+//! a dilatational wave to cross the element, i.e. L/c, where L is the smallest
+//! distance between two nodes of the element and c = sqrt(C/rho) is the wave speed
+//! of the material. For C the largest diagonal component of the spatial tangent is used.
+//! Returns 0 if the critical time step cannot be determined.
+double FEExplicitSolidSolver::ElementCriticalTimeStep(FEElement& el, FESolidMaterial* pme)
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+
+	// characteristic length
+	int neln = el.Nodes();
+	double L2 = 0.0;
+	for (int i = 0; i < neln; ++i)
+	{
+		vec3d ri = mesh.Node(el.m_node[i]).m_rt;
+		for (int j = i + 1; j < neln; ++j)
+		{
+			vec3d rj = mesh.Node(el.m_node[j]).m_rt;
+			double l2 = (rj - ri).norm2();
+			if ((L2 == 0.0) || (l2 < L2)) L2 = l2;
+		}
+	}
+	if (L2 <= 0.0) return 0.0;
+
+	// largest wave speed (squared) over all integration points
+	double c2 = 0.0;
+	int nint = el.GaussPoints();
+	for (int n = 0; n < nint; ++n)
+	{
+		FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+		FEElasticMaterialPoint& ep = *mp.ExtractData<FEElasticMaterialPoint>();
+
+		// current density
+		double rho = pme->Density(mp) / ep.m_J;
+		if (rho <= 0.0) continue;
+
+		tens4ds C = pme->Tangent(mp);
+		double Cmax = C(0, 0);
+		if (C(1, 1) > Cmax) Cmax = C(1, 1);
+		if (C(2, 2) > Cmax) Cmax = C(2, 2);
+
+		double ci = Cmax / rho;
+		if (ci > c2) c2 = ci;
+	}
+	if (c2 <= 0.0) return 0.0;
+
+	return sqrt(L2 / c2);
+}
+
+//-----------------------------------------------------------------------------
+//! Calculate the critical time step of all elements of the elastic solid and shell
+//! domains. The element values (which include the effect of mass scaling) are stored
+//! in m_dte. Returns the smallest critical time step, or 0 if it could not be determined.
+double FEExplicitSolidSolver::CriticalTimeStep()
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+
+	for (int nd = 0; nd < mesh.Domains(); ++nd)
+	{
+		FEDomain& dom = mesh.Domain(nd);
+		double* dte = m_dte.data() + m_elemOffset[nd];
+		double* ms = m_ms.data() + m_elemOffset[nd];
+		int NE = dom.Elements();
+
+		FESolidMaterial* pme = nullptr;
+		if (dynamic_cast<FEElasticSolidDomain*>(&dom) || dynamic_cast<FEElasticShellDomain*>(&dom))
+			pme = dynamic_cast<FESolidMaterial*>(dom.GetMaterial());
+
+		if ((pme == nullptr) || pme->IsRigid())
+		{
+			for (int i = 0; i < NE; ++i) dte[i] = 0.0;
+			continue;
+		}
+
+#pragma omp parallel for
+		for (int i = 0; i < NE; ++i)
+		{
+			// mass scaling increases the critical time step by sqrt(ms)
+			dte[i] = ElementCriticalTimeStep(dom.ElementRef(i), pme) * sqrt(ms[i]);
+		}
+	}
+
+	double dtmin = 0.0;
+	for (double dt : m_dte)
+	{
+		if ((dt > 0.0) && ((dtmin == 0.0) || (dt < dtmin))) dtmin = dt;
+	}
+	return dtmin;
+}
+
+//-----------------------------------------------------------------------------
+//! Report the critical time step, but only if it changed by more than 1% since it
+//! was last reported. It changes a little with every increment as the mesh deforms.
+void FEExplicitSolidSolver::LogCriticalTimeStep()
+{
+	if (fabs(m_dtc - m_dtcLog) > 0.01*m_dtcLog)
+	{
+		feLog("\t critical time step : %lg\n", m_dtc);
+		m_dtcLog = m_dtc;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Selective mass scaling. The density of elements whose (scaled) critical time step 
+//! is smaller than dtmin is increased so that their critical time step becomes dtmin.
+void FEExplicitSolidSolver::CalculateMassScaling(double dtmin)
+{
+	m_ms.assign(m_ms.size(), 1.0);
+	CriticalTimeStep();
+
+	int nscaled = 0;
+	double msmax = 1.0;
+	for (size_t i = 0; i < m_dte.size(); ++i)
+	{
+		double dt = m_dtscale * m_dte[i];
+		if ((dt > 0.0) && (dt < dtmin))
+		{
+			double r = dtmin / dt;
+			m_ms[i] = r * r;
+			if (m_ms[i] > msmax) msmax = m_ms[i];
+			nscaled++;
+		}
+	}
+
+	if (nscaled > 0)
+		feLog("Mass scaling applied to %d elements (max. scale factor = %lg)\n", nscaled, msmax);
+}
+
+//-----------------------------------------------------------------------------
+//! Build the map between the equations of the nodal (solid and shell) displacement dofs
+//! and the corresponding nodal values. The map stores pointers into the mesh' nodal data,
+//! so it needs to be rebuilt when the mesh changes (which is followed by a call to Init).
+void FEExplicitSolidSolver::BuildDofMap()
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+
+	m_dofMap.clear();
+	for (int i = 0; i < mesh.Nodes(); ++i)
+	{
+		FENode& node = mesh.Node(i);
+		double* at = &node.m_at.x;
+		for (int j = 0; j < 3; ++j)
+		{
+			int n;
+			if ((n = node.m_ID[m_dofU[j]]) >= 0)
+			{
+				NodalDof d = { n, &node.get(m_dofU[j]), &node.get(m_dofV[j]), at + j };
+				m_dofMap.push_back(d);
+			}
+
+			if ((n = node.m_ID[m_dofSU[j]]) >= 0)
+			{
+				NodalDof d = { n, &node.get(m_dofSU[j]), &node.get(m_dofSV[j]), &node.get(m_dofSA[j]) };
+				m_dofMap.push_back(d);
+			}
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! initialize equations
 bool FEExplicitSolidSolver::InitEquations()
@@ -491,6 +678,20 @@ bool FEExplicitSolidSolver::Init()
 	gather(m_Ut, mesh, m_dofSU[1]);
 	gather(m_Ut, mesh, m_dofSU[2]);
 
+	// set up the element data for the critical time step
+	int NE = 0;
+	m_elemOffset.resize(mesh.Domains());
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		m_elemOffset[i] = NE;
+		NE += mesh.Domain(i).Elements();
+	}
+	m_dte.assign(NE, 0.0);
+	m_ms.assign(NE, 1.0);
+
+	// selective mass scaling
+	if (m_dtmin > 0.0) CalculateMassScaling(m_dtmin);
+
 	// calculate the inverse mass vector for the explicit analysis
 	if (CalculateMassMatrix() == false)
 	{
@@ -498,6 +699,42 @@ bool FEExplicitSolidSolver::Init()
 		return false;
 	}
 
+	// build the nodal dof map
+	BuildDofMap();
+
+	if ((m_nsubsteps == 0) && (m_bautodt == false))
+	{
+		feLogError("substeps = 0 requires the auto_dt option.");
+		return false;
+	}
+
+	// set the initial time step
+	if (m_bautodt)
+	{
+		FEAnalysis* pstep = fem.GetCurrentStep();
+		if (pstep->m_timeController)
+		{
+			feLogWarning("The time stepper will override the time step size of the auto_dt option.");
+		}
+
+		m_dtc = CriticalTimeStep();
+		if (m_dtc <= 0.0)
+		{
+			feLogError("Failed to determine the critical time step.");
+			return false;
+		}
+		double dt = m_dtscale * m_dtc;
+		feLog("Critical time step: %lg (time step size : %lg)\n", m_dtc, dt);
+		m_dtcLog = m_dtc;
+
+		// When substepping, the time step size is the output interval, so we leave it alone.
+		if (m_nsubsteps == 1)
+		{
+			fem.SetCurrentTimeStep(dt);
+			fem.GetTime().timeIncrement = dt;
+		}
+	}
+
 	// calculate the initial acceleration
 	// (Only when the totiter == 0, in case of a restart)
 	if (fem.GetCurrentStep()->m_ntotiter == 0)
@@ -505,17 +742,10 @@ bool FEExplicitSolidSolver::Init()
 		// Calculate initial residual to be used on the first time step
 		if (Residual(m_Rt) == false) return false;
 
-		for (int i = 0; i < mesh.Nodes(); ++i)
+		for (NodalDof& d : m_dofMap)
 		{
-			FENode& node = mesh.Node(i);
-			int n;
-			if ((n = node.m_ID[m_dofU[0]]) >= 0) { m_data[n].a = node.m_at.x = m_Rt[n] * m_data[n].mi; }
-			if ((n = node.m_ID[m_dofU[1]]) >= 0) { m_data[n].a = node.m_at.y = m_Rt[n] * m_data[n].mi; }
-			if ((n = node.m_ID[m_dofU[2]]) >= 0) { m_data[n].a = node.m_at.z = m_Rt[n] * m_data[n].mi; }
-
-			if ((n = node.m_ID[m_dofSU[0]]) >= 0) { m_data[n].a = m_Rt[n] * m_data[n].mi; node.set(m_dofSA[0], m_data[n].a);}
-			if ((n = node.m_ID[m_dofSU[1]]) >= 0) { m_data[n].a = m_Rt[n] * m_data[n].mi; node.set(m_dofSA[1], m_data[n].a);}
-			if ((n = node.m_ID[m_dofSU[2]]) >= 0) { m_data[n].a = m_Rt[n] * m_data[n].mi; node.set(m_dofSA[2], m_data[n].a);}
+			int n = d.eq;
+			m_data[n].a = *d.a = m_Rt[n] * m_data[n].mi;
 		}
 
 		// do rigid bodies
@@ -572,8 +802,14 @@ void FEExplicitSolidSolver::UpdateKinematics(vector<double>& ui)
 	for (int i=0; i<m_Ut.size(); ++i) U[i] = ui[i] + m_Ut[i];
 
 	// update flexible nodes
-	// translational dofs
-	scatter3(U, mesh, m_dofU[0], m_dofU[1], m_dofU[2]);
+	// translational and shell displacement dofs
+	const int ND = (int)m_dofMap.size();
+#pragma omp parallel for
+	for (int i = 0; i < ND; ++i)
+	{
+		NodalDof& d = m_dofMap[i];
+		*d.u = U[d.eq];
+	}
 
 	// rotational dofs
 	// TODO: Commenting this out, since this is only needed for the old shells, which I'm not sure
@@ -582,9 +818,6 @@ void FEExplicitSolidSolver::UpdateKinematics(vector<double>& ui)
 //	scatter(U, mesh, m_dofQ[1]);
 //	scatter(U, mesh, m_dofQ[2]);
 
-	// shell displacement
-	scatter3(U, mesh, m_dofSU[0], m_dofSU[1], m_dofSU[2]);
-
 	// make sure the prescribed displacements are fullfilled
 	int ndis = fem.BoundaryConditions();
 	for (int i=0; i<ndis; ++i)
@@ -803,17 +1036,11 @@ void FEExplicitSolidSolver::PrepStep()
 {
 	int i, j;
 
-	// initialize counters
-	m_niter = 0;	// nr of iterations
-	m_nrhs  = 0;	// nr of RHS evaluations
-	m_nref  = 0;	// nr of stiffness reformations
-	m_ntotref = 0;
-	m_naug  = 0;	// nr of augmentations
-
 	// store previous mesh state
 	// we need them for velocity and acceleration calculations
 	FEMechModel& fem = static_cast<FEMechModel&>(*GetFEModel());
 	FEMesh& mesh = fem.GetMesh();
+	mesh.UpdateValues();
 #pragma omp parallel for
 	for (i=0; i<mesh.Nodes(); ++i)
 	{
@@ -821,7 +1048,6 @@ void FEExplicitSolidSolver::PrepStep()
 		ni.m_rp = ni.m_rt;
 		ni.m_vp = ni.get_vec3d(m_dofV[0], m_dofV[1], m_dofV[2]);
 		ni.m_ap = ni.m_at;
-		ni.UpdateValues();
 	}
 
 	const FETimeInfo& tp = fem.GetTime();
@@ -950,18 +1176,99 @@ void FEExplicitSolidSolver::PrepStep()
 //-----------------------------------------------------------------------------
 bool FEExplicitSolidSolver::DoSolve()
 {
-	// Get the current step
-	FEMechModel& fem = dynamic_cast<FEMechModel&>(*GetFEModel());
-	FEAnalysis* pstep = fem.GetCurrentStep();
+	FEModel& fem = *GetFEModel();
+
+	// initialize counters
+	m_niter = 0;	// nr of iterations
+	m_nrhs  = 0;	// nr of RHS evaluations
+	m_nref  = 0;	// nr of stiffness reformations
+	m_ntotref = 0;
+	m_naug  = 0;	// nr of augmentations
+
+	if (m_nsubsteps == 1)
+	{
+		// prepare for solve
+		PrepStep();
+
+		// do the increment
+		Increment(true);
+		m_niter++;
+
+		// update the time step size for the next step
+		if (m_bautodt)
+		{
+			double dtc = CriticalTimeStep();
+			if (dtc > 0.0)
+			{
+				m_dtc = dtc;
+				LogCriticalTimeStep();
+				fem.SetCurrentTimeStep(m_dtscale * dtc);
+			}
+		}
+	}
+	else
+	{
+		// Advance the solution over the time step in several increments. The time step
+		// was already initialized for the end of the step, so we need to back up to the start.
+		FETimeInfo& tp = fem.GetTime();
+		double tend = tp.currentTime;
+		double Dt = tp.timeIncrement;
+		double t = tend - Dt;
+		const double eps = Dt * 1e-7;
+		while (tend - t > eps)
+		{
+			// determine the increment
+			double dt = (m_bautodt ? m_dtscale * m_dtc : Dt / m_nsubsteps);
+			if (t + dt > tend - eps) dt = tend - t;
+			t += dt;
+			tp.currentTime = t;
+			tp.timeIncrement = dt;
+
+			// update the load controllers and the parameters that depend on them
+			if (fem.LoadControllers() > 0)
+			{
+				fem.EvaluateLoadControllers(t);
+				bool blocked = fem.LogBlocked();
+				if (blocked == false) fem.BlockLog();
+				fem.EvaluateLoadParameters();
+				if (blocked == false) fem.UnBlockLog();
+			}
+
+			// prepare for increment
+			PrepStep();
+
+			// do the increment (only the last one is logged)
+			bool blast = (tend - t <= eps);
+			Increment(blast);
+			m_niter++;
+
+			// update the critical time step
+			if (m_bautodt)
+			{
+				double dtc = CriticalTimeStep();
+				if (dtc > 0.0) m_dtc = dtc;
+			}
+		}
+		tp.currentTime = tend;
 
-	// prepare for solve
-	PrepStep();
+		feLog("\t increments : %d\n", m_niter);
+		if (m_bautodt) LogCriticalTimeStep();
+	}
+
+	// do minor iterations callbacks
+	fem.DoCallback(CB_MINOR_ITERS);
 
-//	feLog(" %d\n", m_niter+1);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! Advance the solution by one explicit increment, using the current time increment.
+void FEExplicitSolidSolver::Increment(bool blog)
+{
+	FEMechModel& fem = static_cast<FEMechModel&>(*GetFEModel());
 
 	// get the mesh
 	FEMesh& mesh = fem.GetMesh();
-	int N = mesh.Nodes(); // this is the total number of nodes in the mesh
 	double dt = fem.GetTime().timeIncrement;
 
 	// collect accelerations, velocities, displacements
@@ -1016,7 +1323,7 @@ bool FEExplicitSolidSolver::DoSolve()
 		Dnorm += m_ui[i] * m_ui[i];
 	}
 	Dnorm = sqrt(Dnorm);
-	feLog("\t displacement norm : %lg\n", Dnorm);
+	if (blog) feLog("\t displacement norm : %lg\n", Dnorm);
 
 	// the update is done in the spatial frame, so we need to update
 	// rigid body rotation increment
@@ -1066,23 +1373,18 @@ bool FEExplicitSolidSolver::DoSolve()
 		}
 
 		// scatter velocity and accelerations
+		const int ND = (int)m_dofMap.size();
 #pragma omp for nowait
-		for (int i = 0; i < mesh.Nodes(); ++i)
+		for (int i = 0; i < ND; ++i)
 		{
-			FENode& node = mesh.Node(i);
-			int n;
-			if ((n = node.m_ID[m_dofU[0]]) >= 0) { node.set(m_dofV[0], m_data[n].v); node.m_at.x = m_data[n].a; }
-			if ((n = node.m_ID[m_dofU[1]]) >= 0) { node.set(m_dofV[1], m_data[n].v); node.m_at.y = m_data[n].a; }
-			if ((n = node.m_ID[m_dofU[2]]) >= 0) { node.set(m_dofV[2], m_data[n].v); node.m_at.z = m_data[n].a; }
-
-			if ((n = node.m_ID[m_dofSU[0]]) >= 0) { node.set(m_dofSV[0], m_data[n].v); node.set(m_dofSA[0], m_data[n].a); }
-			if ((n = node.m_ID[m_dofSU[1]]) >= 0) { node.set(m_dofSV[1], m_data[n].v); node.set(m_dofSA[1], m_data[n].a); }
-			if ((n = node.m_ID[m_dofSU[2]]) >= 0) { node.set(m_dofSV[2], m_data[n].v); node.set(m_dofSA[2], m_data[n].a); }
+			NodalDof& d = m_dofMap[i];
+			*d.v = m_data[d.eq].v;
+			*d.a = m_data[d.eq].a;
 		}
 	}
 
 	Rnorm = sqrt(Rnorm);
-	feLog("\t force vector norm : %lg\n", Rnorm);
+	if (blog) feLog("\t force vector norm : %lg\n", Rnorm);
 
 	// do rigid bodies
 	for (int i = 0; i < fem.RigidBodies(); ++i)
@@ -1135,13 +1437,6 @@ bool FEExplicitSolidSolver::DoSolve()
 		rb.m_ht = It * rb.m_wt;
 	}
 
-	// increase iteration number
-	m_niter++;
-
-	// do minor iterations callbacks
-	fem.DoCallback(CB_MINOR_ITERS);
-
-	return true;
 }
 
 //-----------------------------------------------------------------------------
@@ -33,6 +33,8 @@ SOFTWARE.*/
 #include <FECore/FEDofList.h>
 #include "FERigidSolver.h"
 
+class FESolidMaterial;
+
 //-----------------------------------------------------------------------------
 //! This class implements a nonlinear explicit solver for solid mechanics
 //! problems.
@@ -51,6 +53,14 @@ class FEExplicitSolidSolver : public FESolver
 		double mi = 0; // inverted mass
 	};
 
+	// maps an equation to the nodal values of the corresponding dof
+	struct NodalDof {
+		int		eq;	// equation number
+		double*	u;	// displacement
+		double*	v;	// velocity
+		double*	a;	// acceleration
+	};
+
 public:
 	//! constructor
 	FEExplicitSolidSolver(FEModel* pfem);
@@ -87,6 +97,9 @@ public:
 	//! solve the step
 	bool DoSolve();
 
+	//! do one explicit increment
+	void Increment(bool blog);
+
 	void PrepStep();
 
 	bool Residual(vector<double>& R);
@@ -95,12 +108,27 @@ public:
 
 	void ContactForces(FEGlobalVector& R);
 
+	//! calculate the critical time step of all elements and return the smallest one
+	double CriticalTimeStep();
+
 private:
 	bool CalculateMassMatrix();
 
+	void CalculateMassScaling(double dtmin);
+
+	double ElementCriticalTimeStep(FEElement& el, FESolidMaterial* pme);
+
+	void LogCriticalTimeStep();
+
+	void BuildDofMap();
+
 public:
 	int			m_mass_lumping;	//!< specify mass lumping method
 	double		m_dyn_damping;	//!< velocity damping for the explicit solver
+	bool		m_bautodt;		//!< determine time step from critical time step
+	double		m_dtscale;		//!< safety factor applied to the critical time step
+	double		m_dtmin;		//!< target time step for selective mass scaling (0 = no mass scaling)
+	int			m_nsubsteps;	//!< nr of explicit increments per time step (0 = use critical time step)
 
 public:
 	// equation numbers
@@ -112,6 +140,14 @@ public:
 	vector<double> m_Rt;	//!< residual loads
 	vector<double> m_Fr;	//!< nodal reaction forces
 
+	vector<double> m_dte;	//!< critical time step of each element
+	vector<double> m_ms;	//!< mass scale factor of each element
+	vector<int>    m_elemOffset;	//!< offset of each domain's elements in m_dte and m_ms
+	double         m_dtc;	//!< current critical time step
+	double         m_dtcLog;	//!< critical time step that was last reported
+
+	vector<NodalDof> m_dofMap;	//!< nodal dofs of the equations
+
 protected:
 	FEDofList	m_dofU, m_dofV, m_dofQ, m_dofRQ;
 	FEDofList	m_dofSU, m_dofSV, m_dofSA;
@@ -260,6 +260,8 @@ FEFacet2FacetSliding::FEFacet2FacetSliding(FEModel* pfem) : FEContactInterface(p
 	static int ncount = 1;
 	SetID(ncount++);
 
+	m_cpp[0] = m_cpp[1] = nullptr;
+
 	// default parameters
 	m_epsn = 1.0;
 	m_knmult = 1.0;
@@ -291,6 +293,23 @@ FEFacet2FacetSliding::FEFacet2FacetSliding(FEModel* pfem) : FEContactInterface(p
 	m_ms.SetSibling(&m_ss);
 }
 
+//-----------------------------------------------------------------------------
+FEFacet2FacetSliding::~FEFacet2FacetSliding()
+{
+	delete m_cpp[0];
+	delete m_cpp[1];
+}
+
+//-----------------------------------------------------------------------------
+//! The projections are created the first time they are needed. After that, Init()
+//! only refits the search tree to the current nodal positions.
+FEClosestPointProjection& FEFacet2FacetSliding::Projection(FEFacetSlidingSurface& ms)
+{
+	int n = (&ms == &m_ss ? 0 : 1);
+	if (m_cpp[n] == nullptr) m_cpp[n] = new FEClosestPointProjection(ms);
+	return *m_cpp[n];
+}
+
 //-----------------------------------------------------------------------------
 //! build the matrix profile for use in the stiffness matrix
 void FEFacet2FacetSliding::BuildMatrixProfile(FEGlobalMatrix& K)
@@ -335,7 +354,7 @@ void FEFacet2FacetSliding::BuildMatrixProfile(FEGlobalMatrix& K)
 
 					for (int l=0; l<nseln; ++l)
 					{
-						vector<int>& id = mesh.Node(sn[l]).m_ID;
+						FENodeDofArray<int>& id = mesh.Node(sn[l]).m_ID;
 						lm[6*l  ] = id[dof_X];
 						lm[6*l+1] = id[dof_Y];
 						lm[6*l+2] = id[dof_Z];
@@ -346,7 +365,7 @@ void FEFacet2FacetSliding::BuildMatrixProfile(FEGlobalMatrix& K)
 
 					for (int l=0; l<nmeln; ++l)
 					{
-						vector<int>& id = mesh.Node(mn[l]).m_ID;
+						FENodeDofArray<int>& id = mesh.Node(mn[l]).m_ID;
 						lm[6*(l+nseln)  ] = id[dof_X];
 						lm[6*(l+nseln)+1] = id[dof_Y];
 						lm[6*(l+nseln)+2] = id[dof_Z];
@@ -441,7 +460,7 @@ void FEFacet2FacetSliding::CalcAutoPenalty(FEFacetSlidingSurface& s)
 //
 void FEFacet2FacetSliding::ProjectSurface(FEFacetSlidingSurface &ss, FEFacetSlidingSurface &ms, bool bsegup, bool bmove)
 {
-	FEClosestPointProjection cpp(ms);
+	FEClosestPointProjection& cpp = Projection(ms);
 	cpp.HandleSpecialCases(true);
 	cpp.SetSearchRadius(m_srad);
 	cpp.SetTolerance(m_stol);
@@ -603,14 +622,21 @@ void FEFacet2FacetSliding::Update()
 }
 
 //-----------------------------------------------------------------------------
-void FEFacet2FacetSliding::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
+// helper function for adding a force to a nodal force that is shared between threads
+static void AtomicAdd(vec3d& F, const double* f)
 {
-	vector<int> sLM, mLM, LM, en;
-	vector<double> fe;
+#pragma omp atomic
+	F.x += f[0];
+#pragma omp atomic
+	F.y += f[1];
+#pragma omp atomic
+	F.z += f[2];
+}
 
+//-----------------------------------------------------------------------------
+void FEFacet2FacetSliding::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
+{
 	const int MELN = FEElement::MAX_NODES;
-	double detJ[MELN], w[MELN], *Hs, Hm[MELN];
-	vec3d r0[MELN];
 
 	m_ss.m_Fn.assign(m_ss.Nodes(), vec3d(0,0,0));
 	m_ms.m_Fn.assign(m_ms.Nodes(), vec3d(0,0,0));
@@ -622,7 +648,17 @@ void FEFacet2FacetSliding::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FEFacetSlidingSurface& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
-		for (int i=0; i<ss.Elements(); ++i)
+		int NE = ss.Elements();
+#pragma omp parallel
+		{
+		// per-thread scratch buffers
+		vector<int> sLM, mLM, LM, en;
+		vector<double> fe;
+		double detJ[MELN], w[MELN], *Hs, Hm[MELN];
+		vec3d r0[MELN];
+
+#pragma omp for schedule(dynamic)
+		for (int i=0; i<NE; ++i)
 		{
 			FESurfaceElement& se = ss.Element(i);
 			int nseln = se.Nodes();
@@ -743,14 +779,16 @@ void FEFacet2FacetSliding::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 
 					for (int k=0; k<ndof; ++k) fe[k] *= tn*detJ[j]*w[j];
 
-					for (int k=0; k<nseln; ++k) ss.m_Fn[se.m_lnode[k]] += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
-					for (int k=0; k<nmeln; ++k) ms.m_Fn[me.m_lnode[k]] += vec3d(fe[3*nseln+3*k], fe[3*nseln+3*k+1], fe[3*nseln+3*k+2]);
+					// nodes are shared between facets, so the nodal forces are updated atomically
+					for (int k=0; k<nseln; ++k) AtomicAdd(ss.m_Fn[se.m_lnode[k]], &fe[3*k]);
+					for (int k=0; k<nmeln; ++k) AtomicAdd(ms.m_Fn[me.m_lnode[k]], &fe[3*nseln+3*k]);
 
 					// assemble the global residual
 					R.Assemble(en, LM, fe);
 				}
 			}
 		}
+		} // omp parallel
 	}
 }
 
@@ -758,11 +796,8 @@ void FEFacet2FacetSliding::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 
 void FEFacet2FacetSliding::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	vector<int> sLM, mLM, LM, en;
 	const int MN = FEElement::MAX_NODES;
 	const int ME = 3*MN*2;
-	double N[ME], T1[ME], T2[ME], N1[ME] = {0}, N2[ME] = {0}, D1[ME], D2[ME], Nb1[ME], Nb2[ME];
-	FEElementMatrix ke;
 
 	// get the mesh
 	FEMesh* pm = m_ss.GetMesh();
@@ -788,9 +823,6 @@ void FEFacet2FacetSliding::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		else knmult = 0;
 	}
 
-	double detJ[MN], w[MN], *Hs, Hm[MN], Hmr[MN], Hms[MN];
-	vec3d r0[MN];
-
 	int npass = (m_btwo_pass?2:1);
 	for (int np=0; np < npass; ++np)
 	{
@@ -798,7 +830,18 @@ void FEFacet2FacetSliding::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		FEFacetSlidingSurface& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
-		for (int i=0; i<ss.Elements(); ++i)
+		int NE = ss.Elements();
+#pragma omp parallel
+		{
+		// per-thread scratch buffers
+		vector<int> sLM, mLM, LM, en;
+		double N[ME], T1[ME], T2[ME], N1[ME] = {0}, N2[ME] = {0}, D1[ME], D2[ME], Nb1[ME], Nb2[ME];
+		double detJ[MN], w[MN], *Hs, Hm[MN], Hmr[MN], Hms[MN];
+		vec3d r0[MN];
+		FEElementMatrix ke;
+
+#pragma omp for schedule(dynamic)
+		for (int i=0; i<NE; ++i)
 		{
 			FESurfaceElement& se = ss.Element(i);
 			int nseln = se.Nodes();
@@ -1059,6 +1102,7 @@ void FEFacet2FacetSliding::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 				}
 			}
 		}
+		} // omp parallel
 	}
 }
 
@@ -30,6 +30,7 @@ SOFTWARE.*/
 
 #include "FEContactInterface.h"
 #include "FEContactSurface.h"
+#include <FECore/FEClosestPointProjection.h>
 
 //-----------------------------------------------------------------------------
 //! Contact surface for facet-to-facet sliding interfaces
@@ -94,6 +95,9 @@ public:
 	//! constructor
 	FEFacet2FacetSliding(FEModel* pfem);
 
+	//! destructor
+	~FEFacet2FacetSliding();
+
 	//! initialization routine
 	bool Init() override;
 
@@ -138,6 +142,9 @@ protected:
     
 	void CalcAutoPenalty(FEFacetSlidingSurface& s);
 
+	//! get the closest point projection onto one of the surfaces
+	FEClosestPointProjection& Projection(FEFacetSlidingSurface& ms);
+
 public:
 	double	m_epsn;			//!< normal penalty factor
 	double	m_knmult;		//!< normal stiffness multiplier
@@ -167,6 +174,8 @@ private:
 	bool	m_bfirst;
 	double	m_normg0;
 
+	FEClosestPointProjection*	m_cpp[2];	//!< projections onto the primary and secondary surface
+
 public:
 	DECLARE_FECORE_CLASS();
 };
@@ -32,6 +32,19 @@ SOFTWARE.*/
 #include <limits>
 #include <FECore/log.h>
 
+//-----------------------------------------------------------------------------
+// The Taylor coefficients of the inverse Langevin function
+static const double f_a[] = { 3.0, 9.0 / 5.0, 297.0 / 175.0, 1539.0 / 875.0, 126117.0 / 67373.0, 43733439.0 / 21896875.0, \
+	231321177.0 / 109484375.0, 20495009043.0 / 9306171875.0, 1073585186448381.0 / 476522530859375.0, 4387445039583.0 / 1944989921875.0, \
+	1000263375846831627.0 / 453346207767578125.0, 280865021365240713.0 / 133337119931640625.0, 148014872740758343473.0 / 75350125192138671875.0, 137372931237386537808993.0 / 76480377070020751953125.0, \
+	41722474198742657618857192737.0 / 25674386102028896409912109375.0, 12348948373636682700768301125723.0 / 8344175483159391333221435546875.0, 5001286000741585238340074032091091.0 / 3590449627018291035442047119140625.0, \
+	185364329915163811141785118512534489.0 / 132846636199676768311355743408203125.0, 6292216384025878939310787532157558451.0 / 4160197291516193533960877227783203125.0, 299869254759556271677902570230858640837.0 / 170568088952163934892395966339111328125.0, \
+	316689568216860631885141475537178451746044283.0 / 148810301691076651811854156590061187744140625.0, 670194310437429598283653289122392937145371137.0 / 258140319260030926612400067554187774658203125.0, 19697015384373759058671314622426656486031717197919.0 / 6332687088594936951180328352888571262359619140625.0, \
+	178793788985653424246012689916144867915861856840849.0 / 49756827124674504616416865629838774204254150390625.0, 323844166067349737493036492206152479344269351967043143667.0 / 82039106319990447886052744467343800746748447418212890625.0, 200808116689754604893460969866238617668631975356485302537199.0 / 49409916306357883385918130190559334540655314922332763671875.0, \
+	27506481209689719715275759452624078040221544551995885750037973.0 / 7164437864421893090958128877631103508395020663738250732421875.0, 16356939619211770477227805130221533318985185730316048281126247721.0 / 5122573073061653560035062147506239008502439774572849273681640625.0, 30976199222209837888906735596203249520053107250807132769871859115868101.0 / 14801698741072505317694781203956860833766632412399612367153167724609375.0, \
+	519588001407316958447129785511020819131555326399179970047767492196701159.0 / 902903623205422824379381653441368510859764577156376354396343231201171875.0 };
+static const int num_fa = sizeof(f_a) / sizeof(f_a[0]);
+
 //-----------------------------------------------------------------------------
 // FEFiberEntropyChain
 //-----------------------------------------------------------------------------
@@ -74,16 +87,6 @@ mat3ds FEFiberEntropyChain::FiberStress(FEMaterialPoint& mp, const vec3d& n0)
 	mat3ds C = pt.RightCauchyGreen();
 	mat3ds s;
 	
-	const double f_a[] = { 3.0, 9.0 / 5.0, 297.0 / 175.0, 1539.0 / 875.0, 126117.0 / 67373.0, 43733439.0 / 21896875.0, \
-		231321177.0 / 109484375.0, 20495009043.0 / 9306171875.0, 1073585186448381.0 / 476522530859375.0, 4387445039583.0 / 1944989921875.0, \
-		1000263375846831627.0 / 453346207767578125.0, 280865021365240713.0 / 133337119931640625.0, 148014872740758343473.0 / 75350125192138671875.0, 137372931237386537808993.0 / 76480377070020751953125.0, \
-		41722474198742657618857192737.0 / 25674386102028896409912109375.0, 12348948373636682700768301125723.0 / 8344175483159391333221435546875.0, 5001286000741585238340074032091091.0 / 3590449627018291035442047119140625.0, \
-		185364329915163811141785118512534489.0 / 132846636199676768311355743408203125.0, 6292216384025878939310787532157558451.0 / 4160197291516193533960877227783203125.0, 299869254759556271677902570230858640837.0 / 170568088952163934892395966339111328125.0, \
-		316689568216860631885141475537178451746044283.0 / 148810301691076651811854156590061187744140625.0, 670194310437429598283653289122392937145371137.0 / 258140319260030926612400067554187774658203125.0, 19697015384373759058671314622426656486031717197919.0 / 6332687088594936951180328352888571262359619140625.0, \
-		178793788985653424246012689916144867915861856840849.0 / 49756827124674504616416865629838774204254150390625.0, 323844166067349737493036492206152479344269351967043143667.0 / 82039106319990447886052744467343800746748447418212890625.0, 200808116689754604893460969866238617668631975356485302537199.0 / 49409916306357883385918130190559334540655314922332763671875.0, \
-		27506481209689719715275759452624078040221544551995885750037973.0 / 7164437864421893090958128877631103508395020663738250732421875.0, 16356939619211770477227805130221533318985185730316048281126247721.0 / 5122573073061653560035062147506239008502439774572849273681640625.0, 30976199222209837888906735596203249520053107250807132769871859115868101.0 / 14801698741072505317694781203956860833766632412399612367153167724609375.0, \
-		519588001407316958447129785511020819131555326399179970047767492196701159.0 / 902903623205422824379381653441368510859764577156376354396343231201171875.0 };
-
 	// fiber direction in global coordinate system
 	//vec3d n0 = GetFiberVector(mp);
 	
@@ -111,15 +114,12 @@ mat3ds FEFiberEntropyChain::FiberStress(FEMaterialPoint& mp, const vec3d& n0)
 
 		///////////////////////////////////////////////////////////////////////////////////////
 		double beta = 0, beta0 = 0, alpha2 = alpha * alpha, alpha02 = alpha0 * alpha0; 
-		int num_fa = sizeof(f_a) / sizeof(f_a[0]);
-		if (m_term > num_fa) {
-			m_term = num_fa;
-		}
-		beta = 1 + f_a[m_term - 1] / f_a[m_term - 2] * alpha2;
-		beta0 = 1 + f_a[m_term - 1] / f_a[m_term - 2] * alpha02;
-		for (int i = 2; i < m_term; i++) {
-			beta = 1 + f_a[m_term - i] / f_a[m_term - i - 1] * alpha2 * beta;
-			beta0 = 1 + f_a[m_term - i] / f_a[m_term - i - 1] * alpha02 * beta0;
+		const int nterm = (m_term > num_fa ? num_fa : m_term);
+		beta = 1 + f_a[nterm - 1] / f_a[nterm - 2] * alpha2;
+		beta0 = 1 + f_a[nterm - 1] / f_a[nterm - 2] * alpha02;
+		for (int i = 2; i < nterm; i++) {
+			beta = 1 + f_a[nterm - i] / f_a[nterm - i - 1] * alpha2 * beta;
+			beta0 = 1 + f_a[nterm - i] / f_a[nterm - i - 1] * alpha02 * beta0;
 			//cout << num_fa - i << endl;
 		};
 		beta = f_a[0] * alpha * beta;
@@ -182,15 +182,6 @@ tens4ds FEFiberEntropyChain::FiberTangent(FEMaterialPoint& mp, const vec3d& n0)
 		tens4ds NxN = dyad1s(N);
 		
 		// calculate strain energy 2nd derivative
-		const double f_a[] = { 3.0, 9.0 / 5.0, 297.0 / 175.0, 1539.0 / 875.0, 126117.0 / 67373.0, 43733439.0 / 21896875.0, \
-			231321177.0 / 109484375.0, 20495009043.0 / 9306171875.0, 1073585186448381.0 / 476522530859375.0, 4387445039583.0 / 1944989921875.0, \
-			1000263375846831627.0 / 453346207767578125.0, 280865021365240713.0 / 133337119931640625.0, 148014872740758343473.0 / 75350125192138671875.0, 137372931237386537808993.0 / 76480377070020751953125.0, \
-			41722474198742657618857192737.0 / 25674386102028896409912109375.0, 12348948373636682700768301125723.0 / 8344175483159391333221435546875.0, 5001286000741585238340074032091091.0 / 3590449627018291035442047119140625.0, \
-			185364329915163811141785118512534489.0 / 132846636199676768311355743408203125.0, 6292216384025878939310787532157558451.0 / 4160197291516193533960877227783203125.0, 299869254759556271677902570230858640837.0 / 170568088952163934892395966339111328125.0, \
-			316689568216860631885141475537178451746044283.0 / 148810301691076651811854156590061187744140625.0, 670194310437429598283653289122392937145371137.0 / 258140319260030926612400067554187774658203125.0, 19697015384373759058671314622426656486031717197919.0 / 6332687088594936951180328352888571262359619140625.0, \
-			178793788985653424246012689916144867915861856840849.0 / 49756827124674504616416865629838774204254150390625.0, 323844166067349737493036492206152479344269351967043143667.0 / 82039106319990447886052744467343800746748447418212890625.0, 200808116689754604893460969866238617668631975356485302537199.0 / 49409916306357883385918130190559334540655314922332763671875.0, \
-			27506481209689719715275759452624078040221544551995885750037973.0 / 7164437864421893090958128877631103508395020663738250732421875.0, 16356939619211770477227805130221533318985185730316048281126247721.0 / 5122573073061653560035062147506239008502439774572849273681640625.0, 30976199222209837888906735596203249520053107250807132769871859115868101.0 / 14801698741072505317694781203956860833766632412399612367153167724609375.0, \
-			519588001407316958447129785511020819131555326399179970047767492196701159.0 / 902903623205422824379381653441368510859764577156376354396343231201171875.0 };
 		double alpha = sqrt(In) / sqrt(m_N);
 		double alpha0 = 1 / sqrt(m_N);
 		double alphaI = 1.0 / sqrt(In) / (2.0 * sqrt(m_N)); 
@@ -198,17 +189,14 @@ tens4ds FEFiberEntropyChain::FiberTangent(FEMaterialPoint& mp, const vec3d& n0)
 
 		/////////////////////////////////////////////////////////////////////////////////
 		double beta = 0, beta0 = 0, beta_alpha = 0, alpha2 = alpha * alpha, alpha02 = alpha0 * alpha0;
-		int num_fa = sizeof(f_a) / sizeof(f_a[0]);
-		if (m_term > num_fa) {
-			m_term = num_fa;
-		}
-		beta = 1 + f_a[m_term - 1] / f_a[m_term - 2] * alpha2;
-		beta0 = 1 + f_a[m_term - 1] / f_a[m_term - 2] * alpha02;
-		beta_alpha = 1 + f_a[m_term - 1] / f_a[m_term - 2] * alpha2 * (2 * m_term - 1) / (2 * m_term - 3);
-		for (int i = 2; i < m_term; i++) {
-			beta = 1 + f_a[m_term - i] / f_a[m_term - i - 1] * alpha2 * beta;
-			beta0 = 1 + f_a[m_term - i] / f_a[m_term - i - 1] * alpha02 * beta0;
-			beta_alpha = 1 + f_a[m_term - i] / f_a[m_term - i - 1] * alpha2 * beta_alpha * (2 * m_term - 2 * i + 1) / (2 * m_term - 2 * i - 1);
+		const int nterm = (m_term > num_fa ? num_fa : m_term);
+		beta = 1 + f_a[nterm - 1] / f_a[nterm - 2] * alpha2;
+		beta0 = 1 + f_a[nterm - 1] / f_a[nterm - 2] * alpha02;
+		beta_alpha = 1 + f_a[nterm - 1] / f_a[nterm - 2] * alpha2 * (2 * nterm - 1) / (2 * nterm - 3);
+		for (int i = 2; i < nterm; i++) {
+			beta = 1 + f_a[nterm - i] / f_a[nterm - i - 1] * alpha2 * beta;
+			beta0 = 1 + f_a[nterm - i] / f_a[nterm - i - 1] * alpha02 * beta0;
+			beta_alpha = 1 + f_a[nterm - i] / f_a[nterm - i - 1] * alpha2 * beta_alpha * (2 * nterm - 2 * i + 1) / (2 * nterm - 2 * i - 1);
 		};
 		beta = f_a[0] * alpha * beta;
 		beta0 = f_a[0] * alpha0 * beta0;
@@ -278,6 +266,61 @@ double FEFiberEntropyChain::FiberStrainEnergyDensity(FEMaterialPoint& mp, const
 
     return sed;
 }
+
+//-----------------------------------------------------------------------------
+bool FEFiberEntropyChain::FiberResponse(FEMaterialPoint& mp, int n, const double* In, double* Wl, double* Wll, double* h, double& mu)
+{
+	double ksi = m_ksi(mp);
+	mu = m_mu(mp);
+
+	const int nterm = (m_term > num_fa ? num_fa : m_term);
+
+	// the reference terms only depend on the material parameters
+	double sN = sqrt(m_N);
+	double alpha0 = 1 / sN;
+	double alpha02 = alpha0 * alpha0;
+	double beta0 = 1 + f_a[nterm - 1] / f_a[nterm - 2] * alpha02;
+	for (int k = 2; k < nterm; k++) beta0 = 1 + f_a[nterm - k] / f_a[nterm - k - 1] * alpha02 * beta0;
+	beta0 = f_a[0] * alpha0 * beta0;
+
+	const double eps = m_epsf * std::numeric_limits<double>::epsilon();
+	for (int i = 0; i < n; ++i)
+	{
+		if ((In[i] - 1.0) > eps)
+		{
+			double sIn = sqrt(In[i]);
+			double alpha = sIn / sN;
+			double alpha2 = alpha * alpha;
+			double alphaI = 1 / sIn / (2.0 * sN);
+
+			double beta = 1 + f_a[nterm - 1] / f_a[nterm - 2] * alpha2;
+			double beta_alpha = 1 + f_a[nterm - 1] / f_a[nterm - 2] * alpha2 * (2 * nterm - 1) / (2 * nterm - 3);
+			for (int k = 2; k < nterm; k++)
+			{
+				beta = 1 + f_a[nterm - k] / f_a[nterm - k - 1] * alpha2 * beta;
+				beta_alpha = 1 + f_a[nterm - k] / f_a[nterm - k - 1] * alpha2 * beta_alpha * (2 * nterm - 2 * k + 1) / (2 * nterm - 2 * k - 1);
+			}
+			beta = f_a[0] * alpha * beta;
+			beta_alpha = f_a[0] * beta_alpha;
+
+			Wl[i] = ksi * m_N * alphaI * beta - ksi*sN / 2 * beta0;
+			if (Wll)
+			{
+				double alphaII = -pow(In[i], (-3.0 / 2.0)) / (4.0 * sN);
+				Wll[i] = ksi * m_N * (beta_alpha*alphaI*alphaI + beta*alphaII);
+			}
+			h[i] = 1.0;
+		}
+		else
+		{
+			Wl[i] = 0.0;
+			if (Wll) Wll[i] = 0.0;
+			h[i] = 0.0;
+		}
+	}
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 // FEElasticFiberEntropyChain
 //-----------------------------------------------------------------------------
@@ -206,6 +206,38 @@ double FEFiberExpPow::FiberStrainEnergyDensity(FEMaterialPoint& mp, const vec3d&
     return sed;
 }
 
+//-----------------------------------------------------------------------------
+bool FEFiberExpPow::FiberResponse(FEMaterialPoint& mp, int n, const double* In, double* Wl, double* Wll, double* h, double& mu)
+{
+	double lam0 = m_lam0(mp);
+	double ksi = m_ksi(mp);
+	double alpha = m_alpha(mp);
+	double beta = m_beta(mp);
+	mu = m_mu(mp);
+
+	const double eps = m_epsf*std::numeric_limits<double>::epsilon();
+	const double I0 = lam0*lam0;
+	for (int i = 0; i < n; ++i)
+	{
+		double In_I0 = In[i] - I0;
+		if (In_I0 >= eps)
+		{
+			double tmp = alpha*pow(In_I0, beta);
+			double ex = exp(tmp);
+			Wl[i] = ksi*pow(In_I0, beta - 1.0)*ex;
+			if (Wll) Wll[i] = ksi*pow(In_I0, beta - 2.0)*((tmp + 1)*beta - 1.0)*ex;
+			h[i] = 1.0;
+		}
+		else
+		{
+			Wl[i] = 0.0;
+			if (Wll) Wll[i] = 0.0;
+			h[i] = 0.0;
+		}
+	}
+	return true;
+}
+
 // define the material parameters
 BEGIN_FECORE_CLASS(FEElasticFiberExpPow, FEElasticFiberMaterial)
 	ADD_PARAMETER(m_fib.m_alpha, FE_RANGE_GREATER_OR_EQUAL(0.0), "alpha");
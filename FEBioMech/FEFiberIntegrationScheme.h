@@ -71,5 +71,9 @@ public:
 	// The passed material point pointer will be zero when evaluating the integrated fiber density
 	virtual FEFiberIntegrationSchemeIterator* GetIterator(FEMaterialPoint* mp = 0) = 0;
 
+	// Returns true if the integration points do not depend on the material point.
+	// In that case the integration points can be evaluated once and stored.
+	virtual bool HasFixedPoints() const { return false; }
+
 	FECORE_BASE_CLASS(FEFiberIntegrationScheme)
 };
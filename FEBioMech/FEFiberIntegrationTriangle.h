@@ -49,6 +49,9 @@ public:
 	// create iterator
 	FEFiberIntegrationSchemeIterator* GetIterator(FEMaterialPoint* mp) override;
 
+	// the integration points don't depend on the material point
+	bool HasFixedPoints() const override { return true; }
+
 protected:
 	void InitIntegrationRule();
     
@@ -42,6 +42,16 @@ public:
 	virtual tens4ds FiberTangent(FEMaterialPoint& mp, const vec3d& fiber) = 0;
 
 	virtual double FiberStrainEnergyDensity(FEMaterialPoint& mp, const vec3d& fiber) = 0;
+
+	// Batched evaluation of the fiber response, used to integrate over many fibers at once.
+	// For each of the n fibers with squared stretch In[i] = n0*C*n0, this calculates the
+	// strain energy derivatives Wl[i] = dW/dIn and Wll[i] = d2W/dIn2, and sets h[i] to 1 if 
+	// the fiber is loaded and to 0 otherwise. Wl and Wll must be zero for fibers that are not loaded.
+	// Wll is null when only the stress is needed. The shear modulus mu of the term
+	// (N*(B-I)).sym()*mu/J (and its tangent), which is added for loaded fibers, is returned in mu.
+	// This returns false if the material does not implement this, in which case FiberStress
+	// and FiberTangent are evaluated for each fiber instead.
+	virtual bool FiberResponse(FEMaterialPoint& mp, int n, const double* In, double* Wl, double* Wll, double* h, double& mu) { return false; }
 };
 
 // fiber materials for use in uncoupled materials
@@ -141,6 +141,34 @@ double FEFiberNH::FiberStrainEnergyDensity(FEMaterialPoint& mp, const vec3d& n0)
     return sed;
 }
 
+//-----------------------------------------------------------------------------
+bool FEFiberNH::FiberResponse(FEMaterialPoint& mp, int n, const double* In, double* Wl, double* Wll, double* h, double& mu)
+{
+	// NOTE: The stress and tangent use different thresholds for the tension check.
+	const double eps = (Wll ? m_epsf*std::numeric_limits<double>::epsilon() : 0.0);
+	for (int i = 0; i < n; ++i)
+	{
+		double In_1 = In[i] - 1.0;
+		if (In_1 > eps)
+		{
+			Wl[i] = 0.5*m_mu*In_1;
+			if (Wll) Wll[i] = 0.5*m_mu;
+			h[i] = 1.0;
+		}
+		else
+		{
+			Wl[i] = 0.0;
+			if (Wll) Wll[i] = 0.0;
+			h[i] = 0.0;
+		}
+	}
+
+	// no shear contribution
+	mu = 0.0;
+
+	return true;
+}
+
 // define the material parameters
 BEGIN_FECORE_CLASS(FEElasticFiberNH, FEElasticFiberMaterial)
 	ADD_PARAMETER(m_fib.m_mu, FE_RANGE_GREATER_OR_EQUAL(0.0), "mu")->setUnits(UNIT_PRESSURE);
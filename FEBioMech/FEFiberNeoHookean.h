@@ -46,6 +46,9 @@ public:
 	//! Strain energy density
 	double FiberStrainEnergyDensity(FEMaterialPoint& mp, const vec3d& a0) override;
 
+	//! Batched fiber response
+	bool FiberResponse(FEMaterialPoint& mp, int n, const double* In, double* Wl, double* Wll, double* h, double& mu) override;
+
 public:
 	double	m_mu;       // shear modulus
 	double	m_epsf;
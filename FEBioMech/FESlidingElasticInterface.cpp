@@ -429,7 +429,7 @@ void FESlidingElasticInterface::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nseln; ++l)
                     {
-                        vector<int>& id = mesh.Node(sn[l]).m_ID;
+                        FENodeDofArray<int>& id = mesh.Node(sn[l]).m_ID;
                         lm[6*l  ] = id[dof_X];
                         lm[6*l+1] = id[dof_Y];
                         lm[6*l+2] = id[dof_Z];
@@ -440,7 +440,7 @@ void FESlidingElasticInterface::BuildMatrixProfile(FEGlobalMatrix& K)
                     
                     for (l=0; l<nmeln; ++l)
                     {
-                        vector<int>& id = mesh.Node(mn[l]).m_ID;
+                        FENodeDofArray<int>& id = mesh.Node(mn[l]).m_ID;
                         lm[6*(l+nseln)  ] = id[dof_X];
                         lm[6*(l+nseln)+1] = id[dof_Y];
                         lm[6*(l+nseln)+2] = id[dof_Z];
@@ -942,11 +942,6 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
 {
     const int MN = FEElement::MAX_NODES;
     
-    vector<int> sLM, mLM, LM, en;
-    vector<double> fe;
-    double detJ[MN], w[MN], Hm[MN];
-    double N[MN*6];
-    
     m_ss.m_Ft = vec3d(0,0,0);
     m_ms.m_Ft = vec3d(0,0,0);
     
@@ -959,8 +954,20 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
         FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
         
         // loop over all primary elements
-        //#pragma omp parallel for private(sLM, mLM, LM, en, fe, detJ, w, Hm, N)
-        for (int i=0; i<ss.Elements(); ++i)
+        int NE = ss.Elements();
+#pragma omp parallel
+        {
+        // per-thread scratch buffers
+        vector<int> sLM, mLM, LM, en;
+        vector<double> fe;
+        double detJ[MN], w[MN], Hm[MN];
+        double N[MN*6];
+        
+        // per-thread contact force totals
+        vec3d Fs(0,0,0), Fm(0,0,0);
+        
+#pragma omp for schedule(dynamic) nowait
+        for (int i=0; i<NE; ++i)
         {
             // get the surface element
             FESurfaceElement& se = ss.Element(i);
@@ -1069,12 +1076,12 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
                         // calculate contact forces
                         for (int k=0; k<nseln; ++k)
                         {
-                            ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+                            Fs += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
                         }
                         
                         for (int k = 0; k<nmeln; ++k)
                         {
-                            ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+                            Fm += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
                         }
                         
                         // assemble the global residual
@@ -1083,6 +1090,13 @@ void FESlidingElasticInterface::LoadVector(FEGlobalVector& R, const FETimeInfo&
                 }
             }
         }
+        
+#pragma omp critical
+        {
+            ss.m_Ft += Fs;
+            ms.m_Ft += Fm;
+        }
+        } // omp parallel
     }
 }
 
@@ -1094,11 +1108,6 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
     
     const int MN = FEElement::MAX_NODES;
     
-    double detJ[MN], w[MN], Hm[MN];
-    double N[MN*6];
-    vector<int> sLM, mLM, LM, en;
-    FEElementMatrix ke;
-    
     double psf = GetPenaltyScaleFactor();
     
     // do single- or two-pass
@@ -1110,8 +1119,17 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
         FESlidingElasticSurface& ms = (np == 0? m_ms : m_ss);
         
         // loop over all primary elements
-        //#pragma omp parallel for private(detJ, w, Hm, N, sLM, mLM, LM, en, ke)
-        for (int i=0; i<ss.Elements(); ++i)
+        int NE = ss.Elements();
+#pragma omp parallel
+        {
+        // per-thread scratch buffers
+        double detJ[MN], w[MN], Hm[MN];
+        double N[MN*6];
+        vector<int> sLM, mLM, LM, en;
+        FEElementMatrix ke;
+        
+#pragma omp for schedule(dynamic)
+        for (int i=0; i<NE; ++i)
         {
             // get ths primary element
             FESurfaceElement& se = ss.Element(i);
@@ -1528,6 +1546,7 @@ void FESlidingElasticInterface::StiffnessMatrix(FELinearSystem& LS, const FETime
                 }
             }
         }
+        } // omp parallel
     }
 }
 
@@ -163,7 +163,7 @@ void FESlidingInterface::BuildMatrixProfile(FEGlobalMatrix& K)
 
 				for (int k=0; k<n; ++k)
 				{
-					vector<int>& id = mesh.Node(en[k]).m_ID;
+					FENodeDofArray<int>& id = mesh.Node(en[k]).m_ID;
 					lm[6*(k+1)  ] = id[dof_X];
 					lm[6*(k+1)+1] = id[dof_Y];
 					lm[6*(k+1)+2] = id[dof_Z];
@@ -408,6 +408,8 @@ FESlidingInterface::FESlidingInterface(FEModel* pfem) : FEContactInterface(pfem)
 	static int count = 1;
 	SetID(count++);
 
+	m_cpp[0] = m_cpp[1] = nullptr;
+
 	m_mu = 0;
 	m_epsf = 0;
 
@@ -510,6 +512,23 @@ void FESlidingInterface::Activate()
 	}
 }
 
+//-----------------------------------------------------------------------------
+FESlidingInterface::~FESlidingInterface()
+{
+	delete m_cpp[0];
+	delete m_cpp[1];
+}
+
+//-----------------------------------------------------------------------------
+//! The projections are created the first time they are needed. After that, Init()
+//! only refits the search tree to the current nodal positions.
+FEClosestPointProjection& FESlidingInterface::Projection(FESlidingSurface& ms)
+{
+	int n = (&ms == &m_ss ? 0 : 1);
+	if (m_cpp[n] == nullptr) m_cpp[n] = new FEClosestPointProjection(ms);
+	return *m_cpp[n];
+}
+
 //-----------------------------------------------------------------------------
 //!  Projects the primary surface onto the secondary surface.
 //!  That is, for each primary surface node we determine the closest
@@ -524,19 +543,22 @@ void FESlidingInterface::Activate()
 
 void FESlidingInterface::ProjectSurface(FESlidingSurface& ss, FESlidingSurface& ms, bool bupseg, bool bmove)
 {
-	// node projection data
-	double r, s;
-	vec3d q;
-
-	FEClosestPointProjection cpp(ms);
+	FEClosestPointProjection& cpp = Projection(ms);
 	cpp.SetTolerance(m_stol);
 	cpp.SetSearchRadius(m_sradius);
 	cpp.HandleSpecialCases(true);
 	cpp.Init();
 
 	// loop over all primary surface nodes
-	for (int i=0; i<ss.Nodes(); ++i)
+	// (each node only updates its own data, so we can do this in parallel)
+	int NN = ss.Nodes();
+#pragma omp parallel for schedule(dynamic)
+	for (int i=0; i<NN; ++i)
 	{
+		// node projection data
+		double r, s;
+		vec3d q;
+
 		// get the node
 		FENode& node = ss.Node(i);
 
@@ -696,25 +718,7 @@ void FESlidingInterface::Update()
 
 void FESlidingInterface::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	// element contact force vector
-	vector<double> fe;
-
-	// the lm array for this force vector
-	vector<int> lm;
-
-	// the en array
-	vector<int> en;
-
-	// the elements LM vectors
-	vector<int> sLM;
-	vector<int> mLM;
-
 	const int MN = FEElement::MAX_NODES;
-	vec3d r0[MN];
-	double w[MN];
-	double* Gr, *Gs;
-	double detJ[MN];
-	vec3d dxr, dxs;
 
 	// do two-pass
 	int npass = (m_btwo_pass?2:1);
@@ -726,6 +730,28 @@ void FESlidingInterface::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 
 		// loop over all primary surface facets
 		int ne = ss.Elements();
+#pragma omp parallel
+		{
+		// element contact force vector
+		vector<double> fe;
+
+		// the lm array for this force vector
+		vector<int> lm;
+
+		// the en array
+		vector<int> en;
+
+		// the elements LM vectors
+		vector<int> sLM;
+		vector<int> mLM;
+
+		vec3d r0[MN];
+		double w[MN];
+		double* Gr, *Gs;
+		double detJ[MN];
+		vec3d dxr, dxs;
+
+#pragma omp for schedule(dynamic)
 		for (int j=0; j<ne; ++j)
 		{
 			// get the next element
@@ -819,6 +845,7 @@ void FESlidingInterface::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 				}
 			}
 		}
+		} // omp parallel
 	}
 }
 
@@ -1039,20 +1066,7 @@ void FESlidingInterface::ContactNodalForce(int m, FESlidingSurface& ss, FESurfac
 
 void FESlidingInterface::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	FEElementMatrix ke;
-
 	const int MAXMN = FEElement::MAX_NODES;
-	vector<int> lm(3*(MAXMN + 1));
-	vector<int> en(MAXMN+1);
-
-	double *Gr, *Gs, w[MAXMN];
-	vec3d r0[MAXMN];
-
-	double detJ[MAXMN];
-	vec3d dxr, dxs;
-
-	vector<int> sLM;
-	vector<int> mLM;
 
 	// do two-pass
 	int npass = (m_btwo_pass?2:1);
@@ -1064,6 +1078,23 @@ void FESlidingInterface::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& t
 
 		// loop over all primary surface elements
 		int ne = ss.Elements();
+#pragma omp parallel
+		{
+		FEElementMatrix ke;
+
+		vector<int> lm(3*(MAXMN + 1));
+		vector<int> en(MAXMN+1);
+
+		double *Gr, *Gs, w[MAXMN];
+		vec3d r0[MAXMN];
+
+		double detJ[MAXMN];
+		vec3d dxr, dxs;
+
+		vector<int> sLM;
+		vector<int> mLM;
+
+#pragma omp for schedule(dynamic)
 		for (int j=0; j<ne; ++j)
 		{
 			// unpack the next element
@@ -1149,6 +1180,7 @@ void FESlidingInterface::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& t
 				}
 			}
 		}
+		} // omp parallel
 	}
 }
 
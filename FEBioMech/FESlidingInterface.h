@@ -95,7 +95,7 @@ public:
 	FESlidingInterface(FEModel* pfem);
 
 	//! destructor
-	virtual ~FESlidingInterface(){}
+	virtual ~FESlidingInterface();
 
 	//! Initializes sliding interface
 	bool Init() override;
@@ -154,6 +154,9 @@ protected:
 private:
 	void SerializePointers(FESlidingSurface& ss, FESlidingSurface& ms, DumpStream& ar);
 
+	//! get the closest point projection onto one of the surfaces
+	FEClosestPointProjection& Projection(FESlidingSurface& ms);
+
 public:
 	FESlidingSurface	m_ss;	//!< primary surface
 	FESlidingSurface	m_ms;	//!< secondary surface
@@ -186,6 +189,8 @@ private:
 	bool	m_bfirst;	//!< flag to indicate the first time we enter Update
 	double	m_normg0;	//!< initial gap norm
 
+	FEClosestPointProjection*	m_cpp[2];	//!< projections onto the primary and secondary surface
+
 public:
 	DECLARE_FECORE_CLASS();
 };
@@ -73,13 +73,7 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 		vector<double>& ui = m_u;
 
 		// adjust for linear constraints
-		FEModel* fem = m_solver->GetFEModel();
-		FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
-		if (LCM.LinearConstraints() > 0)
-		{
-			#pragma omp critical (LCM_assemble)
-			LCM.AssembleStiffness(m_K, m_F, m_u, ke.Nodes(), ke.RowIndices(), ke.ColumnsIndices(), ke);
-		}
+		AssembleLinearConstraints(ke);
 
 		// adjust stiffness matrix for prescribed degrees of freedom
 		// NOTE: I had to comment this if statement out since otherwise
@@ -109,8 +103,12 @@ void FESolidLinearSystem::Assemble(const FEElementMatrix& ke)
 						if (I >= 0)
 						{
 							// dof i is not a prescribed degree of freedom
-							#pragma omp atomic
-							m_F[I] -= ke[i][j] * ui[J];
+							if (m_bcolored) m_F[I] -= ke[i][j] * ui[J];
+							else
+							{
+								#pragma omp atomic
+								m_F[I] -= ke[i][j] * ui[J];
+							}
 						}
 					}
 
@@ -142,6 +142,23 @@ FEStickyInterface::FEStickyInterface(FEModel* pfem) : FEContactInterface(pfem),
 	m_naugmax = 10;
 	m_tmax = 0.0;
 	m_snap = 0.0;
+
+	m_cpp = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+FEStickyInterface::~FEStickyInterface()
+{
+	delete m_cpp;
+}
+
+//-----------------------------------------------------------------------------
+//! The projection is created the first time it is needed. After that, Init()
+//! only refits the search tree to the current nodal positions.
+FEClosestPointProjection& FEStickyInterface::Projection()
+{
+	if (m_cpp == nullptr) m_cpp = new FEClosestPointProjection(ms);
+	return *m_cpp;
 }
 
 //-----------------------------------------------------------------------------
@@ -195,7 +212,7 @@ void FEStickyInterface::BuildMatrixProfile(FEGlobalMatrix& K)
 
 			for (int k=0; k<n; ++k)
 			{
-				vector<int>& id = ms.Node(en[k]).m_ID;
+				FENodeDofArray<int>& id = ms.Node(en[k]).m_ID;
 				lm[6*(k+1)  ] = id[dof_X];
 				lm[6*(k+1)+1] = id[dof_Y];
 				lm[6*(k+1)+2] = id[dof_Z];
@@ -227,7 +244,7 @@ void FEStickyInterface::Activate()
 void FEStickyInterface::Update()
 {
 	// closest point projection method
-	FEClosestPointProjection cpp(ms);
+	FEClosestPointProjection& cpp = Projection();
 	cpp.HandleSpecialCases(true);
 	cpp.SetTolerance(m_stol);
 	cpp.Init();
@@ -322,7 +339,7 @@ void FEStickyInterface::Update()
 void FEStickyInterface::ProjectSurface(FEStickySurface& ss, FEStickySurface& ms, bool bmove)
 {
 	// closest point projection method
-	FEClosestPointProjection cpp(ms);
+	FEClosestPointProjection& cpp = Projection();
 	cpp.HandleSpecialCases(true);
 	cpp.SetTolerance(m_stol);
 	cpp.Init();
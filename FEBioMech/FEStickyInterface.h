@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEContactInterface.h"
 #include "FEContactSurface.h"
+#include <FECore/FEClosestPointProjection.h>
 
 //-----------------------------------------------------------------------------
 //! This class describes a contact surface used for sticky contact.
@@ -85,7 +86,7 @@ public:
 	FEStickyInterface(FEModel* pfem);
 
 	//! destructor
-	virtual ~FEStickyInterface(){}
+	virtual ~FEStickyInterface();
 
 	//! Initializes sliding interface
 	bool Init() override;
@@ -125,6 +126,12 @@ public:
 private:
 	void SerializePointers(FEStickySurface& ss, FEStickySurface& ms, DumpStream& ar);
 
+	//! get the closest point projection onto the secondary surface
+	FEClosestPointProjection& Projection();
+
+private:
+	FEClosestPointProjection*	m_cpp;	//!< projection onto the secondary surface
+
 public:
 	FEStickySurface	ss;	//!< primary surface
 	FEStickySurface	ms;	//!< secondary surface
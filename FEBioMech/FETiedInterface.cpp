@@ -130,7 +130,7 @@ void FETiedInterface::BuildMatrixProfile(FEGlobalMatrix& K)
 
 				for (int k = 0; k < n; ++k)
 				{
-					vector<int>& id = ms.Node(en[k]).m_ID;
+					FENodeDofArray<int>& id = ms.Node(en[k]).m_ID;
 					lm[6 * (k + 1)] = id[dof_X];
 					lm[6 * (k + 1) + 1] = id[dof_Y];
 					lm[6 * (k + 1) + 2] = id[dof_Z];
@@ -163,7 +163,7 @@ void FETiedInterface::BuildMatrixProfile(FEGlobalMatrix& K)
 
 				for (int k = 0; k < n; ++k)
 				{
-					vector<int>& id = ms.Node(en[k]).m_ID;
+					FENodeDofArray<int>& id = ms.Node(en[k]).m_ID;
 					lm[3 * (k + 1)    ] = id[dof_X];
 					lm[3 * (k + 1) + 1] = id[dof_Y];
 					lm[3 * (k + 1) + 2] = id[dof_Z];
@@ -205,7 +205,7 @@ void FEBiphasicSolidDomain::UnpackLM(FEElement& el, vector<int>& lm)
 	{
 		int n = el.m_node[i];
 		FENode& node = m_pMesh->Node(n);
-		vector<int>& id = node.m_ID;
+		FENodeDofArray<int>& id = node.m_ID;
 
         // first the displacement dofs
         lm[4*i  ] = id[m_dofU[0]];
@@ -227,7 +227,7 @@ void FEBiphasicSolidDomain::UnpackLM(FEElement& el, vector<int>& lm)
     {
         if (sel.m_bitfc[i]) {
             FENode& node = m_pMesh->Node(el.m_node[i]);
-            vector<int>& id = node.m_ID;
+            FENodeDofArray<int>& id = node.m_ID;
             
             // first the back-face displacement dofs
             lm[4*i  ] = id[m_dofSU[0]];
@@ -506,11 +506,8 @@ void FEBiphasicSolidDomain::ElementInternalForceSS(FESolidElement& el, vector<do
 void FEBiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 {
 	// repeat over all solid elements
-	int NE = (int)m_Elem.size();
-    
-    #pragma omp parallel for shared(NE)
-	for (int iel=0; iel<NE; ++iel)
-	{
+	LS.ForEachElement(*this, [&](int iel) {
+
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
@@ -532,18 +529,15 @@ void FEBiphasicSolidDomain::StiffnessMatrix(FELinearSystem& LS, bool bsymm)
 
         // assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-	}
+	});
 }
 
 //-----------------------------------------------------------------------------
 void FEBiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 {
 	// repeat over all solid elements
-	int NE = (int)m_Elem.size();
+	LS.ForEachElement(*this, [&](int iel) {
 
-	#pragma omp parallel for shared(NE)
-	for (int iel=0; iel<NE; ++iel)
-	{
 		FESolidElement& el = m_Elem[iel];
 
 		// element stiffness matrix
@@ -565,7 +559,7 @@ void FEBiphasicSolidDomain::StiffnessMatrixSS(FELinearSystem& LS, bool bsymm)
 
 		// assemble element matrix in global stiffness matrix
 		LS.Assemble(ke);
-	}
+	});
 }
 
 //-----------------------------------------------------------------------------
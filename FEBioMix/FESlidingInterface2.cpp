@@ -535,7 +535,7 @@ void FESlidingInterface2::BuildMatrixProfile(FEGlobalMatrix& K)
 
 					for (l=0; l<nseln; ++l)
 					{
-						vector<int>& id = mesh.Node(sn[l]).m_ID;
+						FENodeDofArray<int>& id = mesh.Node(sn[l]).m_ID;
 						lm[7*l  ] = id[dof_X];
 						lm[7*l+1] = id[dof_Y];
 						lm[7*l+2] = id[dof_Z];
@@ -547,7 +547,7 @@ void FESlidingInterface2::BuildMatrixProfile(FEGlobalMatrix& K)
 
 					for (l=0; l<nmeln; ++l)
 					{
-						vector<int>& id = mesh.Node(mn[l]).m_ID;
+						FENodeDofArray<int>& id = mesh.Node(mn[l]).m_ID;
 						lm[7*(l+nseln)  ] = id[dof_X];
 						lm[7*(l+nseln)+1] = id[dof_Y];
 						lm[7*(l+nseln)+2] = id[dof_Z];
@@ -691,12 +691,6 @@ double FESlidingInterface2::AutoPressurePenalty(FESurfaceElement& el, FESlidingS
 void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface2& ms, bool bupseg, bool bmove)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
-	FESurfaceElement* pme;
-	vec3d r, nu;
-	double rs[2];
-	double Ln;
-
-	double ps[FEElement::MAX_NODES], p1;
 
     double psf = GetPenaltyScaleFactor();
     
@@ -758,12 +752,14 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 	}
 
 	// loop over all integration points
- //   #pragma omp parallel for shared(R, bupseg)
+#pragma omp parallel for schedule(dynamic)
 	for (int i=0; i<ss.Elements(); ++i)
 	{
 		FESurfaceElement& el = ss.Element(i);
 		bool sporo = ss.m_poro[i];
 
+		double ps[FEElement::MAX_NODES], p1 = 0.0;
+
 		int ne = el.Nodes();
 		int nint = el.GaussPoints();
 
@@ -779,16 +775,17 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
             FEBiphasicContactPoint& pt = static_cast<FEBiphasicContactPoint&>(*el.GetMaterialPoint(j));
 
 			// calculate the global position of the integration point
-			r = ss.Local2Global(el, j);
+			vec3d r = ss.Local2Global(el, j);
 
 			// get the pressure at the integration point
             if (sporo) p1 = el.eval(ps, j);
 
 			// calculate the normal at this integration point
-			nu = ss.SurfaceNormal(el, j);
+			vec3d nu = ss.SurfaceNormal(el, j);
 
 			// first see if the old intersected face is still good enough
-			pme = pt.m_pme;
+			FESurfaceElement* pme = pt.m_pme;
+			double rs[2] = { 0, 0 };
 			if (pme)
 			{
 				double g;
@@ -825,7 +822,7 @@ void FESlidingInterface2::ProjectSurface(FESlidingSurface2& ss, FESlidingSurface
 
 				double eps = m_epsn*pt.m_epsn*psf;
 
-				Ln = pt.m_Lmd + eps*g;
+				double Ln = pt.m_Lmd + eps*g;
 
 				pt.m_gap = (g <= m_srad? g : 0);
 
@@ -1002,12 +999,7 @@ void FESlidingInterface2::Update()
 //-----------------------------------------------------------------------------
 void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	int i, j, k;
-	vector<int> sLM, mLM, LM, en;
-	vector<double> fe;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	double N[4*MN*2]; // TODO: is the size correct?
 
 	FEModel& fem = *GetFEModel();
 
@@ -1029,7 +1021,21 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FESlidingSurface2& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
-		for (i=0; i<ss.Elements(); ++i)
+		int NE = ss.Elements();
+#pragma omp parallel
+		{
+		// per-thread scratch buffers
+		int i, j, k;
+		vector<int> sLM, mLM, LM, en;
+		vector<double> fe;
+		double detJ[MN], w[MN], *Hs, Hm[MN];
+		double N[4*MN*2]; // TODO: is the size correct?
+
+		// per-thread contact force totals
+		vec3d Fs(0, 0, 0), Fm(0, 0, 0);
+
+#pragma omp for schedule(dynamic) nowait
+		for (i=0; i<NE; ++i)
 		{
 			// get the surface element
 			FESurfaceElement& se = ss.Element(i);
@@ -1150,12 +1156,12 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 
 					for (k=0; k<nseln; ++k)
 					{
-						ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+						Fs += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
 					}
 
 					for (k = 0; k<nmeln; ++k)
 					{
-						ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+						Fm += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
 					}
 
 					// assemble the global residual
@@ -1191,18 +1197,20 @@ void FESlidingInterface2::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 				}
 			}
 		}
+
+#pragma omp critical
+		{
+			ss.m_Ft += Fs;
+			ms.m_Ft += Fm;
+		}
+		} // omp parallel
 	}
 }
 
 //-----------------------------------------------------------------------------
 void FESlidingInterface2::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	int i, j, k, l;
-	vector<int> sLM, mLM, LM, en;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN], pt[MN], dpr[MN], dps[MN];
-	double N[4*MN*2];
-	FEElementMatrix ke;
 
 	FEModel& fem = *GetFEModel();
 
@@ -1236,7 +1244,18 @@ void FESlidingInterface2::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		FESlidingSurface2& ms = (np == 0? m_ms : m_ss);
 
 		// loop over all primary surface elements
-		for (i=0; i<ss.Elements(); ++i)
+		int NE = ss.Elements();
+#pragma omp parallel
+		{
+		// per-thread scratch buffers
+		int i, j, k, l;
+		vector<int> sLM, mLM, LM, en;
+		double detJ[MN], w[MN], *Hs, Hm[MN], pt[MN], dpr[MN], dps[MN];
+		double N[4*MN*2];
+		FEElementMatrix ke;
+
+#pragma omp for schedule(dynamic)
+		for (i=0; i<NE; ++i)
 		{
 			// get the next element
 			FESurfaceElement& se = ss.Element(i);
@@ -1649,6 +1668,7 @@ void FESlidingInterface2::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 				}
 			}
 		}
+		} // omp parallel
 	}
 }
 
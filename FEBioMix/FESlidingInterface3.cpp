@@ -104,7 +104,7 @@ void FESlidingSurface3::UnpackLM(FEElement& el, vector<int>& lm)
 		int n = el.m_node[i];
 
 		FENode& node = m_pMesh->Node(n);
-		vector<int>& id = node.m_ID;
+		FENodeDofArray<int>& id = node.m_ID;
 
 		// first the displacement dofs
 		lm[3*i  ] = id[m_dofX];
@@ -524,7 +524,7 @@ void FESlidingInterface3::BuildMatrixProfile(FEGlobalMatrix& K)
 									
 					for (l=0; l<nseln; ++l)
 					{
-						vector<int>& id = mesh.Node(sn[l]).m_ID;
+						FENodeDofArray<int>& id = mesh.Node(sn[l]).m_ID;
 						lm[8*l  ] = id[dof_X];
 						lm[8*l+1] = id[dof_Y];
 						lm[8*l+2] = id[dof_Z];
@@ -537,7 +537,7 @@ void FESlidingInterface3::BuildMatrixProfile(FEGlobalMatrix& K)
 									
 					for (l=0; l<nmeln; ++l)
 					{
-						vector<int>& id = mesh.Node(mn[l]).m_ID;
+						FENodeDofArray<int>& id = mesh.Node(mn[l]).m_ID;
 						lm[8*(l+nseln)  ] = id[dof_X];
 						lm[8*(l+nseln)+1] = id[dof_Y];
 						lm[8*(l+nseln)+2] = id[dof_Z];
@@ -786,13 +786,6 @@ double FESlidingInterface3::AutoConcentrationPenalty(FESurfaceElement& el, FESli
 void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface3& ms, bool bupseg, bool bmove)
 {
 	FEMesh& mesh = GetFEModel()->GetMesh();
-	FESurfaceElement* pme;
-	vec3d r, nu;
-	double rs[2];
-	double Ln;
-	
-	double ps[FEElement::MAX_NODES], p1;
-	double cs[FEElement::MAX_NODES], c1;
 	
 	double R = m_srad*mesh.GetBoundingBox().radius();
 	
@@ -857,11 +850,14 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
     }
     
 	// loop over all integration points
-//    #pragma omp parallel for shared(R, bupseg)
+#pragma omp parallel for schedule(dynamic)
 	for (int i=0; i<ss.Elements(); ++i)
 	{
 		FESurfaceElement& el = ss.Element(i);
 
+		double ps[FEElement::MAX_NODES], p1 = 0.0;
+		double cs[FEElement::MAX_NODES], c1 = 0.0;
+
 		bool sporo = ss.m_poro[i];
 		int sid = ss.m_solu[i];
 		bool ssolu = (sid > -1) ? true : false;
@@ -886,7 +882,7 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
             FEMultiphasicContactPoint& pt = static_cast<FEMultiphasicContactPoint&>(*el.GetMaterialPoint(j));
 
 			// calculate the global position of the integration point
-			r = ss.Local2Global(el, j);
+			vec3d r = ss.Local2Global(el, j);
 			
 			// get the pressure at the integration point
 			if (sporo) p1 = el.eval(ps, j);
@@ -895,10 +891,11 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
 			if (ssolu) c1 = el.eval(cs, j);
 			
 			// calculate the normal at this integration point
-			nu = ss.SurfaceNormal(el, j);
+			vec3d nu = ss.SurfaceNormal(el, j);
 			
 			// first see if the old intersected face is still good enough
-			pme = pt.m_pme;
+			FESurfaceElement* pme = pt.m_pme;
+			double rs[2] = { 0, 0 };
 			if (pme)
 			{
 				double g;
@@ -935,7 +932,7 @@ void FESlidingInterface3::ProjectSurface(FESlidingSurface3& ss, FESlidingSurface
 				
 				double eps = m_epsn*pt.m_epsn*psf;
 				
-				Ln = pt.m_Lmd + eps*g;
+				double Ln = pt.m_Lmd + eps*g;
 				
 				pt.m_gap = (g <= R? g : 0);
 				
@@ -1142,11 +1139,7 @@ void FESlidingInterface3::Update()
 //-----------------------------------------------------------------------------
 void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-	vector<int> sLM, mLM, LM, en;
-	vector<double> fe;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	double N[10*MN];
 
 	FEModel& fem = *GetFEModel();
 
@@ -1166,7 +1159,20 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 		FESlidingSurface3& ms = (np == 0? m_ms : m_ss);
 		
 		// loop over all primary surface elements
-		for (int i = 0; i<ss.Elements(); ++i)
+		int NE = ss.Elements();
+#pragma omp parallel
+		{
+		// per-thread scratch buffers
+		vector<int> sLM, mLM, LM, en;
+		vector<double> fe;
+		double detJ[MN], w[MN], *Hs, Hm[MN];
+		double N[10*MN];
+
+		// per-thread contact force totals
+		vec3d Fs(0, 0, 0), Fm(0, 0, 0);
+
+#pragma omp for schedule(dynamic) nowait
+		for (int i = 0; i<NE; ++i)
 		{
 			// get the surface element
 			FESurfaceElement& se = ss.Element(i);
@@ -1289,12 +1295,12 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 					
                     for (int k=0; k<nseln; ++k)
                     {
-                        ss.m_Ft += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
+                        Fs += vec3d(fe[k*3], fe[k*3+1], fe[k*3+2]);
                     }
                     
                     for (int k = 0; k<nmeln; ++k)
                     {
-                        ms.m_Ft += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
+                        Fm += vec3d(fe[(k + nseln) * 3], fe[(k + nseln) * 3 + 1], fe[(k + nseln) * 3 + 2]);
                     }
                     
 					// assemble the global residual
@@ -1359,20 +1365,20 @@ void FESlidingInterface3::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 				}
 			}
 		}
+
+#pragma omp critical
+		{
+			ss.m_Ft += Fs;
+			ms.m_Ft += Fm;
+		}
+		} // omp parallel
 	}
 }
 
 //-----------------------------------------------------------------------------
 void FESlidingInterface3::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-	int i, j, k, l;
-	vector<int> sLM, mLM, LM, en;
 	const int MN = FEElement::MAX_NODES;
-	double detJ[MN], w[MN], *Hs, Hm[MN];
-	double pt[MN], dpr[MN], dps[MN];
-	double ct[MN], dcr[MN], dcs[MN];
-	double N[10*MN];
-	FEElementMatrix ke;
 
 	FEModel& fem = *GetFEModel();
 
@@ -1406,7 +1412,20 @@ void FESlidingInterface3::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 		FESlidingSurface3& ms = (np == 0? m_ms : m_ss);
 		
 		// loop over all primary surface elements
-		for (i=0; i<ss.Elements(); ++i)
+		int NE = ss.Elements();
+#pragma omp parallel
+		{
+		// per-thread scratch buffers
+		int i, j, k, l;
+		vector<int> sLM, mLM, LM, en;
+		double detJ[MN], w[MN], *Hs, Hm[MN];
+		double pt[MN], dpr[MN], dps[MN];
+		double ct[MN], dcr[MN], dcs[MN];
+		double N[10*MN];
+		FEElementMatrix ke;
+
+#pragma omp for schedule(dynamic)
+		for (i=0; i<NE; ++i)
 		{
 			// get the next element
 			FESurfaceElement& se = ss.Element(i);
@@ -1958,6 +1977,7 @@ void FESlidingInterface3::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
 				}
 			}
 		}
+		} // omp parallel
 	}
 }
 
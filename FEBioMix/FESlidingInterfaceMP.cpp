@@ -131,7 +131,7 @@ void FESlidingSurfaceMP::UnpackLM(FEElement& el, vector<int>& lm)
 		int n = el.m_node[i];
 
 		FENode& node = m_pMesh->Node(n);
-		vector<int>& id = node.m_ID;
+		FENodeDofArray<int>& id = node.m_ID;
 
 		// first the displacement dofs
 		lm[3*i  ] = id[m_dofX];
@@ -738,7 +738,7 @@ void FESlidingInterfaceMP::BuildMatrixProfile(FEGlobalMatrix& K)
                     
 					for (l=0; l<nseln; ++l)
 					{
-						vector<int>& id = mesh.Node(sn[l]).m_ID;
+						FENodeDofArray<int>& id = mesh.Node(sn[l]).m_ID;
 						lm[ndpn*l  ] = id[dof_X];
 						lm[ndpn*l+1] = id[dof_Y];
 						lm[ndpn*l+2] = id[dof_Z];
@@ -750,7 +750,7 @@ void FESlidingInterfaceMP::BuildMatrixProfile(FEGlobalMatrix& K)
                     
 					for (l=0; l<nmeln; ++l)
 					{
-						vector<int>& id = mesh.Node(mn[l]).m_ID;
+						FENodeDofArray<int>& id = mesh.Node(mn[l]).m_ID;
 						lm[ndpn*(l+nseln)  ] = id[dof_X];
 						lm[ndpn*(l+nseln)+1] = id[dof_Y];
 						lm[ndpn*(l+nseln)+2] = id[dof_Z];
@@ -1041,17 +1041,9 @@ double FESlidingInterfaceMP::AutoConcentrationPenalty(FESurfaceElement& el,
 void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfaceMP& ms, bool bupseg, bool bmove)
 {
     FEMesh& mesh = GetFEModel()->GetMesh();
-    FESurfaceElement* pme;
-    vec3d r, nu;
-    double rs[2] = {0,0};
-    double Ln;
     
     const int MN = FEElement::MAX_NODES;
     int nsol = (int)m_sid.size();
-    double ps[MN], p1 = 0.0;
-    vector< vector<double> > cs(nsol, vector<double>(MN));
-    vector<double> c1(nsol);
-    c1.assign(nsol,0);
     
     double psf = GetPenaltyScaleFactor();
     
@@ -1114,11 +1106,15 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
     }
     
     // loop over all integration points
-    // TODO: commenting this pragma line made my code recover slidingelastic test case results
-//#pragma omp parallel for
+    // NOTE: The work arrays need to be private to each thread.
+#pragma omp parallel for schedule(dynamic)
     for (int i=0; i<ss.Elements(); ++i)
     {
         FESurfaceElement& el = ss.Element(i);
+
+        double ps[MN], p1 = 0.0;
+        vector< vector<double> > cs(nsol, vector<double>(MN));
+        vector<double> c1(nsol, 0.0);
         
         bool sporo = ss.m_bporo;
         
@@ -1141,7 +1137,7 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
             FEMultiphasicContactPoint& pt = static_cast<FEMultiphasicContactPoint&>(*el.GetMaterialPoint(j));
 
             // calculate the global position of the integration point
-            r = ss.Local2Global(el, j);
+            vec3d r = ss.Local2Global(el, j);
             
             // get the pressure at the integration point
             if (sporo) p1 = el.eval(ps, j);
@@ -1150,10 +1146,11 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
             for (int isol=0; isol<nsol; ++isol) c1[isol] = el.eval(&cs[isol][0], j);
             
             // calculate the normal at this integration point
-            nu = ss.SurfaceNormal(el, j);
+            vec3d nu = ss.SurfaceNormal(el, j);
             
             // first see if the old intersected face is still good enough
-            pme = pt.m_pme;
+            FESurfaceElement* pme = pt.m_pme;
+            double rs[2] = { 0, 0 };
             if (pme)
             {
                 double g;
@@ -1190,7 +1187,7 @@ void FESlidingInterfaceMP::ProjectSurface(FESlidingSurfaceMP& ss, FESlidingSurfa
                 
                 double eps = m_epsn*pt.m_epsn*psf;
                 
-                Ln = pt.m_Lmd + eps*g;
+                double Ln = pt.m_Lmd + eps*g;
                 
                 pt.m_gap = (g <= m_srad? g : 0);
                 
@@ -1785,11 +1782,7 @@ vec3d FESlidingInterfaceMP::ContactTraction(FESlidingSurfaceMP& ss, const int ne
 //-----------------------------------------------------------------------------
 void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
 {
-    vector<int> sLM, mLM, LM, en;
-    vector<double> fe;
     const int MN = FEElement::MAX_NODES;
-    double detJ[MN], w[MN], *Hs, Hm[MN];
-    double N[MN*10];
     int nsol = (int)m_sid.size();
     
     FEModel& fem = *GetFEModel();
@@ -1812,7 +1805,20 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
         vector<int>& sl = (np == 0? m_ssl : m_msl);
         
         // loop over all primary surface elements
-        for (int i=0; i<ss.Elements(); ++i)
+        int NE = ss.Elements();
+#pragma omp parallel
+        {
+        // per-thread scratch buffers
+        vector<int> sLM, mLM, LM, en;
+        vector<double> fe;
+        double detJ[MN], w[MN], *Hs, Hm[MN];
+        double N[MN*10];
+        
+        // per-thread contact force totals
+        vec3d Fs(0, 0, 0), Fm(0, 0, 0);
+        
+#pragma omp for schedule(dynamic) nowait
+        for (int i=0; i<NE; ++i)
         {
             // get the surface element
             FESurfaceElement& se = ss.Element(i);
@@ -1923,10 +1929,10 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
                         
                         // calculate contact forces
                         for (int k=0; k<nseln; ++k)
-                            ss.m_Ft += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
+                            Fs += vec3d(fe[3*k], fe[3*k+1], fe[3*k+2]);
                         
                         for (int k = 0; k<nmeln; ++k)
-                            ms.m_Ft += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
+                            Fm += vec3d(fe[3*(k+nseln)], fe[3*(k+nseln)+1], fe[3*(k+nseln)+2]);
                         
                         // assemble the global residual
                         R.Assemble(en, LM, fe);
@@ -1992,19 +1998,21 @@ void FESlidingInterfaceMP::LoadVector(FEGlobalVector& R, const FETimeInfo& tp)
                 }
             }
         }
+        
+#pragma omp critical
+        {
+            ss.m_Ft += Fs;
+            ms.m_Ft += Fm;
+        }
+        } // omp parallel
     }
 }
 
 //-----------------------------------------------------------------------------
 void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo& tp)
 {
-    int i, j, k, l;
-    vector<int> sLM, mLM, LM, en;
     const int MN = FEElement::MAX_NODES;
-    double detJ[MN], w[MN], *Hs, Hm[MN];
-    FEElementMatrix ke;
     int nsol = (int)m_sid.size();
-    vector<double> jn(nsol);
     
     FEModel& fem = *GetFEModel();
      
@@ -2039,7 +2047,18 @@ void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
         vector<int>& sl = (np == 0? m_ssl : m_msl);
         
         // loop over all primary surface elements
-        for (i=0; i<ss.Elements(); ++i)
+        int NE = ss.Elements();
+#pragma omp parallel
+        {
+        // per-thread scratch buffers
+        int i, j, k, l;
+        vector<int> sLM, mLM, LM, en;
+        double detJ[MN], w[MN], *Hs, Hm[MN];
+        FEElementMatrix ke;
+        vector<double> jn(nsol);
+        
+#pragma omp for schedule(dynamic)
+        for (i=0; i<NE; ++i)
         {
             // get the next element
             FESurfaceElement& se = ss.Element(i);
@@ -2716,6 +2735,7 @@ void FESlidingInterfaceMP::StiffnessMatrix(FELinearSystem& LS, const FETimeInfo&
                 }
             }
         }
+        } // omp parallel
     }
 }
 
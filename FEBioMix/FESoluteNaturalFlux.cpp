@@ -212,7 +212,7 @@ void FESoluteNaturalFlux::LoadVector(FEGlobalVector& R)
         for (int i=0; i<neln; ++i) {
             int n = pe->m_node[i];
             FENode& node = GetMesh().Node(n);
-            vector<int>& id = node.m_ID;
+            FENodeDofArray<int>& id = node.m_ID;
             int dof = m_dofC[m_isol-1];
             if (dof != -1) {
                 lm[i] = id[dof];
@@ -351,7 +351,7 @@ void FESoluteNaturalFlux::StiffnessMatrix(FELinearSystem& LS)
         for (int i=0; i<neln; ++i) {
             int n = pe->m_node[i];
             FENode& node = GetMesh().Node(n);
-            vector<int>& id = node.m_ID;
+            FENodeDofArray<int>& id = node.m_ID;
             lm[ndpn*i  ] = id[m_dofU[0]];
             lm[ndpn*i+1] = id[m_dofU[1]];
             lm[ndpn*i+2] = id[m_dofU[2]];
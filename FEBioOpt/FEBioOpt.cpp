@@ -31,12 +31,16 @@ SOFTWARE.*/
 #include "FEOptimize.h"
 #include "FEParameterSweep.h"
 #include "FEBioParamRun.h"
+#include "FESensitivityTest.h"
 #include <FECore/FECoreKernel.h>
 #include "FELMOptimizeMethod.h"
 #include "FEConstrainedLMOptimizeMethod.h"
 #include "FEPowellOptimizeMethod.h"
 #include "FEScanOptimizeMethod.h"
 
+//-----------------------------------------------------------------------------
+static FEBioOpt::FEModelReplicaFactory s_createReplica = nullptr;
+
 //-----------------------------------------------------------------------------
 //! Initialization of the FEBioOpt module. This function registers all the classes
 //! in this module with the FEBio framework.
@@ -46,6 +50,7 @@ void FEBioOpt::InitModule()
 	REGISTER_FECORE_CLASS(FEOptimize      , "optimize");
 	REGISTER_FECORE_CLASS(FEParameterSweep, "parameter_sweep");
 	REGISTER_FECORE_CLASS(FEBioParamRun   , "param_run");
+	REGISTER_FECORE_CLASS(FESensitivityTest, "sensitivity_test");
 
 	// optimization methods
 	REGISTER_FECORE_CLASS(FELMOptimizeMethod, "levmar");
@@ -55,3 +60,15 @@ void FEBioOpt::InitModule()
 	REGISTER_FECORE_CLASS(FEPowellOptimizeMethod, "powell");
 	REGISTER_FECORE_CLASS(FEScanOptimizeMethod, "scan");
 }
+
+//-----------------------------------------------------------------------------
+void FEBioOpt::SetModelReplicaFactory(FEModelReplicaFactory f)
+{
+	s_createReplica = f;
+}
+
+//-----------------------------------------------------------------------------
+FEBioOpt::FEModelReplicaFactory FEBioOpt::GetModelReplicaFactory()
+{
+	return s_createReplica;
+}
@@ -26,6 +26,8 @@ SOFTWARE.*/
 #pragma once
 #include "febioopt_api.h"
 
+class FEModel;
+
 //-----------------------------------------------------------------------------
 //! The FEBioOpt module 
 
@@ -35,4 +37,12 @@ namespace FEBioOpt {
 
 	FEBIOOPT_API void InitModule();
 
+	//! Function that creates an independent copy of a model. The optimization
+	//! module uses these copies to solve several models concurrently.
+	typedef FEModel* (*FEModelReplicaFactory)(FEModel* fem);
+
+	//! set/get the function that creates model replicas
+	FEBIOOPT_API void SetModelReplicaFactory(FEModelReplicaFactory f);
+	FEBIOOPT_API FEModelReplicaFactory GetModelReplicaFactory();
+
 }
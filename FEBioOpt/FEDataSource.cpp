@@ -78,11 +78,15 @@ void FEDataParameter::update()
 
 	// add the data pair to the loadcurve
 	m_rf.Add(x, y);
+
+	m_xrec.push_back(x);
+	m_yrec = y;
 }
 
 FEDataParameter::FEDataParameter(FEModel* fem) : FEDataSource(fem)
 {
 	m_ord = "fem.time";
+	m_yrec = 0.0;
 }
 
 void FEDataParameter::SetParameterName(const std::string& name)
@@ -354,6 +358,8 @@ void FEDataParameter::Reset()
 {
 	// reset the reaction force load curve
 	m_rf.Clear();
+	m_xrec.clear();
+	m_drf.clear();
 	FEDataSource::Reset();
 }
 
@@ -362,6 +368,27 @@ double FEDataParameter::Evaluate(double x)
 	return m_rf.value(x);
 }
 
+void FEDataParameter::UpdateSensitivity(int n, double h)
+{
+	if (m_xrec.empty()) return;
+	if (n >= (int)m_drf.size()) m_drf.resize(n + 1);
+	PointCurve& drf = m_drf[n];
+
+	// data that was recorded without a sensitivity (i.e. the initial state) does not depend on the parameters
+	int nrec = (int)m_xrec.size();
+	while (drf.Points() < nrec - 1) drf.Add(m_xrec[drf.Points()], 0.0);
+
+	// the last recorded data is the unperturbed value
+	double dy = (m_fy() - m_yrec) / h;
+	drf.Add(m_xrec[nrec - 1], dy);
+}
+
+double FEDataParameter::EvaluateSensitivity(int n, double x)
+{
+	if ((n < 0) || (n >= (int)m_drf.size())) return 0.0;
+	return m_drf[n].value(x);
+}
+
 //=================================================================================================
 FEDataFilterPositive::FEDataFilterPositive(FEModel* fem) : FEDataSource(fem)
 {
@@ -397,12 +424,30 @@ double FEDataFilterPositive::Evaluate(double t)
 	return (v >= 0.0 ? v : -v);
 }
 
+bool FEDataFilterPositive::HasSensitivity()
+{
+	return (m_src ? m_src->HasSensitivity() : false);
+}
+
+void FEDataFilterPositive::UpdateSensitivity(int n, double h)
+{
+	m_src->UpdateSensitivity(n, h);
+}
+
+double FEDataFilterPositive::EvaluateSensitivity(int n, double t)
+{
+	double v = m_src->Evaluate(t);
+	double dv = m_src->EvaluateSensitivity(n, t);
+	return (v >= 0.0 ? dv : -dv);
+}
+
 
 //=================================================================================================
 FEDataFilterSum::FEDataFilterSum(FEModel* fem) : FEDataSource(fem)
 {
 	m_data = nullptr;
 	m_nodeSet = nullptr;
+	m_yrec = 0.0;
 }
 
 FEDataFilterSum::~FEDataFilterSum()
@@ -435,6 +480,10 @@ void FEDataFilterSum::Reset()
 {
 	m_rf.Clear();
 	m_rf.Add(0, 0);
+
+	m_xrec.assign(1, 0.0);
+	m_yrec = 0.0;
+	m_drf.clear();
 }
 
 // evaluate data source at x
@@ -452,12 +501,8 @@ bool FEDataFilterSum::update(FEModel* pmdl, unsigned int nwhen, void* pd)
 	return true;
 }
 
-void FEDataFilterSum::update()
+double FEDataFilterSum::sum()
 {
-	// get the current time value
-	double time = m_fem.GetTime().currentTime;
-
-	FEMesh* mesh = m_nodeSet->GetMesh();
 	FENodeSet& ns = *m_nodeSet;
 	double sum = 0.0;
 	for (int i = 0; i < m_nodeSet->Size(); ++i)
@@ -465,11 +510,42 @@ void FEDataFilterSum::update()
 		double vi = m_data->value(*ns.Node(i));
 		sum += vi;
 	}
+	return sum;
+}
+
+void FEDataFilterSum::update()
+{
+	// get the current time value
+	double time = m_fem.GetTime().currentTime;
 
 	// evaluate the current reaction force value
 	double x = time;
-	double y = sum;
+	double y = sum();
 
 	// add the data pair to the loadcurve
 	m_rf.Add(x, y);
+
+	m_xrec.push_back(x);
+	m_yrec = y;
+}
+
+void FEDataFilterSum::UpdateSensitivity(int n, double h)
+{
+	if (m_xrec.empty()) return;
+	if (n >= (int)m_drf.size()) m_drf.resize(n + 1);
+	PointCurve& drf = m_drf[n];
+
+	// data that was recorded without a sensitivity (i.e. the initial state) does not depend on the parameters
+	int nrec = (int)m_xrec.size();
+	while (drf.Points() < nrec - 1) drf.Add(m_xrec[drf.Points()], 0.0);
+
+	// the last recorded data is the unperturbed value
+	double dy = (sum() - m_yrec) / h;
+	drf.Add(m_xrec[nrec - 1], dy);
+}
+
+double FEDataFilterSum::EvaluateSensitivity(int n, double x)
+{
+	if ((n < 0) || (n >= (int)m_drf.size())) return 0.0;
+	return m_drf[n].value(x);
 }
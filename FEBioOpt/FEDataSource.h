@@ -50,6 +50,18 @@ public:
 	// Evaluate source at x
 	virtual double Evaluate(double x) = 0;
 
+public: // sensitivities with respect to the input parameters
+
+	// return true if the data source can record sensitivities
+	virtual bool HasSensitivity() { return false; }
+
+	// Record the sensitivity with respect to input parameter n. This is called after the data
+	// was updated and the model was perturbed in the direction of parameter n by a step h.
+	virtual void UpdateSensitivity(int n, double h) {}
+
+	// Evaluate the sensitivity with respect to input parameter n at x
+	virtual double EvaluateSensitivity(int n, double x) { return 0.0; }
+
 protected:
 	FEModel&			m_fem;	//!< reference to model
 };
@@ -81,6 +93,12 @@ public:
 	// evaluate the current value
 	double value() { return m_fy(); }
 
+public:
+	// NOTE: The sensitivities assume that the ordinate does not depend on the input parameters.
+	bool HasSensitivity() override { return true; }
+	void UpdateSensitivity(int n, double h) override;
+	double EvaluateSensitivity(int n, double x) override;
+
 private:
 	static bool update(FEModel* pmdl, unsigned int nwhen, void* pd);
 	void update();
@@ -91,6 +109,10 @@ private:
 	std::function<double()>	m_fx;				//!< pointer to ordinate value
 	std::function<double()>	m_fy;				//!< pointer to variable data
 	PointCurve		m_rf;	//!< reaction force data
+
+	std::vector<double>		m_xrec;	//!< ordinate values of the recorded data
+	double					m_yrec;	//!< last recorded value
+	std::vector<PointCurve>	m_drf;	//!< sensitivities of the data for each input parameter
 };
 
 //-------------------------------------------------------------------------------------------------
@@ -115,6 +137,11 @@ public:
 	// evaluate data source at x
 	double Evaluate(double x) override;
 
+public:
+	bool HasSensitivity() override;
+	void UpdateSensitivity(int n, double h) override;
+	double EvaluateSensitivity(int n, double x) override;
+
 private:
 	FEDataSource*	m_src;
 };
@@ -137,13 +164,22 @@ public:
 	// evaluate data source at x
 	double Evaluate(double x) override;
 
+public:
+	bool HasSensitivity() override { return true; }
+	void UpdateSensitivity(int n, double h) override;
+	double EvaluateSensitivity(int n, double x) override;
 
 private:
 	static bool update(FEModel* pmdl, unsigned int nwhen, void* pd);
 	void update();
+	double sum();
 
 private:
 	FELogNodeData*	m_data;
 	FENodeSet*		m_nodeSet;
 	PointCurve		m_rf;
+
+	std::vector<double>		m_xrec;	//!< ordinate values of the recorded data
+	double					m_yrec;	//!< last recorded value
+	std::vector<PointCurve>	m_drf;	//!< sensitivities of the data for each input parameter
 };
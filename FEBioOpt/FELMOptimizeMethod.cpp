@@ -39,6 +39,7 @@ BEGIN_FECORE_CLASS(FELMOptimizeMethod, FEOptimizeMethod)
 	ADD_PARAMETER(m_fdiff , "f_diff_scale");
 	ADD_PARAMETER(m_nmax  , "max_iter"    );
 	ADD_PARAMETER(m_bcov  , "print_cov"   );
+	ADD_PARAMETER(m_bsens , "sensitivity" );
 END_FECORE_CLASS();
 
 //-----------------------------------------------------------------------------
@@ -75,6 +76,7 @@ FELMOptimizeMethod::FELMOptimizeMethod(FEModel* fem) : FEOptimizeMethod(fem)
 	m_fdiff  = 0.001;
 	m_nmax   = 100;
 	m_bcov   = 0;
+	m_bsens  = false;
 	m_loglevel = LogLevel::LOG_NEVER;
 }
 
@@ -196,30 +198,52 @@ void FELMOptimizeMethod::ObjFun(vector<double>& x, vector<double>& a, vector<dou
 		}
 	}
 	
-	// evaluate at a
-	if (opt.FESolve(a) == false) throw FEErrorTermination();
-	
-	opt.GetObjective().Evaluate(y);
-	m_yopt = y;
+	// get the derivatives from a sensitivity analysis, which only needs a single solve
+	if (m_bsens)
+	{
+		opt.SetSensitivityMode(true);
+		bool bret = opt.FESolve(a);
+		opt.SetSensitivityMode(false);
+		if (bret == false) throw FEErrorTermination();
+
+		opt.GetObjective().Evaluate(y);
+		m_yopt = y;
+
+		if (opt.GetDerivatives(dyda)) return;
+
+		feLogWarningEx(opt.GetFEModel(), "Sensitivities are not available for this problem. Using finite differences instead.");
+		m_bsens = false;
+	}
 
-	// now calculate the derivatives using forward differences
+	// Setup the parameter sets: the first one evaluates at a, the others
+	// calculate the derivatives using forward differences
 	int ndata = (int)x.size();
-	vector<double> a1(a);
-	vector<double> y1(ndata);
 	int ma = (int)a.size();
+	vector< vector<double> > A(ma + 1, a);
 	for (int i=0; i<ma; ++i)
 	{
 		FEInputParameter& var = *opt.GetInputParameter(i);
 
 		double b = var.ScaleFactor();
 
+		vector<double>& a1 = A[i + 1];
 		a1[i] = a1[i] + dir*m_fdiff*(fabs(b) + fabs(a[i]));
 		assert(a1[i] != a[i]);
+	}
+
+	// The parameter sets are independent, so they can be solved concurrently
+	vector< vector<double> > Y;
+	vector<double> fobj;
+	if (opt.FESolve(A, Y, fobj) == false) throw FEErrorTermination();
+
+	y = Y[0];
+	m_yopt = y;
 
-		if (opt.FESolve(a1) == false) throw FEErrorTermination();
-		opt.GetObjective().Evaluate(y1);
+	for (int i=0; i<ma; ++i)
+	{
+		const vector<double>& a1 = A[i + 1];
+		const vector<double>& y1 = Y[i + 1];
 		for (int j=0; j<ndata; ++j) dyda[j][i] = (y1[j] - y[j])/(a1[i] - a[i]);
-		a1[i] = a[i];
 	}
 }
 
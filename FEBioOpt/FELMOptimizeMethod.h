@@ -52,6 +52,7 @@ public:
 	double			m_fdiff;	// forward difference step size
 	int				m_nmax;		// maximum number of iterations
 	bool			m_bcov;		// flag to print covariant matrix
+	bool			m_bsens;	// use sensitivity analysis instead of finite differences
 
 protected:
 	std::vector<double>	m_yopt;	// optimal y-values
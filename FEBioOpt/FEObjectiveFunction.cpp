@@ -208,6 +208,33 @@ void FEDataFitObjective::EvaluateFunctions(vector<double>& f)
 	}
 }
 
+//----------------------------------------------------------------------------
+bool FEDataFitObjective::HasSensitivity()
+{
+	return (m_src ? m_src->HasSensitivity() : false);
+}
+
+//----------------------------------------------------------------------------
+void FEDataFitObjective::UpdateSensitivity(int n, double h)
+{
+	m_src->UpdateSensitivity(n, h);
+}
+
+//----------------------------------------------------------------------------
+bool FEDataFitObjective::EvaluateDerivatives(matrix& dfda)
+{
+	if (HasSensitivity() == false) return false;
+
+	int ndata = m_lc.Points();
+	int nvar = dfda.columns();
+	for (int i = 0; i<ndata; ++i)
+	{
+		double xi = m_lc.Point(i).x();
+		for (int n = 0; n < nvar; ++n) dfda[i][n] = m_src->EvaluateSensitivity(n, xi);
+	}
+	return true;
+}
+
 //=============================================================================
 
 bool FEMinimizeObjective::ParamFunction::Init()
@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/PointCurve.h>
+#include <FECore/matrix.h>
 #include <vector>
 #include <string>
 #include "FEDataSource.h"
@@ -77,6 +78,19 @@ public:
 	// return the FE model
 	FEModel* GetFEModel() { return m_fem; }
 
+public: // sensitivities with respect to the input parameters
+
+	// return true if the objective function can evaluate derivatives from sensitivities
+	virtual bool HasSensitivity() { return false; }
+
+	// Record the sensitivity with respect to input parameter n. This is called after each
+	// converged time step, when the model was perturbed in the direction of parameter n by a step h.
+	virtual void UpdateSensitivity(int n, double h) {}
+
+	// Evaluate the derivatives of the function values f_i with respect to the input parameters
+	// from the recorded sensitivities. Returns false if this is not supported.
+	virtual bool EvaluateDerivatives(matrix& dfda) { return false; }
+
 public:
 	double RegressionCoefficient(const std::vector<double>& y0, const std::vector<double>& y);
 
@@ -135,6 +149,11 @@ public:
 
 	void GetXValues(std::vector<double>& x);
 
+public:
+	bool HasSensitivity() override;
+	void UpdateSensitivity(int n, double h) override;
+	bool EvaluateDerivatives(matrix& dfda) override;
+
 private:
 	PointCurve			m_lc;		//!< data load curve for evaluating measurements
 	FEDataSource*		m_src;		//!< source for evaluating functions
@@ -30,10 +30,13 @@ SOFTWARE.*/
 #include "FEOptimizeData.h"
 #include "FELMOptimizeMethod.h"
 #include "FEOptimizeInput.h"
+#include "FEBioOpt.h"
 #include <FECore/FECoreKernel.h>
 #include <FECore/FEModel.h>
 #include <FECore/FEAnalysis.h>
+#include <FECore/FENewtonSolver.h>
 #include <FECore/log.h>
+#include <FECore/sys.h>
 //=============================================================================
 
 //-----------------------------------------------------------------------------
@@ -104,12 +107,18 @@ FEOptimizeData::FEOptimizeData(FEModel* fem) : m_fem(fem)
 	m_pTask = 0;
 	m_niter = 0;
 	m_obj = 0;
+	m_poolSize = 1;
+	m_bsens = false;
+	m_bsensOK = false;
 }
 
 //-----------------------------------------------------------------------------
 FEOptimizeData::~FEOptimizeData(void)
 {
 	delete m_pSolver;
+
+	for (size_t i = 0; i < m_pool.size(); ++i) delete m_pool[i];
+	for (size_t i = 0; i < m_poolModels.size(); ++i) delete m_poolModels[i];
 }
 
 //-----------------------------------------------------------------------------
@@ -146,6 +155,71 @@ bool FEOptimizeData::Init()
 	if (m_obj == 0) return false;
 	if (m_obj->Init() == false) return false;
 
+	// The sensitivities are calculated after the objective function has recorded
+	// its data, so this callback must be added after the objective is initialized.
+	m_fem->AddCallback(sensitivity_cb, CB_MAJOR_ITERS, (void*)this);
+
+	// create the model replicas
+	if (m_poolSize > 1)
+	{
+		if (InitPool() == false) return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Each replica is an independent copy of the model with its own optimization data,
+// read from the same optimization input file.
+bool FEOptimizeData::InitPool()
+{
+	FEBioOpt::FEModelReplicaFactory createModel = FEBioOpt::GetModelReplicaFactory();
+	if (createModel == nullptr)
+	{
+		feLogWarning("Model replicas are not available. Models will be solved one at a time.");
+		return true;
+	}
+
+	for (int n = 1; n < m_poolSize; ++n)
+	{
+		FEModel* fem = createModel(m_fem);
+		if (fem == nullptr)
+		{
+			feLogError("Failed to create model replica.");
+			return false;
+		}
+		m_poolModels.push_back(fem);
+
+		// the replicas don't produce any output
+		for (int i = 0; i < fem->Steps(); ++i)
+		{
+			fem->GetStep(i)->SetPlotLevel(FE_PLOT_NEVER);
+			fem->GetStep(i)->SetOutputLevel(FE_OUTPUT_NEVER);
+		}
+
+		FEOptimizeData* opt = new FEOptimizeData(fem);
+		m_pool.push_back(opt);
+		if (opt->Input(m_ctrlFile.c_str()) == false)
+		{
+			feLogError("Failed to read optimization data for model replica.");
+			return false;
+		}
+
+		// the replicas are only used by this object
+		opt->SetPoolSize(1);
+
+		fem->BlockLog();
+		bool bret = opt->Init();
+		fem->UnBlockLog();
+		if (bret == false)
+		{
+			feLogError("Failed to initialize model replica.");
+			return false;
+		}
+	}
+
+	feLog("Number of concurrent models : %d\n", m_poolSize);
+
 	return true;
 }
 
@@ -202,6 +276,7 @@ bool FEOptimizeData::Input(const char *szfile)
 {
 	FEOptimizeInput in;
 	if (in.Input(szfile, this) == false) return false;
+	m_ctrlFile = szfile;
 	return true;
 }
 
@@ -213,17 +288,8 @@ bool FEOptimizeData::RunTask()
 }
 
 //-----------------------------------------------------------------------------
-//! solve the FE problem with a new set of parameters
-bool FEOptimizeData::FESolve(const vector<double>& a)
+bool FEOptimizeData::SetInputParameters(const vector<double>& a)
 {
-	// increase iterator counter
-	m_niter++;
-
-	// reset objective function data
-	FEObjectiveFunction& obj = GetObjective();
-	obj.Reset();
-
-	// set the input parameters
 	int nvar = InputParameters();
 	if (nvar != (int)a.size()) return false;
 	for (int i = 0; i<nvar; ++i)
@@ -231,26 +297,208 @@ bool FEOptimizeData::FESolve(const vector<double>& a)
 		FEInputParameter& var = *GetInputParameter(i);
 		var.SetValue(a[i]);
 	}
+	return true;
+}
 
-	// report the new values
+//-----------------------------------------------------------------------------
+void FEOptimizeData::LogInputParameters(const vector<double>& a)
+{
 	feLog("\n----- Iteration: %d -----\n", m_niter);
-	for (int i = 0; i<nvar; ++i)
+	for (int i = 0; i<(int)a.size(); ++i)
 	{
 		FEInputParameter& var = *GetInputParameter(i);
 		string name = var.GetName();
-		feLog("%-15s = %lg\n", name.c_str(), var.GetValue());
+		feLog("%-15s = %lg\n", name.c_str(), a[i]);
 	}
+}
 
+//-----------------------------------------------------------------------------
+bool FEOptimizeData::SolveModel()
+{
 	// reset the FEM data
 	FEModel& fem = *GetFEModel();
-	fem.BlockLog();
 	fem.Reset();
-	fem.UnBlockLog();
 
 	// solve the FE problem
+	return RunTask();
+}
+
+//-----------------------------------------------------------------------------
+//! solve the FE problem with a new set of parameters
+bool FEOptimizeData::FESolve(const vector<double>& a)
+{
+	// increase iterator counter
+	m_niter++;
+
+	// reset objective function data
+	FEObjectiveFunction& obj = GetObjective();
+	obj.Reset();
+
+	// set the input parameters
+	if (SetInputParameters(a) == false) return false;
+
+	// report the new values
+	LogInputParameters(a);
+
+	// solve the FE problem
+	FEModel& fem = *GetFEModel();
 	fem.BlockLog();
-	bool bret = RunTask();
+	m_bsensOK = m_bsens;
+	bool bret = SolveModel();
 	fem.UnBlockLog();
 
 	return bret;
 }
+
+//-----------------------------------------------------------------------------
+bool FEOptimizeData::sensitivity_cb(FEModel* fem, unsigned int nwhen, void* pd)
+{
+	FEOptimizeData* opt = (FEOptimizeData*)pd;
+	if (opt->m_bsensOK)
+	{
+		try {
+			opt->m_bsensOK = opt->UpdateSensitivities();
+		}
+		catch (...)
+		{
+			opt->m_bsensOK = false;
+		}
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Calculates the sensitivities of the objective function data with respect to the
+// input parameters at the converged state of a time step. For each parameter p, the
+// partial derivative of the residual dR/dp is evaluated with a finite difference at
+// the converged state. Since the residual uses the stresses that are stored at the 
+// material points, the model is updated after each change of the parameter. The solution sensitivity dU/dp then follows from K*dU/dp = dR/dp,
+// which only needs a back-substitution with the factorized stiffness matrix. Finally,
+// the objective records its data for the state perturbed along dU/dp.
+// NOTE: This assumes the response does not depend on the load history (e.g. hyperelastic
+// materials), since the sensitivities of history variables are not tracked.
+bool FEOptimizeData::UpdateSensitivities()
+{
+	FEObjectiveFunction& obj = GetObjective();
+	if (obj.HasSensitivity() == false) return false;
+
+	FEAnalysis* step = m_fem->GetCurrentStep();
+	FENewtonSolver* solver = dynamic_cast<FENewtonSolver*>(step->GetFESolver());
+	if (solver == nullptr) return false;
+
+	// evaluate the residual and stiffness at the converged state
+	vector<double> R0;
+	if (solver->SensitivityInit(R0) == false) return false;
+
+	int neq = (int)R0.size();
+	vector<double> R1(neq), dR(neq), du(neq);
+	int nvar = InputParameters();
+	bool bok = true;
+	for (int n = 0; (n < nvar) && bok; ++n)
+	{
+		FEInputParameter& var = *GetInputParameter(n);
+		double p = var.GetValue();
+		double h = 1e-7*(fabs(var.ScaleFactor()) + fabs(p));
+
+		// partial derivative of the residual
+		var.SetValue(p + h);
+		zero(du);
+		solver->SensitivityUpdate(du);
+		bok = solver->Residual(R1);
+		if (bok)
+		{
+			for (int i = 0; i < neq; ++i) dR[i] = (R1[i] - R0[i]) / h;
+
+			// sensitivity of the solution
+			solver->SensitivitySolve(du, dR);
+
+			// record the data at the perturbed state
+			for (int i = 0; i < neq; ++i) du[i] *= h;
+			solver->SensitivityUpdate(du);
+			bok = solver->Residual(R1);
+			if (bok) obj.UpdateSensitivity(n, h);
+		}
+		var.SetValue(p);
+	}
+
+	// restore the converged state
+	zero(du);
+	solver->SensitivityUpdate(du);
+	if (solver->Residual(R1) == false) bok = false;
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+bool FEOptimizeData::GetDerivatives(matrix& dyda)
+{
+	if (m_bsensOK == false) return false;
+	return GetObjective().EvaluateDerivatives(dyda);
+}
+
+//-----------------------------------------------------------------------------
+bool FEOptimizeData::Evaluate(const vector<double>& a, vector<double>& y, double& fobj)
+{
+	FEObjectiveFunction& obj = GetObjective();
+	obj.Reset();
+	m_bsensOK = false;
+
+	if (SetInputParameters(a) == false) return false;
+	if (SolveModel() == false) return false;
+
+	fobj = obj.Evaluate(y);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEOptimizeData::FESolve(const vector< vector<double> >& a, vector< vector<double> >& y, vector<double>& fobj)
+{
+	int N = (int)a.size();
+	y.resize(N);
+	fobj.assign(N, 0.0);
+
+	// without replicas the models are solved one after the other
+	if (m_pool.empty() || (N == 1))
+	{
+		for (int i = 0; i < N; ++i)
+		{
+			if (FESolve(a[i]) == false) return false;
+			fobj[i] = GetObjective().Evaluate(y[i]);
+		}
+		return true;
+	}
+
+	// The master thread solves this model, the other threads solve the replicas.
+	// Each evaluation writes its own results, so the outcome does not depend on
+	// which thread picked it up.
+	int NP = (int)m_pool.size() + 1;
+	vector<int> bok(N, 0);
+	FEModel& fem = *GetFEModel();
+	fem.BlockLog();
+#pragma omp parallel for schedule(dynamic, 1) num_threads(NP)
+	for (int i = 0; i < N; ++i)
+	{
+		int n = omp_get_thread_num();
+		FEOptimizeData& opt = (n == 0 ? *this : *m_pool[n - 1]);
+		try {
+			bok[i] = (opt.Evaluate(a[i], y[i], fobj[i]) ? 1 : 0);
+		}
+		catch (...)
+		{
+			bok[i] = 0;
+		}
+	}
+	fem.UnBlockLog();
+
+	// report the evaluations in order
+	for (int i = 0; i < N; ++i)
+	{
+		m_niter++;
+		LogInputParameters(a[i]);
+		if (bok[i] == 0) return false;
+		feLog("objective value: %lg\n", fobj[i]);
+	}
+
+	return true;
+}
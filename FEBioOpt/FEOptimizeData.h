@@ -141,6 +141,26 @@ public:
 	//! solve the FE problem with a new set of parameters
 	bool FESolve(const std::vector<double>& a);
 
+	//! Solve the FE problem for several sets of parameters and evaluate the objective
+	//! function for each. The evaluations are distributed over the model replicas (see
+	//! SetPoolSize). The function values y and objective values fobj are returned in
+	//! the order of the parameter sets.
+	bool FESolve(const std::vector< std::vector<double> >& a, std::vector< std::vector<double> >& y, std::vector<double>& fobj);
+
+	//! set the number of models that can be solved concurrently
+	void SetPoolSize(int n) { m_poolSize = n; }
+
+	//! get the number of models that can be solved concurrently
+	int PoolSize() const { return m_poolSize; }
+
+	//! Turn the sensitivity analysis on or off. When on, FESolve calculates the sensitivities
+	//! of the objective function with respect to the input parameters by direct differentiation.
+	void SetSensitivityMode(bool b) { m_bsens = b; }
+
+	//! Get the derivatives of the function values with respect to the input parameters from the
+	//! sensitivity analysis of the last FESolve. Returns false if they could not be calculated.
+	bool GetDerivatives(matrix& dyda);
+
 public:
 	// return the number of input parameters
 	int InputParameters() { return (int)m_Var.size(); }
@@ -171,6 +191,28 @@ public:
 
 	bool RunTask();
 
+protected:
+	//! create the model replicas
+	bool InitPool();
+
+	//! set the values of the input parameters
+	bool SetInputParameters(const std::vector<double>& a);
+
+	//! report the values of the input parameters
+	void LogInputParameters(const std::vector<double>& a);
+
+	//! reset and solve the model. The caller is responsible for blocking the log.
+	bool SolveModel();
+
+	//! solve the model and evaluate the objective function. Used by FESolve to run
+	//! evaluations concurrently, so this does not write to the log.
+	bool Evaluate(const std::vector<double>& a, std::vector<double>& y, double& fobj);
+
+	//! calculate the sensitivities at the converged state of a time step
+	bool UpdateSensitivities();
+
+	static bool sensitivity_cb(FEModel* fem, unsigned int nwhen, void* pd);
+
 public:
 	int	m_niter;	// nr of minor iterations (i.e. FE solves)
 
@@ -185,4 +227,12 @@ protected:
 
 	std::vector<FEInputParameter*>	    m_Var;
 	std::vector<OPT_LIN_CONSTRAINT>		m_LinCon;
+
+	std::string		m_ctrlFile;		//!< optimization input file, used to set up the replicas
+	int				m_poolSize;		//!< number of models that can be solved concurrently
+	std::vector<FEOptimizeData*>	m_pool;			//!< optimization data of the model replicas
+	std::vector<FEModel*>			m_poolModels;	//!< the model replicas
+
+	bool	m_bsens;	//!< calculate sensitivities during FESolve
+	bool	m_bsensOK;	//!< sensitivities of last FESolve are valid
 };
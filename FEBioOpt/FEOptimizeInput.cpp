@@ -149,6 +149,13 @@ void FEOptimizeInput::ParseOptions(XMLTag& tag)
 						else throw XMLReader::InvalidValue(tag);
 					}
 				}
+				else if (tag == "pool_size")
+				{
+					int n = 1;
+					tag.value(n);
+					if (n < 1) throw XMLReader::InvalidValue(tag);
+					m_opt->SetPoolSize(n);
+				}
 				else throw XMLReader::InvalidTag(tag);
 			}
 			++tag;
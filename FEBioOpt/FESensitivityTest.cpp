@@ -0,0 +1,131 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FESensitivityTest.h"
+#include "FEObjectiveFunction.h"
+#include "FECore/log.h"
+
+//-----------------------------------------------------------------------------
+FESensitivityTest::FESensitivityTest(FEModel* pfem) : FECoreTask(pfem), m_opt(pfem)
+{
+	m_tol = 1e-3;
+}
+
+//-----------------------------------------------------------------------------
+bool FESensitivityTest::Init(const char* szfile)
+{
+	// read the data from the xml input file
+	if (m_opt.Input(szfile) == false) return false;
+
+	// do initialization
+	if (m_opt.Init() == false)
+	{
+		feLogErrorEx(m_opt.GetFEModel(), "Failed to initialize the optimization data.");
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FESensitivityTest::Run()
+{
+	int nvar = m_opt.InputParameters();
+	vector<double> a(nvar);
+	for (int i = 0; i < nvar; ++i) a[i] = m_opt.GetInputParameter(i)->InitValue();
+
+	// the derivatives from the sensitivity analysis
+	m_opt.SetSensitivityMode(true);
+	bool bret = m_opt.FESolve(a);
+	m_opt.SetSensitivityMode(false);
+	if (bret == false)
+	{
+		feLogError("The model failed to solve.");
+		return false;
+	}
+
+	vector<double> y;
+	m_opt.GetObjective().Evaluate(y);
+	int ndata = (int)y.size();
+
+	matrix dyda(ndata, nvar);
+	if (m_opt.GetDerivatives(dyda) == false)
+	{
+		feLogError("Sensitivities are not available for this problem.");
+		return false;
+	}
+
+	// the derivatives from central differences
+	vector< vector<double> > A(2 * nvar, a);
+	vector<double> h(nvar);
+	for (int i = 0; i < nvar; ++i)
+	{
+		FEInputParameter& var = *m_opt.GetInputParameter(i);
+		h[i] = 1e-5*(fabs(var.ScaleFactor()) + fabs(a[i]));
+		A[2 * i][i] += h[i];
+		A[2 * i + 1][i] -= h[i];
+	}
+
+	vector< vector<double> > Y;
+	vector<double> fobj;
+	if (m_opt.FESolve(A, Y, fobj) == false)
+	{
+		feLogError("The model failed to solve.");
+		return false;
+	}
+
+	// compare the derivatives of each parameter
+	feLog("\nS E N S I T I V I T Y   T E S T\n\n");
+	feLog("%-20s %15s %15s %15s\n", "parameter", "|dy/dp|", "|dy/dp| (FD)", "rel. diff.");
+	bool bok = true;
+	for (int n = 0; n < nvar; ++n)
+	{
+		double d2 = 0.0, fd2 = 0.0, e2 = 0.0;
+		for (int i = 0; i < ndata; ++i)
+		{
+			double fd = (Y[2 * n][i] - Y[2 * n + 1][i]) / (2.0*h[n]);
+			double d = dyda[i][n];
+			d2 += d*d;
+			fd2 += fd*fd;
+			e2 += (d - fd)*(d - fd);
+		}
+		double err = (fd2 > 0.0 ? sqrt(e2 / fd2) : sqrt(e2));
+		if (err > m_tol) bok = false;
+
+		string name = m_opt.GetInputParameter(n)->GetName();
+		feLog("%-20s %15lg %15lg %15lg\n", name.c_str(), sqrt(d2), sqrt(fd2), err);
+	}
+
+	if (bok)
+		feLog("\nThe sensitivities agree with the finite differences.\n\n");
+	else
+		feLogError("The sensitivities do not agree with the finite differences (tolerance = %lg).", m_tol);
+
+	return bok;
+}
@@ -58,16 +58,11 @@ bool FEPlotElementGnorm::Save(FEDomain& dom, FEDataStream& a)
 class FEMicro1OPK1Stress
 {
 public:
-	FEMicro1OPK1Stress(FEMicroMaterial* pm) : m_mat(pm) {}
 	mat3d operator()(const FEMaterialPoint& mp)
 	{
-		FEMaterialPoint& mp_noconst = const_cast<FEMaterialPoint&>(mp);
-		FEMicroMaterialPoint* mmppt = mp_noconst.ExtractData<FEMicroMaterialPoint>();
-		return m_mat->AveragedStressPK1(mmppt->m_rve, mp_noconst);
+		const FEMicroMaterialPoint* mmppt = mp.ExtractData<FEMicroMaterialPoint>();
+		return mmppt->m_PK1;
 	}
-
-private:
-	FEMicroMaterial* m_mat;
 };
 
 class FEMicro2OPK1Stress
@@ -86,7 +81,7 @@ bool FEPlotElementPK1norm::Save(FEDomain& dom, FEDataStream& a)
 	FEMicroMaterial* pm1O = dynamic_cast<FEMicroMaterial*>(dom.GetMaterial());
 	if (pm1O)
 	{
-		writeAverageElementValue<mat3d, double>(dom, a, FEMicro1OPK1Stress(pm1O), [](const mat3d& m) {return m.dotdot(m); });
+		writeAverageElementValue<mat3d, double>(dom, a, FEMicro1OPK1Stress(), [](const mat3d& m) {return m.dotdot(m); });
 		return true;
 	}
 
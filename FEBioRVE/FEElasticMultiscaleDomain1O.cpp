@@ -50,8 +50,8 @@ bool FEElasticMultiscaleDomain1O::Init()
 	FEMicroMaterial* pmat = dynamic_cast<FEMicroMaterial*>(m_pMat);
 	if (m_pMat == 0) return false;
 
-	// get the parent RVE
-	FERVEModel& rve = pmat->m_mrve;
+	// create the RVEs that will be solved for the material points
+	if (pmat->InitRVESolvers() == false) return false;
 
 	// loop over all elements
 	for (size_t i=0; i<m_Elem.size(); ++i)
@@ -64,13 +64,9 @@ bool FEElasticMultiscaleDomain1O::Init()
 			FEElasticMaterialPoint& pt = *mp.ExtractData<FEElasticMaterialPoint>();
 			FEMicroMaterialPoint& mmpt = *mp.ExtractData<FEMicroMaterialPoint>();
 
-			// create the material point RVEs
+			// initialize the material point's RVE state
 			mmpt.m_F_prev = pt.m_F;	// TODO: I think I can remove this line
-			mmpt.m_rve.CopyFrom(rve);
-			if (mmpt.m_rve.Init() == false) return false;
-
-			// initialize RCI solve
-			if (mmpt.m_rve.RCI_Init() == false) return false;
+			pmat->InitRVEState(mmpt);
 		}
 	}
 
@@ -34,6 +34,7 @@ SOFTWARE.*/
 #include <FECore/mat6d.h>
 #include "FEBioMech/FEBCPrescribedDeformation.h"
 #include "FERVEProbe.h"
+#include <FECore/sys.h>
 #include <sstream>
 
 //=============================================================================
@@ -45,6 +46,10 @@ FEMicroMaterialPoint::FEMicroMaterialPoint()
 	
 	m_macro_energy_inc = 0.;
 	m_micro_energy_inc = 0.;
+
+	m_PK1.zero();
+	m_bKa = false;
+	m_bcached = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -62,8 +67,12 @@ void FEMicroMaterialPoint::Update(const FETimeInfo& timeInfo)
 	FEElasticMaterialPoint::Update(timeInfo);
 	m_F_prev = m_F;
 
-	// clear rewind stack so the next rewind won't overwrite current state
-	m_rve.RCI_ClearRewindStack();
+	// the last RVE solution becomes the start of the next time step
+	if (m_rveTrial.empty() == false)
+	{
+		m_rveState.swap(m_rveTrial);
+		m_rveTrial.clear();
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -86,6 +95,9 @@ void FEMicroMaterialPoint::Serialize(DumpStream& ar)
 	ar & m_energy_diff;
 	ar & m_macro_energy_inc;
 	ar & m_micro_energy_inc;
+
+	// the RVE states are needed to restart the RVE solves from this point
+	ar & m_rveState & m_rveTrial;
 }
 
 //=============================================================================
@@ -97,6 +109,8 @@ BEGIN_FECORE_CLASS(FEMicroMaterial, FEElasticMaterial)
 	ADD_PARAMETER(m_szbc     , "bc_set"  );
 	ADD_PARAMETER(m_bctype   , "rve_type" );
 	ADD_PARAMETER(m_scale	 , "scale"   ); 
+	ADD_PARAMETER(m_cacheTol , FE_RANGE_GREATER_OR_EQUAL(0.0), "cache_tol");
+	ADD_PARAMETER(m_cacheSize, FE_RANGE_GREATER(0), "cache_size");
 
 	ADD_PROPERTY(m_probe, "probe", false);
 
@@ -110,11 +124,15 @@ FEMicroMaterial::FEMicroMaterial(FEModel* pfem) : FEElasticMaterial(pfem)
 	m_szbc[0] = 0;
 	m_bctype = FERVEModel::DISPLACEMENT;	// use displacement BCs by default
 	m_scale = 1.0;
+	m_cacheTol = 0.0;
+	m_cacheSize = 1000;
 }
 
 //-----------------------------------------------------------------------------
 FEMicroMaterial::~FEMicroMaterial(void)
 {
+	for (size_t i = 0; i < m_rve.size(); ++i) delete m_rve[i];
+	m_rve.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -156,9 +174,75 @@ bool FEMicroMaterial::Init()
 		feLogError("An error occurred preparing RVE model"); return false;
 	}
 
+	// setup the response cache
+	if (m_cacheTol > 0.0)
+	{
+		m_cache.SetTolerance(m_cacheTol);
+		m_cache.SetMaxSamples(m_cacheSize);
+		GetFEModel()->AddCallback(cache_cb, CB_MAJOR_ITERS, (void*)this);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEMicroMaterial::cache_cb(FEModel* fem, unsigned int nwhen, void* pd)
+{
+	FEMicroMaterial* mat = (FEMicroMaterial*)pd;
+	mat->UpdateCachedPoints();
+
+	FERVEResponseCache& cache = mat->m_cache;
+	int hits = cache.Hits();
+	int N = hits + cache.Misses();
+	double rate = (N > 0 ? (double)hits / N : 0.0);
+	feLogEx(fem, "RVE response cache (material %d): %d hits, %d misses (hit rate %.3lf), %d samples\n", mat->GetID(), hits, cache.Misses(), rate, cache.Samples());
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The material points do not carry their own RVE model. Instead, the RVE is 
+// solved by a copy of the parent RVE that is shared by all the points, so the 
+// mesh, boundary conditions, and the linear solver data (i.e. matrix profile and
+// symbolic factorization) are only stored once. Each thread gets its own copy. 
+bool FEMicroMaterial::InitRVESolvers()
+{
+	// this may be called by several domains
+	if (m_rve.empty() == false) return true;
+
+	int nt = omp_get_max_threads();
+	for (int i = 0; i < nt; ++i)
+	{
+		FERVEModel* rve = new FERVEModel;
+		m_rve.push_back(rve);
+
+		rve->CopyFrom(m_mrve);
+		if (rve->Init() == false) return false;
+
+		// initialize RCI solve
+		if (rve->RCI_Init() == false) return false;
+	}
+
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void FEMicroMaterial::InitRVEState(FEMicroMaterialPoint& pt)
+{
+	assert(m_rve.empty() == false);
+	m_rve[0]->SaveState(pt.m_rveState);
+	pt.m_rveTrial.clear();
+}
+
+//-----------------------------------------------------------------------------
+// This loads the latest RVE state of a material point in the first RVE and returns it.
+FERVEModel& FEMicroMaterial::RestoreRVE(FEMicroMaterialPoint& pt)
+{
+	FERVEModel& rve = *m_rve[0];
+	if (pt.m_rveTrial.empty() == false) rve.RestoreState(pt.m_rveTrial);
+	else rve.RestoreState(pt.m_rveState);
+	return rve;
+}
+
 //-----------------------------------------------------------------------------
 // Note that this function is not used in the first-order implemenetation
 mat3ds FEMicroMaterial::Stress(FEMaterialPoint &mp)
@@ -167,23 +251,114 @@ mat3ds FEMicroMaterial::Stress(FEMaterialPoint &mp)
 	FEMicroMaterialPoint& pt = *mp.ExtractData<FEMicroMaterialPoint>();
 	mat3d F = pt.m_F;
 
+	// see if the response can be taken from the cache
+	pt.m_bKa = false;
+	if (m_cacheTol > 0.0)
+	{
+		FERVEResponseCache::Response r;
+		if (m_cache.Lookup(F, r))
+		{
+			pt.m_micro_energy = r.energy;
+			pt.m_PK1 = r.PK1;
+			pt.m_Ka = r.c;
+			pt.m_bKa = true;
+
+			// The RVE was not solved for F, so the last RVE solution is no longer valid.
+			// The RVE will be solved when the time step has converged.
+			pt.m_rveTrial.clear();
+			pt.m_bcached = true;
+			return r.s;
+		}
+	}
+
+	return SolveRVE(mp);
+}
+
+//-----------------------------------------------------------------------------
+// Solve the RVE, starting from the point's state at the start of the time step.
+// The RVE solution is stored as the point's trial state.
+mat3ds FEMicroMaterial::SolveRVE(FEMaterialPoint& mp)
+{
+	FEMicroMaterialPoint& pt = *mp.ExtractData<FEMicroMaterialPoint>();
+	mat3d F = pt.m_F;
+	pt.m_bcached = false;
+
+	FERVEModel& rve = *m_rve[omp_get_thread_num()];
+	rve.RestoreState(pt.m_rveState);
+	rve.Advance(F);
+
 	// calculate the averaged Cauchy stress
-	mat3ds sa = pt.m_rve.StressAverage(F, mp);
+	mat3ds sa = rve.StressAverage(mp);
 	
 	// calculate the difference between the macro and micro energy for Hill-Mandel condition
-	pt.m_micro_energy = micro_energy(pt.m_rve);	
+	pt.m_micro_energy = micro_energy(rve);	
+
+	// the PK1 stress needs the reaction forces, which are not part of the RVE state
+	pt.m_PK1 = AveragedStressPK1(rve, mp);
+
+	// store the RVE solution
+	rve.SaveState(pt.m_rveTrial);
+
+	// add the response to the cache
+	if (m_cacheTol > 0.0)
+	{
+		FERVEResponseCache::Response r;
+		r.s = sa;
+		r.c = rve.StiffnessAverage(mp);
+		r.PK1 = pt.m_PK1;
+		r.energy = pt.m_micro_energy;
+		m_cache.Add(F, r);
+
+		pt.m_Ka = r.c;
+		pt.m_bKa = true;
+	}
 	
 	return sa;
 }
 
 //-----------------------------------------------------------------------------
-// The stiffness is evaluated at the same time the stress is evaluated so we 
-// can just return it here. Note that this assumes that the stress function 
-// is always called prior to the tangent function.
+// The points that took their response from the cache in the last iteration don't
+// have an RVE solution. This solves their RVEs for the converged deformation, so 
+// that the next time step starts from the correct RVE state. 
+void FEMicroMaterial::UpdateCachedPoints()
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FESolidDomain* dom = dynamic_cast<FESolidDomain*>(&mesh.Domain(i));
+		if ((dom == nullptr) || (dom->GetMaterial() != this)) continue;
+
+		int NE = dom->Elements();
+#pragma omp parallel for schedule(dynamic)
+		for (int j = 0; j < NE; ++j)
+		{
+			FESolidElement& el = dom->Element(j);
+			int nint = el.GaussPoints();
+			for (int n = 0; n < nint; ++n)
+			{
+				FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+				FEMicroMaterialPoint& pt = *mp.ExtractData<FEMicroMaterialPoint>();
+				if (pt.m_bcached) SolveRVE(mp);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// The stiffness is evaluated from the RVE solution of the last stress evaluation.
+// Note that this assumes that the stress function is always called prior to the 
+// tangent function.
 tens4ds FEMicroMaterial::Tangent(FEMaterialPoint &mp)
 {
 	FEMicroMaterialPoint& mmpt = *mp.ExtractData<FEMicroMaterialPoint>();
-	return mmpt.m_rve.StiffnessAverage(mp);
+
+	// the tangent may already have been evaluated with the stress
+	if (mmpt.m_bKa) return mmpt.m_Ka;
+
+	// evaluate the stiffness of the last RVE solution
+	FERVEModel& rve = *m_rve[omp_get_thread_num()];
+	rve.RestoreState(mmpt.m_rveTrial);
+	return rve.StiffnessAverage(mp);
 }
 
 //-----------------------------------------------------------------------------
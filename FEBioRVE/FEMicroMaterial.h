@@ -30,6 +30,7 @@ SOFTWARE.*/
 #include "FEPeriodicBoundary1O.h"
 #include "FECore/FECallBack.h"
 #include "FERVEModel.h"
+#include "FERVEResponseCache.h"
 #include "febiorve_api.h"
 
 class FERVEProbe;
@@ -65,7 +66,15 @@ public:
 	double	   m_macro_energy_inc;	// Macroscopic strain energy increment
 	double	   m_micro_energy_inc;	// Microscopic strain energy increment
 
-	FERVEModel	m_rve;				// Local copy of the parent rve
+	mat3d		m_PK1;				// averaged PK1 stress of the last RVE solve
+
+	tens4ds		m_Ka;				// averaged tangent of the last stress evaluation
+	bool		m_bKa;				// m_Ka is valid (only used with the response cache)
+	bool		m_bcached;			// the last stress was taken from the response cache
+
+	// The RVE model is shared by the material points, so the points only store the RVE state
+	std::vector<char>	m_rveState;		// RVE state at the start of the time step
+	std::vector<char>	m_rveTrial;		// RVE state after the last RVE solve
 };
 
 //-----------------------------------------------------------------------------
@@ -85,6 +94,12 @@ public:
 	int			m_bctype;		//!< periodic bc flag
 	double		m_scale;		//!< RVE scale factor
 	FERVEModel	m_mrve;			//!< the parent RVE (Representive Volume Element)
+	double		m_cacheTol;		//!< tolerance of the response cache (zero to turn off)
+	int			m_cacheSize;	//!< max number of samples in the response cache
+
+protected:
+	std::vector<FERVEModel*>	m_rve;	//!< RVEs that solve the material points (one per thread)
+	FERVEResponseCache			m_cache;	//!< cache of RVE responses
 
 public:
 	//! calculate stress at material point
@@ -99,6 +114,25 @@ public:
 	//! create material point data
 	FEMaterialPointData* CreateMaterialPointData() override;
 
+	//! create the RVEs that solve the material points
+	bool InitRVESolvers();
+
+	//! initialize the RVE state of a material point
+	void InitRVEState(FEMicroMaterialPoint& pt);
+
+	//! load the latest RVE state of a material point
+	FERVEModel& RestoreRVE(FEMicroMaterialPoint& pt);
+
+private:
+	// callback for updating the cached points and logging the cache statistics
+	static bool cache_cb(FEModel* fem, unsigned int nwhen, void* pd);
+
+	// solve the RVE of a material point for its current deformation gradient
+	mat3ds SolveRVE(FEMaterialPoint& mp);
+
+	// solve the RVEs of the points whose response was taken from the cache
+	void UpdateCachedPoints();
+
 	// calculate the average PK1 stress
 	mat3d AveragedStressPK1(FEModel& rve, FEMaterialPoint &mp);
 
@@ -41,6 +41,7 @@ SOFTWARE.*/
 #include <FECore/FECube.h>
 #include <FECore/FEPointFunction.h>
 #include <FECore/FECoreKernel.h>
+#include <FECore/DumpBufferStream.h>
 
 //-----------------------------------------------------------------------------
 FERVEModel::FERVEModel()
@@ -468,6 +469,16 @@ mat3ds FERVEModel::StressAverage(mat3d& F, FEMaterialPoint& mp)
 	// rewind the RCI
 	RCI_Rewind();
 
+	// advance the RVE solution
+	Advance(F);
+
+	// calculate and return the (Cuachy) stress average
+	return StressAverage(mp);
+}
+
+//-----------------------------------------------------------------------------
+void FERVEModel::Advance(const mat3d& F)
+{
 	// update the BC's
 	Update(F);
 
@@ -483,9 +494,28 @@ mat3ds FERVEModel::StressAverage(mat3d& F, FEMaterialPoint& mp)
 
 	// make sure it converged
 	if (bret == false) throw FEMultiScaleException(-1, -1);
+}
 
-	// calculate and return the (Cuachy) stress average
-	return StressAverage(mp);
+//-----------------------------------------------------------------------------
+// The state is stored with a shallow archive, so it only contains the data that
+// changes during the solution. The mesh, boundary conditions, and solver
+// structures (e.g. the matrix profile) stay with the model.
+void FERVEModel::SaveState(std::vector<char>& buf)
+{
+	DumpBufferStream ar(*this, buf);
+	ar.clear();
+	ar.Open(true, true);
+	Serialize(ar);
+}
+
+//-----------------------------------------------------------------------------
+bool FERVEModel::RestoreState(std::vector<char>& buf)
+{
+	if (buf.empty()) return false;
+	DumpBufferStream ar(*this, buf);
+	ar.Open(false, true);
+	Serialize(ar);
+	return true;
 }
 
 //-----------------------------------------------------------------------------
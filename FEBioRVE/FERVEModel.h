@@ -75,6 +75,15 @@ public:
 	// set the parent FEModel
 	void SetParentModel(FEModel* fem);
 
+	//! Advance the RVE solution for the macro deformation gradient F
+	void Advance(const mat3d& F);
+
+	//! store the RVE state (i.e. nodal values, material point and solver data)
+	void SaveState(std::vector<char>& buf);
+
+	//! restore a state that was stored with SaveState
+	bool RestoreState(std::vector<char>& buf);
+
 	//! Calculate the stress average
 	mat3ds StressAverage(mat3d& F, FEMaterialPoint& mp);
 	mat3ds StressAverage(FEMaterialPoint& mp);
@@ -106,6 +106,8 @@ FEMicroProbe::FEMicroProbe(FEModel* fem) : FERVEProbe(fem)
 {
 	m_neid = -1;	// invalid element - this must be defined by user
 	m_ngp = -1;		// invalid gauss point
+	m_mat = nullptr;
+	m_mmp = nullptr;
 }
 
 bool FEMicroProbe::Init()
@@ -145,7 +147,8 @@ bool FEMicroProbe::Init()
 		FEMaterialPoint* mp = pel->GetMaterialPoint(m_ngp);
 		FEMicroMaterialPoint* mmp = mp->ExtractData<FEMicroMaterialPoint>();
 		if (mmp == nullptr) return false;
-		SetRVEModel(&mmp->m_rve);
+		m_mat = mat;
+		m_mmp = mmp;
 	}
 	else
 	{
@@ -153,6 +156,14 @@ bool FEMicroProbe::Init()
 		return false;
 	}
 
+	// The material points share the RVE model, which is not created yet,
+	// so the RVE model is assigned when the probe is executed.
+	return FECallBack::Init();
+}
 
-	return FERVEProbe::Init();
+bool FEMicroProbe::Execute(FEModel& fem, int nwhen)
+{
+	// load the point's RVE state before the RVE is stored
+	SetRVEModel(&m_mat->RestoreRVE(*m_mmp));
+	return FERVEProbe::Execute(fem, nwhen);
 }
@@ -30,6 +30,8 @@ SOFTWARE.*/
 //-----------------------------------------------------------------------------
 class FEBioPlotFile;
 class FEMaterialPoint;
+class FEMicroMaterial;
+class FEMicroMaterialPoint;
 
 //-----------------------------------------------------------------------------
 // Base class for RVE probes
@@ -71,9 +73,14 @@ public:
 
 	bool Init() override;
 
+	bool Execute(FEModel& fem, int nwhen) override;
+
 private:
 	int			m_neid;			//!< element Id
 	int			m_ngp;			//!< Gauss-point (one-based!)
 
+	FEMicroMaterial*		m_mat;	//!< the micro-material
+	FEMicroMaterialPoint*	m_mmp;	//!< the material point that is tracked
+
 	DECLARE_FECORE_CLASS();
 };
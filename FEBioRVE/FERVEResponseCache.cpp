@@ -0,0 +1,151 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#include "stdafx.h"
+#include "FERVEResponseCache.h"
+#include <mutex>
+
+//-----------------------------------------------------------------------------
+FERVEResponseCache::FERVEResponseCache()
+{
+	m_tol = 0.0;
+	m_max = 1000;
+	m_next = 0;
+	m_hits = 0;
+	m_misses = 0;
+}
+
+//-----------------------------------------------------------------------------
+void FERVEResponseCache::SetMaxSamples(int n)
+{
+	m_max = (n > 0 ? n : 1);
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+void FERVEResponseCache::Clear()
+{
+	std::unique_lock<std::shared_timed_mutex> lock(m_lock);
+	m_F.clear();
+	m_R.clear();
+	m_next = 0;
+	m_hits = 0;
+	m_misses = 0;
+}
+
+//-----------------------------------------------------------------------------
+int FERVEResponseCache::Samples() const
+{
+	std::shared_lock<std::shared_timed_mutex> lock(m_lock);
+	return (int)m_F.size();
+}
+
+//-----------------------------------------------------------------------------
+bool FERVEResponseCache::Lookup(const mat3d& F, Response& r)
+{
+	// find the nearest sample
+	mat3d F0;
+	Response r0;
+	double dmin = -1.0;
+	{
+		std::shared_lock<std::shared_timed_mutex> lock(m_lock);
+		int N = (int)m_F.size();
+		int imin = -1;
+		for (int i = 0; i < N; ++i)
+		{
+			mat3d dF = F - m_F[i];
+			double d = sqrt(dF.dotdot(dF));
+			if ((d <= m_tol) && ((imin < 0) || (d < dmin)))
+			{
+				imin = i;
+				dmin = d;
+				if (d == 0.0) break;
+			}
+		}
+		if (imin >= 0)
+		{
+			F0 = m_F[imin];
+			r0 = m_R[imin];
+		}
+	}
+
+	if (dmin < 0.0)
+	{
+		m_misses++;
+		return false;
+	}
+	m_hits++;
+
+	// an exact match is returned as is
+	if (dmin == 0.0) r = r0;
+	else Extrapolate(F0, r0, F, r);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The increment dF = F - F0 defines the velocity gradient l = dF*F0^-1. The spatial
+// tangent c relates the Truesdell rate of the Cauchy stress to the rate of deformation,
+// so the Cauchy stress increment is ds = c:d + l*s + s*l^T - tr(l)*s, with d = sym(l).
+// The increment of the PK1 stress P = J*s*F^-T follows from dJ = J*tr(l) and 
+// d(F^-T) = -l^T*F^-T, and the energy P:F is linearized in the same way. The tangent 
+// is taken from the sample.
+void FERVEResponseCache::Extrapolate(const mat3d& F0, const Response& r0, const mat3d& F, Response& r)
+{
+	mat3d dF = F - F0;
+	mat3d Fi = F0.inverse();
+	mat3d l = dF*Fi;
+	double trl = l.trace();
+	double J0 = F0.det();
+
+	const mat3ds& s0 = r0.s;
+	mat3d ls = l*s0;
+	mat3ds ds = r0.c.dot(l.sym()) + (ls + ls.transpose()).sym() - s0*trl;
+
+	mat3d dP = ((ds + s0*trl)*J0 - (s0*l.transpose())*J0)*Fi.transpose();
+
+	r.s = s0 + ds;
+	r.c = r0.c;
+	r.PK1 = r0.PK1 + dP;
+	r.energy = r0.energy + dP.dotdot(F0) + r0.PK1.dotdot(dF);
+}
+
+//-----------------------------------------------------------------------------
+void FERVEResponseCache::Add(const mat3d& F, const Response& r)
+{
+	std::unique_lock<std::shared_timed_mutex> lock(m_lock);
+	if ((int)m_F.size() < m_max)
+	{
+		m_F.push_back(F);
+		m_R.push_back(r);
+	}
+	else
+	{
+		m_F[m_next] = F;
+		m_R[m_next] = r;
+		m_next = (m_next + 1) % m_max;
+	}
+}
@@ -0,0 +1,92 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#pragma once
+#include <FECore/mat3d.h>
+#include <FECore/tens4d.h>
+#include <vector>
+#include <atomic>
+#include <shared_mutex>
+#include "febiorve_api.h"
+
+//-----------------------------------------------------------------------------
+//! Cache of homogenized RVE responses, keyed on the macro deformation gradient.
+//! A response is served from the cache if there is a sample within the tolerance
+//! of the requested deformation gradient. The response is then extrapolated from the
+//! nearest sample to first order, using the sample's tangent. Since the key is only 
+//! the deformation gradient, this assumes that the RVE response is path-independent.
+//! The cache can be accessed from multiple threads. Lookups only need a shared lock,
+//! so they can proceed concurrently.
+class FEBIORVE_API FERVEResponseCache
+{
+public:
+	struct Response
+	{
+		mat3ds	s;			//!< averaged Cauchy stress
+		tens4ds	c;			//!< averaged spatial tangent
+		mat3d	PK1;		//!< averaged PK1 stress
+		double	energy;		//!< micro energy
+	};
+
+public:
+	FERVEResponseCache();
+
+	//! set the tolerance on the (Frobenius) norm of the difference in deformation gradients
+	void SetTolerance(double tol) { m_tol = tol; }
+
+	//! set the max number of samples. When full, the oldest samples are replaced.
+	void SetMaxSamples(int n);
+
+	//! remove all samples and reset the statistics
+	void Clear();
+
+	//! find the response for F. Returns false on a cache miss.
+	bool Lookup(const mat3d& F, Response& r);
+
+	//! extrapolate the response r0 at F0 to F
+	static void Extrapolate(const mat3d& F0, const Response& r0, const mat3d& F, Response& r);
+
+	//! add a sample
+	void Add(const mat3d& F, const Response& r);
+
+public:
+	int Samples() const;
+	int Hits() const { return m_hits; }
+	int Misses() const { return m_misses; }
+
+private:
+	double	m_tol;		//!< tolerance
+	int		m_max;		//!< max number of samples
+	int		m_next;		//!< sample to replace next when the cache is full
+
+	std::vector<mat3d>		m_F;	//!< sample keys
+	std::vector<Response>	m_R;	//!< sample responses
+
+	std::atomic<int>	m_hits;		//!< number of cache hits
+	std::atomic<int>	m_misses;	//!< number of cache misses
+
+	mutable std::shared_timed_mutex	m_lock;	//!< guards the samples
+};
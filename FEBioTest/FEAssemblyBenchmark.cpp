@@ -0,0 +1,222 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEAssemblyBenchmark.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEAnalysis.h>
+#include <FECore/FENewtonSolver.h>
+#include <FECore/FEGlobalMatrix.h>
+#include <FECore/FEDomain.h>
+#include <FECore/FELinearConstraintManager.h>
+#include <FECore/Timer.h>
+#include <FECore/sys.h>
+#include <FECore/log.h>
+
+//-----------------------------------------------------------------------------
+// We run the model until the first stiffness matrix was formed and then
+// run the benchmark.
+FEAssemblyBenchmark::FEAssemblyBenchmark(FEModel* fem) : FEBenchmarkTask(fem, 5, CB_MATRIX_REFORM)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FEAssemblyBenchmark::Benchmark()
+{
+	FEModel* fem = GetFEModel();
+	FEAnalysis* step = fem->GetCurrentStep();
+	FENewtonSolver* nlsolve = dynamic_cast<FENewtonSolver*>(step->GetFESolver());
+	if (nlsolve == nullptr) return false;
+
+	FEGlobalMatrix& K = *nlsolve->m_pK;
+	SparseMatrix& A = K;
+	if (A.Values() == nullptr) return false;
+	bool bcolored = K.ColoredAssembly();
+
+	// build the element colorings
+	FEMesh& mesh = fem->GetMesh();
+	int ncolors = 0;
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		dom.BuildElementColoring();
+		if (dom.ElementColoring().Colors() > ncolors) ncolors = dom.ElementColoring().Colors();
+	}
+
+	int maxThreads = omp_get_max_threads();
+	std::vector<int> threads;
+	for (int n = 1; n < maxThreads; n *= 2) threads.push_back(n);
+	threads.push_back(maxThreads);
+
+	printf("\nAssembly benchmark\n");
+	printf("\tNr of equations ........... : %d\n", A.Rows());
+	printf("\tNr of nonzeroes ........... : %d\n", A.NonZeroes());
+	printf("\tMax nr of element colors .. : %d\n", ncolors);
+	printf("\tNr of linear constraints .. : %d\n", fem->GetLinearConstraintManager().LinearConstraints());
+	printf("\tAssemblies per measurement  : %d\n\n", m_reps);
+	printf("%8s %15s %15s %10s\n", "threads", "atomic (s)", "colored (s)", "speedup");
+
+	// the reference matrix (atomic assembly, single thread)
+	std::vector<double> K0;
+	double maxErr = 0.0, maxVal = 0.0;
+	for (int n : threads)
+	{
+		omp_set_num_threads(n);
+
+		double t[2] = { 0.0, 0.0 };
+		for (int mode = 0; mode < 2; ++mode)
+		{
+			K.SetColoredAssembly(mode == 1);
+
+			Timer timer;
+			timer.start();
+			for (int i = 0; i < m_reps; ++i)
+			{
+				A.Zero();
+				zero(nlsolve->m_Fd);
+				nlsolve->StiffnessMatrix();
+			}
+			timer.stop();
+			t[mode] = timer.GetTime() / m_reps;
+
+			// compare to the reference matrix
+			const double* pv = A.Values();
+			int nnz = A.NonZeroes();
+			if (K0.empty()) K0.assign(pv, pv + nnz);
+			for (int j = 0; j < nnz; ++j)
+			{
+				double err = fabs(pv[j] - K0[j]);
+				if (err > maxErr) maxErr = err;
+				if (fabs(K0[j]) > maxVal) maxVal = fabs(K0[j]);
+			}
+		}
+
+		printf("%8d %15.6lg %15.6lg %10.3lg\n", n, t[0], t[1], (t[1] > 0 ? t[0] / t[1] : 0.0));
+	}
+	printf("\nMax difference with reference matrix: %lg (max abs value: %lg)\n\n", maxErr, maxVal);
+
+	LinearConstraintBenchmark(threads);
+
+	// restore the original state
+	omp_set_num_threads(maxThreads);
+	K.SetColoredAssembly(bcolored);
+	A.Zero();
+	zero(nlsolve->m_Fd);
+	nlsolve->StiffnessMatrix();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Times the assembly of the linear constraint contributions of all the elements
+// that reference a constrained node. A unit element matrix is used, since only
+// the cost of the constraint assembly itself is of interest here.
+void FEAssemblyBenchmark::LinearConstraintBenchmark(const std::vector<int>& threads)
+{
+	FEModel* fem = GetFEModel();
+	FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
+	if (LCM.LinearConstraints() == 0) return;
+
+	FEAnalysis* step = fem->GetCurrentStep();
+	FENewtonSolver* nlsolve = dynamic_cast<FENewtonSolver*>(step->GetFESolver());
+	FEGlobalMatrix& K = *nlsolve->m_pK;
+	SparseMatrix& A = K;
+
+	// collect the constrained elements
+	std::vector< std::vector<int> > EN, LM;
+	FEMesh& mesh = fem->GetMesh();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		for (int j = 0; j < dom.Elements(); ++j)
+		{
+			FEElement& el = dom.ElementRef(j);
+			if (LCM.IsConstrained(el.m_node))
+			{
+				std::vector<int> lm;
+				dom.UnpackLM(el, lm);
+				EN.push_back(el.m_node);
+				LM.push_back(lm);
+			}
+		}
+	}
+	const int NE = (int)EN.size();
+
+	printf("Linear constraint assembly\n");
+	printf("\tNr of constrained elements  : %d\n\n", NE);
+	printf("%8s %15s %15s %10s\n", "threads", "locked (s)", "buffered (s)", "speedup");
+
+	std::vector<FELinearConstraintBuffer> buf;
+	for (int n : threads)
+	{
+		omp_set_num_threads(n);
+		if ((int)buf.size() < n) buf.resize(n);
+
+		double t[2] = { 0.0, 0.0 };
+		for (int mode = 0; mode < 2; ++mode)
+		{
+			A.Zero();
+			Timer timer;
+			timer.start();
+			for (int i = 0; i < m_reps; ++i)
+			{
+#pragma omp parallel
+				{
+					matrix ke;
+#pragma omp for schedule(dynamic)
+					for (int j = 0; j < NE; ++j)
+					{
+						const std::vector<int>& lm = LM[j];
+						int ndof = (int)lm.size();
+						if (ke.rows() != ndof)
+						{
+							ke.resize(ndof, ndof);
+							for (int k = 0; k < ndof; ++k)
+								for (int l = 0; l < ndof; ++l) ke[k][l] = 1.0;
+						}
+
+						if (mode == 0)
+						{
+#pragma omp critical (LC_assemble)
+							LCM.AssembleStiffness(K, nlsolve->m_Fd, nlsolve->m_ui, EN[j], lm, lm, ke);
+						}
+						else LCM.AssembleStiffness(buf[omp_get_thread_num()], nlsolve->m_ui, EN[j], lm, lm, ke);
+					}
+				}
+				if (mode == 1)
+				{
+					for (int j = 0; j < n; ++j) buf[j].Assemble(A, nlsolve->m_Fd);
+				}
+			}
+			timer.stop();
+			t[mode] = timer.GetTime() / m_reps;
+		}
+
+		printf("%8d %15.6lg %15.6lg %10.3lg\n", n, t[0], t[1], (t[1] > 0 ? t[0] / t[1] : 0.0));
+	}
+	printf("\n");
+}
@@ -0,0 +1,48 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "FEBenchmarkTask.h"
+
+//-----------------------------------------------------------------------------
+// This task measures the wall time of the stiffness matrix assembly as a function
+// of the number of threads, for both the atomic and the colored assembly mode.
+// For models with linear (or periodic) constraints, the assembly of the linear
+// constraint contributions is timed separately, both with the global lock and
+// with the per-thread linear constraint buffers.
+// The task argument is the number of assemblies per measurement.
+class FEAssemblyBenchmark : public FEBenchmarkTask
+{
+public:
+	FEAssemblyBenchmark(FEModel* fem);
+
+protected:
+	bool Benchmark() override;
+
+private:
+	void LinearConstraintBenchmark(const std::vector<int>& threads);
+};
@@ -0,0 +1,86 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBenchmarkTask.h"
+#include <FECore/FEModel.h>
+#include <FECore/log.h>
+#include <stdlib.h>
+
+//-----------------------------------------------------------------------------
+FEBenchmarkTask::FEBenchmarkTask(FEModel* fem, int reps, unsigned int nwhen) : FECoreTask(fem)
+{
+	m_reps = reps;
+	m_nwhen = nwhen;
+	m_bdone = false;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchmarkTask::Init(const char* szarg)
+{
+	if (szarg && szarg[0])
+	{
+		m_reps = atoi(szarg);
+		if (m_reps <= 0) return false;
+	}
+	return GetFEModel()->Init();
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchmarkTask::benchmark_cb(FEModel* fem, unsigned int nwhen, void* pd)
+{
+	FEBenchmarkTask* task = (FEBenchmarkTask*)pd;
+
+	// we only run this once
+	if (task->m_bdone) return true;
+	task->m_bdone = true;
+
+	return task->Benchmark();
+}
+
+//-----------------------------------------------------------------------------
+bool FEBenchmarkTask::Run()
+{
+	FEModel& fem = *GetFEModel();
+	fem.AddCallback(benchmark_cb, m_nwhen, (void*)this);
+
+	fem.BlockLog();
+	bool bret = fem.Solve();
+	fem.UnBlockLog();
+
+	if (m_bdone == false)
+	{
+		if (m_nwhen == CB_MATRIX_REFORM)
+			feLogError("The stiffness matrix was never formed. Aborting benchmark.\n");
+		else
+			feLogError("The model never reached the state at which the benchmark is run. Aborting benchmark.\n");
+		return false;
+	}
+
+	return bret;
+}
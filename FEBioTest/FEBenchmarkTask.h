@@ -0,0 +1,59 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/FECoreTask.h>
+
+//-----------------------------------------------------------------------------
+// Base class for the benchmark tasks. The model is solved as usual, and the 
+// first time the callback event occurs, Benchmark is called. Since this is done
+// only once, the benchmark sees a fully initialized model. The optional task 
+// argument is the number of repetitions per measurement.
+class FEBenchmarkTask : public FECoreTask
+{
+public:
+	FEBenchmarkTask(FEModel* fem, int reps, unsigned int nwhen);
+
+	bool Init(const char* szarg) override;
+
+	bool Run() override;
+
+protected:
+	// run the benchmark
+	virtual bool Benchmark() = 0;
+
+private:
+	static bool benchmark_cb(FEModel* fem, unsigned int nwhen, void* pd);
+
+protected:
+	int		m_reps;		// nr of repetitions per measurement
+
+private:
+	unsigned int	m_nwhen;	// callback event at which the benchmark is run
+	bool			m_bdone;	// benchmark was run
+};
@@ -36,6 +36,12 @@ SOFTWARE.*/
 #include "FEMaterialTest.h"
 #include "FEResetTest.h"
 #include "FEStiffnessDiagnostic.h"
+#include "FEAssemblyBenchmark.h"
+#include "FEStressBenchmark.h"
+#include "FEFiberBenchmark.h"
+#include "FEFFTBlurTest.h"
+#include "FEGaussianBlurTest.h"
+#include "FEBytecodeTest.h"
 
 namespace FEBioTest
 {
@@ -48,5 +54,11 @@ void InitModule()
 	REGISTER_FECORE_CLASS(FEResetTest, "reset_test");
 	REGISTER_FECORE_CLASS(FEMaterialTest, "material test");
 	REGISTER_FECORE_CLASS(FEStiffnessDiagnostic, "stiffness_test");
+	REGISTER_FECORE_CLASS(FEAssemblyBenchmark, "assembly_benchmark");
+	REGISTER_FECORE_CLASS(FEStressBenchmark, "stress_benchmark");
+	REGISTER_FECORE_CLASS(FEFiberBenchmark, "fiber_benchmark");
+	REGISTER_FECORE_CLASS(FEFFTBlurTest, "fftblur_test");
+	REGISTER_FECORE_CLASS(FEGaussianBlurTest, "gaussblur_test");
+	REGISTER_FECORE_CLASS(FEBytecodeTest, "bytecode_test");
 }
 }
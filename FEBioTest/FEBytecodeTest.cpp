@@ -0,0 +1,213 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEBytecodeTest.h"
+#include <FECore/MBytecode.h>
+#include <FECore/MathObject.h>
+#include <FECore/log.h>
+#include <math.h>
+#include <vector>
+
+// The expressions are evaluated at NPTS points for each of the NTIME times
+#define NPTS	7
+#define NTIME	3
+
+//-----------------------------------------------------------------------------
+// create an expression of the variables x, y, t (in that order)
+static bool create_expression(MSimpleExpression& e, const char* szexpr)
+{
+	e.AddVariable("x");
+	e.AddVariable("y");
+	e.AddVariable("t");
+	return e.Create(szexpr, true) && (e.Variables() == 3);
+}
+
+//-----------------------------------------------------------------------------
+static bool same_value(double a, double b)
+{
+	if (a == b) return true;
+	return (fabs(a - b) <= 1e-12*(fabs(b) > 1.0 ? fabs(b) : 1.0));
+}
+
+//-----------------------------------------------------------------------------
+FEBytecodeTest::FEBytecodeTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FEBytecodeTest::Init(const char* sz)
+{
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEBytecodeTest::Run()
+{
+	// expressions of x, y and t. The number of instructions is only checked if it is 
+	// not negative and tests that constant sub-expressions are folded.
+	struct {
+		const char*	szexpr;
+		int			nins;
+	} expr[] = {
+		{ "exp(1)*sqrt(4)"                    ,  0 },
+		{ "sin(2)*x + cos(0.5)"               ,  2 },
+		{ "sin(x)*cos(y) + x^2"               , -1 },
+		{ "sin(x)*cos(y) + t"                 , -1 },
+		{ "exp(-(x*x + y*y)/2)*(1 + 2*t)"     , -1 },
+		{ "sqrt(x*x + y*y)/(1 + t*t)"         , -1 },
+		{ "atan2(y, x) - t/3"                 , -1 },
+		{ "max(x, y, t)"                      ,  1 },
+		{ "min(x, sqrt(9), y) + avg(1, 2, 3)" ,  2 },
+		{ "avg(x*t, y, -t)*pow(2, 3)"         , -1 },
+	};
+	const int nexpr = sizeof(expr) / sizeof(expr[0]);
+
+	bool bok = true;
+	for (int i = 0; i < nexpr; ++i)
+	{
+		MSimpleExpression e;
+		if ((create_expression(e, expr[i].szexpr) == false) || (TestExpression(expr[i].szexpr, e, expr[i].nins) == false)) bok = false;
+	}
+
+	// symbolic function of N variables (the parser does not create these, so we
+	// wrap an expression in one)
+	{
+		MSimpleExpression e;
+		if (create_expression(e, "x*y + t^2"))
+		{
+			MSequence args;
+			for (int i = 0; i < 3; ++i) args.add(new MVarRef(e.Variable(i)));
+			MITEM f(new MSFuncND("f", e.GetExpression().ItemPtr()->copy(), &args));
+			e.SetExpression(f);
+			if (TestExpression("f(x,y,t) = x*y + t^2", e) == false) bok = false;
+		}
+		else bok = false;
+	}
+
+	// Functions of N variables with too many arguments cannot be compiled. The 
+	// compiler must then report failure, so that the expression tree is used instead.
+	{
+		const char* szexpr = "max(x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, x, y)";
+		MSimpleExpression e;
+		if (create_expression(e, szexpr))
+		{
+			MBytecode code;
+			MSimpleExpression e2;
+			create_expression(e2, "x + y");
+			bool b1 = code.Compile(e2);
+			bool b2 = code.Compile(e, std::vector<bool>{ false, false, true });
+			double v = e.value_s(std::vector<double>{ 1.0, 2.0, 0.0 });
+			bool b = b1 && (b2 == false) && (code.IsValid() == false) && (v == 2.0);
+			feLog("%-40s : compilation rejected, tree value = %lg %s\n", "fallback (too many arguments)", v, (b ? "" : "(FAILED)"));
+			if (b == false) bok = false;
+		}
+		else bok = false;
+	}
+
+	if (bok) feLog("\nAll bytecode tests passed.\n\n");
+	else feLogError("bytecode test failed.");
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+// Compiles the expression, with t as a dynamic variable, and compares the single 
+// point and batch evaluation with the evaluation of the expression tree. In the batch
+// evaluation, the static instructions are only evaluated once, and for each time 
+// only the t block and the dynamic instructions are updated.
+bool FEBytecodeTest::TestExpression(const char* szexpr, MSimpleExpression& e, int nins)
+{
+	MBytecode code;
+	if (code.Compile(e, std::vector<bool>{ false, false, true }) == false)
+	{
+		feLog("%-40s : compilation failed (FAILED)\n", szexpr);
+		return false;
+	}
+
+	bool bok = true;
+
+	// check constant folding
+	if ((nins >= 0) && (code.Instructions() != nins)) bok = false;
+	if ((nins == 0) && (code.IsConst() == false)) bok = false;
+
+	// the result is static if it does not change with t
+	double x[NPTS], y[NPTS], t[NTIME] = { 0.0, 0.5, 1.25 };
+	for (int k = 0; k < NPTS; ++k)
+	{
+		x[k] = 0.3 + 0.25*k;
+		y[k] = -0.7 + 0.4*k;
+	}
+	bool bstatic = true;
+	for (int k = 0; k < NPTS; ++k)
+	{
+		double v0 = e.value_s(std::vector<double>{ x[k], y[k], t[0] });
+		for (int l = 1; l < NTIME; ++l)
+			if (e.value_s(std::vector<double>{ x[k], y[k], t[l] }) != v0) bstatic = false;
+	}
+	if (code.IsStatic() != bstatic) bok = false;
+
+	// single point evaluation
+	std::vector<double> reg(code.Registers());
+	double maxerr = 0.0;
+	for (int l = 0; l < NTIME; ++l)
+		for (int k = 0; k < NPTS; ++k)
+		{
+			reg[0] = x[k]; reg[1] = y[k]; reg[2] = t[l];
+			double v = code.value(reg.data());
+			double v0 = e.value_s(std::vector<double>{ x[k], y[k], t[l] });
+			if (same_value(v, v0) == false) bok = false;
+			if (fabs(v - v0) > maxerr) maxerr = fabs(v - v0);
+		}
+
+	// batch evaluation
+	const int n = NPTS;
+	std::vector<double> breg((size_t)n*code.Registers(), 0.0);
+	for (int k = 0; k < n; ++k)
+	{
+		breg[k] = x[k];
+		breg[n + k] = y[k];
+	}
+	code.EvalStatic(breg.data(), n);
+	for (int l = 0; l < NTIME; ++l)
+	{
+		for (int k = 0; k < n; ++k) breg[2*n + k] = t[l];
+		code.EvalDynamic(breg.data(), n);
+
+		const double* r = code.Result(breg.data(), n);
+		for (int k = 0; k < n; ++k)
+		{
+			double v0 = e.value_s(std::vector<double>{ x[k], y[k], t[l] });
+			if (same_value(r[k], v0) == false) bok = false;
+			if (fabs(r[k] - v0) > maxerr) maxerr = fabs(r[k] - v0);
+		}
+	}
+
+	feLog("%-40s : %2d instructions, %s, max error = %lg %s\n", szexpr, code.Instructions(), (code.IsStatic() ? "static " : "dynamic"), maxerr, (bok ? "" : "(FAILED)"));
+	return bok;
+}
@@ -69,6 +69,13 @@ FEContactDiagnostic::FEContactDiagnostic(FEModel* fem) : FEDiagnostic(fem)
 	fem->SetActiveModule("solid");
 
 	FEAnalysis* pstep = new FEAnalysis(fem);
+
+	// create a new solver
+	FESolver* pnew_solver = fecore_new<FESolver>("solid", fem);
+	assert(pnew_solver);
+	pnew_solver->m_msymm = REAL_UNSYMMETRIC;
+	pstep->SetFESolver(pnew_solver);
+
     fem->AddStep(pstep);
     fem->SetCurrentStep(pstep);
 }
@@ -83,7 +90,9 @@ bool FEContactDiagnostic::Run()
 	// get the solver
 	FEModel& fem = *GetFEModel();
 	FEAnalysis* pstep = fem.GetCurrentStep();
+	pstep->Activate();
 	FESolidSolver2& solver = static_cast<FESolidSolver2&>(*pstep->GetFESolver());
+	solver.InitEquations();
 	solver.Init();
 
 	// make sure contact data is up to data
@@ -94,8 +103,7 @@ bool FEContactDiagnostic::Run()
 
 	// get the stiffness matrix
 	FEGlobalMatrix& K = *solver.GetStiffnessMatrix();
-	SparseMatrix *pA = (SparseMatrix*)(&K);
-	DenseMatrix& K0 = static_cast<DenseMatrix&>(*pA);
+	SparseMatrix& KS = *K;
 
 	// we need a linear system to evaluate contact
 	int neq = solver.m_neq;
@@ -104,10 +112,16 @@ bool FEContactDiagnostic::Run()
 	FELinearSystem LS(&solver, K, Fd, ui, true);
 
 	// build the stiffness matrix
-	K0.Zero();
+	K.Zero();
 	solver.ContactStiffness(LS);
 //	solver.StiffnessMatrix();
 
+	// copy it to a dense matrix
+	const int N = 48;
+	DenseMatrix K0; K0.Create(N, N);
+	for (int i=0; i<N; ++i)
+		for (int j=0; j<N; ++j) K0(i,j) = KS.get(i,j);
+
 	print_matrix(K0);
 
 	// calculate the derivative of the residual
@@ -117,7 +131,6 @@ bool FEContactDiagnostic::Run()
 	print_matrix(K1);
 
 	// calculate difference matrix
-	const int N = 48;
 	DenseMatrix Kd; Kd.Create(N, N);
 	double kij, kmax = 0, k0;
 	int i0=-1, j0=-1;
@@ -216,6 +229,8 @@ bool FEContactDiagnostic::Init()
 	el1.m_node[6] = 14;
 	el1.m_node[7] = 15;
 
+	pbd->CreateMaterialPointData();
+
 	// --- create the sliding interface ---
 	FESlidingInterface* ps = new FESlidingInterface(&fem);
 	ps->m_atol = 0.1;
@@ -238,7 +253,7 @@ bool FEContactDiagnostic::Init()
 
 	// --- set fem data ---
 	// Make sure we are using the LU solver
-	FECoreKernel::GetInstance().SetDefaultSolverType("LU");
+	FECoreKernel::GetInstance().SetDefaultSolver(new FEClassDescriptor("LU"));
 
 	return FEDiagnostic::Init();
 }
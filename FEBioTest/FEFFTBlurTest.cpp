@@ -0,0 +1,129 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEFFTBlurTest.h"
+#include <FECore/log.h>
+#include <FEImgLib/Image.h>
+#include <FEImgLib/image_tools.h>
+#include <math.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// The blurred delta along one axis of size n. The Fourier coefficients are scaled 
+// by exp(-(k*d/n)^2), where the frequency k of coefficient i is i for 2i <= n, and
+// i - n otherwise.
+static std::vector<double> blurred_delta(int n, float d)
+{
+	std::vector<double> g(n, 0.0);
+	if (n == 1) { g[0] = 1.0; return g; }
+
+	double sigma = n / d;
+	for (int j = 0; j < n; ++j)
+	{
+		double w = (2 * j <= n ? j : j - n) / sigma;
+		double m = exp(-w*w);
+		for (int k = 0; k < n; ++k) g[k] += m*cos(2.0*PI*j*k / n) / n;
+	}
+	return g;
+}
+
+//-----------------------------------------------------------------------------
+FEFFTBlurTest::FEFFTBlurTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FEFFTBlurTest::Init(const char* sz)
+{
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEFFTBlurTest::Run()
+{
+	// Image lines are filtered in pairs, so the delta is placed in the first line
+	// and its partner is zero. Any leakage between the two lines shows up as a 
+	// non-symmetric result.
+	const int sizes[][3] = {
+		{  8,  2, 1 },
+		{  5,  2, 1 },
+		{  7,  3, 1 },
+		{ 12,  9, 1 },
+		{ 15,  4, 1 },
+		{ 13, 11, 1 },
+		{  6,  5, 3 },
+		{  9,  7, 5 },
+	};
+	const int nsizes = sizeof(sizes) / sizeof(sizes[0]);
+
+	bool bok = true;
+	for (int i = 0; i < nsizes; ++i)
+	{
+		if (TestSize(sizes[i][0], sizes[i][1], sizes[i][2], 2.f) == false) bok = false;
+	}
+
+	if (bok) feLog("\nAll fftblur tests passed.\n\n");
+	else feLogError("fftblur test failed.");
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+bool FEFFTBlurTest::TestSize(int nx, int ny, int nz, float d)
+{
+	Image src;
+	src.Create(nx, ny, nz);
+	src.zero();
+	src.data()[0] = 1.f;
+
+	Image trg;
+	if (nz == 1) fftblur_2d(trg, src, d);
+	else fftblur_3d(trg, src, d);
+
+	std::vector<double> gx = blurred_delta(nx, d);
+	std::vector<double> gy = blurred_delta(ny, d);
+	std::vector<double> gz = blurred_delta(nz, d);
+
+	double maxerr = 0.0;
+	const float* pf = trg.data();
+	for (int k = 0; k < nz; ++k)
+		for (int j = 0; j < ny; ++j)
+			for (int i = 0; i < nx; ++i)
+			{
+				double v = pf[((size_t)k*ny + j)*nx + i];
+				double e = fabs(v - gx[i] * gy[j] * gz[k]);
+				if (e > maxerr) maxerr = e;
+			}
+
+	// the image is stored in single precision
+	double tol = 1e-6*gx[0] * gy[0] * gz[0];
+	bool bok = (maxerr <= tol);
+	feLog("size = %3d x %3d x %3d : max error = %lg %s\n", nx, ny, nz, maxerr, (bok ? "" : "(FAILED)"));
+	return bok;
+}
@@ -0,0 +1,144 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEFiberBenchmark.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/FEDomain.h>
+#include <FECore/Timer.h>
+#include <FECore/log.h>
+#include <FEBioMech/FESolidMaterial.h>
+#include <FEBioMech/FEContinuousFiberDistribution.h>
+
+//-----------------------------------------------------------------------------
+// The benchmark is run at the end of the first time step. The fibers are then 
+// deformed, so that the stresses and tangents that are compared are not trivial.
+// (Fibers that are not stretched do not contribute.)
+FEFiberBenchmark::FEFiberBenchmark(FEModel* fem) : FEBenchmarkTask(fem, 10, CB_MAJOR_ITERS)
+{
+}
+
+//-----------------------------------------------------------------------------
+// find the continuous fiber distributions of a material
+static void FindFiberDistributions(FECoreBase* pc, std::vector<FEContinuousFiberDistribution*>& cfd)
+{
+	if (pc == nullptr) return;
+	FEContinuousFiberDistribution* pf = dynamic_cast<FEContinuousFiberDistribution*>(pc);
+	if (pf) cfd.push_back(pf);
+	for (int i = 0; i < pc->Properties(); ++i) FindFiberDistributions(pc->GetProperty(i), cfd);
+}
+
+//-----------------------------------------------------------------------------
+// evaluate the stress and tangent at all material points of the fiber domains, 
+// and return the sum of the norms, used to verify that both measurements agree.
+void FEFiberBenchmark::Evaluate(double& snorm, double& cnorm)
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	snorm = cnorm = 0.0;
+	for (int nd : m_dom)
+	{
+		FEDomain& dom = mesh.Domain(nd);
+		FESolidMaterial* mat = dynamic_cast<FESolidMaterial*>(dom.GetMaterial());
+		for (int i = 0; i < dom.Elements(); ++i)
+		{
+			FEElement& el = dom.ElementRef(i);
+			for (int n = 0; n < el.GaussPoints(); ++n)
+			{
+				FEMaterialPoint& mp = *el.GetMaterialPoint(n);
+				mat3ds s = mat->Stress(mp);
+				tens4ds c = mat->Tangent(mp);
+				snorm += s.norm();
+				for (int k = 0; k < tens4ds::NNZ; ++k) cnorm += fabs(c.d[k]);
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+bool FEFiberBenchmark::Benchmark()
+{
+	FEModel* fem = GetFEModel();
+	FEMesh& mesh = fem->GetMesh();
+
+	printf("\nFiber integration benchmark\n");
+
+	// find the domains with continuous fiber distributions
+	int npoints = 0;
+	m_dom.clear();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		if (dynamic_cast<FESolidMaterial*>(dom.GetMaterial()) == nullptr) continue;
+
+		std::vector<FEContinuousFiberDistribution*> cfd;
+		FindFiberDistributions(dom.GetMaterial(), cfd);
+		if (cfd.empty()) continue;
+
+		m_dom.push_back(i);
+		for (int j = 0; j < dom.Elements(); ++j) npoints += dom.ElementRef(j).GaussPoints();
+
+		for (FEContinuousFiberDistribution* pf : cfd)
+		{
+			FEFiberIntegrationScheme* scheme = pf->GetIntegrationScheme();
+			printf("\tDomain %d: scheme \"%s\"%s\n", i + 1, scheme->GetTypeStr(), (scheme->HasFixedPoints() ? " (fixed points)" : ""));
+		}
+	}
+
+	if (m_dom.empty())
+	{
+		printf("\tNo continuous fiber distributions found.\n\n");
+		return true;
+	}
+
+	printf("\tNr of material points ..... : %d\n", npoints);
+	printf("\tEvaluations per measurement : %d\n\n", m_reps);
+	printf("%12s %15s %18s %18s %18s\n", "evaluation", "time (s)", "points/s", "stress norm", "tangent norm");
+
+	bool bbatch = FEContinuousFiberDistribution::BatchEvaluation();
+	double t[2] = { 0.0, 0.0 };
+	double snorm = 0.0, cnorm = 0.0;
+	for (int mode = 0; mode < 2; ++mode)
+	{
+		FEContinuousFiberDistribution::SetBatchEvaluation(mode == 1);
+
+		Timer timer;
+		timer.start();
+		for (int i = 0; i < m_reps; ++i) Evaluate(snorm, cnorm);
+		timer.stop();
+		t[mode] = timer.GetTime() / m_reps;
+
+		double pps = (t[mode] > 0 ? npoints / t[mode] : 0.0);
+		printf("%12s %15.6lg %18.6lg %18.10lg %18.10lg\n", (mode == 0 ? "per fiber" : "batched"), t[mode], pps, snorm, cnorm);
+	}
+	printf("\nSpeedup: %lg\n\n", (t[1] > 0 ? t[0] / t[1] : 0.0));
+	if (snorm == 0.0) printf("WARNING: The stresses are zero, so the comparison is not meaningful.\n\n");
+
+	FEContinuousFiberDistribution::SetBatchEvaluation(bbatch);
+
+	return true;
+}
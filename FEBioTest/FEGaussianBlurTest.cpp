@@ -0,0 +1,156 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEGaussianBlurTest.h"
+#include <FECore/log.h>
+#include <FEImgLib/Image.h>
+#include <FEImgLib/image_tools.h>
+#include <math.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// The recursive filter approximates the Gaussian to within about 5% of the peak value 
+// per axis (for the blur radii tested here).
+#define MAX_ERROR	0.06
+
+//-----------------------------------------------------------------------------
+// sampled and normalized Gaussian kernel, truncated at 5 standard deviations
+static std::vector<double> gaussian_kernel(float d, int& r)
+{
+	r = (int)ceil(5.0*d);
+	std::vector<double> g(2 * r + 1);
+	double sum = 0.0;
+	for (int i = -r; i <= r; ++i)
+	{
+		g[i + r] = exp(-0.5*i*i / ((double)d*d));
+		sum += g[i + r];
+	}
+	for (double& gi : g) gi /= sum;
+	return g;
+}
+
+//-----------------------------------------------------------------------------
+FEGaussianBlurTest::FEGaussianBlurTest(FEModel* pfem) : FECoreTask(pfem)
+{
+}
+
+//-----------------------------------------------------------------------------
+bool FEGaussianBlurTest::Init(const char* sz)
+{
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool FEGaussianBlurTest::Run()
+{
+	// The sources are placed far enough from the boundaries that the boundary 
+	// treatment does not matter.
+	const struct { int nx, ny, nz; float d; } tests[] = {
+		{ 41, 37,  1, 2.f },
+		{ 41, 37,  1, 3.f },
+		{ 22, 25,  1, 1.5f },
+		{ 25, 23, 21, 2.f },
+	};
+	const int ntests = sizeof(tests) / sizeof(tests[0]);
+
+	bool bok = true;
+	for (int i = 0; i < ntests; ++i)
+	{
+		if (TestSize(tests[i].nx, tests[i].ny, tests[i].nz, tests[i].d) == false) bok = false;
+	}
+
+	if (bok) feLog("\nAll Gaussian blur tests passed.\n\n");
+	else feLogError("Gaussian blur test failed.");
+
+	return bok;
+}
+
+//-----------------------------------------------------------------------------
+bool FEGaussianBlurTest::TestSize(int nx, int ny, int nz, float d)
+{
+	// Image lines are filtered in pairs, so the sources are placed in neighboring 
+	// lines and planes to check that the lines don't mix.
+	Image src;
+	src.Create(nx, ny, nz);
+	src.zero();
+	float* ps = src.data();
+	int cx = nx / 2, cy = ny / 2, cz = nz / 2;
+	ps[((size_t)cz*ny + cy)*nx + cx] = 1.f;
+	ps[((size_t)cz*ny + cy + 1)*nx + cx - 1] = 0.5f;
+	if (nz > 1) ps[((size_t)(cz + 1)*ny + cy)*nx + cx + 1] = 0.25f;
+
+	Image trg;
+	if (nz == 1) gaussian_blur_2d(trg, src, d);
+	else gaussian_blur_3d(trg, src, d);
+
+	// direct convolution (with the boundary values extended)
+	int r;
+	std::vector<double> g = gaussian_kernel(d, r);
+	int rz = (nz > 1 ? r : 0);
+	std::vector<double> ref((size_t)nx*ny*nz, 0.0);
+	double refmax = 0.0;
+	for (int k = 0; k < nz; ++k)
+		for (int j = 0; j < ny; ++j)
+			for (int i = 0; i < nx; ++i)
+			{
+				double v = 0.0;
+				for (int c = -rz; c <= rz; ++c)
+				{
+					int kc = k + c; if (kc < 0) kc = 0; if (kc >= nz) kc = nz - 1;
+					double wz = (nz > 1 ? g[c + r] : 1.0);
+					for (int b = -r; b <= r; ++b)
+					{
+						int jb = j + b; if (jb < 0) jb = 0; if (jb >= ny) jb = ny - 1;
+						double wyz = wz*g[b + r];
+						for (int a = -r; a <= r; ++a)
+						{
+							int ia = i + a; if (ia < 0) ia = 0; if (ia >= nx) ia = nx - 1;
+							v += wyz*g[a + r] * ps[((size_t)kc*ny + jb)*nx + ia];
+						}
+					}
+				}
+				ref[((size_t)k*ny + j)*nx + i] = v;
+				if (v > refmax) refmax = v;
+			}
+
+	double maxerr = 0.0;
+	const float* pf = trg.data();
+	for (size_t n = 0; n < ref.size(); ++n)
+	{
+		double e = fabs(pf[n] - ref[n]);
+		if (e > maxerr) maxerr = e;
+	}
+
+	// The errors of the axes add up (to first order).
+	int ndim = (nz > 1 ? 3 : 2);
+	double rel = maxerr / refmax;
+	bool bok = (rel <= ndim*MAX_ERROR);
+	feLog("size = %3d x %3d x %3d, d = %g : max relative error = %lg %s\n", nx, ny, nz, d, rel, (bok ? "" : "(FAILED)"));
+	return bok;
+}
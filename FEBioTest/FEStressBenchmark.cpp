@@ -0,0 +1,138 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEStressBenchmark.h"
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/FESolidDomain.h>
+#include <FECore/FEMaterialPoint.h>
+#include <FECore/Timer.h>
+#include <FECore/log.h>
+#include <FEBioMech/FEElasticMaterialPoint.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// We run the model until the first stiffness matrix was formed, so that all
+// the material points are initialized, and then run the benchmark.
+FEStressBenchmark::FEStressBenchmark(FEModel* fem) : FEBenchmarkTask(fem, 10, CB_MATRIX_REFORM)
+{
+}
+
+//-----------------------------------------------------------------------------
+// collect the stresses of all material points and return the sum of their norms. 
+// The stresses are used to verify that both measurements evaluate the same stresses.
+double FEStressBenchmark::CollectStresses(std::vector<mat3ds>& s)
+{
+	FEMesh& mesh = GetFEModel()->GetMesh();
+	s.clear();
+	double snorm = 0.0;
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FESolidDomain* dom = dynamic_cast<FESolidDomain*>(&mesh.Domain(i));
+		if (dom == nullptr) continue;
+		for (int j = 0; j < dom->Elements(); ++j)
+		{
+			FESolidElement& el = dom->Element(j);
+			for (int n = 0; n < el.GaussPoints(); ++n)
+			{
+				FEElasticMaterialPoint* ep = el.GetMaterialPoint(n)->ExtractData<FEElasticMaterialPoint>();
+				if (ep)
+				{
+					s.push_back(ep->m_s);
+					snorm += ep->m_s.norm();
+				}
+			}
+		}
+	}
+	return snorm;
+}
+
+//-----------------------------------------------------------------------------
+bool FEStressBenchmark::Benchmark()
+{
+	FEModel* fem = GetFEModel();
+	FEMesh& mesh = fem->GetMesh();
+	const FETimeInfo& tp = fem->GetTime();
+
+	int npoints = 0;
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain& dom = mesh.Domain(i);
+		for (int j = 0; j < dom.Elements(); ++j) npoints += dom.ElementRef(j).GaussPoints();
+	}
+
+	printf("\nStress update benchmark\n");
+	printf("\tNr of elements ............ : %d\n", mesh.Elements());
+	printf("\tNr of material points ..... : %d\n", npoints);
+	printf("\tUpdates per measurement ... : %d\n\n", m_reps);
+	printf("%12s %15s %18s %15s\n", "lookup", "time (s)", "points/s", "stress norm");
+
+	bool bcache = FEMaterialPoint::LookupCache();
+	double t[2] = { 0.0, 0.0 };
+	std::vector<mat3ds> s[2];
+	for (int mode = 0; mode < 2; ++mode)
+	{
+		FEMaterialPoint::SetLookupCache(mode == 1);
+
+		Timer timer;
+		timer.start();
+		for (int i = 0; i < m_reps; ++i) mesh.Update(tp);
+		timer.stop();
+		t[mode] = timer.GetTime() / m_reps;
+
+		double snorm = CollectStresses(s[mode]);
+		double pps = (t[mode] > 0 ? npoints / t[mode] : 0.0);
+		printf("%12s %15.6lg %18.6lg %15.10lg\n", (mode == 0 ? "search" : "cached"), t[mode], pps, snorm);
+	}
+	printf("\nSpeedup: %lg\n\n", (t[1] > 0 ? t[0] / t[1] : 0.0));
+
+	FEMaterialPoint::SetLookupCache(bcache);
+
+	// The lookup cache only changes how the material point data is found, so the
+	// stresses of the cached pass must be identical to the reference stresses.
+	if (s[0].size() != s[1].size())
+	{
+		feLogError("stress benchmark: the number of material points changed.");
+		return false;
+	}
+	int ndiff = 0;
+	double maxdiff = 0.0;
+	for (size_t i = 0; i < s[0].size(); ++i)
+	{
+		double d = (s[1][i] - s[0][i]).norm();
+		if (d != 0.0) ndiff++;
+		if (d > maxdiff) maxdiff = d;
+	}
+	if (ndiff > 0)
+	{
+		feLogError("stress benchmark: the stresses of %d material points differ (max difference = %lg).", ndiff, maxdiff);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,49 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "FEBenchmarkTask.h"
+#include <FECore/mat3d.h>
+#include <vector>
+
+//-----------------------------------------------------------------------------
+// This task measures the throughput of the stress update, i.e. the time it takes
+// to update all the material points of the mesh. The update is timed with and
+// without the material point data lookup cache, which is the main cost of 
+// materials with deep material point data (e.g. mixtures, multigeneration).
+// The task argument is the number of updates per measurement.
+class FEStressBenchmark : public FEBenchmarkTask
+{
+public:
+	FEStressBenchmark(FEModel* fem);
+
+protected:
+	bool Benchmark() override;
+
+private:
+	double CollectStresses(std::vector<mat3ds>& s);
+};
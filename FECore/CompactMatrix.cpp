@@ -29,6 +29,8 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "CompactMatrix.h"
 #include <assert.h>
+#include <algorithm>
+using namespace std;
 
 //=============================================================================
 // CompactMatrix
@@ -41,6 +43,7 @@ CompactMatrix::CompactMatrix(int offset)
 	m_pindices = 0;
 	m_ppointers = 0;
 	m_offset = offset;
+	m_ncap = 0;
 
 	m_bdel = false;
 }
@@ -71,6 +74,7 @@ void CompactMatrix::Clear()
 	m_pd = 0;
 	m_pindices = 0;
 	m_ppointers = 0;
+	m_ncap = 0;
 
 	SparseMatrix::Clear();
 }
@@ -88,6 +92,7 @@ void CompactMatrix::alloc(int nr, int nc, int nz, double* pv, int* pi, int* pp,
 	m_nrow = nr;
 	m_ncol = nc;
 	m_nsize = nz;
+	m_ncap = nz;
 
 	int nn = (isRowBased() ? nr : nc) + 1;
 }
@@ -140,3 +145,146 @@ size_t CompactMatrix::actualNonZeroes()
 	}
 	return nnz;
 }
+
+//-----------------------------------------------------------------------------
+//! find the position of an entry in the index array. The major index is the row for 
+//! row-based formats and the column otherwise. The indices of a row (or column) are
+//! assumed to be sorted.
+int CompactMatrix::find(int nmajor, int nminor) const
+{
+	int* p0 = m_pindices + (m_ppointers[nmajor    ] - m_offset);
+	int* p1 = m_pindices + (m_ppointers[nmajor + 1] - m_offset);
+	int* p = lower_bound(p0, p1, nminor + m_offset);
+	if ((p != p1) && (*p == nminor + m_offset)) return (int)(p - m_pindices);
+	return -1;
+}
+
+//-----------------------------------------------------------------------------
+//! Inserts and removes entries in the matrix structure. Removals are done in a forward
+//! pass and insertions in a backward pass over the index and value arrays, starting
+//! from the first row (or column) that changes. New entries are inserted in the slack
+//! that was reserved when the matrix was created, so nothing is reallocated. 
+//! For symmetric matrices only the lower-triangular entries are considered.
+bool CompactMatrix::UpdateStructure(const vector< pair<int, int> >& add, const vector< pair<int, int> >& remove)
+{
+	if ((m_pindices == nullptr) || (m_ppointers == nullptr) || (m_pd == nullptr)) return false;
+
+	bool brow = isRowBased();
+	bool bsymm = isSymmetric();
+	int nmaj = (brow ? m_nrow : m_ncol);
+
+	// convert to (major, minor) pairs and drop the entries that don't change anything
+	vector< pair<int, int> > ins, del;
+	for (const pair<int, int>& e : remove)
+	{
+		int i = e.first, j = e.second;
+		if (bsymm && (i < j)) continue;
+		int a = (brow ? i : j), b = (brow ? j : i);
+		if (find(a, b) >= 0) del.push_back(pair<int, int>(a, b));
+	}
+	for (const pair<int, int>& e : add)
+	{
+		int i = e.first, j = e.second;
+		if (bsymm && (i < j)) continue;
+		int a = (brow ? i : j), b = (brow ? j : i);
+		if (find(a, b) < 0) ins.push_back(pair<int, int>(a, b));
+	}
+	sort(del.begin(), del.end()); del.erase(unique(del.begin(), del.end()), del.end());
+	sort(ins.begin(), ins.end()); ins.erase(unique(ins.begin(), ins.end()), ins.end());
+
+	// make sure we have room
+	if (m_nsize - (int)del.size() + (int)ins.size() > m_ncap) return false;
+
+	const int off = m_offset;
+
+	// remove entries
+	if (del.empty() == false)
+	{
+		size_t k = 0;
+		int src0 = m_ppointers[del[0].first] - off;
+		int dst = src0;
+		for (int j = del[0].first; j < nmaj; ++j)
+		{
+			int src1 = m_ppointers[j + 1] - off;
+			m_ppointers[j] = dst + off;
+			if ((k < del.size()) && (del[k].first == j))
+			{
+				for (int s = src0; s < src1; ++s)
+				{
+					if ((k < del.size()) && (del[k].first == j) && (del[k].second == m_pindices[s] - off)) { ++k; continue; }
+					m_pindices[dst] = m_pindices[s];
+					m_pd[dst] = m_pd[s];
+					++dst;
+				}
+			}
+			else if (dst != src0)
+			{
+				int n = src1 - src0;
+				memmove(m_pindices + dst, m_pindices + src0, n * sizeof(int));
+				memmove(m_pd + dst, m_pd + src0, n * sizeof(double));
+				dst += n;
+			}
+			else dst = src1;
+			src0 = src1;
+		}
+		assert(k == del.size());
+		m_ppointers[nmaj] = dst + off;
+		m_nsize = dst;
+	}
+
+	// insert entries
+	if (ins.empty() == false)
+	{
+		int k = (int)ins.size() - 1;
+		int send = m_nsize;
+		int dst = m_nsize + (int)ins.size();
+		m_ppointers[nmaj] = dst + off;
+		for (int j = nmaj - 1; j >= ins[0].first; --j)
+		{
+			int s0 = m_ppointers[j] - off;
+			if ((k >= 0) && (ins[k].first == j))
+			{
+				int s = send - 1;
+				while ((k >= 0) && (ins[k].first == j))
+				{
+					int b = ins[k].second + off;
+					if ((s >= s0) && (m_pindices[s] > b))
+					{
+						--dst;
+						m_pindices[dst] = m_pindices[s];
+						m_pd[dst] = m_pd[s];
+						--s;
+					}
+					else
+					{
+						--dst;
+						m_pindices[dst] = b;
+						m_pd[dst] = 0.0;
+						--k;
+					}
+				}
+				int n = s - s0 + 1;
+				dst -= n;
+				if (dst != s0)
+				{
+					memmove(m_pindices + dst, m_pindices + s0, n * sizeof(int));
+					memmove(m_pd + dst, m_pd + s0, n * sizeof(double));
+				}
+			}
+			else
+			{
+				int n = send - s0;
+				dst -= n;
+				memmove(m_pindices + dst, m_pindices + s0, n * sizeof(int));
+				memmove(m_pd + dst, m_pd + s0, n * sizeof(double));
+			}
+			m_ppointers[j] = dst + off;
+			send = s0;
+		}
+		assert(k == -1);
+		assert(dst == send);
+		m_nsize += (int)ins.size();
+	}
+
+	return true;
+}
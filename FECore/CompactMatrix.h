@@ -86,11 +86,20 @@ public:
 	//! count the actual nr. of nonzeroes
 	size_t actualNonZeroes();
 
+public:
+	//! Insert and remove entries in the existing structure
+	bool UpdateStructure(const std::vector< std::pair<int, int> >& add, const std::vector< std::pair<int, int> >& remove) override;
+
+protected:
+	//! find the position of an entry in the index array (or -1 if not found)
+	int find(int nmajor, int nminor) const;
+
 protected:
 	double*	m_pd;			//!< matrix values
 	int*	m_pindices;		//!< indices
 	int*	m_ppointers;	//!< pointers
 	int		m_offset;		//!< adjust array indices for fortran arrays
+	int		m_ncap;			//!< allocated size of the value and index arrays (>= m_nsize)
 	bool	m_bdel;			//!< delete data arrays in destructor
 
 protected:
@@ -129,7 +129,9 @@ void CompactSymmMatrix::Create(SparseMatrixProfile& mp)
 	}
 
 	// allocate indices which store row index for each matrix element
-	int* pindices = new int[nsize];
+	// (including the requested slack, which is kept at the end of the arrays)
+	int ncap = nsize + Slack()*nc;
+	int* pindices = new int[ncap];
 	int m = 0;
 	for (int i = 0; i <= nc; ++i)
 	{
@@ -169,10 +171,11 @@ void CompactSymmMatrix::Create(SparseMatrixProfile& mp)
 	}
 
 	// create the values array
-	double* pvalues = new double[nsize];
+	double* pvalues = new double[ncap];
 
 	// create the stiffness matrix
 	CompactMatrix::alloc(nr, nc, nsize, pvalues, pindices, pointers);
+	m_ncap = ncap;
 }
 
 //-----------------------------------------------------------------------------
@@ -221,8 +224,12 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == I)
 				{
-					#pragma omp atomic
-					pm[n] += ke[i][j];
+					if (m_batomic)
+					{
+						#pragma omp atomic
+						pm[n] += ke[i][j];
+					}
+					else pm[n] += ke[i][j];
 					break;
 				}
 		}
@@ -257,8 +264,12 @@ void CompactSymmMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const
 				for (int n = 0; n<l; ++n) 
 					if (pi[n] - m_offset == I)
 					{
-						#pragma omp atomic
-						pv[n] += ke[i][j];
+						if (m_batomic)
+						{
+							#pragma omp atomic
+							pv[n] += ke[i][j];
+						}
+						else pv[n] += ke[i][j];
 						break;
 					}
 			}
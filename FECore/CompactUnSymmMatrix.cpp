@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "CompactUnSymmMatrix.h"
+#include <algorithm>
 using namespace std;
 
 //-----------------------------------------------------------------------------
@@ -142,7 +143,8 @@ void CRSSparseMatrix::Create(SparseMatrixProfile& mp)
 		}
 	}
 
-	int* pindices = new int[nsize];
+	int ncap = nsize + Slack()*nr;
+	int* pindices = new int[ncap];
 	int m = 0;
 	for (int i = 0; i <= nr; ++i)
 	{
@@ -175,10 +177,11 @@ void CRSSparseMatrix::Create(SparseMatrixProfile& mp)
 	}
 
 	// create the values array
-	double* pvalues = new double[nsize];
+	double* pvalues = new double[ncap];
 
 	// create the stiffness matrix
 	CompactMatrix::alloc(nr, nc, nsize, pvalues, pindices, pointers);
+	m_ncap = ncap;
 
 	// calculate and print matrix bandwidth
 //	feLog("\tMatrix bandwidth .......................... : %d\n", bandWidth());
@@ -223,8 +226,12 @@ void CRSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == J)
 				{
+					if (m_batomic)
+					{
 #pragma omp atomic
-					pm[n] += kij;
+						pm[n] += kij;
+					}
+					else pm[n] += kij;
 					break;
 				}
 		}
@@ -239,6 +246,30 @@ void CRSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const v
 	const int N = ke.rows();
 	const int M = ke.columns();
 
+	if (m_batomic == false)
+	{
+		// no other thread writes to these rows, so we can add the values directly
+		for (int i = 0; i<N; ++i)
+		{
+			if ((I = LMi[i]) >= 0)
+			{
+				const int* pi = m_pindices + (m_ppointers[I] - m_offset);
+				double* pd = m_pd + (m_ppointers[I] - m_offset);
+				const int* pe = pi + (m_ppointers[I + 1] - m_ppointers[I]);
+				for (int j = 0; j<M; ++j)
+				{
+					if ((J = LMj[j]) >= 0)
+					{
+						const int* pn = std::lower_bound(pi, pe, J + m_offset);
+						assert((pn != pe) && (*pn == J + m_offset));
+						pd[pn - pi] += ke[i][j];
+					}
+				}
+			}
+		}
+		return;
+	}
+
 	for (int i = 0; i<N; ++i)
 	{
 		if ((I = LMi[i]) >= 0)
@@ -558,7 +589,8 @@ void CCSSparseMatrix::Create(SparseMatrixProfile& mp)
 		}
 	}
 
-	int* pindices = new int[nsize];
+	int ncap = nsize + Slack()*nc;
+	int* pindices = new int[ncap];
 	int m = 0;
 	for (int i = 0; i <= nc; ++i)
 	{
@@ -591,10 +623,11 @@ void CCSSparseMatrix::Create(SparseMatrixProfile& mp)
 	}
 
 	// create the values array
-	double* pvalues = new double[nsize];
+	double* pvalues = new double[ncap];
 
 	// create the stiffness matrix
 	CompactMatrix::alloc(nr, nc, nsize, pvalues, pindices, pointers);
+	m_ncap = ncap;
 }
 
 //-----------------------------------------------------------------------------
@@ -633,8 +666,12 @@ void CCSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LM)
 			for (; n<l; ++n)
 				if (pi[n] == I)
 				{
+					if (m_batomic)
+					{
 #pragma omp atomic
-					pm[n] += ke[i][j];
+						pm[n] += ke[i][j];
+					}
+					else pm[n] += ke[i][j];
 					break;
 				}
 		}
@@ -649,6 +686,30 @@ void CCSSparseMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const v
 	const int N = ke.rows();
 	const int M = ke.columns();
 
+	if (m_batomic == false)
+	{
+		// no other thread writes to these columns, so we can add the values directly
+		for (int j = 0; j<M; ++j)
+		{
+			if ((J = LMj[j]) >= 0)
+			{
+				const int* pi = m_pindices + (m_ppointers[J] - m_offset);
+				double* pd = m_pd + (m_ppointers[J] - m_offset);
+				const int* pe = pi + (m_ppointers[J + 1] - m_ppointers[J]);
+				for (int i = 0; i<N; ++i)
+				{
+					if ((I = LMi[i]) >= 0)
+					{
+						const int* pn = std::lower_bound(pi, pe, I + m_offset);
+						assert((pn != pe) && (*pn == I + m_offset));
+						pd[pn - pi] += ke[i][j];
+					}
+				}
+			}
+		}
+		return;
+	}
+
 	for (int i = 0; i<N; ++i)
 	{
 		if ((I = LMi[i]) >= 0)
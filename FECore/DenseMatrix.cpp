@@ -102,7 +102,15 @@ void DenseMatrix::Assemble(const matrix& ke, const vector<int>& lm)
 		{
 			for (int j=0; j<M; ++j)
 			{
-				if ((J = lm[j]) >= 0) m_pr[I][J] += ke[i][j];
+				if ((J = lm[j]) >= 0)
+				{
+					if (m_batomic)
+					{
+#pragma omp atomic
+						m_pr[I][J] += ke[i][j];
+					}
+					else m_pr[I][J] += ke[i][j];
+				}
 			}
 		}
 	}
@@ -122,7 +130,15 @@ void DenseMatrix::Assemble(const matrix& ke, const vector<int>& LMi, const vecto
 		{
 			for (int j=0; j<M; ++j)
 			{
-				if ((J = LMj[j]) >= 0) m_pr[I][J] += ke[i][j];
+				if ((J = LMj[j]) >= 0)
+				{
+					if (m_batomic)
+					{
+#pragma omp atomic
+						m_pr[I][J] += ke[i][j];
+					}
+					else m_pr[I][J] += ke[i][j];
+				}
 			}
 		}
 	}
@@ -67,6 +67,7 @@ public:
 	bool check(int i, int j) override { return true; }
 	void add(int i, int j, double v) override { m_pr[i][j] += v; }
 	void set(int i, int j, double v) override { m_pr[i][j] = v; }
+	double get(int i, int j) override { return m_pr[i][j]; }
 	double diag(int i) override { return m_pr[i][i]; }
 
 protected:
@@ -0,0 +1,70 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "DumpBufferStream.h"
+#include <assert.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+DumpBufferStream::DumpBufferStream(FEModel& fem, std::vector<char>& buf) : DumpStream(fem), m_buf(buf)
+{
+	m_pos = 0;
+}
+
+//-----------------------------------------------------------------------------
+size_t DumpBufferStream::write(const void* pd, size_t size, size_t count)
+{
+	size_t n = size*count;
+	const char* pc = (const char*)pd;
+	m_buf.insert(m_buf.end(), pc, pc + n);
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+size_t DumpBufferStream::read(void* pd, size_t size, size_t count)
+{
+	size_t n = size*count;
+	assert(m_pos + n <= m_buf.size());
+	memcpy(pd, m_buf.data() + m_pos, n);
+	m_pos += n;
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+bool DumpBufferStream::EndOfStream() const
+{
+	return (m_pos >= m_buf.size());
+}
+
+//-----------------------------------------------------------------------------
+void DumpBufferStream::clear()
+{
+	m_buf.clear();
+	m_pos = 0;
+}
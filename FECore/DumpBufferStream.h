@@ -0,0 +1,51 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "DumpStream.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! A dump stream that stores its data in a buffer that is owned by the caller. 
+//! This allows the caller to keep the serialized state of an object (e.g. a block
+//! of elements, or a model state) and to reuse the buffer's memory between saves.
+class FECORE_API DumpBufferStream : public DumpStream
+{
+public:
+	DumpBufferStream(FEModel& fem, std::vector<char>& buf);
+
+public: // overloaded from base class
+	size_t write(const void* pd, size_t size, size_t count) override;
+	size_t read(void* pd, size_t size, size_t count) override;
+	bool EndOfStream() const override;
+	void clear() override;
+
+private:
+	std::vector<char>&	m_buf;	//!< the buffer
+	size_t				m_pos;	//!< read position
+};
@@ -36,6 +36,7 @@ DumpStream::DumpStream(FEModel& fem) : m_fem(fem)
 	m_bshallow = false;
 	m_bytes_serialized = 0;
 	m_ptr_lock = false;
+	m_bexcludeElemData = false;
 
 #ifndef NDEBUG
 	m_btypeInfo = false;
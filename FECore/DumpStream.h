@@ -146,6 +146,13 @@ public:
 	// see if the stream has type info
 	bool HasTypeInfo() const;
 
+	// Exclude the element data of domains from a shallow stream. This is used
+	// when the element data is serialized separately (see FEModelSnapshot).
+	void ExcludeElementData(bool b) { m_bexcludeElemData = b; }
+
+	// see if the element data is excluded
+	bool ElementDataExcluded() const { return m_bexcludeElemData; }
+
 	// return total nr of bytes that was serialized
 	size_t bytesSerialized() const { return m_bytes_serialized; }
 
@@ -191,6 +198,9 @@ public: // output operators
 
 	template <typename T> DumpStream& write_raw(const T& o);
 
+	// write an array of n values in the same format as a std::vector<T> of size n
+	template <typename T> DumpStream& write_array(T* d, int n);
+
 public: // input operators
 	DumpStream& operator >> (char* sz);
 	DumpStream& operator >> (double a[3][3]);
@@ -205,6 +215,12 @@ public: // input operators
 
 	template <typename T> DumpStream& read_raw(T& o);
 
+	// Read an array that was written with write_array (or as a std::vector<T>). 
+	// The size is read first, and then the values are read into storage provided
+	// by the caller, which must be large enough.
+	int read_array_size();
+	template <typename T> DumpStream& read_array(T* d, int n);
+
 private:
 	int FindPointer(void* p);
 	void AddPointer(void* p);
@@ -233,6 +249,7 @@ private:
 	bool		m_bsave;	//!< true if output stream, false for input stream
 	bool		m_bshallow;	//!< if true only shallow data needs to be serialized
 	bool		m_btypeInfo;	//!< write/read type info
+	bool		m_bexcludeElemData;	//!< exclude element data from shallow streams
 	FEModel&	m_fem;		//!< the FE Model that is being serialized
 
 	size_t	m_bytes_serialized;	//!< number or bytes serialized
@@ -373,6 +390,27 @@ template <> inline DumpStream& DumpStream::operator >> (std::vector<double>& o)
 	return This;
 }
 
+// byte buffers (e.g. serialized states) are written as a block
+template <> inline DumpStream& DumpStream::operator << (std::vector<char>& o)
+{
+	if (m_btypeInfo) writeType(TypeID::TYPE_UNKNOWN);
+	int N = (int)o.size();
+	m_bytes_serialized += write(&N, sizeof(int), 1);
+	if (N > 0) m_bytes_serialized += write(o.data(), sizeof(char), N);
+	return *this;
+}
+
+template <> inline DumpStream& DumpStream::operator >> (std::vector<char>& o)
+{
+	if (m_btypeInfo) readType(TypeID::TYPE_UNKNOWN);
+	DumpStream& This = *this;
+	int N = 0;
+	m_bytes_serialized += read(&N, sizeof(int), 1);
+	o.resize(N);
+	if (N > 0) m_bytes_serialized += read(o.data(), sizeof(char), N);
+	return This;
+}
+
 template <> inline DumpStream& DumpStream::operator << (std::vector<bool>& o)
 {
 	if (m_btypeInfo) writeType(TypeID::TYPE_UNKNOWN);
@@ -406,6 +444,42 @@ template <> inline DumpStream& DumpStream::operator >> (std::vector<bool>& o)
 	return This;
 }
 
+template <typename T> inline DumpStream& DumpStream::write_array(T* d, int n)
+{
+	if (m_btypeInfo) writeType(TypeID::TYPE_UNKNOWN);
+	m_bytes_serialized += write(&n, sizeof(int), 1);
+	for (int i = 0; i < n; ++i) (*this) << d[i];
+	return *this;
+}
+
+template <> inline DumpStream& DumpStream::write_array(double* d, int n)
+{
+	if (m_btypeInfo) writeType(TypeID::TYPE_UNKNOWN);
+	m_bytes_serialized += write(&n, sizeof(int), 1);
+	write(d, sizeof(double), n);
+	return *this;
+}
+
+inline int DumpStream::read_array_size()
+{
+	if (m_btypeInfo) readType(TypeID::TYPE_UNKNOWN);
+	int N = 0;
+	m_bytes_serialized += read(&N, sizeof(int), 1);
+	return N;
+}
+
+template <typename T> inline DumpStream& DumpStream::read_array(T* d, int n)
+{
+	for (int i = 0; i < n; ++i) (*this) >> d[i];
+	return *this;
+}
+
+template <> inline DumpStream& DumpStream::read_array(double* d, int n)
+{
+	if (n > 0) read(d, sizeof(double), n);
+	return *this;
+}
+
 template <typename A, typename B> DumpStream& DumpStream::operator << (std::map<A, B>& o)
 {
 	if (m_btypeInfo) writeType(TypeID::TYPE_UNKNOWN);
@@ -0,0 +1,367 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "EBEMatrix.h"
+#include "sys.h"
+
+//-----------------------------------------------------------------------------
+EBEMatrix::EBEMatrix(bool bsymm) : m_bsymm(bsymm)
+{
+	m_nrow = m_ncol = 0;
+	m_nsize = 0;
+	m_bdiag = false;
+	m_buf.resize(omp_get_max_threads());
+}
+
+//-----------------------------------------------------------------------------
+size_t EBEMatrix::Blocks() const
+{
+	size_t n = 0;
+	for (const Buffer& b : m_buf) n += b.blk.size();
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+size_t EBEMatrix::MemoryUsage() const
+{
+	size_t n = 0;
+	for (const Buffer& b : m_buf)
+	{
+		n += b.blk.capacity()*sizeof(Block);
+		n += b.ind.capacity()*sizeof(int);
+		n += b.val.capacity()*sizeof(double);
+	}
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::Create(SparseMatrixProfile& MP)
+{
+	Clear();
+	m_nrow = MP.Rows();
+	m_ncol = MP.Columns();
+}
+
+//-----------------------------------------------------------------------------
+// keep the capacity of a buffer close to the size that was last used
+template <typename T> static void trim(std::vector<T>& v)
+{
+	if (v.capacity() > v.size() + v.size() / 8)
+	{
+		std::vector<T> tmp;
+		tmp.reserve(v.size());
+		v.swap(tmp);
+	}
+	else v.clear();
+}
+
+//-----------------------------------------------------------------------------
+// The allocated memory is kept, since the same element matrices are usually
+// assembled again.
+void EBEMatrix::Zero()
+{
+	for (Buffer& b : m_buf)
+	{
+		trim(b.blk);
+		trim(b.ind);
+		trim(b.val);
+	}
+	m_entry.clear();
+	m_bdiag = false;
+	m_nsize = 0;
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::Clear()
+{
+	for (Buffer& b : m_buf)
+	{
+		std::vector<Block>().swap(b.blk);
+		std::vector<int>().swap(b.ind);
+		std::vector<double>().swap(b.val);
+	}
+	m_entry.clear();
+	std::vector<double>().swap(m_diag);
+	m_tmp.clear();
+	m_bdiag = false;
+	m_nsize = 0;
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::Assemble(const matrix& ke, const std::vector<int>& lm)
+{
+	Assemble(ke, lm, lm);
+}
+
+//-----------------------------------------------------------------------------
+// Stores the rows and columns of the element matrix that belong to equations. 
+// Symmetric element matrices of a symmetric matrix are stored as (lower) triangles.
+// For other element matrices of a symmetric matrix only the entries of the lower 
+// triangle of the global matrix are used (as in CompactSymmMatrix).
+void EBEMatrix::Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj)
+{
+	int N = ke.rows();
+	int M = ke.columns();
+
+	// the equations of this element matrix
+	int ri[256], cj[256];
+	std::vector<int> rv, cv;
+	int* r = ri; int* c = cj;
+	if ((N > 256) || (M > 256)) { rv.resize(N); cv.resize(M); r = &rv[0]; c = &cv[0]; }
+	int nr = 0, nc = 0;
+	for (int i = 0; i < N; ++i) if ((lmi[i] >= 0) && (lmi[i] < m_nrow)) r[nr++] = i;
+	for (int j = 0; j < M; ++j) if ((lmj[j] >= 0) && (lmj[j] < m_ncol)) c[nc++] = j;
+	if ((nr == 0) || (nc == 0)) return;
+
+	int nt = omp_get_thread_num();
+	assert(nt < (int)m_buf.size());
+	Buffer& B = m_buf[nt];
+
+	Block b;
+	b.nr = nr;
+	b.ind = B.ind.size();
+	b.val = B.val.size();
+	if (m_bsymm && (N == M) && ((&lmi == &lmj) || (lmi == lmj)))
+	{
+		b.nc = 0;
+		for (int i = 0; i < nr; ++i) B.ind.push_back(lmi[r[i]]);
+		for (int i = 0; i < nr; ++i)
+		{
+			int I = lmi[r[i]];
+			for (int j = 0; j <= i; ++j)
+			{
+				int J = lmi[r[j]];
+				B.val.push_back(I >= J ? ke[r[i]][r[j]] : ke[r[j]][r[i]]);
+			}
+		}
+	}
+	else
+	{
+		b.nc = nc;
+		for (int i = 0; i < nr; ++i) B.ind.push_back(lmi[r[i]]);
+		for (int j = 0; j < nc; ++j) B.ind.push_back(lmj[c[j]]);
+		for (int i = 0; i < nr; ++i)
+		{
+			int I = lmi[r[i]];
+			for (int j = 0; j < nc; ++j)
+			{
+				int J = lmj[c[j]];
+				B.val.push_back((m_bsymm == false) || (I >= J) ? ke[r[i]][c[j]] : 0.0);
+			}
+		}
+	}
+	B.blk.push_back(b);
+}
+
+//-----------------------------------------------------------------------------
+bool EBEMatrix::check(int i, int j)
+{
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::set(int i, int j, double v)
+{
+	if (m_bsymm && (i < j)) std::swap(i, j);
+#pragma omp critical (EBE_entry)
+	m_entry[std::pair<int, int>(i, j)] = v;
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::add(int i, int j, double v)
+{
+	if (m_bsymm && (i < j)) std::swap(i, j);
+#pragma omp critical (EBE_entry)
+	m_entry[std::pair<int, int>(i, j)] += v;
+}
+
+//-----------------------------------------------------------------------------
+double EBEMatrix::get(int i, int j)
+{
+	if (m_bsymm && (i < j)) std::swap(i, j);
+	double v = 0.0;
+	for (const Buffer& B : m_buf)
+	{
+		for (const Block& b : B.blk)
+		{
+			const int* ind = &B.ind[b.ind];
+			const double* val = &B.val[b.val];
+			if (b.nc == 0)
+			{
+				for (int k = 0; k < b.nr; ++k)
+					for (int l = 0; l <= k; ++l, ++val)
+					{
+						int I = ind[k], J = ind[l];
+						if (I < J) std::swap(I, J);
+						if ((I == i) && (J == j)) v += *val;
+					}
+			}
+			else
+			{
+				for (int k = 0; k < b.nr; ++k)
+					for (int l = 0; l < b.nc; ++l, ++val)
+					{
+						int I = ind[k], J = ind[b.nr + l];
+						if (m_bsymm && (I < J)) std::swap(I, J);
+						if ((I == i) && (J == j)) v += *val;
+					}
+			}
+		}
+	}
+	auto it = m_entry.find(std::pair<int, int>(i, j));
+	if (it != m_entry.end()) v += it->second;
+	return v;
+}
+
+//-----------------------------------------------------------------------------
+void EBEMatrix::BuildDiagonal()
+{
+	m_diag.assign(m_nrow, 0.0);
+	for (const Buffer& B : m_buf)
+	{
+		for (const Block& b : B.blk)
+		{
+			const int* ind = &B.ind[b.ind];
+			const double* val = &B.val[b.val];
+			if (b.nc == 0)
+			{
+				// An lm array can contain the same equation more than once, so all entries 
+				// that map to a diagonal entry are added. The off-diagonal entries of the 
+				// lower triangle are also used for the upper triangle, so they count twice.
+				for (int k = 0; k < b.nr; ++k, ++val)
+				{
+					for (int l = 0; l < k; ++l, ++val)
+						if (ind[l] == ind[k]) m_diag[ind[k]] += 2.0*(*val);
+					m_diag[ind[k]] += *val;
+				}
+			}
+			else
+			{
+				for (int k = 0; k < b.nr; ++k)
+					for (int l = 0; l < b.nc; ++l)
+						if (ind[k] == ind[b.nr + l]) m_diag[ind[k]] += val[k*b.nc + l];
+			}
+		}
+	}
+	for (auto& it : m_entry)
+	{
+		if (it.first.first == it.first.second) m_diag[it.first.first] += it.second;
+	}
+	m_bdiag = true;
+}
+
+//-----------------------------------------------------------------------------
+double EBEMatrix::diag(int i)
+{
+	if (m_bdiag == false) BuildDiagonal();
+	return m_diag[i];
+}
+
+//-----------------------------------------------------------------------------
+// r = A*x. Each thread accumulates the products of a part of the element matrices
+// in its own vector, and these are added at the end.
+bool EBEMatrix::mult_vector(double* x, double* r)
+{
+	const int N = m_nrow;
+	const bool bsymm = m_bsymm;
+	int NT = omp_get_max_threads();
+	if ((int)m_tmp.size() < NT) m_tmp.resize(NT);
+
+#pragma omp parallel
+	{
+		int nt = omp_get_thread_num();
+		int nthreads = omp_get_num_threads();
+		std::vector<double>& y = m_tmp[nt];
+		y.assign(N, 0.0);
+
+		for (const Buffer& B : m_buf)
+		{
+			int NB = (int)B.blk.size();
+#pragma omp for schedule(dynamic, 64) nowait
+			for (int n = 0; n < NB; ++n)
+			{
+				const Block& b = B.blk[n];
+				const int* ind = &B.ind[b.ind];
+				const double* val = &B.val[b.val];
+				if (b.nc == 0)
+				{
+					for (int k = 0; k < b.nr; ++k)
+					{
+						int I = ind[k];
+						double xI = x[I], s = 0.0;
+						for (int l = 0; l < k; ++l, ++val)
+						{
+							s += (*val)*x[ind[l]];
+							y[ind[l]] += (*val)*xI;
+						}
+						y[I] += s + (*val)*xI;
+						++val;
+					}
+				}
+				else
+				{
+					const int* col = ind + b.nr;
+					for (int k = 0; k < b.nr; ++k)
+					{
+						int I = ind[k];
+						double s = 0.0;
+						for (int l = 0; l < b.nc; ++l) s += val[l] * x[col[l]];
+						if (bsymm)
+						{
+							for (int l = 0; l < b.nc; ++l) if (col[l] != I) y[col[l]] += val[l] * x[I];
+						}
+						y[I] += s;
+						val += b.nc;
+					}
+				}
+			}
+		}
+
+#pragma omp barrier
+
+		// add the thread contributions
+#pragma omp for schedule(static)
+		for (int i = 0; i < N; ++i)
+		{
+			double s = 0.0;
+			for (int t = 0; t < nthreads; ++t) s += m_tmp[t][i];
+			r[i] = s;
+		}
+	}
+
+	// individual entries
+	for (auto& it : m_entry)
+	{
+		int i = it.first.first, j = it.first.second;
+		r[i] += it.second*x[j];
+		if (bsymm && (i != j)) r[j] += it.second*x[i];
+	}
+
+	return true;
+}
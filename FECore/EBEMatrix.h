@@ -0,0 +1,116 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "SparseMatrix.h"
+#include <map>
+
+//-----------------------------------------------------------------------------
+// Element-by-element (EBE) matrix. This class stores the element matrices that are
+// assembled into it, instead of the global matrix, and evaluates matrix-vector 
+// products element by element. It can replace an assembled sparse matrix for 
+// iterative solvers that only need products and the diagonal (e.g. with a Jacobi or
+// Chebyshev preconditioner). For high-order elements this needs less memory than
+// a compact matrix, since no index data is stored per entry, and symmetric element
+// matrices are stored as triangles.
+class FECORE_API EBEMatrix : public SparseMatrix
+{
+	// An assembled element matrix. A block with nc == 0 is a symmetric matrix, 
+	// of which only the lower triangle (row by row) is stored.
+	struct Block
+	{
+		int		nr, nc;		// number of rows and columns
+		size_t	ind;		// offset of the equation numbers (rows, then columns)
+		size_t	val;		// offset of the values
+	};
+
+	// element matrices assembled by one thread
+	struct Buffer
+	{
+		std::vector<Block>	blk;
+		std::vector<int>	ind;
+		std::vector<double>	val;
+	};
+
+public:
+	EBEMatrix(bool bsymm);
+
+	//! multiply with vector
+	bool mult_vector(double* x, double* r) override;
+
+	//! is the matrix symmetric
+	bool isSymmetric() const { return m_bsymm; }
+
+	//! number of stored element matrices
+	size_t Blocks() const;
+
+	//! memory (in bytes) used for storing the element matrices
+	size_t MemoryUsage() const;
+
+public:
+	//! set all matrix elements to zero
+	void Zero() override;
+
+	//! Create the matrix. Only the matrix size is taken from the profile.
+	void Create(SparseMatrixProfile& MP) override;
+
+	//! store an element matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lm) override;
+
+	//! store an element matrix
+	void Assemble(const matrix& ke, const std::vector<int>& lmi, const std::vector<int>& lmj) override;
+
+	//! entries can always be added
+	bool check(int i, int j) override;
+
+	//! set entry to value (only for entries that do not get element contributions)
+	void set(int i, int j, double v) override;
+
+	//! add value to entry
+	void add(int i, int j, double v) override;
+
+	//! retrieve value (this is slow)
+	double get(int i, int j) override;
+
+	//! get the diagonal value
+	double diag(int i) override;
+
+	//! release memory for storing data
+	void Clear() override;
+
+private:
+	void BuildDiagonal();
+
+private:
+	bool	m_bsymm;		//!< symmetric matrix flag
+	std::vector<Buffer>		m_buf;		//!< element matrices (one buffer per thread)
+	std::map<std::pair<int, int>, double>	m_entry;	//!< values that were added individually
+	std::vector<double>		m_diag;		//!< diagonal
+	bool					m_bdiag;	//!< diagonal is up to date
+	std::vector< std::vector<double> >	m_tmp;	//!< thread-local products
+};
@@ -41,18 +41,56 @@ FEClosestPointProjection::FEClosestPointProjection(FESurface& s) : m_surf(s)
 	m_bspecial = false;
 	m_projectBoundary = false;
 
-	// calculate node-element list
-	m_NEL.Create(m_surf);
-	m_EEL.Create(&m_surf);
+	// the lists are built in Init
+	m_nelems = -1;
+	m_stamp = 0;
+}
+
+//-----------------------------------------------------------------------------
+// Calculate a stamp of the surface's connectivity. This includes the address of 
+// the element storage, since the node-element and element-element lists store 
+// element pointers, which become invalid when the surface is re-created (e.g. 
+// after a remesh), even if the connectivity didn't change.
+unsigned long long FEClosestPointProjection::SurfaceStamp() const
+{
+	// FNV-1a
+	const unsigned long long prime = 1099511628211ULL;
+	unsigned long long h = 14695981039346656037ULL;
+	auto mix = [&](unsigned long long v) { h ^= v; h *= prime; };
+
+	int NE = m_surf.Elements();
+	mix((unsigned long long)NE);
+	mix((unsigned long long)m_surf.Nodes());
+	if (NE > 0) mix((unsigned long long)(size_t)(&m_surf.Element(0)));
+	for (int i = 0; i < NE; ++i)
+	{
+		const FESurfaceElement& el = m_surf.Element(i);
+		int ne = el.Nodes();
+		mix((unsigned long long)ne);
+		for (int j = 0; j < ne; ++j) mix((unsigned long long)el.m_lnode[j]);
+	}
+	return h;
 }
 
 //-----------------------------------------------------------------------------
 //! Initialization of data structures
 bool FEClosestPointProjection::Init()
 {
-	// initialize the nearest neighbor search
-	m_SNQ.Attach(&m_surf);
-	m_SNQ.Init();
+	// (re-)build the node-element and element-element lists and the search tree 
+	// if this is the first call or if the surface has changed since the last call.
+	// Otherwise, we only need to update the tree with the current nodal positions.
+	int NE = m_surf.Elements();
+	unsigned long long stamp = SurfaceStamp();
+	if ((NE != m_nelems) || (stamp != m_stamp) || (m_bvh.IsValid() == false))
+	{
+		m_NEL.Create(m_surf);
+		if (NE > 0) m_EEL.Create(&m_surf);
+		m_bvh.Create(&m_surf);
+
+		m_nelems = NE;
+		m_stamp = stamp;
+	}
+	else m_bvh.Refit();
 
 	return true;
 }
@@ -169,7 +207,7 @@ FESurfaceElement* FEClosestPointProjection::Project(const vec3d& x, vec3d& q, ve
 	FEMesh& mesh = *m_surf.GetMesh();
 
 	// let's find the closest node
-	int mn = m_SNQ.Find(x);
+	int mn = m_bvh.FindClosestNode(x);
 	if (mn < 0) return nullptr;
 
 	// make sure it is within the search radius
@@ -218,40 +256,16 @@ FESurfaceElement* FEClosestPointProjection::Project(int nodeIndex, vec3d& q, vec
 	// Find the closest surface node to x that:
 	// 1. is within the search radius
 	// 2. its star does not contain n
-	int mn = -1;	// local index of closest node
-	double d2min;	// min squared distance
-	int N = m_surf.Nodes();
 	double R2 = m_rad * m_rad;
-	for (int i = 0; i < N; ++i)
-	{
-		if (m_surf.NodeIndex(i) != nodeIndex)
-		{
-			vec3d r = m_surf.Node(i).m_rt;
-			double d2 = (r - x)*(r - x);
-
-			// make sure the node lies within the search radius
-			if ((m_rad == 0) || (d2 <= R2))
-			{
-				bool bok = true;
+	int mn = m_bvh.FindClosestNode(x, R2, [&](int i) {
+		if (m_surf.NodeIndex(i) == nodeIndex) return false;
 
-				// The node cannot be part of the star of the closest point
-				FEPatch patch(&m_surf, m_NEL.ElementList(i), m_NEL.Valence(i));
-				if (patch.HasNode(nodeIndex))
-				{
-					bok = false;
-				}
-
-				// make sure the point is closer than the last one
-				if (bok && ((mn == -1) || (d2 < d2min)))
-				{
-					d2min = d2;
-					mn = i;
-					q = r;
-				}
-			}
-		}
-	}
+		// The node cannot be part of the star of the closest point
+		FEPatch patch(&m_surf, m_NEL.ElementList(i), m_NEL.Valence(i));
+		return (patch.HasNode(nodeIndex) == false);
+	});
 	if (mn == -1) return nullptr;
+	q = m_surf.Node(mn).m_rt;
 
 	// now that we found the closest node, lets see if we can find 
 	// the best element
@@ -299,38 +313,16 @@ FESurfaceElement* FEClosestPointProjection::Project(FESurfaceElement* pse, int i
 	}
 
 	// find the closest point
-	int mn = -1;
-	double d2min;
 	double R2 = m_rad * m_rad;
-	int N = m_surf.Nodes();
-	for (int i = 0; i < N; ++i)
-	{
-		vec3d ri = m_surf.Node(i).m_rt;
-		double d2 = (ri - x)*(ri - x);
-
-		// make sure the node lies within the search radius
-		if ((R2 == 0) || (d2 <= R2))
-		{
-			bool bok = true;
-			if (check_self_projection)
-			{
-				// The pse element cannot be part of the star of the closest point
-				FEPatch patch(&m_surf, m_NEL.ElementList(i), m_NEL.Valence(i));
-				if (patch.Contains(*pse))
-				{
-					bok = false;
-				}
-			}
+	int mn = m_bvh.FindClosestNode(x, R2, [&](int i) {
+		if (check_self_projection == false) return true;
 
-			if (bok && ((mn == -1) || (d2 < d2min)))
-			{
-				d2min = d2;
-				mn = i;
-				q = ri;
-			}
-		}
-	}
+		// The pse element cannot be part of the star of the closest point
+		FEPatch patch(&m_surf, m_NEL.ElementList(i), m_NEL.Valence(i));
+		return (patch.Contains(*pse) == false);
+	});
 	if (mn == -1) return nullptr;
+	q = m_surf.Node(mn).m_rt;
 
 	// mn is a local index, so get the global node number too
 	int m = m_surf.NodeIndex(mn);
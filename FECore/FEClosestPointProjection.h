@@ -28,13 +28,14 @@ SOFTWARE.*/
 
 #pragma once
 #include "FESurface.h"
-#include "FENNQuery.h"
+#include "FESurfaceBVH.h"
 #include "FEElemElemList.h"
 #include "FENodeElemList.h"
 
 //-----------------------------------------------------------------------------
 // This class can be used to find the closest point projection of a point
-// onto a surface.
+// onto a surface. After Init() is called, the Project functions do not modify
+// the object, so they can be called from multiple threads.
 class FECORE_API FEClosestPointProjection
 {
 public:
@@ -71,6 +72,7 @@ public:
 
 private:
 	bool ContainsElement(FESurfaceElement* el);
+	unsigned long long SurfaceStamp() const;
 	FESurfaceElement* ProjectSpecial(int closestPoint, const vec3d& x, vec3d& q, vec2d& r);
 
 protected:
@@ -81,7 +83,10 @@ protected:
 
 protected:
 	FESurface&		m_surf;		//!< reference to surface
-	FENNQuery		m_SNQ;		//!< used to find the nearest neighbour
+	FESurfaceBVH	m_bvh;		//!< used to find the nearest neighbour
 	FENodeElemList	m_NEL;		//!< node-element tree
 	FEElemElemList	m_EEL;		//!< element neighbor list
+
+	int					m_nelems;	//!< number of surface elements when the lists were built
+	unsigned long long	m_stamp;	//!< connectivity stamp of the surface when the lists were built
 };
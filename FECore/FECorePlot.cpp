@@ -317,7 +317,29 @@ bool FEPlotParameter::Save(FEDomain& dom, FEDataStream& a)
 				}
 			}
 
-			writeNodalProjectedElementValues<double>(sd, a, mapDouble);
+			// evaluate the parameter at all the integration points of the domain at once, 
+			// so that math expressions can use their batch evaluation
+			int NE = sd.Elements();
+			vector<const FEMaterialPoint*> pts;
+			for (int i = 0; i < NE; ++i)
+			{
+				FEElement& e = sd.ElementRef(i);
+				for (int k = 0; k < e.GaussPoints(); ++k) pts.push_back(e.GetMaterialPoint(k));
+			}
+			vector<double> vals(pts.size());
+			if (pts.empty() == false) mapDouble.values(&pts[0], (int)pts.size(), &vals[0]);
+
+			// project to nodes
+			double sn[FEElement::MAX_NODES];
+			int m = 0;
+			for (int i = 0; i < NE; ++i)
+			{
+				FEElement& e = sd.ElementRef(i);
+				e.project_to_nodes(&vals[m], sn);
+				m += e.GaussPoints();
+
+				for (int j = 0; j < e.Nodes(); ++j) a << sn[j];
+			}
 		}
 		else if (m_param.type() == FE_PARAM_VEC3D_MAPPED)
 		{
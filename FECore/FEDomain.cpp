@@ -60,12 +60,27 @@ void FEDomain::CreateMaterialPointData()
 	if (m_matAxis) m_matAxis->Init();
 
 	FEMaterial* pmat = GetMaterial();
+	if (pmat == nullptr) return;
+
+	// This function can be called more than once (e.g. after a remesh). Since memory
+	// cannot be returned to the arena, we delete the existing material point data and
+	// reset the arena, so that the old points don't accumulate.
+	int NE = Elements();
+	for (int i = 0; i < NE; ++i) ElementRef(i).ClearData();
+	m_arena.Clear();
+
+	// The material point data is allocated from the domain's arena, in element order, 
+	// so that the data of consecutive integration points is contiguous in memory.
+	// This is why the loop is not done in parallel.
+	FEMemoryArena::Scope scope(&m_arena);
 	FEMesh* mesh = GetMesh();
-	if (pmat) ForEachElement([=](FEElement& el) {
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = ElementRef(i);
 
 		vec3d r[FEElement::MAX_NODES];
 		int ne = el.Nodes();
-		for (int i = 0; i < ne; ++i) r[i] = mesh->Node(el.m_node[i]).m_r0;
+		for (int j = 0; j < ne; ++j) r[j] = mesh->Node(el.m_node[j]).m_r0;
 
 		for (int k = 0; k < el.GaussPoints(); ++k)
 		{
@@ -76,7 +91,7 @@ void FEDomain::CreateMaterialPointData()
 			mp->m_index = k;
 			el.SetMaterialPointData(mp, k);
 		}
-	});
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -87,14 +102,7 @@ void FEDomain::Serialize(DumpStream& ar)
 
 	if (ar.IsShallow())
 	{
-		int NEL = Elements();
-		for (int i = 0; i < NEL; ++i)
-		{
-			FEElement& el = ElementRef(i);
-			el.Serialize(ar);
-			int nint = el.GaussPoints();
-			for (int j = 0; j < nint; ++j) el.GetMaterialPoint(j)->Serialize(ar);
-		}
+		if (ar.ElementDataExcluded() == false) SerializeElementData(ar, 0, Elements());
 	}
 	else
 	{
@@ -124,6 +132,7 @@ void FEDomain::Serialize(DumpStream& ar)
 			int NEL = 0;
 			ar >> NEL;
 			Create(NEL, espec);
+			FEMemoryArena::Scope scope(&m_arena);
 			for (int i = 0; i < NEL; ++i)
 			{
 				FEElement& el = ElementRef(i);
@@ -140,6 +149,19 @@ void FEDomain::Serialize(DumpStream& ar)
 	}
 }
 
+//-----------------------------------------------------------------------------
+void FEDomain::SerializeElementData(DumpStream& ar, int first, int last)
+{
+	assert(ar.IsShallow());
+	for (int i = first; i < last; ++i)
+	{
+		FEElement& el = ElementRef(i);
+		el.Serialize(ar);
+		int nint = el.GaussPoints();
+		for (int j = 0; j < nint; ++j) el.GetMaterialPoint(j)->Serialize(ar);
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! Unpack the LM data for an element of this domain
 void FEDomain::UnpackLM(FEElement& el, vector<int>& lm)
@@ -160,6 +182,12 @@ void FEDomain::IncrementalUpdate(std::vector<double>& ui, bool finalFlag)
 
 }
 
+//-----------------------------------------------------------------------------
+void FEDomain::BuildElementColoring()
+{
+	m_coloring.Create(*this);
+}
+
 //-----------------------------------------------------------------------------
 // This is the default packing method. 
 // It stores all the degrees of freedom for the first node in the order defined
@@ -174,7 +202,7 @@ void FEDomain::UnpackLM(FEElement& el, const FEDofList& dof, vector<int>& lm)
 	{
 		int n = el.m_node[i];
 		FENode& node = mesh->Node(n);
-		vector<int>& id = node.m_ID;
+		FENodeDofArray<int>& id = node.m_ID;
 		for (int j = 0; j<ndofs; ++j) lm[i*ndofs + j] = id[dof[j]];
 	}
 }
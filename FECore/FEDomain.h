@@ -29,6 +29,8 @@ SOFTWARE.*/
 #pragma once
 #include "FEMeshPartition.h"
 #include "FEMat3dValuator.h"
+#include "FEElementColoring.h"
+#include "FEMemoryArena.h"
 
 // forward declaration of material class
 class FEMaterial;
@@ -57,6 +59,10 @@ public:
 	// serialization
 	void Serialize(DumpStream& ar) override;
 
+	//! Serialize the element and material point data of the elements in the range [first, last).
+	//! This is only used for shallow archives.
+	void SerializeElementData(DumpStream& ar, int first, int last);
+
 	//! augmentation
 	// NOTE: This is here so that the FESolver can do the augmentations
 	// for the 3-field hex/shell domains.
@@ -83,6 +89,13 @@ public:
 	//! indicates whether it is safe to commit the updates.
 	virtual void IncrementalUpdate(std::vector<double>& ui, bool finalFlag);
 
+public:
+	//! build the element coloring (used for lock-free assembly)
+	void BuildElementColoring();
+
+	//! get the element coloring
+	const FEElementColoring& ElementColoring() const { return m_coloring; }
+
 protected:
 	// helper function for activating dof lists
 	void Activate(const FEDofList& dof);
@@ -92,4 +105,8 @@ protected:
 
 protected:
 	FEMat3dValuator* m_matAxis; // initial material axis
+
+	FEElementColoring	m_coloring;	// element coloring
+
+	FEMemoryArena	m_arena;	// storage for the material point data
 };
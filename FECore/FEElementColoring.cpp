@@ -0,0 +1,109 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEElementColoring.h"
+#include "FEMeshPartition.h"
+#include "FEMesh.h"
+
+//-----------------------------------------------------------------------------
+FEElementColoring::FEElementColoring()
+{
+}
+
+//-----------------------------------------------------------------------------
+void FEElementColoring::Clear()
+{
+	m_pc.clear();
+	m_elem.clear();
+}
+
+//-----------------------------------------------------------------------------
+// This uses a greedy coloring: each element gets the lowest color that is not
+// yet used by any of the elements it shares a node with. For typical meshes this
+// gives about 8 (hex) to 30 (tet) colors.
+void FEElementColoring::Create(FEMeshPartition& dom)
+{
+	Clear();
+
+	int NE = dom.Elements();
+	if (NE == 0) return;
+
+	// build the node-element list for this partition
+	int NN = dom.GetMesh()->Nodes();
+	std::vector<int> val(NN + 1, 0);
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = dom.ElementRef(i);
+		for (int j = 0; j < el.Nodes(); ++j) val[el.m_node[j] + 1]++;
+	}
+	for (int i = 0; i < NN; ++i) val[i + 1] += val[i];
+
+	std::vector<int> nel(val[NN]);
+	std::vector<int> pos(val.begin(), val.end() - 1);
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = dom.ElementRef(i);
+		for (int j = 0; j < el.Nodes(); ++j) nel[pos[el.m_node[j]]++] = i;
+	}
+
+	// assign colors
+	std::vector<int> color(NE, -1);
+	std::vector<int> tag;	// tag[c] == i if color c is used by a neighbor of element i
+	int ncolors = 0;
+	for (int i = 0; i < NE; ++i)
+	{
+		FEElement& el = dom.ElementRef(i);
+		for (int j = 0; j < el.Nodes(); ++j)
+		{
+			int nj = el.m_node[j];
+			for (int k = val[nj]; k < val[nj + 1]; ++k)
+			{
+				int c = color[nel[k]];
+				if (c >= 0) tag[c] = i;
+			}
+		}
+
+		int c = 0;
+		while ((c < ncolors) && (tag[c] == i)) ++c;
+		if (c == ncolors)
+		{
+			ncolors++;
+			tag.push_back(-1);
+		}
+		color[i] = c;
+	}
+
+	// sort the elements by color
+	m_pc.assign(ncolors + 1, 0);
+	for (int i = 0; i < NE; ++i) m_pc[color[i] + 1]++;
+	for (int i = 0; i < ncolors; ++i) m_pc[i + 1] += m_pc[i];
+
+	m_elem.resize(NE);
+	pos.assign(m_pc.begin(), m_pc.end() - 1);
+	for (int i = 0; i < NE; ++i) m_elem[pos[color[i]]++] = i;
+}
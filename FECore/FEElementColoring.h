@@ -0,0 +1,66 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+
+class FEMeshPartition;
+
+//-----------------------------------------------------------------------------
+//! The FEElementColoring class partitions the elements of a mesh partition into
+//! groups ("colors") such that no two elements of the same color share a node.
+//! Elements of the same color can therefore be assembled concurrently without 
+//! any synchronization, since they never scatter into the same rows or columns
+//! of the global matrix.
+class FECORE_API FEElementColoring
+{
+public:
+	FEElementColoring();
+
+	//! build the coloring for the elements of a mesh partition
+	void Create(FEMeshPartition& dom);
+
+	//! clear the coloring
+	void Clear();
+
+	//! number of colors
+	int Colors() const { return (m_pc.empty() ? 0 : (int)m_pc.size() - 1); }
+
+	//! number of elements of a color
+	int Elements(int color) const { return m_pc[color + 1] - m_pc[color]; }
+
+	//! the (local) element indices of a color
+	const int* ElementList(int color) const { return &m_elem[0] + m_pc[color]; }
+
+	//! total number of elements that were colored
+	int TotalElements() const { return (int)m_elem.size(); }
+
+private:
+	std::vector<int>	m_pc;	//!< start index of each color into the m_elem array
+	std::vector<int>	m_elem;	//!< element indices, sorted by color
+};
@@ -0,0 +1,1012 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FEFillReducingOrdering.h"
+#include "MatrixProfile.h"
+#include "FENodeNodeList.h"
+#include <algorithm>
+#include <queue>
+#include <assert.h>
+using namespace std;
+
+//=============================================================================
+// Helper structures and functions. All graphs are stored in compressed row 
+// format, are symmetric and do not contain self-loops.
+//=============================================================================
+struct FEOrderingGraph
+{
+	int			n = 0;
+	vector<int>	xadj;	// adjacency pointers
+	vector<int>	adj;	// adjacency list
+	vector<int>	ewgt;	// edge weights
+	vector<int>	vwgt;	// vertex weights
+
+	int TotalWeight() const
+	{
+		int w = 0;
+		for (int i = 0; i < n; ++i) w += vwgt[i];
+		return w;
+	}
+};
+
+//-----------------------------------------------------------------------------
+// simple deterministic random number generator, so that orderings are reproducible
+class FEOrderingRandom
+{
+public:
+	FEOrderingRandom(unsigned int seed = 12345u) : m_state(seed) {}
+	int operator () (int n) 
+	{ 
+		m_state = m_state * 1103515245u + 12345u;
+		return (int)((m_state >> 8) % (unsigned int)n);
+	}
+
+	void Shuffle(vector<int>& v)
+	{
+		for (int i = (int)v.size() - 1; i > 0; --i) std::swap(v[i], v[(*this)(i + 1)]);
+	}
+
+private:
+	unsigned int m_state;
+};
+
+//-----------------------------------------------------------------------------
+// Merge vertices that have the same adjacency (including the vertex itself). The
+// vertex weights of the compressed graph are the nr of merged vertices.
+static void CompressGraph(int n, const vector<int>& xadj, const vector<int>& adj, FEOrderingGraph& cg, vector<int>& group)
+{
+	vector<int> hash(n), order(n);
+	group.assign(n, -1);
+	for (int i = 0; i < n; ++i)
+	{
+		unsigned int h = i;
+		for (int k = xadj[i]; k < xadj[i + 1]; ++k) h += adj[k];
+		hash[i] = (int)(h & 0x7FFFFFFF);
+		order[i] = i;
+	}
+	std::sort(order.begin(), order.end(), [&](int a, int b) {
+		if (hash[a] != hash[b]) return hash[a] < hash[b];
+		int da = xadj[a + 1] - xadj[a];
+		int db = xadj[b + 1] - xadj[b];
+		if (da != db) return da < db;
+		return a < b;
+	});
+
+	vector<int> mark(n, -1);
+	vector<int> rep;	// representative of each group
+	int ng = 0;
+	for (int i0 = 0; i0 < n;)
+	{
+		int a = order[i0];
+		int i1 = i0 + 1;
+		while ((i1 < n) && (hash[order[i1]] == hash[a]) && (xadj[order[i1] + 1] - xadj[order[i1]] == xadj[a + 1] - xadj[a])) i1++;
+
+		// compare all vertices in this run
+		for (int k = i0; k < i1; ++k)
+		{
+			int p = order[k];
+			if (group[p] >= 0) continue;
+			group[p] = ng;
+			rep.push_back(p);
+			if (k + 1 < i1)
+			{
+				mark[p] = p;
+				for (int l = xadj[p]; l < xadj[p + 1]; ++l) mark[adj[l]] = p;
+				for (int m = k + 1; m < i1; ++m)
+				{
+					int q = order[m];
+					if ((group[q] >= 0) || (mark[q] != p)) continue;
+					bool bsame = true;
+					for (int l = xadj[q]; l < xadj[q + 1]; ++l)
+					{
+						if (mark[adj[l]] != p) { bsame = false; break; }
+					}
+					if (bsame) group[q] = ng;
+				}
+			}
+			ng++;
+		}
+		i0 = i1;
+	}
+
+	// build the compressed graph
+	cg.n = ng;
+	cg.vwgt.assign(ng, 0);
+	for (int i = 0; i < n; ++i) cg.vwgt[group[i]]++;
+
+	cg.xadj.assign(ng + 1, 0);
+	cg.adj.clear();
+	mark.assign(ng, -1);
+	for (int g = 0; g < ng; ++g)
+	{
+		int p = rep[g];
+		mark[g] = g;
+		for (int k = xadj[p]; k < xadj[p + 1]; ++k)
+		{
+			int h = group[adj[k]];
+			if (mark[h] != g) { mark[h] = g; cg.adj.push_back(h); }
+		}
+		cg.xadj[g + 1] = (int)cg.adj.size();
+	}
+	cg.ewgt.assign(cg.adj.size(), 1);
+}
+
+//-----------------------------------------------------------------------------
+// Approximate minimum degree ordering on a quotient graph. The degrees are 
+// weighted by the vertex weights. 
+static void MinimumDegree(const FEOrderingGraph& G, vector<int>& order)
+{
+	const int ng = G.n;
+	order.clear();
+	if (ng == 0) return;
+	order.reserve(ng);
+
+	const vector<int>& nv = G.vwgt;
+	int ntot = G.TotalWeight();
+
+	// variables and elements
+	vector< vector<int> > av(ng), ae(ng), le(ng);
+	for (int i = 0; i < ng; ++i) av[i].assign(G.adj.begin() + G.xadj[i], G.adj.begin() + G.xadj[i + 1]);
+
+	// state: 0 = variable, 1 = element, 2 = absorbed element
+	vector<char> state(ng, 0);
+	vector<int> deg(ng, 0), ew(ng, 0), w(ng, 0), wflag(ng, -1), mark(ng, -1);
+
+	// degree lists
+	vector<int> head(ntot + 1, -1), next(ng, -1), prev(ng, -1);
+	auto insert = [&](int i) {
+		int d = deg[i];
+		next[i] = head[d]; prev[i] = -1;
+		if (head[d] >= 0) prev[head[d]] = i;
+		head[d] = i;
+	};
+	auto remove = [&](int i) {
+		if (prev[i] >= 0) next[prev[i]] = next[i]; else head[deg[i]] = next[i];
+		if (next[i] >= 0) prev[next[i]] = prev[i];
+	};
+
+	for (int i = 0; i < ng; ++i)
+	{
+		int d = 0;
+		for (int v : av[i]) d += nv[v];
+		deg[i] = d;
+		insert(i);
+	}
+
+	vector<int> Lp;
+	int nleft = ntot;
+	int mindeg = 0;
+	int tag = 0;
+	while ((int)order.size() < ng)
+	{
+		// find the variable with minimum degree
+		while (head[mindeg] < 0) mindeg++;
+		int p = head[mindeg];
+		remove(p);
+		nleft -= nv[p];
+		tag++;
+
+		// form the new element
+		Lp.clear();
+		mark[p] = tag;
+		for (int v : av[p])
+		{
+			if ((state[v] == 0) && (mark[v] != tag)) { mark[v] = tag; Lp.push_back(v); }
+		}
+		for (int e : ae[p])
+		{
+			if (state[e] != 1) continue;
+			for (int v : le[e])
+			{
+				if ((state[v] == 0) && (mark[v] != tag)) { mark[v] = tag; Lp.push_back(v); }
+			}
+			state[e] = 2;
+			vector<int>().swap(le[e]);
+		}
+		state[p] = 1;
+		order.push_back(p);
+		vector<int>().swap(av[p]);
+		vector<int>().swap(ae[p]);
+
+		int wLp = 0;
+		for (int i : Lp) wLp += nv[i];
+		le[p] = Lp;
+		ew[p] = wLp;
+
+		// update the adjacency of the variables in the new element
+		for (int i : Lp)
+		{
+			remove(i);
+
+			vector<int>& Ei = ae[i];
+			int m = 0;
+			for (int e : Ei) if (state[e] == 1) Ei[m++] = e;
+			Ei.resize(m);
+			Ei.push_back(p);
+
+			vector<int>& Ai = av[i];
+			m = 0;
+			for (int v : Ai) if ((state[v] == 0) && (mark[v] != tag)) Ai[m++] = v;
+			Ai.resize(m);
+		}
+
+		// calculate |Le \ Lp| for all elements adjacent to Lp
+		for (int i : Lp)
+		{
+			for (int e : ae[i])
+			{
+				if (e == p) continue;
+				if (wflag[e] != tag) { w[e] = ew[e]; wflag[e] = tag; }
+				w[e] -= nv[i];
+			}
+		}
+
+		// approximate external degrees
+		for (int i : Lp)
+		{
+			int d = wLp - nv[i];
+			for (int e : ae[i])
+			{
+				if (e == p) continue;
+				// elements that are a subset of Lp are absorbed 
+				if (w[e] == 0) { state[e] = 2; vector<int>().swap(le[e]); }
+				else d += w[e];
+			}
+			for (int v : av[i]) d += nv[v];
+			if (d > nleft - nv[i]) d = nleft - nv[i];
+			deg[i] = d;
+			insert(i);
+			if (d < mindeg) mindeg = d;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// coarsen the graph by collapsing a heavy-edge matching
+static void CoarsenGraph(const FEOrderingGraph& G, FEOrderingGraph& C, vector<int>& cmap, FEOrderingRandom& rnd)
+{
+	const int n = G.n;
+	vector<int> match(n, -1);
+	vector<int> order(n);
+	for (int i = 0; i < n; ++i) order[i] = i;
+	rnd.Shuffle(order);
+
+	for (int v : order)
+	{
+		if (match[v] != -1) continue;
+		int best = -1, bw = -1;
+		for (int k = G.xadj[v]; k < G.xadj[v + 1]; ++k)
+		{
+			int u = G.adj[k];
+			if ((match[u] == -1) && (G.ewgt[k] > bw)) { best = u; bw = G.ewgt[k]; }
+		}
+		if (best == -1) match[v] = v;
+		else { match[v] = best; match[best] = v; }
+	}
+
+	cmap.assign(n, -1);
+	int cn = 0;
+	for (int v = 0; v < n; ++v)
+	{
+		if (cmap[v] != -1) continue;
+		cmap[v] = cn;
+		cmap[match[v]] = cn;
+		cn++;
+	}
+
+	C.n = cn;
+	C.vwgt.assign(cn, 0);
+	C.xadj.assign(cn + 1, 0);
+	C.adj.clear();
+	C.ewgt.clear();
+	vector<int> pos(cn, -1);
+	int c = 0;
+	for (int v = 0; v < n; ++v)
+	{
+		if (cmap[v] != c) continue;
+
+		int nv = (match[v] == v ? 1 : 2);
+		int vl[2] = { v, match[v] };
+		int start = (int)C.adj.size();
+		for (int l = 0; l < nv; ++l)
+		{
+			int u = vl[l];
+			C.vwgt[c] += G.vwgt[u];
+			for (int k = G.xadj[u]; k < G.xadj[u + 1]; ++k)
+			{
+				int cu = cmap[G.adj[k]];
+				if (cu == c) continue;
+				if (pos[cu] < start) 
+				{ 
+					pos[cu] = (int)C.adj.size(); 
+					C.adj.push_back(cu); 
+					C.ewgt.push_back(G.ewgt[k]); 
+				}
+				else C.ewgt[pos[cu]] += G.ewgt[k];
+			}
+		}
+		C.xadj[c + 1] = (int)C.adj.size();
+		c++;
+	}
+	assert(c == cn);
+}
+
+//-----------------------------------------------------------------------------
+// This class refines a two-way partition using the Fiduccia-Mattheyses heuristic
+class FEBisectionRefinement
+{
+public:
+	FEBisectionRefinement(const FEOrderingGraph& G, vector<int>& where) : m_G(G), m_where(where) {}
+
+	// returns the edge cut
+	int Refine(int maxPasses);
+
+	int Cut() const { return m_cut; }
+
+private:
+	void Init();
+	void Move(int v);
+	int Gain(int v) const { return m_ed[v] - m_id[v]; }
+	int Top(int side);
+	bool Balanced() const { return (m_pwgt[0] <= m_maxW) && (m_pwgt[1] <= m_maxW); }
+
+private:
+	const FEOrderingGraph&	m_G;
+	vector<int>&			m_where;
+	vector<int>		m_id, m_ed;		// internal and external degrees
+	vector<char>	m_locked;
+	int				m_pwgt[2];
+	int				m_maxW;
+	int				m_cut;
+	priority_queue< pair<int, int> >	m_heap[2];
+};
+
+void FEBisectionRefinement::Init()
+{
+	const FEOrderingGraph& G = m_G;
+	m_id.assign(G.n, 0);
+	m_ed.assign(G.n, 0);
+	m_pwgt[0] = m_pwgt[1] = 0;
+	m_cut = 0;
+	int maxvw = 0;
+	for (int v = 0; v < G.n; ++v)
+	{
+		int s = m_where[v];
+		m_pwgt[s] += G.vwgt[v];
+		if (G.vwgt[v] > maxvw) maxvw = G.vwgt[v];
+		for (int k = G.xadj[v]; k < G.xadj[v + 1]; ++k)
+		{
+			if (m_where[G.adj[k]] == s) m_id[v] += G.ewgt[k];
+			else m_ed[v] += G.ewgt[k];
+		}
+		m_cut += m_ed[v];
+	}
+	m_cut /= 2;
+
+	int tot = m_pwgt[0] + m_pwgt[1];
+	m_maxW = std::max((int)(0.53*tot), tot / 2 + maxvw);
+}
+
+void FEBisectionRefinement::Move(int v)
+{
+	const FEOrderingGraph& G = m_G;
+	int from = m_where[v];
+	int to = 1 - from;
+	m_cut -= Gain(v);
+	m_where[v] = to;
+	m_pwgt[from] -= G.vwgt[v];
+	m_pwgt[to] += G.vwgt[v];
+	std::swap(m_id[v], m_ed[v]);
+
+	for (int k = G.xadj[v]; k < G.xadj[v + 1]; ++k)
+	{
+		int u = G.adj[k];
+		int w = G.ewgt[k];
+		if (m_where[u] == to) { m_id[u] += w; m_ed[u] -= w; }
+		else { m_id[u] -= w; m_ed[u] += w; }
+		if ((m_locked[u] == 0) && (m_ed[u] > 0)) m_heap[m_where[u]].push(make_pair(Gain(u), u));
+	}
+}
+
+// returns the vertex with the highest gain on the side (or -1)
+int FEBisectionRefinement::Top(int side)
+{
+	priority_queue< pair<int, int> >& h = m_heap[side];
+	while (h.empty() == false)
+	{
+		pair<int, int> t = h.top();
+		int v = t.second;
+		if ((m_locked[v] == 0) && (m_where[v] == side) && (Gain(v) == t.first)) return v;
+		h.pop();
+	}
+	return -1;
+}
+
+int FEBisectionRefinement::Refine(int maxPasses)
+{
+	const FEOrderingGraph& G = m_G;
+	Init();
+
+	vector<int> moves;
+	int limit = std::min(std::max(50, G.n / 100), 500);
+	for (int pass = 0; pass < maxPasses; ++pass)
+	{
+		m_locked.assign(G.n, 0);
+		for (int s = 0; s < 2; ++s) m_heap[s] = priority_queue< pair<int, int> >();
+		for (int v = 0; v < G.n; ++v)
+		{
+			if (m_ed[v] > 0) m_heap[m_where[v]].push(make_pair(Gain(v), v));
+		}
+
+		moves.clear();
+		int bestCut = m_cut;
+		bool bestBal = Balanced();
+		int bestImb = std::abs(m_pwgt[0] - m_pwgt[1]);
+		size_t bestMove = 0;
+		int nomove = 0;
+		while (true)
+		{
+			int v0 = Top(0);
+			int v1 = Top(1);
+			if ((v0 < 0) && (v1 < 0)) break;
+
+			// pick the side to move from
+			int from;
+			if (m_pwgt[0] > m_maxW) from = 0;
+			else if (m_pwgt[1] > m_maxW) from = 1;
+			else if (v0 < 0) from = 1;
+			else if (v1 < 0) from = 0;
+			else from = (Gain(v0) >= Gain(v1) ? 0 : 1);
+
+			int v = (from == 0 ? v0 : v1);
+			if (v < 0) break;
+			m_heap[from].pop();
+			m_locked[v] = 1;
+
+			// don't violate the balance constraint
+			int to = 1 - from;
+			if ((m_pwgt[to] + G.vwgt[v] > m_maxW) && (m_pwgt[from] <= m_maxW)) continue;
+
+			Move(v);
+			moves.push_back(v);
+
+			bool bal = Balanced();
+			int imb = std::abs(m_pwgt[0] - m_pwgt[1]);
+			bool better = false;
+			if (bal && (!bestBal || (m_cut < bestCut) || ((m_cut == bestCut) && (imb < bestImb)))) better = true;
+			else if (!bal && !bestBal && (imb < bestImb)) better = true;
+
+			if (better)
+			{
+				bestCut = m_cut;
+				bestBal = bal;
+				bestImb = imb;
+				bestMove = moves.size();
+				nomove = 0;
+			}
+			else if (++nomove > limit) break;
+		}
+
+		// undo the moves after the best point
+		for (size_t i = moves.size(); i > bestMove; --i)
+		{
+			int v = moves[i - 1];
+			m_locked[v] = 1;
+			Move(v);
+		}
+
+		if (bestMove == 0) break;
+	}
+
+	return m_cut;
+}
+
+//-----------------------------------------------------------------------------
+// grow a partition from a seed vertex by breadth-first search until it contains half the weight
+static void GrowBisection(const FEOrderingGraph& G, int seed, vector<int>& where)
+{
+	where.assign(G.n, 1);
+	int tot = G.TotalWeight();
+	int w0 = 0;
+	vector<char> visited(G.n, 0);
+	queue<int> Q;
+	Q.push(seed); visited[seed] = 1;
+	int next = 0;
+	while (2 * w0 < tot)
+	{
+		if (Q.empty())
+		{
+			// the graph is not connected
+			while ((next < G.n) && visited[next]) next++;
+			if (next == G.n) break;
+			Q.push(next); visited[next] = 1;
+		}
+
+		int v = Q.front(); Q.pop();
+		where[v] = 0;
+		w0 += G.vwgt[v];
+		for (int k = G.xadj[v]; k < G.xadj[v + 1]; ++k)
+		{
+			int u = G.adj[k];
+			if (visited[u] == 0) { visited[u] = 1; Q.push(u); }
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// multilevel edge bisection
+static void EdgeBisection(const FEOrderingGraph& G, vector<int>& where, FEOrderingRandom& rnd)
+{
+	const int COARSE_SIZE = 100;
+
+	// coarsen the graph
+	vector<FEOrderingGraph> levels;
+	vector< vector<int> > cmaps;
+	levels.reserve(64);
+	const FEOrderingGraph* cur = &G;
+	while (cur->n > COARSE_SIZE)
+	{
+		FEOrderingGraph C;
+		vector<int> cmap;
+		CoarsenGraph(*cur, C, cmap, rnd);
+		if (C.n > 0.9*cur->n) break;
+		levels.push_back(std::move(C));
+		cmaps.push_back(std::move(cmap));
+		cur = &levels.back();
+	}
+
+	// initial bisection of the coarsest graph
+	const FEOrderingGraph& Gc = *cur;
+	int bestCut = -1;
+	vector<int> w;
+	const int ntries = 6;
+	for (int i = 0; i < ntries; ++i)
+	{
+		GrowBisection(Gc, rnd(Gc.n), w);
+		FEBisectionRefinement fm(Gc, w);
+		int cut = fm.Refine(8);
+		if ((bestCut < 0) || (cut < bestCut)) { bestCut = cut; where = w; }
+	}
+
+	// uncoarsen and refine
+	for (int l = (int)levels.size() - 1; l >= 0; --l)
+	{
+		const FEOrderingGraph& Gf = (l == 0 ? G : levels[l - 1]);
+		const vector<int>& cmap = cmaps[l];
+		w.resize(Gf.n);
+		for (int v = 0; v < Gf.n; ++v) w[v] = where[cmap[v]];
+		where = w;
+		FEBisectionRefinement fm(Gf, where);
+		fm.Refine(4);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Convert an edge separator into a vertex separator. The boundary vertices form a
+// bipartite graph and the smallest separator is its minimum vertex cover, which
+// is found from a maximum matching (König's theorem). Separator vertices get where = 2.
+static void VertexSeparator(const FEOrderingGraph& G, vector<int>& where)
+{
+	// find the boundary vertices
+	vector<int> lid(G.n, -1);
+	vector<int> left, right;
+	for (int v = 0; v < G.n; ++v)
+	{
+		for (int k = G.xadj[v]; k < G.xadj[v + 1]; ++k)
+		{
+			if (where[G.adj[k]] != where[v])
+			{
+				if (where[v] == 0) { lid[v] = (int)left.size(); left.push_back(v); }
+				else { lid[v] = (int)right.size(); right.push_back(v); }
+				break;
+			}
+		}
+	}
+	const int nl = (int)left.size();
+	const int nr = (int)right.size();
+	if ((nl == 0) || (nr == 0)) return;
+
+	// bipartite graph
+	vector<int> bx(nl + 1, 0), badj;
+	for (int a = 0; a < nl; ++a)
+	{
+		int v = left[a];
+		for (int k = G.xadj[v]; k < G.xadj[v + 1]; ++k)
+		{
+			int u = G.adj[k];
+			if (where[u] == 1) badj.push_back(lid[u]);
+		}
+		bx[a + 1] = (int)badj.size();
+	}
+
+	// maximum matching
+	vector<int> matchL(nl, -1), matchR(nr, -1);
+	for (int a = 0; a < nl; ++a)
+	{
+		for (int k = bx[a]; k < bx[a + 1]; ++k)
+		{
+			int b = badj[k];
+			if (matchR[b] == -1) { matchL[a] = b; matchR[b] = a; break; }
+		}
+	}
+
+	struct FRAME { int a, it, b; };
+	vector<FRAME> stack;
+	vector<int> visR(nr, -1);
+	for (int a0 = 0; a0 < nl; ++a0)
+	{
+		if (matchL[a0] != -1) continue;
+
+		// look for an augmenting path (iterative depth-first search)
+		stack.clear();
+		FRAME f0 = { a0, bx[a0], -1 };
+		stack.push_back(f0);
+		while (stack.empty() == false)
+		{
+			FRAME& f = stack.back();
+			if (f.it == bx[f.a + 1]) { stack.pop_back(); continue; }
+			int b = badj[f.it++];
+			if (visR[b] == a0) continue;
+			visR[b] = a0;
+			f.b = b;
+			if (matchR[b] == -1)
+			{
+				// augment
+				for (size_t i = 0; i < stack.size(); ++i)
+				{
+					matchL[stack[i].a] = stack[i].b;
+					matchR[stack[i].b] = stack[i].a;
+				}
+				break;
+			}
+			else
+			{
+				int a = matchR[b];
+				FRAME fn = { a, bx[a], -1 };
+				stack.push_back(fn);
+			}
+		}
+	}
+
+	// find all vertices reachable from unmatched left vertices by alternating paths
+	vector<char> zl(nl, 0), zr(nr, 0);
+	vector<int> Q;
+	for (int a = 0; a < nl; ++a) if (matchL[a] == -1) { zl[a] = 1; Q.push_back(a); }
+	while (Q.empty() == false)
+	{
+		int a = Q.back(); Q.pop_back();
+		for (int k = bx[a]; k < bx[a + 1]; ++k)
+		{
+			int b = badj[k];
+			if (zr[b]) continue;
+			zr[b] = 1;
+			int a2 = matchR[b];
+			if ((a2 >= 0) && (zl[a2] == 0)) { zl[a2] = 1; Q.push_back(a2); }
+		}
+	}
+
+	// the minimum vertex cover
+	for (int a = 0; a < nl; ++a) if (zl[a] == 0) where[left[a]] = 2;
+	for (int b = 0; b < nr; ++b) if (zr[b] == 1) where[right[b]] = 2;
+}
+
+//-----------------------------------------------------------------------------
+// extract the subgraph of the vertices with where[v] == part
+static void ExtractSubgraph(const FEOrderingGraph& G, const vector<int>& where, int part, FEOrderingGraph& S, vector<int>& vmap)
+{
+	vector<int> lid(G.n, -1);
+	vmap.clear();
+	for (int v = 0; v < G.n; ++v) if (where[v] == part) { lid[v] = (int)vmap.size(); vmap.push_back(v); }
+
+	S.n = (int)vmap.size();
+	S.vwgt.resize(S.n);
+	S.xadj.assign(S.n + 1, 0);
+	S.adj.clear();
+	S.ewgt.clear();
+	for (int i = 0; i < S.n; ++i)
+	{
+		int v = vmap[i];
+		S.vwgt[i] = G.vwgt[v];
+		for (int k = G.xadj[v]; k < G.xadj[v + 1]; ++k)
+		{
+			int u = lid[G.adj[k]];
+			if (u >= 0) { S.adj.push_back(u); S.ewgt.push_back(1); }
+		}
+		S.xadj[i + 1] = (int)S.adj.size();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Recursive nested dissection. The ordered (global) vertex ids are appended to order.
+static void NestedDissection(const FEOrderingGraph& G, const vector<int>& gid, vector<int>& order, FEOrderingRandom& rnd)
+{
+	const int MIN_SIZE = 150;
+
+	vector<int> lo;
+	if (G.n <= MIN_SIZE)
+	{
+		MinimumDegree(G, lo);
+		for (int v : lo) order.push_back(gid[v]);
+		return;
+	}
+
+	// find a vertex separator
+	vector<int> where;
+	EdgeBisection(G, where, rnd);
+	VertexSeparator(G, where);
+
+	int nv[3] = { 0, 0, 0 };
+	for (int v = 0; v < G.n; ++v) nv[where[v]]++;
+	if ((nv[0] == 0) || (nv[1] == 0))
+	{
+		// no useful separator was found
+		MinimumDegree(G, lo);
+		for (int v : lo) order.push_back(gid[v]);
+		return;
+	}
+
+	for (int part = 0; part < 2; ++part)
+	{
+		FEOrderingGraph S;
+		vector<int> vmap;
+		ExtractSubgraph(G, where, part, S, vmap);
+		for (int& v : vmap) v = gid[v];
+		NestedDissection(S, vmap, order, rnd);
+	}
+
+	// the separator is ordered last
+	for (int v = 0; v < G.n; ++v) if (where[v] == 2) order.push_back(gid[v]);
+}
+
+//-----------------------------------------------------------------------------
+// Predict the nonzeroes and flops of the factorization for an ordering of the 
+// compressed graph. Since the merged vertices are indistinguishable, the 
+// prediction is exact for the uncompressed graph.
+static void PredictFill(const FEOrderingGraph& G, const vector<int>& order, double& nnz, double& flops)
+{
+	const int n = G.n;
+	vector<int> iperm(n);
+	for (int k = 0; k < n; ++k) iperm[order[k]] = k;
+
+	// elimination tree
+	vector<int> parent(n, -1), anc(n, -1);
+	for (int k = 0; k < n; ++k)
+	{
+		int p = order[k];
+		for (int l = G.xadj[p]; l < G.xadj[p + 1]; ++l)
+		{
+			int i = iperm[G.adj[l]];
+			if (i >= k) continue;
+			int r = i;
+			while ((anc[r] != -1) && (anc[r] != k))
+			{
+				int t = anc[r];
+				anc[r] = k;
+				r = t;
+			}
+			if (anc[r] == -1) { anc[r] = k; parent[r] = k; }
+		}
+	}
+
+	// weighted column counts (using row subtrees)
+	vector<double> cc(n);
+	vector<int> flag(n, -1);
+	for (int i = 0; i < n; ++i)
+	{
+		int p = order[i];
+		cc[i] = G.vwgt[p];
+		flag[i] = i;
+		for (int l = G.xadj[p]; l < G.xadj[p + 1]; ++l)
+		{
+			int j = iperm[G.adj[l]];
+			if (j >= i) continue;
+			while (flag[j] != i)
+			{
+				cc[j] += G.vwgt[p];
+				flag[j] = i;
+				j = parent[j];
+			}
+		}
+	}
+
+	nnz = flops = 0.0;
+	for (int k = 0; k < n; ++k)
+	{
+		int nv = G.vwgt[order[k]];
+		for (int t = 0; t < nv; ++t)
+		{
+			double c = cc[k] - t;
+			nnz += c;
+			flops += c*c;
+		}
+	}
+}
+
+//=============================================================================
+FEFillReducingOrdering::FEFillReducingOrdering()
+{
+	m_n = 0;
+	m_method = AUTO_ORDERING;
+	m_nnzL = 0.0;
+	m_flops = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+void FEFillReducingOrdering::Create(int n, const int* xadj, const int* adj)
+{
+	m_n = n;
+
+	// count the entries of the symmetrized graph
+	m_xadj.assign(n + 1, 0);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = xadj[j]; k < xadj[j + 1]; ++k)
+		{
+			int i = adj[k];
+			if (i != j) { m_xadj[i + 1]++; m_xadj[j + 1]++; }
+		}
+	}
+	for (int i = 0; i < n; ++i) m_xadj[i + 1] += m_xadj[i];
+
+	m_adj.resize(m_xadj[n]);
+	vector<int> pos(m_xadj.begin(), m_xadj.end() - 1);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = xadj[j]; k < xadj[j + 1]; ++k)
+		{
+			int i = adj[k];
+			if (i != j) { m_adj[pos[i]++] = j; m_adj[pos[j]++] = i; }
+		}
+	}
+
+	// remove duplicates
+	int m = 0;
+	int start = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		int* a = m_adj.data() + start;
+		int na = m_xadj[i + 1] - start;
+		std::sort(a, a + na);
+		int m0 = m;
+		for (int k = 0; k < na; ++k)
+		{
+			if ((k == 0) || (a[k] != a[k - 1])) m_adj[m++] = a[k];
+		}
+		start = m_xadj[i + 1];
+		m_xadj[i] = m0;
+	}
+	m_xadj[n] = m;
+	m_adj.resize(m);
+}
+
+//-----------------------------------------------------------------------------
+void FEFillReducingOrdering::Create(SparseMatrixProfile& mp)
+{
+	int n = mp.Columns();
+	assert(mp.Rows() == n);
+	vector<int> xadj(n + 1, 0), adj;
+	for (int j = 0; j < n; ++j)
+	{
+		SparseMatrixProfile::ColumnProfile& a = mp.Column(j);
+		for (int k = 0; k < a.size(); ++k)
+		{
+			for (int i = a[k].start; i <= a[k].end; ++i) adj.push_back(i);
+		}
+		xadj[j + 1] = (int)adj.size();
+	}
+	Create(n, xadj.data(), adj.data());
+}
+
+//-----------------------------------------------------------------------------
+void FEFillReducingOrdering::Create(FENodeNodeList& NNL)
+{
+	int n = NNL.Size();
+	vector<int> xadj(n + 1, 0), adj;
+	for (int i = 0; i < n; ++i)
+	{
+		int nval = NNL.Valence(i);
+		int* pn = NNL.NodeList(i);
+		adj.insert(adj.end(), pn, pn + nval);
+		xadj[i + 1] = (int)adj.size();
+	}
+	Create(n, xadj.data(), adj.data());
+}
+
+//-----------------------------------------------------------------------------
+bool FEFillReducingOrdering::Apply(vector<int>& perm, int method)
+{
+	const int n = m_n;
+	perm.resize(n);
+	m_nnzL = m_flops = 0.0;
+	m_method = method;
+	if (n == 0) return true;
+
+	// compress the graph
+	FEOrderingGraph G;
+	vector<int> group;
+	CompressGraph(n, m_xadj, m_adj, G, group);
+
+	// order the compressed graph
+	vector<int> order;
+	if (method == MINIMUM_DEGREE)
+	{
+		MinimumDegree(G, order);
+		PredictFill(G, order, m_nnzL, m_flops);
+	}
+	else if (method == NESTED_DISSECTION)
+	{
+		vector<int> gid(G.n);
+		for (int i = 0; i < G.n; ++i) gid[i] = i;
+		FEOrderingRandom rnd;
+		order.reserve(G.n);
+		NestedDissection(G, gid, order, rnd);
+		PredictFill(G, order, m_nnzL, m_flops);
+	}
+	else if (method == AUTO_ORDERING)
+	{
+		// try both and keep the one with the smallest flop count
+		MinimumDegree(G, order);
+		PredictFill(G, order, m_nnzL, m_flops);
+		m_method = MINIMUM_DEGREE;
+
+		vector<int> gid(G.n), ndorder;
+		for (int i = 0; i < G.n; ++i) gid[i] = i;
+		FEOrderingRandom rnd;
+		ndorder.reserve(G.n);
+		NestedDissection(G, gid, ndorder, rnd);
+		double nnz, flops;
+		PredictFill(G, ndorder, nnz, flops);
+		if (flops < m_flops)
+		{
+			order.swap(ndorder);
+			m_nnzL = nnz;
+			m_flops = flops;
+			m_method = NESTED_DISSECTION;
+		}
+	}
+	else return false;
+	assert((int)order.size() == G.n);
+
+	// expand the ordering of the compressed graph
+	vector<int> pg(G.n + 1, 0);
+	for (int i = 0; i < n; ++i) pg[group[i] + 1]++;
+	for (int g = 0; g < G.n; ++g) pg[g + 1] += pg[g];
+	vector<int> members(n);
+	for (int i = 0; i < n; ++i) members[pg[group[i]]++] = i;
+	for (int g = G.n; g > 0; --g) pg[g] = pg[g - 1];
+	pg[0] = 0;
+
+	int k = 0;
+	for (int g : order)
+	{
+		for (int l = pg[g]; l < pg[g + 1]; ++l) perm[k++] = members[l];
+	}
+	assert(k == n);
+
+	return true;
+}
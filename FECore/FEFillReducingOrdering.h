@@ -0,0 +1,97 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+
+class SparseMatrixProfile;
+class FENodeNodeList;
+
+//-----------------------------------------------------------------------------
+//! This class calculates fill-reducing orderings for sparse direct solvers.
+
+//! The ordering works on the (symmetric) adjacency graph of a matrix, which can 
+//! be defined by a sparse matrix profile, a node-node list, or a compressed (CSR)
+//! graph. Two methods are implemented:
+//! (1) an approximate minimum degree ordering on a quotient graph, and 
+//! (2) a multilevel nested dissection ordering (heavy-edge coarsening, 
+//!     Fiduccia-Mattheyses refinement and minimum vertex separators). 
+//! Subgraphs that become small during the dissection are ordered with (1).
+//! Before ordering, vertices with identical adjacency (e.g. the degrees of freedom
+//! of a node) are merged, which makes both methods much faster. 
+//! After the ordering is calculated, the number of nonzeroes and the floating 
+//! point operations of the (Cholesky) factorization are predicted, so that solvers
+//! can choose the best ordering before doing any numerical work.
+class FECORE_API FEFillReducingOrdering
+{
+public:
+	enum OrderingMethod {
+		AUTO_ORDERING,			//!< pick the ordering with the smallest predicted flop count
+		MINIMUM_DEGREE,			//!< approximate minimum degree
+		NESTED_DISSECTION		//!< multilevel nested dissection
+	};
+
+public:
+	//! constructor
+	FEFillReducingOrdering();
+
+	//! Create the graph from a compressed row (or column) structure. The structure
+	//! does not have to be symmetric (e.g. only the lower triangular part of a symmetric
+	//! matrix can be passed) and the diagonal is ignored. Indices are zero-based.
+	void Create(int n, const int* xadj, const int* adj);
+
+	//! Create the graph from the profile of a sparse matrix
+	void Create(SparseMatrixProfile& mp);
+
+	//! Create the graph from a node-node list
+	void Create(FENodeNodeList& NNL);
+
+	//! number of vertices in the graph
+	int Vertices() const { return m_n; }
+
+	//! Calculate the ordering. On return perm[k] is the vertex that is eliminated k-th.
+	bool Apply(std::vector<int>& perm, int method = AUTO_ORDERING);
+
+	//! method that was used by the last call to Apply
+	int Method() const { return m_method; }
+
+	//! predicted number of nonzeroes in the factor L (including the diagonal)
+	double FactorNonZeroes() const { return m_nnzL; }
+
+	//! predicted number of floating point operations of the factorization
+	double FactorOperations() const { return m_flops; }
+
+private:
+	int					m_n;		//!< nr of vertices
+	std::vector<int>	m_xadj;		//!< adjacency pointers
+	std::vector<int>	m_adj;		//!< adjacency list (symmetric, without diagonal)
+
+	int		m_method;	//!< method used for last ordering
+	double	m_nnzL;		//!< predicted nr of nonzeroes in factor
+	double	m_flops;	//!< predicted flop count
+};
@@ -31,6 +31,8 @@ SOFTWARE.*/
 #include "FEModel.h"
 #include "FEDomain.h"
 #include "FESurface.h"
+#include <algorithm>
+#include <assert.h>
 
 //-----------------------------------------------------------------------------
 FEElementMatrix::FEElementMatrix(const FEElement& el)
@@ -90,6 +92,15 @@ FEGlobalMatrix::FEGlobalMatrix(SparseMatrix* pK, bool del)
 	m_pMP = 0;
 	m_nlm = 0;
 	m_delA = del;
+	m_bcolored = false;
+	m_bcollect = false;
+	m_bdynValid = false;
+	m_bdynNew = false;
+	m_dynKey.elems = m_dynKeyNew.elems = 0;
+	m_dynKey.size = m_dynKeyNew.size = 0;
+	m_dynKey.hash = m_dynKeyNew.hash = 0;
+	m_bincremental = false;
+	m_bdynDelta = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -105,6 +116,15 @@ FEGlobalMatrix::~FEGlobalMatrix()
 void FEGlobalMatrix::Clear()
 { 
 	if (m_pA) m_pA->Clear(); 
+	m_bdynValid = false;
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::SetIncrementalProfile(bool b)
+{
+	m_bincremental = b;
+	m_pA->SetSlack(b ? PROFILE_SLACK : 0);
+	if (b == false) m_dynRef.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -120,6 +140,10 @@ void FEGlobalMatrix::build_begin(int neq)
 	m_pMP->CreateDiagonal();
 
 	m_nlm = 0;
+	m_bdynValid = false;
+	m_bdynDelta = false;
+	m_dynIns.clear();
+	m_dynDel.clear();
 }
 
 //-----------------------------------------------------------------------------
@@ -133,6 +157,21 @@ void FEGlobalMatrix::build_add(vector<int>& lm)
 {
 	if (lm.empty() == false)
 	{
+		if (m_bcollect)
+		{
+			m_dynNew.push_back((int)lm.size());
+			m_dynNew.insert(m_dynNew.end(), lm.begin(), lm.end());
+
+			// update the fingerprint. The hashes of the lm arrays are added, so
+			// that the fingerprint does not depend on the order of the elements.
+			unsigned long long h = 14695981039346656037ULL;
+			for (int n : lm) { h ^= (unsigned int)n; h *= 1099511628211ULL; }
+			m_dynKeyNew.elems++;
+			m_dynKeyNew.size += (int)lm.size();
+			m_dynKeyNew.hash += h;
+			return;
+		}
+
 		m_LM[m_nlm++] = lm;
 		if (m_nlm >= MAX_LM_SIZE) build_flush();
 	}
@@ -171,6 +210,52 @@ void FEGlobalMatrix::build_end()
 	m_pA->Create(*m_pMP);
 }
 
+//-----------------------------------------------------------------------------
+// Helper functions for processing the flattened lm arrays of the dynamic profile
+
+// get the offsets to the elements in a flattened list of lm arrays
+static void dynamic_elements(const vector<int>& LM, vector<int>& off)
+{
+	off.clear();
+	for (size_t i = 0; i < LM.size(); i += LM[i] + 1) off.push_back((int)i);
+}
+
+// compare two elements (first by size, then by equation numbers)
+static bool dynamic_less(const int* a, const int* b)
+{
+	if (a[0] != b[0]) return (a[0] < b[0]);
+	return lexicographical_compare(a + 1, a + 1 + a[0], b + 1, b + 1 + b[0]);
+}
+
+// copy a flattened list of lm arrays with the elements in sorted order
+static void dynamic_sorted(const vector<int>& LM, const vector<int>& off, vector<int>& sorted)
+{
+	sorted.clear();
+	sorted.reserve(LM.size());
+	for (int n : off) sorted.insert(sorted.end(), LM.begin() + n, LM.begin() + n + LM[n] + 1);
+}
+
+static void dynamic_sorted(const vector<int>& LM, vector<int>& sorted)
+{
+	vector<int> off;
+	dynamic_elements(LM, off);
+	const int* L = LM.data();
+	sort(off.begin(), off.end(), [=](int a, int b) { return dynamic_less(L + a, L + b); });
+	dynamic_sorted(LM, off, sorted);
+}
+
+// normalize an lm array (i.e. prescribed dofs get a valid equation number)
+static void dynamic_lm(const int* a, vector<int>& lm)
+{
+	lm.clear();
+	for (int i = 1; i <= a[0]; ++i)
+	{
+		int n = a[i];
+		if (n < -1) n = -n - 2;
+		if (n >= 0) lm.push_back(n);
+	}
+}
+
 //-----------------------------------------------------------------------------
 bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 {
@@ -182,6 +267,18 @@ bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 	// reconstructing it every time we come here saves us a lot of time. The 
 	// static profile is stored in the variable m_MPs.
 
+	// With incremental updates we only process the dynamic elements that changed.
+	if (m_bincremental && (breset == false) && m_bdynValid && (m_pMP->Rows() == neq))
+	{
+		if (m_bdynDelta == false)
+		{
+			if (m_bdynNew == false) CollectDynamicProfile(pfem);
+			UpdateDynamicProfile();
+		}
+		ApplyDynamicProfile();
+		return true;
+	}
+
 	// begin building the profile
 	build_begin(neq);
 	{
@@ -203,6 +300,18 @@ bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 			// Make sure the LM buffer is flushed first.
 			build_flush();
 			m_MPs = *m_pMP;
+
+			// The element colorings only depend on the element connectivity, 
+			// so we rebuild them together with the static profile.
+			if (m_bcolored)
+			{
+				FEMesh& mesh = pfem->GetMesh();
+				for (int i = 0; i < mesh.Domains(); ++i)
+				{
+					FEDomain& dom = mesh.Domain(i);
+					dom.BuildElementColoring();
+				}
+			}
 		}
 		else
 		{
@@ -210,16 +319,194 @@ bool FEGlobalMatrix::Create(FEModel* pfem, int neq, bool breset)
 			*m_pMP = m_MPs;
 		}
 
-		// Add the "dynamic" profile
-		pfem->BuildMatrixProfile(*this, false);
+		// Add the "dynamic" profile. We keep a copy of it so that the next
+		// time we come here we can see if it changed.
+		if (breset || (m_bdynNew == false)) CollectDynamicProfile(pfem);
+		for (size_t i = 0; i < m_dynNew.size();)
+		{
+			int n = m_dynNew[i++];
+			vector<int> lm(m_dynNew.begin() + i, m_dynNew.begin() + i + n);
+			build_add(lm);
+			i += n;
+		}
+		m_dynLM.swap(m_dynNew);
+		m_dynKey = m_dynKeyNew;
+		dynamic_sorted(m_dynLM, m_dynSorted);
+		m_dynNew.clear();
+		m_bdynNew = false;
 	}
 	// All done! We can now finish building the profile and create 
 	// the actual sparse matrix. This is done in the following function
 	build_end();
+	m_bdynValid = true;
+
+	if (m_bincremental) InitDynamicReferences();
 
 	return true;
 }
 
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::CollectDynamicProfile(FEModel* pfem)
+{
+	m_dynNew.clear();
+	m_dynKeyNew.elems = 0;
+	m_dynKeyNew.size = 0;
+	m_dynKeyNew.hash = 0;
+	m_bcollect = true;
+	pfem->BuildMatrixProfile(*this, false);
+	m_bcollect = false;
+	m_bdynNew = true;
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::InitDynamicReferences()
+{
+	m_dynRef.clear();
+	long long neq = m_pMP->Rows();
+	vector<int> off, lm;
+	dynamic_elements(m_dynLM, off);
+	for (int n : off)
+	{
+		dynamic_lm(&m_dynLM[n], lm);
+		for (int j : lm)
+			for (int i : lm) m_dynRef[j*neq + i]++;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! Finds the dynamic elements that were added or removed since the last time the
+//! profile was updated, and inserts or removes the matrix entries that only those 
+//! elements contribute to. Entries of the static profile are never removed.
+void FEGlobalMatrix::UpdateDynamicProfile()
+{
+	// sort the old and new elements
+	vector<int> off0, off1;
+	dynamic_elements(m_dynLM , off0);
+	dynamic_elements(m_dynNew, off1);
+	const int* L0 = m_dynLM.data();
+	const int* L1 = m_dynNew.data();
+	sort(off0.begin(), off0.end(), [=](int a, int b) { return dynamic_less(L0 + a, L0 + b); });
+	sort(off1.begin(), off1.end(), [=](int a, int b) { return dynamic_less(L1 + a, L1 + b); });
+
+	// find the removed and added elements
+	vector<const int*> removed, added;
+	size_t i0 = 0, i1 = 0;
+	while ((i0 < off0.size()) || (i1 < off1.size()))
+	{
+		if (i1 == off1.size()) removed.push_back(L0 + off0[i0++]);
+		else if (i0 == off0.size()) added.push_back(L1 + off1[i1++]);
+		else if (dynamic_less(L0 + off0[i0], L1 + off1[i1])) removed.push_back(L0 + off0[i0++]);
+		else if (dynamic_less(L1 + off1[i1], L0 + off0[i0])) added.push_back(L1 + off1[i1++]);
+		else { i0++; i1++; }
+	}
+
+	// update the reference counts and collect the entries that change.
+	// We do the added elements first, so that entries that move from one
+	// element to another are not removed and inserted again.
+	long long neq = m_pMP->Rows();
+	vector< pair<int, int> >& ins = m_dynIns;
+	vector< pair<int, int> >& del = m_dynDel;
+	ins.clear();
+	del.clear();
+	vector<int> lm;
+	for (const int* a : added)
+	{
+		dynamic_lm(a, lm);
+		for (int j : lm)
+			for (int i : lm)
+			{
+				int& n = m_dynRef[j*neq + i];
+				if ((n++ == 0) && (m_MPs.HasEntry(i, j) == false))
+				{
+					m_pMP->Insert(i, j);
+					ins.push_back(pair<int, int>(i, j));
+				}
+			}
+	}
+	for (const int* a : removed)
+	{
+		dynamic_lm(a, lm);
+		for (int j : lm)
+			for (int i : lm)
+			{
+				auto it = m_dynRef.find(j*neq + i);
+				assert(it != m_dynRef.end());
+				if (--(it->second) == 0)
+				{
+					m_dynRef.erase(it);
+					if (m_MPs.HasEntry(i, j) == false)
+					{
+						m_pMP->Remove(i, j);
+						del.push_back(pair<int, int>(i, j));
+					}
+				}
+			}
+	}
+
+	dynamic_sorted(m_dynNew, off1, m_dynSorted);
+	m_dynLM.swap(m_dynNew);
+	m_dynKey = m_dynKeyNew;
+	m_dynNew.clear();
+	m_bdynNew = false;
+	m_bdynDelta = true;
+}
+
+//-----------------------------------------------------------------------------
+void FEGlobalMatrix::ApplyDynamicProfile()
+{
+	// update the matrix structure. If there is not enough room we have to recreate
+	// it, but at least the profile is already up to date.
+	if ((m_dynIns.empty() == false) || (m_dynDel.empty() == false))
+	{
+		if (m_pA->UpdateStructure(m_dynIns, m_dynDel) == false) m_pA->Create(*m_pMP);
+	}
+	m_dynIns.clear();
+	m_dynDel.clear();
+	m_bdynDelta = false;
+}
+
+//-----------------------------------------------------------------------------
+bool FEGlobalMatrix::DynamicStructureChanged(FEModel* pfem, int neq)
+{
+	if ((m_bincremental == false) || (m_bdynValid == false) || (m_pMP == nullptr) || (m_pMP->Rows() != neq)) return true;
+
+	if (m_bdynDelta == false)
+	{
+		if (m_bdynNew == false) CollectDynamicProfile(pfem);
+		UpdateDynamicProfile();
+	}
+
+	// if no entries changed, the sparse matrix can be used as is
+	if (m_dynIns.empty() && m_dynDel.empty())
+	{
+		m_bdynDelta = false;
+		return false;
+	}
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+//! The fingerprints of the dynamic profiles (element count, total size and an 
+//! order-independent hash of the lm arrays) are compared first, which quickly detects
+//! most changes. If they match, the sorted lm arrays are compared, since different 
+//! profiles can have the same fingerprint.
+bool FEGlobalMatrix::DynamicProfileChanged(FEModel* pfem, int neq)
+{
+	CollectDynamicProfile(pfem);
+
+	if ((m_bdynValid == false) || (m_pMP == nullptr) || (m_pMP->Rows() != neq)) return true;
+	if ((m_dynKeyNew.elems != m_dynKey.elems) || (m_dynKeyNew.size != m_dynKey.size) || (m_dynKeyNew.hash != m_dynKey.hash)) return true;
+
+	vector<int> sorted;
+	dynamic_sorted(m_dynNew, sorted);
+	if (sorted != m_dynSorted) return true;
+
+	// nothing changed, so the collected profile won't be needed
+	m_dynNew.clear();
+	m_bdynNew = false;
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 //! Constructs the stiffness matrix from a FEMesh object. 
 bool FEGlobalMatrix::Create(FEMesh& mesh, int neq)
@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "SparseMatrix.h"
 #include "FESolver.h"
 #include <vector>
+#include <unordered_map>
 
 //-----------------------------------------------------------------------------
 class FEModel;
@@ -105,6 +106,7 @@ class FECORE_API FEGlobalMatrix
 {
 protected:
 	enum { MAX_LM_SIZE = 64000 };
+	enum { PROFILE_SLACK = 4 };		// slack per column reserved for incremental updates
 
 public:
 	//! constructor
@@ -116,6 +118,16 @@ public:
 	//! construct the stiffness matrix from a FEM object
 	bool Create(FEModel* pfem, int neq, bool breset);
 
+	//! See if the "dynamic" part of the profile (e.g. contact) differs from the one
+	//! that was used the last time the matrix was created with Create(pfem, neq, false).
+	//! If not, the sparse matrix can be reused as is.
+	bool DynamicProfileChanged(FEModel* pfem, int neq);
+
+	//! With incremental profile updates, update the dynamic profile and see if any
+	//! entries need to be inserted into or removed from the sparse matrix. The sparse
+	//! matrix itself is only updated by the next call to Create(pfem, neq, false).
+	bool DynamicStructureChanged(FEModel* pfem, int neq);
+
 	//! construct the stiffness matrix from a mesh
 	bool Create(FEMesh& mesh, int neq);
 
@@ -153,15 +165,47 @@ public:
 	//! get the sparse matrix profile
 	SparseMatrixProfile* GetSparseMatrixProfile() { return m_pMP; }
 
+	//! turn colored assembly on or off
+	//! When on, the element colorings of the domains are rebuilt together with the
+	//! static profile, and FELinearSystem can then assemble the domains without atomics.
+	void SetColoredAssembly(bool b) { m_bcolored = b; }
+
+	//! see if colored assembly is on
+	bool ColoredAssembly() const { return m_bcolored; }
+
+	//! turn incremental profile updates on or off
+	//! When on, Create(pfem, neq, false) only inserts and removes the entries of the
+	//! dynamic elements that changed since the last call, instead of rebuilding the
+	//! profile and the sparse matrix from scratch.
+	void SetIncrementalProfile(bool b);
+
+	//! see if incremental profile updates are on
+	bool IncrementalProfile() const { return m_bincremental; }
+
 public:
 	void build_begin(int neq);
 	void build_add(std::vector<int>& lm);
 	void build_end();
 	void build_flush();
 
+protected:
+	//! collect the "dynamic" profile in m_dynNew
+	void CollectDynamicProfile(FEModel* pfem);
+
+	//! update the profile with the changes between m_dynLM and m_dynNew, and collect
+	//! the entries that need to be inserted into or removed from the sparse matrix
+	void UpdateDynamicProfile();
+
+	//! insert and remove the collected entries in the sparse matrix
+	void ApplyDynamicProfile();
+
+	//! count the references to the entries of the dynamic profile
+	void InitDynamicReferences();
+
 protected:
 	SparseMatrix*	m_pA;	//!< the actual global stiffness matrix
 	bool			m_delA;	//!< delete A in destructor
+	bool			m_bcolored;	//!< use colored assembly
 
 	// The following data structures are used to incrementally
 	// build the profile of the sparse matrix
@@ -170,4 +214,32 @@ protected:
 	SparseMatrixProfile		m_MPs;		//!< the "static" part of the matrix profile
 	vector< vector<int> >	m_LM;		//!< used for building the stiffness matrix
 	int	m_nlm;				//!< nr of elements in m_LM array
+
+	// The "dynamic" profile of the last build is kept so that we can see if the
+	// matrix structure needs to change. The lm arrays are stored back-to-back,
+	// each one preceded by its size.
+	vector<int>	m_dynLM;		//!< dynamic profile used for the current matrix
+	vector<int>	m_dynNew;		//!< newly collected dynamic profile
+	vector<int>	m_dynSorted;	//!< copy of m_dynLM with the lm arrays in sorted order
+
+	// Fingerprint of a dynamic profile, used as a quick check to see if the 
+	// profile changed before comparing the lm arrays.
+	struct DynamicProfileKey
+	{
+		int					elems;	//!< nr of lm arrays
+		int					size;	//!< total size of the lm arrays
+		unsigned long long	hash;	//!< sum of the hashes of the lm arrays
+	};
+	DynamicProfileKey	m_dynKey;		//!< fingerprint of m_dynLM
+	DynamicProfileKey	m_dynKeyNew;	//!< fingerprint of m_dynNew
+	bool		m_bcollect;		//!< build_add collects into m_dynNew
+	bool		m_bdynValid;	//!< m_dynLM describes the current matrix
+	bool		m_bdynNew;		//!< m_dynNew was collected but not used yet
+
+	// data for incremental profile updates
+	bool	m_bincremental;		//!< use incremental profile updates
+	std::unordered_map<long long, int>	m_dynRef;	//!< nr of dynamic elements referencing an entry
+	vector< std::pair<int, int> >	m_dynIns;	//!< entries to insert into the sparse matrix
+	vector< std::pair<int, int> >	m_dynDel;	//!< entries to remove from the sparse matrix
+	bool	m_bdynDelta;		//!< m_dynIns and m_dynDel were collected but not applied yet
 };
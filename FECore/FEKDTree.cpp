@@ -0,0 +1,184 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#include "stdafx.h"
+#include "FEKDTree.h"
+#include <algorithm>
+#include <limits>
+using namespace std;
+
+// ranges with at most this many points are not split any further
+#define KDTREE_LEAF_SIZE	8
+
+//-----------------------------------------------------------------------------
+// Data for a single k-NN query. The candidates are kept in a bounded max-heap
+// so that the current farthest candidate is always at the front.
+struct FEKDTree::QUERY
+{
+	vec3d	x;		// query point
+	size_t	k;		// number of requested neighbors
+	double	dmax;	// squared distance of the farthest candidate, once k candidates are found
+	vector< pair<double, int> >	heap;
+
+	void Add(double d2, int n)
+	{
+		if (heap.size() < k)
+		{
+			heap.push_back(pair<double, int>(d2, n));
+			push_heap(heap.begin(), heap.end());
+			if (heap.size() == k) dmax = heap.front().first;
+		}
+		else if (d2 < dmax)
+		{
+			pop_heap(heap.begin(), heap.end());
+			heap.back() = pair<double, int>(d2, n);
+			push_heap(heap.begin(), heap.end());
+			dmax = heap.front().first;
+		}
+	}
+};
+
+//-----------------------------------------------------------------------------
+FEKDTree::FEKDTree()
+{
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::Clear()
+{
+	m_pt.clear();
+	m_id.clear();
+	m_axis.clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::Build(const std::vector<vec3d>& points)
+{
+	int N = (int)points.size();
+
+	// the ranges are built by permuting the index array
+	m_pt = points;
+	m_id.resize(N);
+	for (int i = 0; i < N; ++i) m_id[i] = i;
+	m_axis.assign(N, 0);
+	BuildRange(0, N);
+
+	// store the points in tree order so that the queries access them sequentially
+	for (int i = 0; i < N; ++i) m_pt[i] = points[m_id[i]];
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::BuildRange(int n0, int n1)
+{
+	if (n1 - n0 <= KDTREE_LEAF_SIZE) return;
+
+	// split along the largest dimension of the bounding box
+	vec3d r0 = m_pt[m_id[n0]], r1 = r0;
+	for (int i = n0 + 1; i < n1; ++i)
+	{
+		const vec3d& r = m_pt[m_id[i]];
+		r0.x = min(r0.x, r.x); r1.x = max(r1.x, r.x);
+		r0.y = min(r0.y, r.y); r1.y = max(r1.y, r.y);
+		r0.z = min(r0.z, r.z); r1.z = max(r1.z, r.z);
+	}
+	vec3d dr = r1 - r0;
+	int axis = 0;
+	if (dr.y > dr(axis)) axis = 1;
+	if (dr.z > dr(axis)) axis = 2;
+
+	// place the median point in the middle of the range
+	int mid = (n0 + n1) / 2;
+	const vector<vec3d>& pt = m_pt;
+	nth_element(m_id.begin() + n0, m_id.begin() + mid, m_id.begin() + n1, [&](int a, int b) {
+		return (pt[a](axis) < pt[b](axis));
+	});
+	m_axis[mid] = (char)axis;
+
+	BuildRange(n0, mid);
+	BuildRange(mid + 1, n1);
+}
+
+//-----------------------------------------------------------------------------
+void FEKDTree::SearchRange(int n0, int n1, QUERY& q) const
+{
+	if (n1 - n0 <= KDTREE_LEAF_SIZE)
+	{
+		for (int i = n0; i < n1; ++i)
+		{
+			vec3d dr = m_pt[i] - q.x;
+			q.Add(dr*dr, i);
+		}
+		return;
+	}
+
+	int mid = (n0 + n1) / 2;
+	int axis = m_axis[mid];
+	vec3d dr = q.x - m_pt[mid];
+	q.Add(dr*dr, mid);
+
+	// visit the side that contains the query point first, and the other
+	// side only if it can still contain a closer point.
+	double d = dr(axis);
+	if (d < 0)
+	{
+		SearchRange(n0, mid, q);
+		if (d*d < q.dmax) SearchRange(mid + 1, n1, q);
+	}
+	else
+	{
+		SearchRange(mid + 1, n1, q);
+		if (d*d < q.dmax) SearchRange(n0, mid, q);
+	}
+}
+
+//-----------------------------------------------------------------------------
+int FEKDTree::FindNearestNeighbors(const vec3d& x, int k, std::vector<int>& closestNodes) const
+{
+	int N = Points();
+	if (k > N) k = N;
+	if (k <= 0) { closestNodes.clear(); return 0; }
+
+	QUERY q;
+	q.x = x;
+	q.k = k;
+	q.dmax = numeric_limits<double>::max();
+	q.heap.reserve(k);
+	SearchRange(0, N, q);
+
+	// sort from closest to farthest
+	sort_heap(q.heap.begin(), q.heap.end());
+	closestNodes.resize(k);
+	for (int i = 0; i < k; ++i) closestNodes[i] = m_id[q.heap[i].second];
+
+	return k;
+}
+
+//-----------------------------------------------------------------------------
+int FEKDTree::FindNearest(const vec3d& x) const
+{
+	vector<int> closestNodes;
+	if (FindNearestNeighbors(x, 1, closestNodes) == 0) return -1;
+	return closestNodes[0];
+}
@@ -0,0 +1,69 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+#pragma once
+#include "vec3d.h"
+#include <vector>
+#include "fecore_api.h"
+
+//-----------------------------------------------------------------------------
+//! A static k-d tree for nearest-neighbor queries on a fixed point set.
+//! The tree is stored in flat arrays: the points are reordered so that each
+//! subtree occupies a contiguous range and the splitting point of a range is
+//! its middle element. Queries do not modify the tree, so they can be called
+//! concurrently from multiple threads.
+class FECORE_API FEKDTree
+{
+public:
+	FEKDTree();
+
+	//! build the tree for the given points
+	void Build(const std::vector<vec3d>& points);
+
+	//! clear all data
+	void Clear();
+
+	//! number of points in the tree
+	int Points() const { return (int)m_pt.size(); }
+
+	//! find the k closest points to x. On return, closestNodes contains the
+	//! indices (in the original point list) sorted from closest to farthest.
+	//! Returns the number of points found, which is less than k only if the
+	//! tree has fewer than k points.
+	int FindNearestNeighbors(const vec3d& x, int k, std::vector<int>& closestNodes) const;
+
+	//! find the closest point to x. Returns -1 if the tree is empty.
+	int FindNearest(const vec3d& x) const;
+
+private:
+	struct QUERY;
+	void BuildRange(int n0, int n1);
+	void SearchRange(int n0, int n1, QUERY& q) const;
+
+private:
+	std::vector<vec3d>	m_pt;	//!< reordered points
+	std::vector<int>	m_id;	//!< original index of the reordered points
+	std::vector<char>	m_axis;	//!< split axis for the range whose middle element is at this position
+};
@@ -35,6 +35,24 @@ SOFTWARE.*/
 #include "FEDomain.h"
 #include "FEGlobalMatrix.h"
 
+//-----------------------------------------------------------------------------
+void FELinearConstraintBuffer::Assemble(SparseMatrix& K, vector<double>& R)
+{
+	for (size_t n = 0; n < m_K.size(); ++n)
+	{
+		const ENTRY& e = m_K[n];
+		K.add(e.i, e.j, e.v);
+	}
+
+	for (size_t n = 0; n < m_R.size(); ++n)
+	{
+		const RHS_ENTRY& e = m_R[n];
+		R[e.i] += e.v;
+	}
+
+	Clear();
+}
+
 //-----------------------------------------------------------------------------
 FELinearConstraintManager::FELinearConstraintManager(FEModel* fem) : m_fem(fem)
 {
@@ -130,6 +148,7 @@ void FELinearConstraintManager::Serialize(DumpStream& ar)
 			m_LCT.resize(nr, nc);
 			ar.read(&m_LCT(0,0), sizeof(int), nr*nc);
 		}
+		InitNodeFlags();
 	}
 }
 
@@ -318,6 +337,25 @@ void FELinearConstraintManager::InitTable()
 			m_LCT(n, m) = i;
 		}
 	}
+
+	InitNodeFlags();
+}
+
+//-----------------------------------------------------------------------------
+// Flag the nodes that have at least one constrained dof. This allows a quick 
+// test whether an element matrix needs to be processed by AssembleStiffness.
+void FELinearConstraintManager::InitNodeFlags()
+{
+	int nr = m_LCT.rows();
+	int nc = m_LCT.columns();
+	m_node.assign(nr, 0);
+	for (int i = 0; i < nr; ++i)
+	{
+		for (int j = 0; j < nc; ++j)
+		{
+			if (m_LCT(i, j) >= 0) { m_node[i] = 1; break; }
+		}
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -406,6 +444,30 @@ void FELinearConstraintManager::AssembleResidual(vector<double>& R, vector<int>&
 
 //-----------------------------------------------------------------------------
 void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<double>& R, vector<double>& ui, const vector<int>& en, const vector<int>& lmi, const vector<int>& lmj, const matrix& ke)
+{
+	// (rigid matrices will not have the node list set and therefore should be ignored)
+	if (en.size() == 0) return;
+
+	FELinearConstraintBuffer buf;
+	AssembleStiffness(buf, ui, en, lmi, lmj, ke);
+	buf.Assemble(G, R);
+}
+
+//-----------------------------------------------------------------------------
+// see if any of the nodes in the list is referenced by an active linear constraint
+bool FELinearConstraintManager::IsConstrained(const vector<int>& en) const
+{
+	const int nn = (int)m_node.size();
+	for (size_t i = 0; i < en.size(); ++i)
+	{
+		int n = en[i];
+		if ((n >= 0) && (n < nn) && m_node[n]) return true;
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+void FELinearConstraintManager::AssembleStiffness(FELinearConstraintBuffer& buf, vector<double>& ui, const vector<int>& en, const vector<int>& lmi, const vector<int>& lmj, const matrix& ke)
 {
 	FEMesh& mesh = m_fem->GetMesh();
 
@@ -418,8 +480,6 @@ void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<doub
 	int ndn = ndof / (int)en.size();
 	const int nodes = (int)en.size();
 
-	SparseMatrix& K = *(&G);
-
 	// loop over all stiffness components 
 	// and correct for linear constraints
 	for (int i = 0; i<ndof; ++i)
@@ -443,12 +503,12 @@ void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<doub
 					int I = mesh.Node((*is)->node).m_ID[(*is)->dof];
 					int J = lmj[j];
 					double kij = (*is)->val*ke[i][j];
-					if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
+					if ((J >= 0) && (I >= 0)) buf.AddStiffness(I, J, kij);
 					else
 					{
 						// adjust for prescribed dofs
 						J = -J - 2;
-						if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
+						if ((J >= 0) && (I >= 0)) buf.AddRHS(I, -kij*ui[J]);
 					}
 				}
 			}
@@ -465,12 +525,12 @@ void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<doub
 					int I = lmi[i];
 					int J = mesh.Node((*js)->node).m_ID[(*js)->dof];
 					double kij = (*js)->val*ke[i][j];
-					if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
+					if ((J >= 0) && (I >= 0)) buf.AddStiffness(I, J, kij);
 					else
 					{
 						// adjust for prescribed dofs
 						J = -J - 2;
-						if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
+						if ((J >= 0) && (I >= 0)) buf.AddRHS(I, -kij*ui[J]);
 					}
 				}
 
@@ -479,7 +539,7 @@ void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<doub
 				{
 					double ri = ke[i][j] * m_up[lj];
 					int I = lmi[i];
-					if (I >= 0) R[I] -= ri;
+					if (I >= 0) buf.AddRHS(I, -ri);
 				}
 			}
 			else if ((li >= 0) && (lj >= 0))
@@ -503,12 +563,12 @@ void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<doub
 						int J = mesh.Node((*js)->node).m_ID[(*js)->dof];;
 						double kij = ke[i][j] * (*is)->val*(*js)->val;
 
-						if ((J >= 0) && (I >= 0)) K.add(I, J, kij);
+						if ((J >= 0) && (I >= 0)) buf.AddStiffness(I, J, kij);
 						else
 						{
 							// adjust for prescribed dofs
 							J = -J - 2;
-							if ((J >= 0) && (I >= 0)) R[I] -= kij*ui[J];
+							if ((J >= 0) && (I >= 0)) buf.AddRHS(I, -kij*ui[J]);
 						}
 					}
 				}
@@ -521,7 +581,7 @@ void FELinearConstraintManager::AssembleStiffness(FEGlobalMatrix& G, vector<doub
 					{
 						int I = mesh.Node((*is)->node).m_ID[(*is)->dof];
 						double ri = (*is)->val * ke[i][j] * m_up[lj];
-						if (I >= 0) R[I] -= ri;
+						if (I >= 0) buf.AddRHS(I, -ri);
 					}
 				}
 			}
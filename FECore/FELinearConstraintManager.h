@@ -31,8 +31,51 @@ SOFTWARE.*/
 #include "table.h"
 
 class FEGlobalMatrix;
+class SparseMatrix;
 class matrix;
 
+//-----------------------------------------------------------------------------
+// This class collects the stiffness and residual contributions of the linear
+// constraints for a single thread. This allows the element loops to process the
+// linear constraints without locking the global matrix. The collected values 
+// are added to the global system after the element loop by calling Assemble.
+class FECORE_API FELinearConstraintBuffer
+{
+	struct ENTRY
+	{
+		int		i, j;
+		double	v;
+	};
+
+	struct RHS_ENTRY
+	{
+		int		i;
+		double	v;
+	};
+
+public:
+	FELinearConstraintBuffer() {}
+
+	// add a stiffness contribution
+	void AddStiffness(int i, int j, double v) { ENTRY e = { i, j, v }; m_K.push_back(e); }
+
+	// add a contribution to the right-hand side
+	void AddRHS(int i, double v) { RHS_ENTRY e = { i, v }; m_R.push_back(e); }
+
+	// add the collected values to the global system and clear the buffer
+	void Assemble(SparseMatrix& K, vector<double>& R);
+
+	// clear the buffer (this does not release the memory)
+	void Clear() { m_K.clear(); m_R.clear(); }
+
+	// see if the buffer is empty
+	bool IsEmpty() const { return (m_K.empty() && m_R.empty()); }
+
+private:
+	vector<ENTRY>		m_K;
+	vector<RHS_ENTRY>	m_R;
+};
+
 //-----------------------------------------------------------------------------
 // This class helps manage all the linear constraints
 class FECORE_API FELinearConstraintManager
@@ -81,6 +124,13 @@ public:
 	// assemble element matrix into (reduced) global matrix
 	void AssembleStiffness(FEGlobalMatrix& K, vector<double>& R, vector<double>& ui, const vector<int>& en, const vector<int>& lmi, const vector<int>& lmj, const matrix& ke);
 
+	// Same as above, but the contributions are collected in the buffer. This function 
+	// is thread-safe as long as each thread uses its own buffer.
+	void AssembleStiffness(FELinearConstraintBuffer& buf, vector<double>& ui, const vector<int>& en, const vector<int>& lmi, const vector<int>& lmj, const matrix& ke);
+
+	// see if any of the nodes in the list is referenced by an active linear constraint
+	bool IsConstrained(const vector<int>& en) const;
+
 	// called before the first reformation for each time step
 	void PrepStep();
 
@@ -89,10 +139,12 @@ public:
 
 protected:
 	void InitTable();
+	void InitNodeFlags();
 
 private:
 	FEModel* m_fem;
 	vector<FELinearConstraint*>	m_LinC;		//!< linear constraints data
 	table<int>					m_LCT;		//!< linear constraint table
+	vector<char>				m_node;		//!< flags the nodes that have constrained dofs
 	vector<double>				m_up;		//!< the inhomogenous component of the linear constraint
 };
@@ -146,6 +146,9 @@ bool FELinearSolver::Init()
 		return false;
 	}
 
+	// set the assembly mode
+	m_pK->SetColoredAssembly(m_assembly_mode == ASSEMBLY_MODE::COLORED_ASSEMBLY);
+
 	// Set the matrix formation flag
 	m_breform = true;
 
@@ -30,11 +30,15 @@ SOFTWARE.*/
 #include "FELinearSystem.h"
 #include "FELinearConstraintManager.h"
 #include "FEModel.h"
+#include "FEDomain.h"
+#include "sys.h"
 
 //-----------------------------------------------------------------------------
 FELinearSystem::FELinearSystem(FESolver* solver, FEGlobalMatrix& K, vector<double>& F, vector<double>& u, bool bsymm) : m_K(K), m_F(F), m_u(u), m_solver(solver)
 {
 	m_bsymm = bsymm;
+	m_bcolored = false;
+	m_bbuffered = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -88,8 +92,12 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 				if (I >= 0)
 				{
 					// dof i is not a prescribed degree of freedom
+					if (m_bcolored) m_F[I] -= ke[i][j] * m_u[J];
+					else
+					{
 #pragma omp atomic
-					m_F[I] -= ke[i][j] * m_u[J];
+						m_F[I] -= ke[i][j] * m_u[J];
+					}
 				}
 			}
 
@@ -98,16 +106,43 @@ void FELinearSystem::Assemble(const FEElementMatrix& ke)
 		}
 	}
 
-#pragma omp critical (LC_assemble)
-	{
+	// adjust for linear constraints
+	AssembleLinearConstraints(ke);
+}
+
+//-----------------------------------------------------------------------------
+// Only element matrices that reference constrained nodes need to be processed. 
+// Inside ForEachElement the contributions are collected in the calling thread's 
+// buffer, so no lock is needed. Other callers still need to serialize the update.
+void FELinearSystem::AssembleLinearConstraints(const FEElementMatrix& ke)
+{
 	FEModel* fem = m_solver->GetFEModel();
 	FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
-	if (LCM.LinearConstraints())
+	if (LCM.LinearConstraints() == 0) return;
+
+	const vector<int>& en = ke.Nodes();
+	if (LCM.IsConstrained(en) == false) return;
+
+	if (m_bbuffered)
+	{
+		FELinearConstraintBuffer& buf = m_LCbuf[omp_get_thread_num()];
+		LCM.AssembleStiffness(buf, m_u, en, ke.RowIndices(), ke.ColumnsIndices(), ke);
+	}
+	else
+	{
+#pragma omp critical (LC_assemble)
+		LCM.AssembleStiffness(m_K, m_F, m_u, en, ke.RowIndices(), ke.ColumnsIndices(), ke);
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FELinearSystem::FlushLinearConstraintBuffers()
+{
+	SparseMatrix& K = m_K;
+	for (size_t i = 0; i < m_LCbuf.size(); ++i)
 	{
-		const vector<int>& en = ke.Nodes();
-		LCM.AssembleStiffness(m_K, m_F, m_u, en, lmi, lmj, ke);
+		if (m_LCbuf[i].IsEmpty() == false) m_LCbuf[i].Assemble(K, m_F);
 	}
-	} // omp critical
 }
 
 //-----------------------------------------------------------------------------
@@ -142,3 +177,62 @@ void FELinearSystem::AssembleRHS(vector<int>& lm, vector<double>& fe)
 		}
 	}
 }
+
+//-----------------------------------------------------------------------------
+bool FELinearSystem::UseColoredAssembly(FEDomain& dom)
+{
+	if (m_K.ColoredAssembly() == false) return false;
+
+	// the coloring must be up-to-date
+	const FEElementColoring& C = dom.ElementColoring();
+	if ((C.Colors() == 0) || (C.TotalElements() != dom.Elements())) return false;
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void FELinearSystem::ForEachElement(FEDomain& dom, std::function<void(int iel)> f)
+{
+	// Linear constraints assemble into the rows of other nodes, so we buffer 
+	// their contributions per thread. This also keeps colored assembly valid.
+	FEModel* fem = m_solver->GetFEModel();
+	FELinearConstraintManager& LCM = fem->GetLinearConstraintManager();
+	bool bbuffered = m_bbuffered;
+	if (LCM.LinearConstraints() > 0)
+	{
+		int nt = omp_get_max_threads();
+		if ((int)m_LCbuf.size() < nt) m_LCbuf.resize(nt);
+		m_bbuffered = true;
+	}
+
+	if (UseColoredAssembly(dom))
+	{
+		const FEElementColoring& C = dom.ElementColoring();
+
+		SparseMatrix& K = m_K;
+		K.SetAtomicAssembly(false);
+		m_bcolored = true;
+		for (int c = 0; c < C.Colors(); ++c)
+		{
+			const int* elem = C.ElementList(c);
+			int NE = C.Elements(c);
+#pragma omp parallel for shared(f)
+			for (int i = 0; i < NE; ++i) f(elem[i]);
+		}
+		m_bcolored = false;
+		K.SetAtomicAssembly(true);
+	}
+	else
+	{
+		int NE = dom.Elements();
+#pragma omp parallel for shared(f)
+		for (int i = 0; i < NE; ++i) f(i);
+	}
+
+	// add the linear constraint contributions
+	if (m_bbuffered && (bbuffered == false))
+	{
+		FlushLinearConstraintBuffers();
+	}
+	m_bbuffered = bbuffered;
+}
@@ -29,9 +29,12 @@ SOFTWARE.*/
 #pragma once
 #include "FEGlobalMatrix.h"
 #include "matrix.h"
+#include "FELinearConstraintManager.h"
 #include <vector>
+#include <functional>
 
 class FESolver;
+class FEDomain;
 
 //-----------------------------------------------------------------------------
 // Experimental class to see if all the assembly operations can be moved to a class
@@ -68,10 +71,34 @@ public:
 	// This assembles a vetor to the RHS
 	void AssembleRHS(std::vector<int>& lm, std::vector<double>& fe);
 
+public:
+	// Loop over all the elements of a domain in parallel and call f with the element's index.
+	// f should calculate the element matrix and assemble it by calling Assemble. If the 
+	// global matrix uses colored assembly, the elements are processed one color at a time. 
+	// Since elements of the same color do not share nodes, the element matrices can then
+	// be assembled without atomic updates.
+	// Linear constraint contributions are collected per thread during the loop and
+	// added to the global system after the loop has finished.
+	void ForEachElement(FEDomain& dom, std::function<void(int iel)> f);
+
+protected:
+	// see if the elements of this domain can be assembled per color
+	bool UseColoredAssembly(FEDomain& dom);
+
+	// adjust the global system for the linear constraints
+	void AssembleLinearConstraints(const FEElementMatrix& ke);
+
+	// add the buffered linear constraint contributions to the global system
+	void FlushLinearConstraintBuffers();
+
 protected:
 	bool					m_bsymm;	//!< symmetry flag
 	FESolver*				m_solver;
 	FEGlobalMatrix&			m_K;	//!< The global stiffness matrix
 	std::vector<double>&	m_F;	//!< Contributions from prescribed degrees of freedom
 	std::vector<double>&	m_u;	//!< the array with prescribed values
+	bool					m_bcolored;	//!< set during a colored element loop
+	bool					m_bbuffered;	//!< set when linear constraints are buffered
+
+	std::vector<FELinearConstraintBuffer>	m_LCbuf;	//!< per-thread linear constraint buffers
 };
@@ -85,6 +85,7 @@ FEMaterialPoint::FEMaterialPoint(FEMaterialPointData* data)
 	m_index = -1;
 	m_shape = nullptr;
 	m_J0 = m_Jt = 1;
+	ClearLookupCache();
 }
 
 FEMaterialPoint::~FEMaterialPoint()
@@ -101,6 +102,7 @@ FEMaterialPoint::FEMaterialPoint(const FEMaterialPoint&)
 	m_data = nullptr;
 	m_J0 = m_Jt = 1;
 	m_index = -1;
+	ClearLookupCache();
 }
 
 FEMaterialPoint& FEMaterialPoint::operator = (const FEMaterialPoint&)
@@ -110,6 +112,7 @@ FEMaterialPoint& FEMaterialPoint::operator = (const FEMaterialPoint&)
 	m_data = nullptr;
 	m_J0 = m_Jt = 1;
 	m_index = -1;
+	ClearLookupCache();
 	return *this;
 }
 
@@ -144,6 +147,50 @@ void FEMaterialPoint::Append(FEMaterialPointData* pt)
 	if (pt == nullptr) return;
 	assert(m_data);
 	if (m_data) m_data->Append(pt);
+	ClearLookupCache();
+}
+
+bool FEMaterialPoint::m_buseCache = true;
+
+void FEMaterialPoint::SetLookupCache(bool b) { m_buseCache = b; }
+bool FEMaterialPoint::LookupCache() { return m_buseCache; }
+
+int FEMaterialPoint::NewTypeSlot()
+{
+	static std::atomic<int> slots(0);
+	return slots++;
+}
+
+// returns the location where the data for this slot was found, or 0 if the slot is not cached.
+unsigned long long FEMaterialPoint::FindData(int slot) const
+{
+	unsigned long long e = m_lookup[slot % LOOKUP_CACHE_SIZE].load(std::memory_order_relaxed);
+	return ((e >> 48) == (unsigned long long)(slot + 1) ? (e & 0xFFFFFFFFFFFFull) : 0);
+}
+
+void FEMaterialPoint::CacheData(int slot, FEMaterialPointData* pd) const
+{
+	CacheEntry(slot, (unsigned long long)(uintptr_t)pd);
+}
+
+void FEMaterialPoint::CacheComponent(int slot, int n) const
+{
+	CacheEntry(slot, ((unsigned long long)n << 1) | 1);
+}
+
+// Entries are stored as a single word, so concurrent lookups on the same point
+// (e.g. from contact interfaces) always see a consistent entry. Locations that 
+// do not fit in 48 bits are not cached.
+void FEMaterialPoint::CacheEntry(int slot, unsigned long long loc) const
+{
+	if ((slot >= 0xFFFF) || (loc == 0) || ((loc >> 48) != 0)) return;
+	const unsigned long long e = ((unsigned long long)(slot + 1) << 48) | loc;
+	m_lookup[slot % LOOKUP_CACHE_SIZE].store(e, std::memory_order_relaxed);
+}
+
+void FEMaterialPoint::ClearLookupCache()
+{
+	for (int i = 0; i < LOOKUP_CACHE_SIZE; ++i) m_lookup[i].store(0, std::memory_order_relaxed);
 }
 
 //=================================================================================================
@@ -31,7 +31,11 @@ SOFTWARE.*/
 #include "mat3d.h"
 #include "quatd.h"
 #include "FETimeInfo.h"
+#include "FEMemoryArena.h"
 #include <vector>
+#include <atomic>
+#include <type_traits>
+#include <stdint.h>
 
 class FEElement;
 class FEMaterialPoint;
@@ -52,6 +56,10 @@ public:
 	FEMaterialPointData(FEMaterialPointData* ppt = 0);
 	virtual ~FEMaterialPointData();
 
+	// material point data is allocated from the current arena, if there is one
+	static void* operator new(size_t size) { return fecore_arena_new(size); }
+	static void operator delete(void* p) { fecore_arena_delete(p); }
+
 public:
 	//! The init function is used to intialize data
 	virtual void Init();
@@ -107,6 +115,10 @@ public:
 	FEMaterialPoint(FEMaterialPointData* data = nullptr);
 	virtual ~FEMaterialPoint();
 
+	// material points are allocated from the current arena, if there is one
+	static void* operator new(size_t size) { return fecore_arena_new(size); }
+	static void operator delete(void* p) { fecore_arena_delete(p); }
+
 	// TODO: These functions copy  nothing! They are only included because we need them to create vectors!
 	//       I would like to delete these functions, but this means they cannot be used in vectors anymore.
 	FEMaterialPoint(const FEMaterialPoint&);
@@ -141,6 +153,29 @@ public:
 	template <class T> T* ExtractData();
 	template <class T> const T* ExtractData() const;
 
+	//! Returns the type slot of a material point data class. Slots are assigned
+	//! the first time a type is requested and are used to cache ExtractData lookups.
+	template <class T> static int TypeSlot();
+
+	//! Turn the ExtractData lookup cache on or off (on by default). This is only used for benchmarking.
+	static void SetLookupCache(bool b);
+	static bool LookupCache();
+
+private:
+	static int NewTypeSlot();
+
+	// The lookup cache stores for a type slot where the data was found. The slot 
+	// determines the entry, which packs the slot (+1) in the upper 16 bits and the 
+	// location in the lower 48 bits. The location is either the address of the data,
+	// or a component index (shifted left by one, with the lowest bit set). Since the
+	// data is aligned, the lowest bit of an address is never set.
+	enum { LOOKUP_CACHE_SIZE = 4 };
+	unsigned long long FindData(int slot) const;
+	void CacheData(int slot, FEMaterialPointData* pd) const;
+	void CacheComponent(int slot, int n) const;
+	void CacheEntry(int slot, unsigned long long loc) const;
+	void ClearLookupCache();
+
 public:
 	vec3d		m_r0;		//!< material point position
 	vec3d		m_rt;		//!< current point position
@@ -155,6 +190,11 @@ public:
 
 protected:
 	FEMaterialPointData* m_data;
+
+private:
+	mutable std::atomic<unsigned long long>	m_lookup[LOOKUP_CACHE_SIZE];	//!< ExtractData lookup cache
+
+	static bool	m_buseCache;
 };
 
 //-----------------------------------------------------------------------------
@@ -226,9 +266,69 @@ template <class T> inline const T* FEMaterialPointData::ExtractData() const
 }
 
 //-----------------------------------------------------------------------------
+// Casts for cached lookups. Data classes derived from FEMaterialPointData can
+// be cast statically, since the lookup already verified the type.
+template <class T> inline T* fecore_data_cast(FEMaterialPointData* p, std::true_type) { return static_cast<T*>(p); }
+template <class T> inline T* fecore_data_cast(FEMaterialPointData* p, std::false_type) { return dynamic_cast<T*>(p); }
+
+//-----------------------------------------------------------------------------
+template <class T> inline int FEMaterialPoint::TypeSlot()
+{
+	static const int slot = NewTypeSlot();
+	return slot;
+}
+
+//-----------------------------------------------------------------------------
+// This does the same search as FEMaterialPointData::ExtractData, but remembers
+// where the data was found, so that subsequent calls do not need to search.
+// Note that only successful searches are cached.
 template <class T> inline T* FEMaterialPoint::ExtractData()
 {
-	return (m_data ? m_data->ExtractData<T>() : nullptr);
+	if (m_data == nullptr) return nullptr;
+	if (m_buseCache == false) return m_data->ExtractData<T>();
+
+	const int slot = TypeSlot<T>();
+	unsigned long long loc = FindData(slot);
+	if (loc)
+	{
+		if (loc & 1)
+			return m_data->GetPointData((int)(loc >> 1))->ExtractData<T>();
+		else
+			return fecore_data_cast<T>((FEMaterialPointData*)(uintptr_t)loc, std::is_base_of<FEMaterialPointData, T>());
+	}
+
+	// first see if this is the correct type
+	T* p = dynamic_cast<T*>(m_data);
+	if (p) { CacheData(slot, m_data); return p; }
+
+	// check all the child classes
+	FEMaterialPointData* pt = m_data;
+	while (pt->m_pNext)
+	{
+		pt = pt->m_pNext;
+		p = dynamic_cast<T*>(pt);
+		if (p) { CacheData(slot, pt); return p; }
+	}
+
+	// search up
+	pt = m_data;
+	while (pt->m_pPrev)
+	{
+		pt = pt->m_pPrev;
+		p = dynamic_cast<T*>(pt);
+		if (p) { CacheData(slot, pt); return p; }
+	}
+
+	const int nc = m_data->Components();
+	for (int i = 0; i < nc; ++i)
+	{
+		FEMaterialPoint* mpi = m_data->GetPointData(i);
+		p = mpi->ExtractData<T>();
+		if (p) { CacheComponent(slot, i); return p; }
+	}
+
+	// Everything has failed. Material point data can not be found
+	return nullptr;
 }
 
 //-----------------------------------------------------------------------------
@@ -0,0 +1,133 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEMemoryArena.h"
+#include <new>
+#include <stdlib.h>
+#include <assert.h>
+
+// the current arena of each thread
+static thread_local FEMemoryArena* current_arena = nullptr;
+
+//-----------------------------------------------------------------------------
+FEMemoryArena::Scope::Scope(FEMemoryArena* arena)
+{
+	m_prev = current_arena;
+	current_arena = arena;
+}
+
+FEMemoryArena::Scope::~Scope()
+{
+	current_arena = m_prev;
+}
+
+//-----------------------------------------------------------------------------
+FEMemoryArena* FEMemoryArena::Current()
+{
+	return current_arena;
+}
+
+//-----------------------------------------------------------------------------
+FEMemoryArena::FEMemoryArena(size_t blockSize)
+{
+	m_blockSize = blockSize;
+	m_used = 0;
+	m_allocated = 0;
+}
+
+//-----------------------------------------------------------------------------
+FEMemoryArena::~FEMemoryArena()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+void FEMemoryArena::Clear()
+{
+	for (Block& b : m_block) ::operator delete(b.data);
+	m_block.clear();
+	m_used = 0;
+	m_allocated = 0;
+}
+
+//-----------------------------------------------------------------------------
+size_t FEMemoryArena::Capacity() const
+{
+	size_t n = 0;
+	for (const Block& b : m_block) n += b.size;
+	return n;
+}
+
+//-----------------------------------------------------------------------------
+void* FEMemoryArena::Allocate(size_t size)
+{
+	// round up to keep all allocations aligned
+	size = (size + ALIGNMENT - 1) & ~((size_t)ALIGNMENT - 1);
+
+	if (m_block.empty() || (m_used + size > m_block.back().size))
+	{
+		Block b;
+		b.size = (size > m_blockSize ? size : m_blockSize);
+		b.data = (char*) ::operator new(b.size);
+		m_block.push_back(b);
+		m_used = 0;
+	}
+
+	void* p = m_block.back().data + m_used;
+	m_used += size;
+	m_allocated += size;
+	return p;
+}
+
+//-----------------------------------------------------------------------------
+// The header is padded to the alignment so that the object itself is aligned.
+// It stores a pointer to the arena, or nullptr for heap allocations.
+union ArenaHeader
+{
+	FEMemoryArena*	arena;
+	char			pad[FEMemoryArena::ALIGNMENT];
+};
+
+void* fecore_arena_new(size_t size)
+{
+	FEMemoryArena* arena = current_arena;
+	size_t n = size + sizeof(ArenaHeader);
+	ArenaHeader* h = (ArenaHeader*)(arena ? arena->Allocate(n) : ::operator new(n));
+	h->arena = arena;
+	return (void*)(h + 1);
+}
+
+void fecore_arena_delete(void* p)
+{
+	if (p == nullptr) return;
+	ArenaHeader* h = ((ArenaHeader*)p) - 1;
+
+	// memory in an arena is released when the arena is cleared
+	if (h->arena == nullptr) ::operator delete((void*)h);
+}
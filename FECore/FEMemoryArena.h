@@ -0,0 +1,108 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include <vector>
+#include <stddef.h>
+
+//-----------------------------------------------------------------------------
+//! A simple arena (or region) allocator. Memory is handed out from large
+//! blocks by incrementing a pointer, so consecutive allocations are laid out
+//! contiguously. Individual allocations cannot be released; all memory is 
+//! released when the arena is cleared or destroyed.
+//!
+//! An arena can be made the current arena of a thread (see FEMemoryArena::Scope).
+//! Classes that support arena allocation (e.g. the material point classes) will
+//! then allocate their objects from that arena.
+class FECORE_API FEMemoryArena
+{
+	enum { DEFAULT_BLOCK_SIZE = 1 << 20 };
+
+public:
+	//! Makes an arena the current arena of this thread for the lifetime of the scope.
+	class FECORE_API Scope
+	{
+	public:
+		Scope(FEMemoryArena* arena);
+		~Scope();
+
+	private:
+		FEMemoryArena*	m_prev;
+	};
+
+public:
+	// all allocations are aligned to this value
+	enum { ALIGNMENT = 16 };
+
+public:
+	FEMemoryArena(size_t blockSize = DEFAULT_BLOCK_SIZE);
+	~FEMemoryArena();
+
+	//! allocate memory from the arena
+	void* Allocate(size_t size);
+
+	//! Release all memory. This should only be called when none of 
+	//! the objects allocated from the arena are in use anymore.
+	void Clear();
+
+	//! number of bytes allocated from the arena
+	size_t Allocated() const { return m_allocated; }
+
+	//! total size of the blocks owned by the arena
+	size_t Capacity() const;
+
+	//! number of blocks
+	int Blocks() const { return (int)m_block.size(); }
+
+	//! the current arena of this thread (or nullptr if there is none)
+	static FEMemoryArena* Current();
+
+private:
+	FEMemoryArena(const FEMemoryArena&) = delete;
+	void operator = (const FEMemoryArena&) = delete;
+
+private:
+	struct Block
+	{
+		char*	data;
+		size_t	size;
+	};
+
+	std::vector<Block>	m_block;		//!< allocated blocks
+	size_t	m_blockSize;	//!< (minimum) size of new blocks
+	size_t	m_used;			//!< bytes used in last block
+	size_t	m_allocated;	//!< total bytes allocated
+};
+
+//-----------------------------------------------------------------------------
+//! Helper functions for classes whose objects can be allocated from the current arena.
+//! Each allocation is preceded by a small header that records whether the object
+//! lives in an arena, so that operator delete knows whether to release the memory.
+FECORE_API void* fecore_arena_new(size_t size);
+FECORE_API void fecore_arena_delete(void* p);
@@ -99,6 +99,9 @@ void FEMesh::Serialize(DumpStream& ar)
 	}
 	ar.UnlockPointerTable();
 
+	// the nodes own their data after a (deep) load, so we need to move it to the mesh
+	if ((ar.IsShallow() == false) && ar.IsLoading()) UpdateNodeDofData();
+
 	// stream domain data
 	ar & m_Domain;
 
@@ -243,6 +246,7 @@ void FEMesh::CreateNodes(int nodes)
 {
 	assert(nodes);
 	m_Node.resize(nodes);
+	UpdateNodeDofData();
 
 	// set the default node IDs
 	for (int i=0; i<nodes; ++i) Node(i).SetID(i+1);
@@ -268,6 +272,7 @@ void FEMesh::AddNodes(int nodes)
 	if (N0 > 0) n0 = m_Node[N0-1].GetID() + 1;
 
 	m_Node.resize(N0 + nodes);
+	UpdateNodeDofData();
 	for (int i=0; i<nodes; ++i) m_Node[i+N0].SetID(n0+i);
 
 	delete m_ELT; m_ELT = nullptr;
@@ -278,10 +283,69 @@ void FEMesh::AddNodes(int nodes)
 void FEMesh::SetDOFS(int n)
 {
 	int NN = Nodes();
+	m_dofData.Create(NN, n);
+#pragma omp parallel for
+	for (int i = 0; i < NN; ++i)
+	{
+		m_Node[i].Attach(m_dofData, i);
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Reallocate the nodal dof data after the node list has changed. The data of
+// nodes that have the mesh's dof count is retained, all other nodes are reset.
+void FEMesh::UpdateNodeDofData()
+{
+	int NN = Nodes();
+	int ndofs = m_dofData.Dofs();
+	if ((ndofs == 0) && (NN > 0)) ndofs = m_Node[0].dofs();
+	if (ndofs == 0) { m_dofData.Clear(); return; }
+
+	// The nodes may still refer to the old storage, so we must copy
+	// the data before the old storage is released.
+	FENodeDofData data;
+	data.Create(NN, ndofs);
 #pragma omp parallel for
 	for (int i = 0; i < NN; ++i)
 	{
-		m_Node[i].SetDOFS(n);
+		m_Node[i].Attach(data, i, true);
+	}
+
+	// swapping does not move the data, so the nodes remain attached.
+	std::swap(m_dofData, data);
+}
+
+//-----------------------------------------------------------------------------
+// Nodes that own their dof data (i.e. their number of dofs was changed after they 
+// were attached) are not part of the contiguous storage. The nodes that have the
+// mesh's dof count are moved back to the mesh's storage, and the others are 
+// updated one by one.
+void FEMesh::UpdateValues()
+{
+	int NN = Nodes();
+	if (m_dofData.Nodes() != NN) UpdateNodeDofData();
+
+	int ndofs = m_dofData.Dofs();
+	int detached = 0;
+	for (int i = 0; i < NN; ++i)
+	{
+		FENode& node = m_Node[i];
+		if (node.IsAttached() == false)
+		{
+			if (node.dofs() == ndofs) node.Attach(m_dofData, i, true);
+			else detached++;
+		}
+	}
+
+	m_dofData.UpdateValues();
+
+	if (detached > 0)
+	{
+		for (int i = 0; i < NN; ++i)
+		{
+			FENode& node = m_Node[i];
+			if (node.IsAttached() == false) node.UpdateValues();
+		}
 	}
 }
 
@@ -382,6 +446,7 @@ void FEMesh::InitMaterialPoints()
 void FEMesh::Clear()
 {
 	m_Node.clear();
+	m_dofData.Clear();
 	for (size_t i=0; i<m_Domain.size (); ++i) delete m_Domain [i];
 
 	// TODO: Surfaces are currently managed by the classes that use them so don't delete them
@@ -1260,6 +1325,7 @@ void FEMesh::CopyFrom(FEMesh& mesh)
 
 	int N0 = mesh.Nodes();
 	CreateNodes(N0);
+	if (N0 > 0) SetDOFS(mesh.Dofs());
 	for (int i = 0; i < N0; ++i)
 	{
 		Node(i) = mesh.Node(i);
@@ -128,6 +128,15 @@ public:
 	//! Set the number of degrees of freedom on this mesh
 	void SetDOFS(int n);
 
+	//! return the number of degrees of freedom per node
+	int Dofs() const { return m_dofData.Dofs(); }
+
+	//! copy the current nodal values to the previous values for all nodes
+	void UpdateValues();
+
+	//! access to the contiguous nodal dof data
+	FENodeDofData& NodeDofData() { return m_dofData; }
+
 	//! update bounding box
 	void UpdateBox();
 
@@ -296,8 +305,13 @@ public: // data maps
 	int DataMaps() const;
 	FEDataMap* GetDataMap(int i);
 
+private:
+	//! (re)allocate the nodal dof storage and attach all nodes to it
+	void UpdateNodeDofData();
+
 private:
 	vector<FENode>		m_Node;		//!< nodes
+	FENodeDofData		m_dofData;	//!< nodal dof data
 	vector<FEDomain*>	m_Domain;	//!< list of domains
 	vector<FESurface*>	m_Surf;		//!< surfaces
 	vector<FEEdge*>		m_Edge;		//!< Edges
@@ -88,6 +88,9 @@ public:
 	// evaluate the parameter at a material point
 	double operator () (const FEMaterialPoint& pt) { return m_scl*(*m_val)(pt); }
 
+	// evaluate the parameter at an array of n material points
+	void values(const FEMaterialPoint* const* pt, int n, double* val);
+
 	// is this a const value
 	bool isConst() const;
 
@@ -0,0 +1,168 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "FEModelSnapshot.h"
+#include "FEModel.h"
+#include "FEMesh.h"
+#include "FEDomain.h"
+#include "Timer.h"
+#include "DumpBufferStream.h"
+
+//-----------------------------------------------------------------------------
+FEModelSnapshot::FEModelSnapshot(FEModel* fem) : m_fem(fem), m_dmp(*fem)
+{
+	m_bvalid = false;
+	m_bclean = false;
+	m_breused = false;
+	m_saveTime = 0.0;
+	m_restoreTime = 0.0;
+	m_totalSaveTime = 0.0;
+	m_nsaves = 0;
+}
+
+//-----------------------------------------------------------------------------
+// (Re)create the element blocks. Returns false if the blocks had to be recreated.
+bool FEModelSnapshot::UpdateBlocks()
+{
+	FEMesh& mesh = m_fem->GetMesh();
+
+	// see if the current blocks are still valid
+	int n = 0;
+	bool bvalid = true;
+	for (int i = 0; (i < mesh.Domains()) && bvalid; ++i)
+	{
+		FEDomain* dom = &mesh.Domain(i);
+		int NE = dom->Elements();
+		for (int j = 0; j < NE; j += BLOCK_SIZE, ++n)
+		{
+			int last = (j + BLOCK_SIZE < NE ? j + BLOCK_SIZE : NE);
+			if ((n >= (int)m_block.size()) || (m_block[n].dom != dom) || (m_block[n].first != j) || (m_block[n].last != last))
+			{
+				bvalid = false;
+				break;
+			}
+		}
+	}
+	if (bvalid && (n == (int)m_block.size())) return true;
+
+	m_block.clear();
+	for (int i = 0; i < mesh.Domains(); ++i)
+	{
+		FEDomain* dom = &mesh.Domain(i);
+		int NE = dom->Elements();
+		for (int j = 0; j < NE; j += BLOCK_SIZE)
+		{
+			Block b;
+			b.dom = dom;
+			b.first = j;
+			b.last = (j + BLOCK_SIZE < NE ? j + BLOCK_SIZE : NE);
+			m_block.push_back(b);
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+void FEModelSnapshot::Save()
+{
+	Timer timer;
+	timer.start();
+
+	// store the model state, excluding the element data
+	m_dmp.clear();
+	m_dmp.ExcludeElementData(true);
+	m_fem->Serialize(m_dmp);
+
+	// The element data only needs to be stored if it changed since the last restore.
+	m_breused = (UpdateBlocks() && m_bvalid && m_bclean);
+	if (m_breused == false)
+	{
+		FEModel& fem = *m_fem;
+		int NB = (int)m_block.size();
+#pragma omp parallel for schedule(dynamic)
+		for (int i = 0; i < NB; ++i)
+		{
+			Block& b = m_block[i];
+			DumpBufferStream ar(fem, b.buf);
+			ar.clear();
+			ar.Open(true, true);
+			b.dom->SerializeElementData(ar, b.first, b.last);
+		}
+	}
+
+	m_bvalid = true;
+	m_bclean = false;
+
+	timer.stop();
+	m_saveTime = timer.GetTime();
+	m_totalSaveTime += m_saveTime;
+	m_nsaves++;
+}
+
+//-----------------------------------------------------------------------------
+bool FEModelSnapshot::Restore()
+{
+	if (m_bvalid == false) return false;
+
+	Timer timer;
+	timer.start();
+
+	// restore the element data
+	FEModel& fem = *m_fem;
+	int NB = (int)m_block.size();
+#pragma omp parallel for schedule(dynamic)
+	for (int i = 0; i < NB; ++i)
+	{
+		Block& b = m_block[i];
+		DumpBufferStream ar(fem, b.buf);
+		ar.Open(false, true);
+		b.dom->SerializeElementData(ar, b.first, b.last);
+	}
+
+	// restore the rest of the model
+	m_dmp.Open(false, true);
+	m_dmp.ExcludeElementData(true);
+	m_fem->Serialize(m_dmp);
+
+	// the element data now matches the snapshot
+	m_bclean = true;
+
+	timer.stop();
+	m_restoreTime = timer.GetTime();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+size_t FEModelSnapshot::Size() const
+{
+	size_t n = m_dmp.size();
+	for (const Block& b : m_block) n += b.buf.size();
+	return n;
+}
@@ -0,0 +1,98 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "fecore_api.h"
+#include "DumpMemStream.h"
+#include <vector>
+
+class FEModel;
+class FEDomain;
+
+//-----------------------------------------------------------------------------
+//! This class stores the state of a model so that it can be restored later. 
+//! It is used to restore the model when a time step needs to be retried.
+//!
+//! The element data (i.e. the element and material point state) of the domains,
+//! which is usually the bulk of the state, is stored separately in blocks of
+//! elements. These blocks are saved and restored in parallel, and their buffers
+//! are reused. After a restore the element data is unchanged, so the next
+//! snapshot only needs to store the remaining model state.
+class FECORE_API FEModelSnapshot
+{
+	enum { BLOCK_SIZE = 256 };
+
+	struct Block
+	{
+		FEDomain*			dom;	// the domain
+		int					first;	// first element
+		int					last;	// one past last element
+		std::vector<char>	buf;	// serialized element data
+	};
+
+public:
+	FEModelSnapshot(FEModel* fem);
+
+	//! Store the current model state
+	void Save();
+
+	//! Restore the model state from the snapshot. Returns false if there is no snapshot.
+	bool Restore();
+
+	//! see if a snapshot was taken
+	bool IsValid() const { return m_bvalid; }
+
+	//! size of the snapshot (in bytes)
+	size_t Size() const;
+
+public:
+	double LastSaveTime() const { return m_saveTime; }
+	double LastRestoreTime() const { return m_restoreTime; }
+	double TotalSaveTime() const { return m_totalSaveTime; }
+	int Saves() const { return m_nsaves; }
+
+	//! returns true if the element data was reused in the last save
+	bool ElementDataReused() const { return m_breused; }
+
+private:
+	bool UpdateBlocks();
+
+private:
+	FEModel*			m_fem;
+	DumpMemStream		m_dmp;		//!< model state, excluding element data
+	std::vector<Block>	m_block;	//!< element data blocks
+
+	bool	m_bvalid;		//!< a snapshot was taken
+	bool	m_bclean;		//!< element data has not changed since last restore
+	bool	m_breused;		//!< element data was reused in last save
+
+	double	m_saveTime;			//!< time of last save
+	double	m_restoreTime;		//!< time of last restore
+	double	m_totalSaveTime;	//!< total time spent in saving
+	int		m_nsaves;			//!< number of saves
+};
@@ -58,6 +58,7 @@ BEGIN_FECORE_CLASS(FENewtonSolver, FESolver)
 		ADD_PARAMETER(m_breformtimestep     , "reform_each_time_step");
 		ADD_PARAMETER(m_breformAugment      , "reform_augment");
 		ADD_PARAMETER(m_bdivreform          , "diverge_reform");
+		ADD_PARAMETER(m_bincrementalProfile , "incremental_profile");
 //		ADD_PARAMETER(m_bdoreforms          , "do_reforms"  );
 		ADD_PARAMETER(m_Rmin, FE_RANGE_GREATER_OR_EQUAL(0.0), "min_residual");
 		ADD_PARAMETER(m_Rmax, FE_RANGE_GREATER_OR_EQUAL(0.0), "max_residual");
@@ -77,6 +78,8 @@ FENewtonSolver::FENewtonSolver(FEModel* pfem) : FESolver(pfem)
 	m_maxref = 15;
 
 	m_nref = 0;
+	m_nreshape = 0;
+	m_nskipReshape = 0;
 
     m_neq = 0;
     m_plinsolve = 0;
@@ -100,6 +103,7 @@ FENewtonSolver::FENewtonSolver(FEModel* pfem) : FESolver(pfem)
 	m_force_partition = 0;
 	m_breformtimestep = true;
 	m_breformAugment = false;
+	m_bincrementalProfile = false;
 }
 
 //-----------------------------------------------------------------------------
@@ -276,13 +280,32 @@ std::vector<double> FENewtonSolver::GetSolutionVector() const
 //! \todo Can we move this to the FEGlobalMatrix::Create function?
 bool FENewtonSolver::CreateStiffness(bool breset)
 {
+	// If only the "dynamic" part of the profile (e.g. contact) needs to be rebuilt, we first
+	// check if it actually changed. If not, we keep the matrix and the linear solver's
+	// symbolic factorization, and only the numerical factorization needs to be redone.
+	// With incremental profile updates, the dynamic elements may change without changing
+	// the matrix structure, in which case we can keep the factorization as well.
+	if (breset == false)
+	{
+		TRACK_TIME(TimerID::Timer_Reform);
+		m_nreshape++;
+		bool bchanged = m_pK->DynamicProfileChanged(GetFEModel(), m_neq);
+		if (bchanged && m_pK->IncrementalProfile()) bchanged = m_pK->DynamicStructureChanged(GetFEModel(), m_neq);
+		if (bchanged == false)
+		{
+			m_nskipReshape++;
+			feLogDebug("stiffness matrix profile unchanged: reshape skipped (%d of %d)\n", m_nskipReshape, m_nreshape);
+			return true;
+		}
+	}
+
 	{
 		TRACK_TIME(TimerID::Timer_Reform);
 		// clean up the solver
 		m_plinsolve->Destroy();
 
-		// clean up the stiffness matrix
-		m_pK->Clear();
+		// clean up the stiffness matrix, unless we only need to update its structure
+		if (breset || (m_pK->IncrementalProfile() == false)) m_pK->Clear();
 
 		// create the stiffness matrix
 		feLog("===== reforming stiffness matrix:\n");
@@ -407,6 +430,12 @@ bool FENewtonSolver::AllocateLinearSystem()
 		return false;
 	}
 
+	// set the assembly mode
+	m_pK->SetColoredAssembly(m_assembly_mode == ASSEMBLY_MODE::COLORED_ASSEMBLY);
+
+	// set the profile update mode
+	m_pK->SetIncrementalProfile(m_bincrementalProfile);
+
 	return true;
 }
 
@@ -501,6 +530,8 @@ bool FENewtonSolver::SolveStep()
 	m_nref = 0;		// nr of stiffness reformations
 	m_ntotref = 0;
 	m_naug = 0;		// nr of augmentations
+	m_nreshape = 0;		// nr of reshapes of the dynamic profile
+	m_nskipReshape = 0;	// nr of skipped reshapes
 
 	try
 	{
@@ -522,6 +553,7 @@ bool FENewtonSolver::SolveStep()
 		feLog("\nconvergence summary\n");
 		feLog("    number of iterations   : %d\n", m_niter);
 		feLog("    number of reformations : %d\n", m_nref);
+		if (m_nreshape > 0) feLog("    number of reshapes     : %d (skipped: %d)\n", m_nreshape, m_nskipReshape);
 	}
 
 	// if we don't want to hold on to the stiffness matrix, let's clean it up
@@ -727,6 +759,45 @@ void FENewtonSolver::SolveLinearSystem(vector<double>& x, vector<double>& R)
 		throw LinearSolverFailed();
 }
 
+//-----------------------------------------------------------------------------
+// The next three functions are used for calculating the sensitivity of the converged
+// solution U with respect to a model parameter p by direct differentiation. Since
+// R(U(p), p) = 0 at convergence, the sensitivity satisfies K*dU/dp = dR/dp, where dR/dp
+// is the partial derivative of the residual. These functions must be called after
+// the time step has converged and before the next time step starts.
+bool FENewtonSolver::SensitivityInit(vector<double>& R)
+{
+	R.assign(m_neq, 0.0);
+	if (Residual(R) == false) return false;
+
+	// The last factorization may be from an earlier iteration (or time step), so 
+	// we reform the stiffness matrix at the converged state. This does not count 
+	// towards the max nr of reformations of the time step.
+	int nref = m_nref;
+	m_nref = 0;
+	bool bret = ReformStiffness();
+	m_nref = nref;
+
+	return bret;
+}
+
+//-----------------------------------------------------------------------------
+void FENewtonSolver::SensitivitySolve(vector<double>& du, vector<double>& dR)
+{
+	du.assign(m_neq, 0.0);
+	SolveLinearSystem(du, dR);
+}
+
+//-----------------------------------------------------------------------------
+void FENewtonSolver::SensitivityUpdate(vector<double>& du)
+{
+	// At convergence, the increments of this time step were already added to the 
+	// total solution, but Update expects the total solution at the start of the time step.
+	m_Ut -= m_Ui;
+	Update(du);
+	m_Ut += m_Ui;
+}
+
 //-----------------------------------------------------------------------------
 //! rewind solver
 //! This is called when the time step failed.
@@ -209,6 +209,18 @@ public:
 	//! Update the model
 	virtual void UpdateModel();
 
+public: // parameter sensitivities
+	//! Prepare the sensitivity solves at the converged state of the current time step.
+	//! This evaluates the residual R and reforms the stiffness matrix at the converged state.
+	bool SensitivityInit(std::vector<double>& R);
+
+	//! Solve K*du = dR with the stiffness matrix that was reformed in SensitivityInit
+	void SensitivitySolve(std::vector<double>& du, std::vector<double>& dR);
+
+	//! Update the model to the converged state plus du. 
+	//! Call this with a zero vector to restore the converged state.
+	void SensitivityUpdate(std::vector<double>& du);
+
 public:
 	ConvergenceInfo GetResidualConvergence() { return m_residuNorm; }
 	ConvergenceInfo GetEnergyConvergence() { return m_energyNorm; }
@@ -236,9 +248,12 @@ public:
 	bool				m_bforceReform;		//!< forces a reform in QNInit
 	bool				m_bdivreform;		//!< reform when diverging
 	bool				m_bdoreforms;		//!< do reformations
+	bool				m_bincrementalProfile;	//!< only update the changed contact entries when reshaping
 
 	// counters
 	int		m_nref;			//!< nr of stiffness retormations
+	int		m_nreshape;		//!< nr of times the dynamic matrix profile was checked for changes
+	int		m_nskipReshape;	//!< nr of reshapes that were skipped because the profile did not change
 
 	// Error handling
 	bool	m_bzero_diagonal;	//!< check for zero diagonals
@@ -29,6 +29,48 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "FENode.h"
 #include "DumpStream.h"
+#include <string.h>
+
+//=============================================================================
+// FENodeDofData
+//-----------------------------------------------------------------------------
+FENodeDofData::FENodeDofData()
+{
+	m_nodes = 0;
+	m_ndofs = 0;
+}
+
+//-----------------------------------------------------------------------------
+void FENodeDofData::Create(int nodes, int ndofs)
+{
+	m_nodes = nodes;
+	m_ndofs = ndofs;
+	size_t N = (size_t)nodes * (size_t)ndofs;
+	m_ID.assign(N, -1);
+	m_BC.assign(N, 0);
+	m_val_t.assign(N, 0.0);
+	m_val_p.assign(N, 0.0);
+	m_Fr.assign(N, 0.0);
+}
+
+//-----------------------------------------------------------------------------
+void FENodeDofData::Clear()
+{
+	m_nodes = 0;
+	m_ndofs = 0;
+	m_ID.clear(); m_ID.shrink_to_fit();
+	m_BC.clear(); m_BC.shrink_to_fit();
+	m_val_t.clear(); m_val_t.shrink_to_fit();
+	m_val_p.clear(); m_val_p.shrink_to_fit();
+	m_Fr.clear(); m_Fr.shrink_to_fit();
+}
+
+//-----------------------------------------------------------------------------
+void FENodeDofData::UpdateValues()
+{
+	if (m_val_t.empty() == false)
+		memcpy(m_val_p.data(), m_val_t.data(), m_val_t.size()*sizeof(double));
+}
 
 //=============================================================================
 // FENode
@@ -43,24 +85,104 @@ FENode::FENode()
 
 	// default ID
 	m_nID = -1;
+
+	// no dofs yet
+	m_ndofs = 0;
+	m_BC = nullptr;
+	m_val_t = nullptr;
+	m_val_p = nullptr;
+	m_Fr = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+// Set the pointers to the node's own storage
+void FENode::SetPointers(int* pi, double* pd)
+{
+	int n = m_ndofs;
+	m_ID.m_d = pi; m_ID.m_n = n;
+	m_BC = (pi ? pi + n : nullptr);
+	m_val_t = pd;
+	m_val_p = (pd ? pd + n : nullptr);
+	m_Fr = (pd ? pd + 2*n : nullptr);
 }
 
 //-----------------------------------------------------------------------------
 void FENode::SetDOFS(int n)
 {
+	// allocate our own storage, unless we already have the right size
+	if (n != m_ndofs)
+	{
+		m_ndofs = n;
+		m_ibuf.assign(2*n, 0);
+		m_dbuf.assign(3*n, 0.0);
+		SetPointers((n > 0 ? m_ibuf.data() : nullptr), (n > 0 ? m_dbuf.data() : nullptr));
+	}
+
 	// initialize dof stuff
-	m_ID.assign(n, -1);
-	m_BC.assign(n, 0);
-	m_val_t.assign(n, 0.0);
-	m_val_p.assign(n, 0.0);
-	m_Fr.assign(n, 0.0);
+	for (int i = 0; i < n; ++i)
+	{
+		m_ID[i] = -1;
+		m_BC[i] = 0;
+		m_val_t[i] = 0.0;
+		m_val_p[i] = 0.0;
+		m_Fr[i] = 0.0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+void FENode::Attach(FENodeDofData& data, int i, bool copyData)
+{
+	int n = data.Dofs();
+	size_t off = (size_t)i * (size_t)n;
+
+	if (copyData && (n == m_ndofs))
+	{
+		for (int j = 0; j < n; ++j)
+		{
+			data.m_ID[off + j] = m_ID[j];
+			data.m_BC[off + j] = m_BC[j];
+			data.m_val_t[off + j] = m_val_t[j];
+			data.m_val_p[off + j] = m_val_p[j];
+			data.m_Fr[off + j] = m_Fr[j];
+		}
+	}
+
+	m_ndofs = n;
+	m_ID.m_d = data.m_ID.data() + off; m_ID.m_n = n;
+	m_BC = data.m_BC.data() + off;
+	m_val_t = data.m_val_t.data() + off;
+	m_val_p = data.m_val_p.data() + off;
+	m_Fr = data.m_Fr.data() + off;
+
+	// we no longer need our own storage
+	std::vector<int>().swap(m_ibuf);
+	std::vector<double>().swap(m_dbuf);
+}
+
+//-----------------------------------------------------------------------------
+// Copy the dof data of another node. If the size of the dof arrays differ,
+// the node will allocate its own storage.
+void FENode::CopyDofData(const FENode& n)
+{
+	if (m_ndofs != n.m_ndofs) SetDOFS(n.m_ndofs);
+
+	int N = m_ndofs;
+	for (int i = 0; i < N; ++i)
+	{
+		m_ID[i] = n.m_ID[i];
+		m_BC[i] = n.m_BC[i];
+		m_val_t[i] = n.m_val_t[i];
+		m_val_p[i] = n.m_val_p[i];
+		m_Fr[i] = n.m_Fr[i];
+	}
 }
 
 //-----------------------------------------------------------------------------
-FENode::FENode(const FENode& n)
+FENode::FENode(const FENode& n) : FENode()
 {
 	m_r0 = n.m_r0;
 	m_rt = n.m_rt;
+	m_ra = n.m_ra;
 	m_at = n.m_at;
 	m_rp = n.m_rp;
 	m_vp = n.m_vp;
@@ -73,18 +195,52 @@ FENode::FENode(const FENode& n)
 	m_rid = n.m_rid;
 	m_nstate = n.m_nstate;
 
+	CopyDofData(n);
+}
+
+//-----------------------------------------------------------------------------
+// The moved-to node refers to the same dof data as the original. This keeps
+// the nodes attached to the mesh's storage when the node list is reallocated.
+FENode::FENode(FENode&& n) noexcept
+{
+	m_r0 = n.m_r0;
+	m_rt = n.m_rt;
+	m_ra = n.m_ra;
+	m_at = n.m_at;
+	m_rp = n.m_rp;
+	m_vp = n.m_vp;
+	m_ap = n.m_ap;
+	m_d0 = n.m_d0;
+    m_dt = n.m_dt;
+    m_dp = n.m_dp;
+
+	m_nID = n.m_nID;
+	m_rid = n.m_rid;
+	m_nstate = n.m_nstate;
+
+	// moving the buffers does not change their data pointers
+	m_ibuf = std::move(n.m_ibuf);
+	m_dbuf = std::move(n.m_dbuf);
+
+	m_ndofs = n.m_ndofs;
 	m_ID = n.m_ID;
 	m_BC = n.m_BC;
 	m_val_t = n.m_val_t;
 	m_val_p = n.m_val_p;
 	m_Fr = n.m_Fr;
+
+	n.m_ndofs = 0;
+	n.SetPointers(nullptr, nullptr);
 }
 
 //-----------------------------------------------------------------------------
 FENode& FENode::operator = (const FENode& n)
 {
+	if (&n == this) return (*this);
+
 	m_r0 = n.m_r0;
 	m_rt = n.m_rt;
+	m_ra = n.m_ra;
 	m_at = n.m_at;
 	m_rp = n.m_rp;
 	m_vp = n.m_vp;
@@ -97,11 +253,7 @@ FENode& FENode::operator = (const FENode& n)
 	m_rid = n.m_rid;
 	m_nstate = n.m_nstate;
 
-	m_ID = n.m_ID;
-	m_BC = n.m_BC;
-	m_val_t = n.m_val_t;
-	m_val_p = n.m_val_p;
-	m_Fr = n.m_Fr;
+	CopyDofData(n);
 
 	return (*this);
 }
@@ -112,15 +264,42 @@ void FENode::Serialize(DumpStream& ar)
 {
 	ar & m_rt & m_at;
 	ar & m_rp & m_vp & m_ap;
-	ar & m_Fr;
-	ar & m_val_t & m_val_p;
+
+	// The dof arrays are streamed directly from and to the nodal storage. 
+	// The format is the same as that of a std::vector.
+	if (ar.IsSaving())
+	{
+		ar.write_array(m_Fr, m_ndofs);
+		ar.write_array(m_val_t, m_ndofs);
+		ar.write_array(m_val_p, m_ndofs);
+	}
+	else
+	{
+		int n = ar.read_array_size();
+		if (n != m_ndofs) SetDOFS(n);
+		ar.read_array(m_Fr, n);
+		n = ar.read_array_size(); assert(n == m_ndofs);
+		ar.read_array(m_val_t, n);
+		n = ar.read_array_size(); assert(n == m_ndofs);
+		ar.read_array(m_val_p, n);
+	}
 	ar & m_dt & m_dp;
 	if (ar.IsShallow() == false)
 	{
 		ar & m_nID;
 		ar & m_nstate;
-		ar & m_ID;
-		ar & m_BC;
+		if (ar.IsSaving())
+		{
+			ar.write_array(m_ID.data(), m_ndofs);
+			ar.write_array(m_BC, m_ndofs);
+		}
+		else
+		{
+			int n = ar.read_array_size(); assert(n == m_ndofs);
+			ar.read_array(m_ID.data(), n);
+			n = ar.read_array_size(); assert(n == m_ndofs);
+			ar.read_array(m_BC, n);
+		}
 		ar & m_r0;
 		ar & m_ra;
 		ar & m_rid;
@@ -132,5 +311,5 @@ void FENode::Serialize(DumpStream& ar)
 //! Update nodal values, which copies the current values to the previous array
 void FENode::UpdateValues()
 {
-	m_val_p = m_val_t;
+	for (int i = 0; i < m_ndofs; ++i) m_val_p[i] = m_val_t[i];
 }
@@ -34,6 +34,69 @@ SOFTWARE.*/
 
 class DumpStream;
 
+//-----------------------------------------------------------------------------
+//! Light-weight view of a node's dof array. This offers the subset of the
+//! std::vector interface that is used to access the nodal dof data.
+template <typename T> class FENodeDofArray
+{
+public:
+	FENodeDofArray() : m_d(nullptr), m_n(0) {}
+
+	T& operator [] (int i) { return m_d[i]; }
+	const T& operator [] (int i) const { return m_d[i]; }
+
+	size_t size() const { return (size_t) m_n; }
+	bool empty() const { return (m_n == 0); }
+
+	T* data() { return m_d; }
+	const T* data() const { return m_d; }
+
+private:
+	T*	m_d;	//!< pointer to first entry
+	int	m_n;	//!< number of entries
+
+	friend class FENode;
+};
+
+//-----------------------------------------------------------------------------
+//! Contiguous storage of the dof data for all the nodes of a mesh.
+
+//! The data of node i is stored at offset i*Dofs() in each of the arrays, so
+//! that loops over all nodes touch the data sequentially. The FENode objects
+//! of the mesh refer to this storage (see FENode::Attach).
+class FECORE_API FENodeDofData
+{
+public:
+	FENodeDofData();
+
+	//! allocate storage for the given number of nodes and dofs per node,
+	//! and initialize all the values to their default
+	void Create(int nodes, int ndofs);
+
+	//! release all data
+	void Clear();
+
+	//! number of nodes
+	int Nodes() const { return m_nodes; }
+
+	//! number of dofs per node
+	int Dofs() const { return m_ndofs; }
+
+	//! copy the current values to the previous values of all nodes
+	void UpdateValues();
+
+public:
+	std::vector<int>	m_ID;		//!< nodal equation numbers
+	std::vector<int>	m_BC;		//!< boundary condition flags
+	std::vector<double>	m_val_t;	//!< current nodal DOF values
+	std::vector<double>	m_val_p;	//!< previous nodal DOF values
+	std::vector<double>	m_Fr;		//!< equivalent nodal forces
+
+private:
+	int	m_nodes;
+	int	m_ndofs;
+};
+
 //-----------------------------------------------------------------------------
 //! This class defines a finite element node
 
@@ -44,6 +107,11 @@ class DumpStream;
 //! gives the equation number in the linear system of equations, (b) -1 if the
 //! dof is fixed, and (c) < -1 if the dof corresponds to a prescribed dof. In
 //! that case the corresponding equation number is given by -ID-2.
+//!
+//! The dof data (equation numbers, bc flags, values and loads) of the nodes of
+//! a mesh is stored in the mesh's FENodeDofData object and the node only keeps
+//! pointers to its block. A node that is not attached to a mesh (e.g. a copy)
+//! owns its dof data.
 
 class FECORE_API FENode
 {
@@ -63,12 +131,24 @@ public:
 	//! copy constructor
 	FENode(const FENode& n);
 
+	//! move constructor
+	FENode(FENode&& n) noexcept;
+
 	//! assignment operator
 	FENode& operator = (const FENode& n);
 
 	//! Set the number of DOFS
 	void SetDOFS(int n);
 
+	//! Make this node refer to the dof data of node i in the data array. If
+	//! copyData is true, the node's current dof data is copied to the array.
+	void Attach(FENodeDofData& data, int i, bool copyData = false);
+
+	//! see if the node's dof data is stored in an FENodeDofData object (i.e. the 
+	//! node does not own its dof data). Note that SetDOFS detaches the node if
+	//! the number of dofs changes.
+	bool IsAttached() const { return m_ibuf.empty(); }
+
 	//! Get the nodal ID
 	int GetID() const { return m_nID; }
 
@@ -147,7 +227,7 @@ public:
 	int get_bc(int ndof) const { return (m_BC[ndof] & 0x0F); }
 	bool is_active(int ndof) const { return ((m_BC[ndof] & 0xF0) != 0); }
 
-	int dofs() const { return (int) m_ID.size(); }
+	int dofs() const { return m_ndofs; }
     
 public:
 	// return position of shell back-node
@@ -156,11 +236,20 @@ public:
     vec3d sp() const { return m_rp - m_dp; }
 
 private:
-	std::vector<int>		m_BC;		//!< boundary condition array
-	std::vector<double>		m_val_t;	//!< current nodal DOF values
-	std::vector<double>		m_val_p;	//!< previous nodal DOF values
-	std::vector<double>		m_Fr;		//!< equivalent nodal forces
+	void SetPointers(int* pi, double* pd);
+	void CopyDofData(const FENode& n);
+
+private:
+	int			m_ndofs;	//!< number of dofs
+	int*		m_BC;		//!< boundary condition array
+	double*		m_val_t;	//!< current nodal DOF values
+	double*		m_val_p;	//!< previous nodal DOF values
+	double*		m_Fr;		//!< equivalent nodal forces
+
+	// storage of dof data for nodes that are not attached to a mesh
+	std::vector<int>	m_ibuf;
+	std::vector<double>	m_dbuf;
 
 public:
-	std::vector<int>		m_ID;	//!< nodal equation numbers
+	FENodeDofArray<int>	m_ID;	//!< nodal equation numbers
 };
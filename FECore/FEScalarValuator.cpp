@@ -33,11 +33,20 @@ SOFTWARE.*/
 #include "FEModel.h"
 #include "DumpStream.h"
 #include "log.h"
+#include <algorithm>
+
+//=============================================================================
+void FEScalarValuator::values(const FEMaterialPoint* const* pt, int n, double* val)
+{
+	for (int i = 0; i < n; ++i) val[i] = (*this)(*pt[i]);
+}
 
 //=============================================================================
 bool FEMathExpression::Init(const std::string& expr, FECoreBase* pc)
 {
 	Clear();
+	m_vars.clear();
+	m_code.Clear();
 
 	AddVariable("X");
 	AddVariable("Y");
@@ -56,56 +65,74 @@ bool FEMathExpression::Init(const std::string& expr, FECoreBase* pc)
 
 			ParamString ps(vari->Name().c_str());
 			FEParam* p = pc->FindParameter(ps);
-			if (p)
+			if (p == nullptr)
 			{
-				assert((p->type() == FE_PARAM_DOUBLE_MAPPED) || (p->type() == FE_PARAM_DOUBLE) || (p->type() == FE_PARAM_INT));
+				// see if it's a global variable
+				FEModel* fem = pc->GetFEModel();
+				p = fem->FindParameter(ps);
+			}
 
+			if (p)
+			{
 				MathParam mp;
-				mp.type = 0;
-				mp.pp = p;
+				switch (p->type())
+				{
+				case FE_PARAM_INT          : mp.type = PARAM_INT; break;
+				case FE_PARAM_DOUBLE       : mp.type = PARAM_DOUBLE; break;
+				case FE_PARAM_DOUBLE_MAPPED: mp.type = PARAM_MAPPED; break;
+				default:
+					{
+						// the parameter data is read directly, so other types cannot be used
+						const char* szvar = vari->Name().c_str();
+						feLogErrorEx(pc->GetFEModel(), "Parameter \"%s\" in math expression must be of type int or double.", szvar);
+						return false;
+					}
+				}
+				mp.pv = p->data_ptr();
+				mp.map = nullptr;
 				m_vars.push_back(mp);
 			}
 			else
 			{
 				// see if it's a data map
 				FEModel* fem = pc->GetFEModel();
-
-				// see if it's a global variable
-				p = fem->FindParameter(ps);
-				if (p)
-				{
-					MathParam mp;
-					mp.type = 0;
-					mp.pp = p;
-					m_vars.push_back(mp);
+				FEMesh& mesh = fem->GetMesh();
+
+				FEDataMap* map = mesh.FindDataMap(vari->Name());
+				assert(map);
+				if (map == nullptr) {
+					const char* szvar = vari->Name().c_str();
+					feLogErrorEx(fem, "Don't understand variable name \"%s\" in math expression.", szvar);
+					return false;
 				}
-				else
-				{
-					FEMesh& mesh = fem->GetMesh();
-
-					FEDataMap* map = mesh.FindDataMap(vari->Name());
-					assert(map);
-					if (map == nullptr) {
-						const char* szvar = vari->Name().c_str();
-						feLogErrorEx(fem, "Don't understand variable name \"%s\" in math expression.", szvar);
-						return false;
-					}
-					if (map->DataType() != FEDataType::FE_DOUBLE) {
-						const char* szvar = vari->Name().c_str();
-						feLogErrorEx(fem, "Variable \"%s\" is not a scalar variable.", szvar);
-						return false;
-					}
-
-					MathParam mp;
-					mp.type = 1;
-					mp.map = map;
-					m_vars.push_back(mp);
+				if (map->DataType() != FEDataType::FE_DOUBLE) {
+					const char* szvar = vari->Name().c_str();
+					feLogErrorEx(fem, "Variable \"%s\" is not a scalar variable.", szvar);
+					return false;
 				}
+
+				MathParam mp;
+				mp.type = DATA_MAP;
+				mp.pv = nullptr;
+				mp.map = map;
+				m_vars.push_back(mp);
 			}
 		}
 	}
 
 	assert(b);
+	if (b)
+	{
+		// Compile the expression. Time and the model parameters can change during
+		// the analysis, the coordinates and data maps remain fixed.
+		std::vector<bool> dyn(Variables(), false);
+		dyn[3] = true;
+		for (int i = 0; i < (int)m_vars.size(); ++i) dyn[4 + i] = (m_vars[i].type != DATA_MAP);
+
+		// if this fails, we'll evaluate the expression tree directly
+		m_code.Compile(*this, dyn);
+	}
+
 	return b;
 }
 
@@ -113,38 +140,116 @@ void FEMathExpression::operator = (const FEMathExpression& me)
 {
 	MSimpleExpression::operator=(me);
 	m_vars = me.m_vars;
+	m_code = me.m_code;
+}
+
+double FEMathExpression::paramValue(const MathParam& mp, const FEMaterialPoint& pt)
+{
+	switch (mp.type)
+	{
+	case PARAM_INT   : return (double)(*(int*)mp.pv);
+	case PARAM_DOUBLE: return *(double*)mp.pv;
+	case PARAM_MAPPED: return (*(FEParamDouble*)mp.pv)(pt);
+	case DATA_MAP    : return mp.map->value(pt);
+	}
+	assert(false);
+	return 0.0;
 }
 
 double FEMathExpression::value(FEModel* fem, const FEMaterialPoint& pt)
 {
-	std::vector<double> var(4 + m_vars.size());
+	// Use a register buffer on the stack, unless the expression is very large.
+	const int MAX_REGS = 64;
+	double buf[MAX_REGS];
+	std::vector<double> tmp;
+
+	int nreg = (m_code.IsValid() ? m_code.Registers() : Variables());
+	double* var = buf;
+	if (nreg > MAX_REGS) { tmp.resize(nreg); var = tmp.data(); }
+
 	var[0] = pt.m_r0.x;
 	var[1] = pt.m_r0.y;
 	var[2] = pt.m_r0.z;
 	var[3] = fem->GetTime().currentTime;
-	if (m_vars.empty() == false)
+	for (int i = 0; i < (int)m_vars.size(); ++i) var[4 + i] = paramValue(m_vars[i], pt);
+
+	if (m_code.IsValid()) return m_code.value(var);
+	else return value_s(std::vector<double>(var, var + Variables()));
+}
+
+void FEMathExpression::value(FEModel* fem, const FEMaterialPoint* const* pt, int n, double* val)
+{
+	std::vector<double> reg;
+	InitBatch(pt, n, reg);
+	EvalBatch(fem, pt, n, reg, val);
+}
+
+void FEMathExpression::InitBatch(const FEMaterialPoint* const* pt, int n, std::vector<double>& reg)
+{
+	reg.clear();
+	if (m_code.IsValid() == false) return;
+
+	reg.assign((size_t)n*m_code.Registers(), 0.0);
+	double* X = reg.data();
+	double* Y = X + n;
+	double* Z = Y + n;
+	for (int k = 0; k < n; ++k)
 	{
-		for (int i = 0; i < (int)m_vars.size(); ++i)
+		X[k] = pt[k]->m_r0.x;
+		Y[k] = pt[k]->m_r0.y;
+		Z[k] = pt[k]->m_r0.z;
+	}
+
+	for (int i = 0; i < (int)m_vars.size(); ++i)
+	{
+		const MathParam& mp = m_vars[i];
+		if (mp.type == DATA_MAP)
 		{
-			MathParam& mp = m_vars[i];
-			if (mp.type == 0)
-			{
-				FEParam* pi = mp.pp;
-				switch (pi->type())
-				{
-				case FE_PARAM_INT: var[4 + i] = (double)pi->value<int>(); break;
-				case FE_PARAM_DOUBLE: var[4 + i] = pi->value<double>(); break;
-				case FE_PARAM_DOUBLE_MAPPED: var[4 + i] = pi->value<FEParamDouble>()(pt); break;
-				}
-			}
-			else
+			double* v = reg.data() + (4 + i)*n;
+			for (int k = 0; k < n; ++k) v[k] = mp.map->value(*pt[k]);
+		}
+	}
+
+	m_code.EvalStatic(reg.data(), n);
+}
+
+void FEMathExpression::EvalBatch(FEModel* fem, const FEMaterialPoint* const* pt, int n, std::vector<double>& reg, double* val)
+{
+	if (n <= 0) return;
+	if (m_code.IsValid() == false)
+	{
+		for (int k = 0; k < n; ++k) val[k] = value(fem, *pt[k]);
+		return;
+	}
+	assert(reg.size() == (size_t)n*m_code.Registers());
+
+	double* T = reg.data() + 3*n;
+	const double t = fem->GetTime().currentTime;
+	for (int k = 0; k < n; ++k) T[k] = t;
+
+	for (int i = 0; i < (int)m_vars.size(); ++i)
+	{
+		const MathParam& mp = m_vars[i];
+		double* v = reg.data() + (4 + i)*n;
+		switch (mp.type)
+		{
+		case PARAM_INT:
+		case PARAM_DOUBLE:
 			{
-				FEDataMap& map = *mp.map;
-				var[4 + i] = map.value(pt);
+				const double c = paramValue(mp, *pt[0]);
+				for (int k = 0; k < n; ++k) v[k] = c;
 			}
+			break;
+		case PARAM_MAPPED:
+			for (int k = 0; k < n; ++k) v[k] = paramValue(mp, *pt[k]);
+			break;
 		}
 	}
-	return value_s(var);
+
+	m_code.EvalDynamic(reg.data(), n);
+
+	const double* r = m_code.Result(reg.data(), n);
+	for (int k = 0; k < n; ++k) val[k] = r[k];
 }
 
 //=============================================================================
@@ -218,6 +323,8 @@ bool FEMathValue::create(FECoreBase* pc)
 	m_parent = pc;
 
 	// initialize the math expression
+	m_reg.clear();
+	m_regPts.clear();
 	bool b = m_math.Init(m_expr, pc);
 	return b;
 }
@@ -239,6 +346,36 @@ double FEMathValue::operator()(const FEMaterialPoint& pt)
 	return m_math.value(GetFEModel(), pt);
 }
 
+void FEMathValue::values(const FEMaterialPoint* const* pt, int n, double* val)
+{
+	if (n <= 0) return;
+
+	// see if we can reuse the register block of the last call. Material points can be
+	// re-allocated at the same address (e.g. after a remesh), so we also check that 
+	// the reference positions are the same.
+	bool reuse = (m_regPts.size() == (size_t)n) && (m_reg.size() >= 3*(size_t)n) && std::equal(pt, pt + n, m_regPts.begin());
+	if (reuse)
+	{
+		const double* X = m_reg.data();
+		const double* Y = X + n;
+		const double* Z = Y + n;
+		for (int k = 0; k < n; ++k)
+		{
+			const vec3d& r0 = pt[k]->m_r0;
+			if ((X[k] != r0.x) || (Y[k] != r0.y) || (Z[k] != r0.z)) { reuse = false; break; }
+		}
+	}
+
+	if (reuse == false)
+	{
+		m_math.InitBatch(pt, n, m_reg);
+		if (m_reg.empty()) m_regPts.clear();
+		else m_regPts.assign(pt, pt + n);
+	}
+
+	m_math.EvalBatch(GetFEModel(), pt, n, m_reg, val);
+}
+
 //---------------------------------------------------------------------------------------
 
 FEMappedValue::FEMappedValue(FEModel* fem) : FEScalarValuator(fem), m_val(nullptr)
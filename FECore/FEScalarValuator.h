@@ -29,6 +29,7 @@ SOFTWARE.*/
 #pragma once
 #include "FEValuator.h"
 #include "MathObject.h"
+#include "MBytecode.h"
 #include "FEDataMap.h"
 #include "FENodeDataMap.h"
 
@@ -44,6 +45,9 @@ public:
 
 	virtual double operator()(const FEMaterialPoint& pt) = 0;
 
+	// evaluate the valuator at an array of n material points
+	virtual void values(const FEMaterialPoint* const* pt, int n, double* val);
+
 	virtual FEScalarValuator* copy() = 0;
 
 	virtual bool isConst() { return false; }
@@ -73,11 +77,13 @@ private:
 //---------------------------------------------------------------------------------------
 class FEMathExpression : public MSimpleExpression
 {
+	enum MathParamType { PARAM_INT, PARAM_DOUBLE, PARAM_MAPPED, DATA_MAP };
+
 	struct MathParam
 	{
-		int			type;	// 0 = param, 1 = map
-		FEParam* pp;
-		FEDataMap* map;
+		int			type;	// one of MathParamType
+		void*		pv;		// pointer to parameter data
+		FEDataMap*	map;
 	};
 
 public:
@@ -87,8 +93,22 @@ public:
 
 	double value(FEModel* fem, const FEMaterialPoint& pt);
 
+	// evaluate the expression at an array of n material points
+	void value(FEModel* fem, const FEMaterialPoint* const* pt, int n, double* val);
+
+	// Batch evaluation with a register block that is owned by the caller. InitBatch 
+	// evaluates all sub-expressions that do not depend on time or model parameters,
+	// so EvalBatch only needs to evaluate the remainder. The register block remains
+	// valid as long as the material points' reference positions do not change.
+	void InitBatch(const FEMaterialPoint* const* pt, int n, std::vector<double>& reg);
+	void EvalBatch(FEModel* fem, const FEMaterialPoint* const* pt, int n, std::vector<double>& reg, double* val);
+
+private:
+	double paramValue(const MathParam& mp, const FEMaterialPoint& pt);
+
 private:
 	std::vector<MathParam>	m_vars;
+	MBytecode				m_code;
 };
 
 //---------------------------------------------------------------------------------------
@@ -99,6 +119,8 @@ public:
 	~FEMathValue();
 	double operator()(const FEMaterialPoint& pt) override;
 
+	void values(const FEMaterialPoint* const* pt, int n, double* val) override;
+
 	bool Init() override;
 
 	FEScalarValuator* copy() override;
@@ -114,6 +136,12 @@ private:
 	FEMathExpression	m_math;
 	FECoreBase*			m_parent;
 
+	// register block of the last call to values(). It is reused as long as values()
+	// is called with the same material points, so only the dynamic part of the 
+	// expression needs to be evaluated. (Note that this makes values() not thread-safe.)
+	std::vector<double>					m_reg;
+	std::vector<const FEMaterialPoint*>	m_regPts;
+
 	DECLARE_FECORE_CLASS();
 };
 
@@ -52,6 +52,16 @@ enum EQUATION_ORDER
 	FEBIO2_ORDER
 };
 
+//-----------------------------------------------------------------------------
+// How element matrices are assembled into the global matrix
+// ATOMIC : all elements are processed concurrently and use atomic updates
+// COLORED: elements are processed per color (no shared nodes), without atomic updates
+enum ASSEMBLY_MODE
+{
+	ATOMIC_ASSEMBLY,
+	COLORED_ASSEMBLY
+};
+
 //-----------------------------------------------------------------------------
 // Solution variable
 class FESolutionVariable
@@ -191,6 +201,7 @@ public: //TODO Move these parameters elsewhere
 	int					m_msymm;		//!< matrix symmetry flag for linear solver allocation
 	int					m_eq_scheme;	//!< equation number scheme (used in InitEquations)
 	int					m_eq_order;		//!< normal or reverse ordering
+	int					m_assembly_mode;	//!< assembly mode (see ASSEMBLY_MODE)
 	int					m_neq;			//!< number of equations
 	std::vector<int>	m_part;			//!< partitions of linear system
 	std::vector<int>	m_dofMap;		//!< array stores for each equation the corresponding dof index
@@ -0,0 +1,171 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#include "stdafx.h"
+#include "FESurfaceBVH.h"
+#include <algorithm>
+using namespace std;
+
+//-----------------------------------------------------------------------------
+FESurfaceBVH::FESurfaceBVH()
+{
+	m_surf = nullptr;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::FacetBox(int nfacet, vec3d& rmin, vec3d& rmax) const
+{
+	int ne = FacetNodes(nfacet);
+	rmin = rmax = NodePosition(FacetNode(nfacet, 0));
+	for (int j = 1; j < ne; ++j)
+	{
+		const vec3d& r = NodePosition(FacetNode(nfacet, j));
+		if (r.x < rmin.x) rmin.x = r.x;
+		if (r.x > rmax.x) rmax.x = r.x;
+		if (r.y < rmin.y) rmin.y = r.y;
+		if (r.y > rmax.y) rmax.y = r.y;
+		if (r.z < rmin.z) rmin.z = r.z;
+		if (r.z > rmax.z) rmax.z = r.z;
+	}
+}
+
+//-----------------------------------------------------------------------------
+//! squared distance of a point to the bounding box of a tree node (zero if inside)
+double FESurfaceBVH::BoxDistance2(const BVHNode& nd, const vec3d& x)
+{
+	double dx = (x.x < nd.rmin.x ? nd.rmin.x - x.x : (x.x > nd.rmax.x ? x.x - nd.rmax.x : 0.0));
+	double dy = (x.y < nd.rmin.y ? nd.rmin.y - x.y : (x.y > nd.rmax.y ? x.y - nd.rmax.y : 0.0));
+	double dz = (x.z < nd.rmin.z ? nd.rmin.z - x.z : (x.z > nd.rmax.z ? x.z - nd.rmax.z : 0.0));
+	return dx*dx + dy*dy + dz*dz;
+}
+
+//-----------------------------------------------------------------------------
+void FESurfaceBVH::Create(FESurface* surf)
+{
+	m_surf = surf;
+	m_node.clear();
+	m_fac.clear();
+
+	int NF = (surf ? surf->Elements() : 0);
+	if (NF == 0) return;
+
+	m_fac.resize(NF);
+	for (int i = 0; i < NF; ++i) m_fac[i] = i;
+
+	// A balanced tree has about 2*NF/MAX_LEAF_SIZE nodes
+	m_node.reserve(4 * (NF / MAX_LEAF_SIZE + 1));
+	m_node.push_back(BVHNode());
+	Build(0, 0, NF, 0);
+}
+
+//-----------------------------------------------------------------------------
+//! Builds the tree recursively. The facets are split at the median of their centroids
+//! along the longest axis of the node's box.
+void FESurfaceBVH::Build(int inode, int first, int n, int depth)
+{
+	// calculate the bounding box of the node and of the facet centroids
+	vec3d rmin, rmax, cmin, cmax;
+	for (int i = first; i < first + n; ++i)
+	{
+		vec3d a, b;
+		FacetBox(m_fac[i], a, b);
+		vec3d c = (a + b)*0.5;
+		if (i == first) { rmin = a; rmax = b; cmin = cmax = c; }
+		else
+		{
+			rmin.x = min(rmin.x, a.x); rmin.y = min(rmin.y, a.y); rmin.z = min(rmin.z, a.z);
+			rmax.x = max(rmax.x, b.x); rmax.y = max(rmax.y, b.y); rmax.z = max(rmax.z, b.z);
+			cmin.x = min(cmin.x, c.x); cmin.y = min(cmin.y, c.y); cmin.z = min(cmin.z, c.z);
+			cmax.x = max(cmax.x, c.x); cmax.y = max(cmax.y, c.y); cmax.z = max(cmax.z, c.z);
+		}
+	}
+
+	BVHNode& nd = m_node[inode];
+	nd.rmin = rmin;
+	nd.rmax = rmax;
+	nd.first = first;
+	nd.n = n;
+	nd.left = -1;
+
+	if ((n <= MAX_LEAF_SIZE) || (depth >= MAX_DEPTH - 1)) return;
+
+	// find the split axis
+	vec3d d = cmax - cmin;
+	int axis = 0;
+	if ((d.y > d.x) && (d.y >= d.z)) axis = 1;
+	else if ((d.z > d.x) && (d.z > d.y)) axis = 2;
+
+	// split at the median
+	auto centroid = [&](int nf) {
+		vec3d a, b;
+		FacetBox(nf, a, b);
+		vec3d c = a + b;
+		return (axis == 0 ? c.x : (axis == 1 ? c.y : c.z));
+	};
+	int nl = n / 2;
+	nth_element(m_fac.begin() + first, m_fac.begin() + first + nl, m_fac.begin() + first + n, [&](int a, int b) {
+		return centroid(a) < centroid(b);
+	});
+
+	// create the children (note that this may reallocate m_node)
+	int left = (int)m_node.size();
+	m_node.push_back(BVHNode());
+	m_node.push_back(BVHNode());
+	m_node[inode].left = left;
+
+	Build(left    , first     , nl    , depth + 1);
+	Build(left + 1, first + nl, n - nl, depth + 1);
+}
+
+//-----------------------------------------------------------------------------
+//! Updates the boxes with the current nodal positions. Since children are always 
+//! stored after their parent, we can do this in a single backward pass.
+void FESurfaceBVH::Refit()
+{
+	for (int i = (int)m_node.size() - 1; i >= 0; --i)
+	{
+		BVHNode& nd = m_node[i];
+		if (nd.left < 0)
+		{
+			FacetBox(m_fac[nd.first], nd.rmin, nd.rmax);
+			for (int j = nd.first + 1; j < nd.first + nd.n; ++j)
+			{
+				vec3d a, b;
+				FacetBox(m_fac[j], a, b);
+				nd.rmin.x = min(nd.rmin.x, a.x); nd.rmin.y = min(nd.rmin.y, a.y); nd.rmin.z = min(nd.rmin.z, a.z);
+				nd.rmax.x = max(nd.rmax.x, b.x); nd.rmax.y = max(nd.rmax.y, b.y); nd.rmax.z = max(nd.rmax.z, b.z);
+			}
+		}
+		else
+		{
+			const BVHNode& n0 = m_node[nd.left];
+			const BVHNode& n1 = m_node[nd.left + 1];
+			nd.rmin.x = min(n0.rmin.x, n1.rmin.x); nd.rmin.y = min(n0.rmin.y, n1.rmin.y); nd.rmin.z = min(n0.rmin.z, n1.rmin.z);
+			nd.rmax.x = max(n0.rmax.x, n1.rmax.x); nd.rmax.y = max(n0.rmax.y, n1.rmax.y); nd.rmax.z = max(n0.rmax.z, n1.rmax.z);
+		}
+	}
+}
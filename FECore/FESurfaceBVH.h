@@ -0,0 +1,148 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+#pragma once
+#include "FESurface.h"
+#include <vector>
+
+//-----------------------------------------------------------------------------
+//! A bounding volume hierarchy (BVH) of axis-aligned boxes over the facets of a 
+//! surface. The tree is built once and can then be refitted when the nodes move, 
+//! as long as the surface's connectivity does not change. 
+//! The queries do not modify the tree, so they can be called from multiple threads.
+class FECORE_API FESurfaceBVH
+{
+	enum { MAX_LEAF_SIZE = 4 };	// max nr of facets per leaf
+	enum { MAX_DEPTH = 64 };	// max depth of the tree (limits the traversal stack)
+
+	struct BVHNode
+	{
+		vec3d	rmin, rmax;	// bounding box
+		int		left;		// index of first child (second child is left + 1), or -1 for leaves
+		int		first, n;	// range of facets in m_fac (leaves only)
+	};
+
+public:
+	FESurfaceBVH();
+
+	//! build the tree for a surface, using the current nodal positions
+	void Create(FESurface* surf);
+
+	//! update the boxes with the current nodal positions
+	void Refit();
+
+	//! see if the tree was built
+	bool IsValid() const { return (m_surf != nullptr) && (m_node.empty() == false); }
+
+	//! Find the surface node (local index) closest to x, or -1 if there is none. 
+	//! If R2 > 0, only nodes with a squared distance to x of at most R2 are considered.
+	int FindClosestNode(const vec3d& x, double R2 = 0.0) const
+	{
+		return FindClosestNode(x, R2, [](int) { return true; });
+	}
+
+	//! Same as above, but only considers nodes (local index) for which accept(node) returns true.
+	//! Ties are resolved in favor of the lowest node index, so the result is the same as for
+	//! a linear search over all the nodes.
+	template <class Filter> int FindClosestNode(const vec3d& x, double R2, Filter accept) const;
+
+private:
+	void Build(int inode, int first, int n, int depth);
+	void FacetBox(int nfacet, vec3d& rmin, vec3d& rmax) const;
+	const vec3d& NodePosition(int n) const { return m_surf->Node(n).m_rt; }
+	int FacetNodes(int nfacet) const { return m_surf->Element(nfacet).Nodes(); }
+	int FacetNode(int nfacet, int i) const { return m_surf->Element(nfacet).m_lnode[i]; }
+
+	static double BoxDistance2(const BVHNode& nd, const vec3d& x);
+
+private:
+	FESurface*				m_surf;	//!< the surface
+	std::vector<BVHNode>	m_node;	//!< the tree nodes (root is the first node)
+	std::vector<int>		m_fac;	//!< facet indices, ordered by leaf
+};
+
+//-----------------------------------------------------------------------------
+template <class Filter> int FESurfaceBVH::FindClosestNode(const vec3d& x, double R2, Filter accept) const
+{
+	if (m_node.empty()) return -1;
+
+	int imin = -1;
+	double d2min = 0.0;
+
+	int stack[2*MAX_DEPTH + 2];
+	int ns = 0;
+	stack[ns++] = 0;
+	while (ns > 0)
+	{
+		const BVHNode& nd = m_node[stack[--ns]];
+		double b2 = BoxDistance2(nd, x);
+		if ((R2 > 0) && (b2 > R2)) continue;
+		if ((imin >= 0) && (b2 > d2min)) continue;
+
+		if (nd.left < 0)
+		{
+			for (int i = nd.first; i < nd.first + nd.n; ++i)
+			{
+				int nf = m_fac[i];
+				int ne = FacetNodes(nf);
+				for (int j = 0; j < ne; ++j)
+				{
+					int m = FacetNode(nf, j);
+					vec3d dr = NodePosition(m) - x;
+					double d2 = dr*dr;
+					if ((R2 > 0) && (d2 > R2)) continue;
+					if ((imin == -1) || (d2 < d2min) || ((d2 == d2min) && (m < imin)))
+					{
+						if (accept(m))
+						{
+							imin = m;
+							d2min = d2;
+						}
+					}
+				}
+			}
+		}
+		else
+		{
+			// visit the closest child first
+			const BVHNode& n0 = m_node[nd.left];
+			const BVHNode& n1 = m_node[nd.left + 1];
+			if (BoxDistance2(n0, x) <= BoxDistance2(n1, x))
+			{
+				stack[ns++] = nd.left + 1;
+				stack[ns++] = nd.left;
+			}
+			else
+			{
+				stack[ns++] = nd.left;
+				stack[ns++] = nd.left + 1;
+			}
+		}
+	}
+
+	return imin;
+}
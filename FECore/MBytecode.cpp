@@ -0,0 +1,361 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "MBytecode.h"
+#include <math.h>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+// evaluate a single instruction for constant operands
+static double fold(const MBytecode::Instruction& ins, const double* x)
+{
+	switch (ins.op)
+	{
+	case MBytecode::OP_NEG: return -x[0];
+	case MBytecode::OP_ADD: return x[0] + x[1];
+	case MBytecode::OP_SUB: return x[0] - x[1];
+	case MBytecode::OP_MUL: return x[0] * x[1];
+	case MBytecode::OP_DIV: return x[0] / x[1];
+	case MBytecode::OP_POW: return pow(x[0], x[1]);
+	case MBytecode::OP_F1D: return ins.f1(x[0]);
+	case MBytecode::OP_F2D: return ins.f2(x[0], x[1]);
+	case MBytecode::OP_FND: return ins.fn(const_cast<double*>(x), ins.b);
+	}
+	assert(false);
+	return 0.0;
+}
+
+//-----------------------------------------------------------------------------
+MBytecode::MBytecode()
+{
+	Clear();
+}
+
+//-----------------------------------------------------------------------------
+void MBytecode::Clear()
+{
+	m_nvar = 0;
+	m_nreg = 0;
+	m_out = -1;
+	m_outKind = CONST_VALUE;
+	m_nstatic = 0;
+	m_dyn.clear();
+	m_code.clear();
+	m_dcode.clear();
+	m_args.clear();
+	m_creg.clear();
+	m_cval.clear();
+}
+
+//-----------------------------------------------------------------------------
+bool MBytecode::Compile(const MSimpleExpression& e, const std::vector<bool>& dynVars)
+{
+	Clear();
+
+	const MItem* pi = e.GetExpression().ItemPtr();
+	if (pi == nullptr) return false;
+
+	m_nvar = e.Variables();
+	m_nreg = m_nvar;
+	m_dyn.assign(m_nvar, false);
+	for (int i = 0; i < m_nvar; ++i)
+		if ((i < (int)dynVars.size()) && dynVars[i]) m_dyn[i] = true;
+
+	Operand r;
+	if (compile(pi, r) == false)
+	{
+		Clear();
+		return false;
+	}
+
+	// a constant result still needs a register
+	if (r.reg < 0) r.reg = constReg(r.val);
+	m_out = r.reg;
+	m_outKind = r.kind;
+
+	// the static instructions were placed in m_code, append the dynamic ones
+	m_nstatic = (int)m_code.size();
+	m_code.insert(m_code.end(), m_dcode.begin(), m_dcode.end());
+	m_dcode.clear();
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool MBytecode::compile(const MItem* pi, Operand& r)
+{
+	Instruction ins = { 0, -1, -1, -1, nullptr, nullptr, nullptr };
+	Operand arg[MAX_ARGS];
+
+	switch (pi->Type())
+	{
+	case MCONST:
+	case MFRAC:
+	case MNAMED:
+		r.reg = -1;
+		r.kind = CONST_VALUE;
+		r.val = mnumber(pi)->value();
+		return true;
+	case MVAR:
+		{
+			int n = mvar(pi)->index();
+			if ((n < 0) || (n >= m_nvar)) return false;
+			r.reg = n;
+			r.kind = (m_dyn[n] ? DYNAMIC_VALUE : STATIC_VALUE);
+			r.val = 0.0;
+			return true;
+		}
+	case MNEG:
+		if (compile(munary(pi)->Item(), arg[0]) == false) return false;
+		ins.op = OP_NEG;
+		r = emit(ins, arg, 1);
+		return true;
+	case MF1D:
+		if (compile(munary(pi)->Item(), arg[0]) == false) return false;
+		ins.op = OP_F1D;
+		ins.f1 = mfnc1d(pi)->funcptr();
+		r = emit(ins, arg, 1);
+		return true;
+	case MADD:
+	case MSUB:
+	case MMUL:
+	case MDIV:
+	case MPOW:
+	case MF2D:
+		if (compile(mbinary(pi)->LeftItem(), arg[0]) == false) return false;
+		if (compile(mbinary(pi)->RightItem(), arg[1]) == false) return false;
+		switch (pi->Type())
+		{
+		case MADD: ins.op = OP_ADD; break;
+		case MSUB: ins.op = OP_SUB; break;
+		case MMUL: ins.op = OP_MUL; break;
+		case MDIV: ins.op = OP_DIV; break;
+		case MPOW: ins.op = OP_POW; break;
+		default:
+			ins.op = OP_F2D;
+			ins.f2 = mfnc2d(pi)->funcptr();
+		}
+		r = emit(ins, arg, 2);
+		return true;
+	case MSFNC:
+		return compile(msfncnd(pi)->Value(), r);
+	case MFND:
+		{
+			const MFuncND* f = mfncnd(pi);
+			int n = f->Params();
+			if ((n < 1) || (n > MAX_ARGS)) return false;
+			for (int i = 0; i < n; ++i)
+			{
+				if (compile(f->Param(i), arg[i]) == false) return false;
+			}
+			ins.op = OP_FND;
+			ins.fn = f->funcptr();
+			ins.b = n;
+			r = emit(ins, arg, n);
+			return true;
+		}
+	default:
+		return false;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Adds the instruction to the program, or evaluates it if all arguments are constant.
+MBytecode::Operand MBytecode::emit(Instruction& ins, Operand* arg, int nargs)
+{
+	Operand r;
+	r.reg = -1;
+	r.val = 0.0;
+	r.kind = CONST_VALUE;
+	for (int i = 0; i < nargs; ++i) if (arg[i].kind > r.kind) r.kind = arg[i].kind;
+
+	// constant folding
+	if (r.kind == CONST_VALUE)
+	{
+		double x[MAX_ARGS];
+		for (int i = 0; i < nargs; ++i) x[i] = arg[i].val;
+		r.val = fold(ins, x);
+		return r;
+	}
+
+	// store constant operands in registers
+	for (int i = 0; i < nargs; ++i)
+	{
+		if (arg[i].reg < 0) arg[i].reg = constReg(arg[i].val);
+	}
+
+	if (ins.op == OP_FND)
+	{
+		ins.a = (int)m_args.size();
+		for (int i = 0; i < nargs; ++i) m_args.push_back(arg[i].reg);
+	}
+	else
+	{
+		ins.a = arg[0].reg;
+		if (nargs > 1) ins.b = arg[1].reg;
+	}
+
+	ins.dst = m_nreg++;
+	r.reg = ins.dst;
+
+	if (r.kind == STATIC_VALUE) m_code.push_back(ins);
+	else m_dcode.push_back(ins);
+
+	return r;
+}
+
+//-----------------------------------------------------------------------------
+// returns the register for a constant value
+int MBytecode::constReg(double v)
+{
+	for (size_t i = 0; i < m_cval.size(); ++i)
+	{
+		if (memcmp(&m_cval[i], &v, sizeof(double)) == 0) return m_creg[i];
+	}
+	m_creg.push_back(m_nreg);
+	m_cval.push_back(v);
+	return m_nreg++;
+}
+
+//-----------------------------------------------------------------------------
+void MBytecode::setConstants(double* reg, int n) const
+{
+	for (size_t i = 0; i < m_creg.size(); ++i)
+	{
+		double* r = reg + m_creg[i]*n;
+		const double v = m_cval[i];
+		for (int k = 0; k < n; ++k) r[k] = v;
+	}
+}
+
+//-----------------------------------------------------------------------------
+double MBytecode::value(double* reg) const
+{
+	assert(IsValid());
+	setConstants(reg, 1);
+	run(reg, 1, 0, (int)m_code.size());
+	return reg[m_out];
+}
+
+//-----------------------------------------------------------------------------
+void MBytecode::EvalStatic(double* reg, int n) const
+{
+	assert(IsValid());
+	setConstants(reg, n);
+	run(reg, n, 0, m_nstatic);
+}
+
+//-----------------------------------------------------------------------------
+void MBytecode::EvalDynamic(double* reg, int n) const
+{
+	assert(IsValid());
+	run(reg, n, m_nstatic, (int)m_code.size());
+}
+
+//-----------------------------------------------------------------------------
+// Executes the instructions [first, last). Each instruction is applied to the
+// whole block of n points before moving on to the next one.
+void MBytecode::run(double* reg, int n, int first, int last) const
+{
+	for (int i = first; i < last; ++i)
+	{
+		const Instruction& ins = m_code[i];
+		double* r = reg + ins.dst*n;
+		switch (ins.op)
+		{
+		case OP_NEG:
+			{
+				const double* x = reg + ins.a*n;
+				for (int k = 0; k < n; ++k) r[k] = -x[k];
+			}
+			break;
+		case OP_ADD:
+			{
+				const double* x = reg + ins.a*n;
+				const double* y = reg + ins.b*n;
+				for (int k = 0; k < n; ++k) r[k] = x[k] + y[k];
+			}
+			break;
+		case OP_SUB:
+			{
+				const double* x = reg + ins.a*n;
+				const double* y = reg + ins.b*n;
+				for (int k = 0; k < n; ++k) r[k] = x[k] - y[k];
+			}
+			break;
+		case OP_MUL:
+			{
+				const double* x = reg + ins.a*n;
+				const double* y = reg + ins.b*n;
+				for (int k = 0; k < n; ++k) r[k] = x[k] * y[k];
+			}
+			break;
+		case OP_DIV:
+			{
+				const double* x = reg + ins.a*n;
+				const double* y = reg + ins.b*n;
+				for (int k = 0; k < n; ++k) r[k] = x[k] / y[k];
+			}
+			break;
+		case OP_POW:
+			{
+				const double* x = reg + ins.a*n;
+				const double* y = reg + ins.b*n;
+				for (int k = 0; k < n; ++k) r[k] = pow(x[k], y[k]);
+			}
+			break;
+		case OP_F1D:
+			{
+				const double* x = reg + ins.a*n;
+				for (int k = 0; k < n; ++k) r[k] = ins.f1(x[k]);
+			}
+			break;
+		case OP_F2D:
+			{
+				const double* x = reg + ins.a*n;
+				const double* y = reg + ins.b*n;
+				for (int k = 0; k < n; ++k) r[k] = ins.f2(x[k], y[k]);
+			}
+			break;
+		case OP_FND:
+			{
+				const int* arg = &m_args[ins.a];
+				double d[MAX_ARGS];
+				for (int k = 0; k < n; ++k)
+				{
+					for (int j = 0; j < ins.b; ++j) d[j] = reg[arg[j]*n + k];
+					r[k] = ins.fn(d, ins.b);
+				}
+			}
+			break;
+		default:
+			assert(false);
+		}
+	}
+}
@@ -0,0 +1,132 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include "MathObject.h"
+#include "MFunctions.h"
+#include <vector>
+#include "fecore_api.h"
+
+//-----------------------------------------------------------------------------
+// This class compiles the expression tree of an MSimpleExpression into a flat
+// register program. 
+// The first Variables() registers hold the values of the expression variables,
+// the remaining registers hold constants and intermediate results. Sub-expressions
+// that only depend on constants are folded at compile time. 
+// Variables can be flagged as dynamic (e.g. time). The instructions are ordered
+// such that all instructions that do not depend on a dynamic variable come first,
+// so that they can be evaluated once and reused when only the dynamic variables change.
+class FECORE_API MBytecode
+{
+public:
+	enum OpCode {
+		OP_NEG, OP_ADD, OP_SUB, OP_MUL, OP_DIV, OP_POW, OP_F1D, OP_F2D, OP_FND
+	};
+
+	struct Instruction
+	{
+		int			op;		// op code
+		int			dst;	// destination register
+		int			a, b;	// operand registers (for OP_FND: offset in argument list and argument count)
+		FUNCPTR		f1;		// function pointer for OP_F1D
+		FUNC2PTR	f2;		// function pointer for OP_F2D
+		FUNCNPTR	fn;		// function pointer for OP_FND
+	};
+
+	// max nr of arguments for functions of N variables
+	enum { MAX_ARGS = 16 };
+
+public:
+	MBytecode();
+
+	// Compile the expression. Variables for which dynVars is true are assumed to change
+	// between evaluations. Returns false if the expression contains items that cannot 
+	// be compiled. 
+	bool Compile(const MSimpleExpression& e, const std::vector<bool>& dynVars = std::vector<bool>());
+
+	void Clear();
+
+	// was the expression compiled successfully
+	bool IsValid() const { return (m_out >= 0); }
+
+	int Variables() const { return m_nvar; }
+	int Registers() const { return m_nreg; }
+	int Instructions() const { return (int)m_code.size(); }
+
+	// the result does not depend on any of the variables
+	bool IsConst() const { return (m_outKind == CONST_VALUE); }
+
+	// the result does not depend on any of the dynamic variables
+	bool IsStatic() const { return (m_outKind != DYNAMIC_VALUE); }
+
+	// Evaluate the expression at a single point. reg must have room for Registers()
+	// values and the first Variables() values must be set to the variable values.
+	double value(double* reg) const;
+
+	// Batch evaluation over n points. The registers are stored in blocks of n, i.e.
+	// register r of point k is stored in reg[r*n + k], and reg must have room for
+	// n*Registers() values. The variable blocks must be set before evaluation. 
+	// Evaluate the constants and the sub-expressions that don't depend on dynamic variables
+	void EvalStatic(double* reg, int n) const;
+
+	// Evaluate the sub-expressions that depend on dynamic variables.
+	void EvalDynamic(double* reg, int n) const;
+
+	// return the result block after evaluation
+	const double* Result(const double* reg, int n) const { return reg + m_out*n; }
+
+private:
+	enum ValueKind { CONST_VALUE, STATIC_VALUE, DYNAMIC_VALUE };
+
+	struct Operand
+	{
+		int		reg;	// register (-1 for constants that are not stored yet)
+		int		kind;	// value kind
+		double	val;	// value for constants
+	};
+
+	bool compile(const MItem* pi, Operand& r);
+	Operand emit(Instruction& ins, Operand* arg, int nargs);
+	int constReg(double v);
+	void setConstants(double* reg, int n) const;
+	void run(double* reg, int n, int first, int last) const;
+
+private:
+	int		m_nvar;		// nr of variables
+	int		m_nreg;		// total nr of registers
+	int		m_out;		// register with the result
+	int		m_outKind;	// value kind of the result
+	int		m_nstatic;	// nr of instructions that don't depend on dynamic variables
+
+	std::vector<bool>			m_dyn;		// dynamic flags of variables
+	std::vector<Instruction>	m_code;		// instructions
+	std::vector<Instruction>	m_dcode;	// dynamic instructions (only used during compilation)
+	std::vector<int>			m_args;		// argument registers of OP_FND instructions
+	std::vector<int>			m_creg;		// constant registers
+	std::vector<double>			m_cval;		// constant values
+};
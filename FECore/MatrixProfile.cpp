@@ -153,6 +153,45 @@ void SparseMatrixProfile::ColumnProfile::insertRow(int row)
 	}
 }
 
+//-----------------------------------------------------------------------------
+// find the row entry that contains row (or -1 if row is not in the profile)
+static int findRowEntry(const vector<SparseMatrixProfile::RowEntry>& data, int row)
+{
+	int N0 = 0, N1 = (int)data.size() - 1;
+	while (N0 <= N1)
+	{
+		int n = (N0 + N1) / 2;
+		const SparseMatrixProfile::RowEntry& rn = data[n];
+		if (row < rn.start) N1 = n - 1;
+		else if (row > rn.end) N0 = n + 1;
+		else return n;
+	}
+	return -1;
+}
+
+bool SparseMatrixProfile::ColumnProfile::hasRow(int row) const
+{
+	return (findRowEntry(m_data, row) >= 0);
+}
+
+void SparseMatrixProfile::ColumnProfile::removeRow(int row)
+{
+	int n = findRowEntry(m_data, row);
+	if (n < 0) return;
+
+	RowEntry& rn = m_data[n];
+	if (rn.start == rn.end) m_data.erase(m_data.begin() + n);
+	else if (row == rn.start) rn.start++;
+	else if (row == rn.end) rn.end--;
+	else
+	{
+		// split the entry
+		RowEntry re = { row + 1, rn.end };
+		rn.end = row - 1;
+		m_data.insert(m_data.begin() + n + 1, re);
+	}
+}
+
 //-----------------------------------------------------------------------------
 //! MatrixProfile constructor. Takes the nr of equations as input argument.
 //! If n is larger than zero a default profile is constructor for a diagonal
@@ -319,6 +358,22 @@ void SparseMatrixProfile::Insert(int i, int j)
 	a.insertRow(i);
 }
 
+//-----------------------------------------------------------------------------
+//! removes an entry from the profile
+void SparseMatrixProfile::Remove(int i, int j)
+{
+	ColumnProfile& a = m_prof[j];
+	a.removeRow(i);
+}
+
+//-----------------------------------------------------------------------------
+//! see if an entry is in the profile
+bool SparseMatrixProfile::HasEntry(int i, int j) const
+{
+	const ColumnProfile& a = m_prof[j];
+	return a.hasRow(i);
+}
+
 //-----------------------------------------------------------------------------
 // extract the matrix profile of a block
 SparseMatrixProfile SparseMatrixProfile::GetBlockProfile(int nrow0, int ncol0, int nrow1, int ncol1) const
@@ -85,6 +85,12 @@ public:
 		// add row index to column profile
 		void insertRow(int row);
 
+		// remove row index from column profile
+		void removeRow(int row);
+
+		// see if the row index is in the column profile
+		bool hasRow(int row) const;
+
 	private:
 		std::vector<RowEntry>	m_data;	// the column profile data
 	};
@@ -114,6 +120,12 @@ public:
 	//! inserts an entry into the profile (This is an expensive operation!)
 	void Insert(int i, int j);
 
+	//! removes an entry from the profile
+	void Remove(int i, int j);
+
+	//! see if an entry is in the profile
+	bool HasEntry(int i, int j) const;
+
 	//! returns the number of rows
 	int Rows() const { return m_nrow; }
 
@@ -36,6 +36,8 @@ SparseMatrix::SparseMatrix()
 {
 	m_nrow = m_ncol = 0;
 	m_nsize = 0;
+	m_batomic = true;
+	m_nslack = 0;
 }
 
 SparseMatrix::~SparseMatrix()
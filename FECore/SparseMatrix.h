@@ -31,6 +31,7 @@ SOFTWARE.*/
 #include "MatrixOperator.h"
 #include "matrix.h"
 #include <vector>
+#include <utility>
 
 //-----------------------------------------------------------------------------
 //! Base class for sparse matrices
@@ -95,6 +96,28 @@ public: // functions to be overwritten in derived classes
 	//! scale matrix
 	virtual void scale(const std::vector<double>& L, const std::vector<double>& R);
 
+	//! Insert and remove entries (given as (row, column) pairs) in the existing matrix
+	//! structure. This is meant for small changes to the structure. Returns false when
+	//! this is not supported or when there is not enough room, in which case the matrix
+	//! has to be recreated from its profile.
+	virtual bool UpdateStructure(const std::vector< std::pair<int, int> >& add, const std::vector< std::pair<int, int> >& remove) { return false; }
+
+public:
+	//! Turn atomic updates in the Assemble functions on or off. They can only be turned
+	//! off when the caller guarantees that no two threads assemble into the same entries
+	//! at the same time (e.g. when the elements are processed per color).
+	void SetAtomicAssembly(bool b) { m_batomic = b; }
+
+	//! see if the Assemble functions use atomic updates
+	bool AtomicAssembly() const { return m_batomic; }
+
+	//! Set the nr of extra entries per column (or row) that Create should reserve, so 
+	//! that UpdateStructure can insert entries without reallocating.
+	void SetSlack(int n) { m_nslack = n; }
+
+	//! get the nr of extra entries reserved per column (or row)
+	int Slack() const { return m_nslack; }
+
 public:
 	//! multiply with vector
 	bool mult_vector(double* x, double* r) override { assert(false); return false; }
@@ -111,4 +134,6 @@ protected:
 	// NOTE: These values are set by derived classes
 	int	m_nrow, m_ncol;		//!< dimension of matrix
 	int	m_nsize;			//!< number of nonzeroes (i.e. matrix elements actually allocated)
+	bool	m_batomic;		//!< use atomic updates during assembly
+	int		m_nslack;		//!< extra entries per column (or row) reserved by Create
 };
@@ -32,6 +32,7 @@ BEGIN_FECORE_CLASS(FEImageDataMap, FEElemDataGenerator)
 	ADD_PARAMETER(m_r0, "range_min");
 	ADD_PARAMETER(m_r1, "range_max");
 	ADD_PARAMETER(m_blur, "blur");
+	ADD_PARAMETER(m_blurType, "blur_type")->setEnums("STENCIL\0GAUSSIAN\0FFT\0");
 	ADD_PROPERTY(m_imgSrc, "image");
 END_FECORE_CLASS();
 
@@ -39,6 +40,7 @@ FEImageDataMap::FEImageDataMap(FEModel* fem) : FEElemDataGenerator(fem), m_map(m
 {
 	m_imgSrc = nullptr;
 	m_blur = 0.0;
+	m_blurType = BLUR_STENCIL;
 	m_data = nullptr;
 }
 
@@ -92,8 +94,21 @@ void FEImageDataMap::Evaluate(double time)
 {
 	if (m_blur > 0)
 	{
-		if (m_im0.depth() == 1) blur_image_2d(m_im, m_im0, (float)m_blur);
-		else blur_image(m_im, m_im0, (float)m_blur);
+		bool b2d = (m_im0.depth() == 1);
+		switch (m_blurType)
+		{
+		case BLUR_GAUSSIAN:
+			if (b2d) gaussian_blur_2d(m_im, m_im0, (float)m_blur);
+			else gaussian_blur_3d(m_im, m_im0, (float)m_blur);
+			break;
+		case BLUR_FFT:
+			if (b2d) fftblur_2d(m_im, m_im0, (float)m_blur);
+			else fftblur_3d(m_im, m_im0, (float)m_blur);
+			break;
+		default:
+			if (b2d) blur_image_2d(m_im, m_im0, (float)m_blur);
+			else blur_image(m_im, m_im0, (float)m_blur);
+		}
 	}
 	else m_im = m_im0;
 
@@ -33,6 +33,15 @@ class FEDomainMap;
 
 class FEIMGLIB_API FEImageDataMap : public FEElemDataGenerator
 {
+public:
+	// blur filters (see image_tools.h)
+	enum BlurType
+	{
+		BLUR_STENCIL,		// repeated neighbor averaging
+		BLUR_GAUSSIAN,		// recursive Gaussian filter (blur is the standard deviation)
+		BLUR_FFT			// Gaussian filter in Fourier space
+	};
+
 public:
 	FEImageDataMap(FEModel* fem);
 
@@ -49,6 +58,7 @@ private:
 	vec3d	m_r0;
 	vec3d	m_r1;
 	double	m_blur;
+	int		m_blurType;
 
 	FEImageSource* m_imgSrc;
 
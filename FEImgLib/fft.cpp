@@ -1,105 +1,104 @@
-#ifdef HAVE_MKL
-#include <mkl.h>
-#include <complex>
+#include "image_tools.h"
+#include <math.h>
 
 //---------------------------------------------------------------------------------------
-// calculate the DFT of a source image x. The source image is assumed to be stored
-// in row-major order, indexed by (x,y), where x is the column index, and y the row index. 
-// The complex Fourier coefficients are returned in c. The buffer must be pre-allocated and must have
-// the size (nx,ny), the same as the source image.
-bool mkl_dft2(int nx, int ny, float* x, MKL_Complex8* c)
+// Create the plan for a transform of size n. The size is factored into radices that
+// are processed by the mixed radix algorithm. Any size is supported, but a radix p 
+// costs O(n*p) operations, since radices other than 2 are combined with a direct DFT.
+// Sizes with small prime factors are therefore the most efficient and the transform 
+// of a prime size n falls back to an O(n^2) DFT.
+FFTPlan::FFTPlan(int n) : m_n(n)
 {
-	DFTI_DESCRIPTOR_HANDLE my_desc_handle;
-	MKL_LONG status;
+	// factor n
+	int m = n;
+	int p = 2;
+	while (m > 1)
+	{
+		while (m % p == 0)
+		{
+			m_fac.push_back(p);
+			m /= p;
+		}
+		p = (p == 2 ? 3 : p + 2);
+		if (p*p > m) p = m;
+	}
+	if (m_fac.empty()) m_fac.push_back(1);
 
-	MKL_LONG sizes[2] = { nx, ny };
-	MKL_LONG is[3] = { 0, 1, nx };
-	MKL_LONG os[3] = { 0, 1, nx }; // { 0, 1, N2/2+1}
-	status = DftiCreateDescriptor(&my_desc_handle, DFTI_SINGLE, DFTI_REAL, 2, sizes);
-	status = DftiSetValue(my_desc_handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	status = DftiSetValue(my_desc_handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-	status = DftiSetValue(my_desc_handle, DFTI_INPUT_STRIDES, is);
-	status = DftiSetValue(my_desc_handle, DFTI_OUTPUT_STRIDES, os);
-	status = DftiCommitDescriptor(my_desc_handle);
-	status = DftiComputeForward(my_desc_handle, x, c);
-	status = DftiFreeDescriptor(&my_desc_handle);
+	// work space for the largest radix
+	int pmax = 1;
+	for (size_t i = 0; i < m_fac.size(); ++i) if (m_fac[i] > pmax) pmax = m_fac[i];
+	m_t.resize(pmax);
 
-	return true;
+	// twiddle factors
+	const double PI = 3.14159265358979323846;
+	m_tw.resize(n);
+	m_itw.resize(n);
+	for (int i = 0; i < n; ++i)
+	{
+		double a = -2.0*PI*i / n;
+		m_tw[i] = std::complex<double>(cos(a), sin(a));
+		m_itw[i] = std::conj(m_tw[i]);
+	}
 }
 
 //---------------------------------------------------------------------------------------
-// calculate the inverse DFT. The fourier coefficients are passed and assumed to be stored
-// in row-major order, indexed by (x,y), where x is the column index, and y the row index. 
-// The reconstructed image is returned in x, which must have the same size and storage. 
-bool mkl_idft2(int nx, int ny, MKL_Complex8* c, float* x)
+void FFTPlan::forward(const std::complex<double>* in, std::complex<double>* out) const
 {
-	DFTI_DESCRIPTOR_HANDLE my_desc_handle;
-	MKL_LONG status;
-
-	MKL_LONG sizes[2] = { nx, ny };
-	MKL_LONG is[3] = { 0, 1, nx };  // { 0, 1, Nx/2+1}
-	MKL_LONG os[3] = { 0, 1, nx };
-	status = DftiCreateDescriptor(&my_desc_handle, DFTI_SINGLE, DFTI_REAL, 2, sizes);
-	status = DftiSetValue(my_desc_handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	status = DftiSetValue(my_desc_handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-	status = DftiSetValue(my_desc_handle, DFTI_INPUT_STRIDES, is);
-	status = DftiSetValue(my_desc_handle, DFTI_OUTPUT_STRIDES, os);
-	status = DftiSetValue(my_desc_handle, DFTI_BACKWARD_SCALE, 1.f / ((float)nx * (float)ny));
-	status = DftiCommitDescriptor(my_desc_handle);
-	status = DftiComputeBackward(my_desc_handle, c, x);
-	status = DftiFreeDescriptor(&my_desc_handle);
-
-	return true;
+	work(out, in, 1, m_n, &m_fac[0], &m_tw[0]);
 }
 
 //---------------------------------------------------------------------------------------
-// calculate the DFT of a source image x. The source image is assumed to be stored
-// in row-major order, indexed by (x,y,z), where x is the column index, y the row index, z is the plane index. 
-// The complex Fourier coefficients are returned in c. The buffer must be pre-allocated and must have
-// the size (nx,ny,nz), the same as the source image.
-bool mkl_dft3(int nx, int ny, int nz, float* x, MKL_Complex8* c)
+void FFTPlan::inverse(const std::complex<double>* in, std::complex<double>* out) const
 {
-	DFTI_DESCRIPTOR_HANDLE my_desc_handle;
-	MKL_LONG status;
-
-	MKL_LONG sizes[3] = { nx, ny, nz };
-	MKL_LONG is[4] = { 0, 1, nx, nx*ny };
-	MKL_LONG os[4] = { 0, 1, nx, nx*ny }; // { 0, 1, nx, ny, nz/2+1}
-	status = DftiCreateDescriptor(&my_desc_handle, DFTI_SINGLE, DFTI_REAL, 3, sizes);
-	status = DftiSetValue(my_desc_handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	status = DftiSetValue(my_desc_handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-	status = DftiSetValue(my_desc_handle, DFTI_INPUT_STRIDES, is);
-	status = DftiSetValue(my_desc_handle, DFTI_OUTPUT_STRIDES, os);
-	status = DftiCommitDescriptor(my_desc_handle);
-	status = DftiComputeForward(my_desc_handle, x, c);
-	status = DftiFreeDescriptor(&my_desc_handle);
-
-	return true;
+	work(out, in, 1, m_n, &m_fac[0], &m_itw[0]);
+	double s = 1.0 / m_n;
+	for (int i = 0; i < m_n; ++i) out[i] *= s;
 }
 
 //---------------------------------------------------------------------------------------
-// calculate the inverse DFT. The fourier coefficients are passed and assumed to be stored
-// in row-major order, indexed by (x,y,z), where x is the column index, y the row index, and z the plane index. 
-// The reconstructed image is returned in y, which must have the same size and storage. 
-bool mkl_idft3(int nx, int ny, int nz, MKL_Complex8* c, float* y)
+// Calculate the DFT of the n values in[0], in[s], in[2s], ... and store it in out.
+// The DFT is split into p = fac[0] transforms of size n/p, which are then combined.
+void FFTPlan::work(std::complex<double>* out, const std::complex<double>* in, int s, int n, const int* fac, const std::complex<double>* tw) const
 {
-	DFTI_DESCRIPTOR_HANDLE my_desc_handle;
-	MKL_LONG status;
+	typedef std::complex<double> cd;
 
-	MKL_LONG sizes[3] = { nx, ny, nz };
-	MKL_LONG is[4] = { 0, 1, nx, nx * ny };  // { 0, 1, nx, ny, nz/2+1}
-	MKL_LONG os[4] = { 0, 1, nx, nx * ny };
-	status = DftiCreateDescriptor(&my_desc_handle, DFTI_SINGLE, DFTI_REAL, 3, sizes);
-	status = DftiSetValue(my_desc_handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
-	status = DftiSetValue(my_desc_handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
-	status = DftiSetValue(my_desc_handle, DFTI_INPUT_STRIDES, is);
-	status = DftiSetValue(my_desc_handle, DFTI_OUTPUT_STRIDES, os);
-	status = DftiSetValue(my_desc_handle, DFTI_BACKWARD_SCALE, 1.f / ((float)nx * (float)ny * (float) nz));
-	status = DftiCommitDescriptor(my_desc_handle);
-	status = DftiComputeBackward(my_desc_handle, c, y);
-	status = DftiFreeDescriptor(&my_desc_handle);
+	int p = fac[0];
+	int m = n / p;
+	if (m == 1)
+	{
+		for (int q = 0; q < p; ++q) out[q] = in[q*s];
+	}
+	else
+	{
+		for (int q = 0; q < p; ++q) work(out + q*m, in + q*s, s*p, m, fac + 1, tw);
+	}
+	if (p == 1) return;
 
-	return true;
+	// Note that the twiddle factors of this level are W_n^k = tw[k*s]
+	if (p == 2)
+	{
+		for (int k = 0; k < m; ++k)
+		{
+			cd a = out[k];
+			cd b = out[k + m] * tw[k*s];
+			out[k] = a + b;
+			out[k + m] = a - b;
+		}
+	}
+	else
+	{
+		int N = m_n;
+		int r0 = N / p;
+		cd* t = &m_t[0];
+		for (int k = 0; k < m; ++k)
+		{
+			for (int q = 0; q < p; ++q) t[q] = out[q*m + k] * tw[q*k*s];
+			for (int r = 0; r < p; ++r)
+			{
+				cd v = t[0];
+				for (int q = 1; q < p; ++q) v += t[q] * tw[((q*r) % p)*r0];
+				out[r*m + k] = v;
+			}
+		}
+	}
 }
-
-#endif
@@ -1,10 +1,50 @@
 #pragma once
 #include "feimglib_api.h"
+#include <complex>
+#include <vector>
 
 class Image;
 
+// Blur the image by repeatedly averaging over the neighboring pixels. 
+// The blur radius d is the number of iterations.
 FEIMGLIB_API void blur_image_2d(Image& trg, Image& src, float d);
 FEIMGLIB_API void blur_image(Image& trg, Image& src, float d);
 
+// Gaussian blur that is evaluated in Fourier space (periodic boundaries). 
+// The Fourier coefficients are scaled by exp(-(k*d/n)^2).
 FEIMGLIB_API void fftblur_2d(Image& trg, Image& src, float d);
 FEIMGLIB_API void fftblur_3d(Image& trg, Image& src, float d);
+
+// Gaussian blur using a recursive (IIR) filter. The blur radius d is the standard 
+// deviation of the Gaussian in pixels. The cost does not depend on the blur radius.
+FEIMGLIB_API void gaussian_blur_2d(Image& trg, Image& src, float d);
+FEIMGLIB_API void gaussian_blur_3d(Image& trg, Image& src, float d);
+
+//-----------------------------------------------------------------------------
+// Complex discrete Fourier transform of size n, using a mixed radix algorithm.
+// The cost is O(n*(p1 + p2 + ...)) for the prime factors p1, p2, ... of n, so prime 
+// sizes fall back to an O(n^2) DFT. The plan holds its own work space, so each thread 
+// needs its own copy of the plan.
+class FEIMGLIB_API FFTPlan
+{
+public:
+	FFTPlan(int n);
+
+	int size() const { return m_n; }
+
+	// forward transform. (in and out cannot be the same)
+	void forward(const std::complex<double>* in, std::complex<double>* out) const;
+
+	// inverse transform, including the 1/n scaling. (in and out cannot be the same)
+	void inverse(const std::complex<double>* in, std::complex<double>* out) const;
+
+private:
+	void work(std::complex<double>* out, const std::complex<double>* in, int s, int n, const int* fac, const std::complex<double>* tw) const;
+
+private:
+	int		m_n;								// size of transform
+	std::vector<int>	m_fac;					// radices
+	std::vector<std::complex<double> >	m_tw;	// twiddle factors of forward transform
+	std::vector<std::complex<double> >	m_itw;	// twiddle factors of inverse transform
+	mutable std::vector<std::complex<double> >	m_t;	// work space for combining radices
+};
@@ -0,0 +1,827 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#include "stdafx.h"
+#include "AMG_Preconditioner.h"
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/FEModel.h>
+#include <FECore/FEMesh.h>
+#include <FECore/log.h>
+#include <algorithm>
+
+// number of near-nullspace vectors: the six rigid body modes and one vector for
+// all other (i.e. non-displacement) equations.
+#define NNS	7
+
+// max size of the coarsest level for which a dense factorization is used
+#define MAX_DENSE	4000
+
+//-----------------------------------------------------------------------------
+BEGIN_FECORE_CLASS(AMG_Preconditioner, Preconditioner)
+	ADD_PARAMETER(m_maxLevels , "max_levels");
+	ADD_PARAMETER(m_coarseSize, "coarse_size");
+	ADD_PARAMETER(m_theta     , "theta");
+	ADD_PARAMETER(m_nsmooth   , "smooth_steps");
+	ADD_PARAMETER(m_printLevel, "print_level");
+END_FECORE_CLASS();
+
+//=============================================================================
+// sparse matrix helper functions (all matrices are zero-based)
+
+// r = A*x
+static void spmv(CSRMatrix& A, const double* x, double* r)
+{
+	int N = A.rows();
+	const int* ptr = &A.pointers()[0];
+	const int* col = (A.nonzeroes() ? &A.indices()[0] : nullptr);
+	const double* val = (A.nonzeroes() ? &A.values()[0] : nullptr);
+#pragma omp parallel for schedule(dynamic, 1024)
+	for (int i = 0; i < N; ++i)
+	{
+		double ri = 0.0;
+		for (int k = ptr[i]; k < ptr[i + 1]; ++k) ri += val[k] * x[col[k]];
+		r[i] = ri;
+	}
+}
+
+// C = A*B
+static void spgemm(CSRMatrix& A, CSRMatrix& B, CSRMatrix& C)
+{
+	int nr = A.rows();
+	int nc = B.cols();
+	std::vector<int>& pa = A.pointers(); std::vector<int>& ia = A.indices(); std::vector<double>& va = A.values();
+	std::vector<int>& pb = B.pointers(); std::vector<int>& ib = B.indices(); std::vector<double>& vb = B.values();
+
+	C.create(nr, nc);
+	std::vector<int>& pc = C.pointers();
+	pc.assign(nr + 1, 0);
+
+	// count the entries of each row
+#pragma omp parallel
+	{
+		std::vector<int> mark(nc, -1);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < nr; ++i)
+		{
+			int n = 0;
+			for (int k = pa[i]; k < pa[i + 1]; ++k)
+			{
+				int j = ia[k];
+				for (int l = pb[j]; l < pb[j + 1]; ++l)
+				{
+					int m = ib[l];
+					if (mark[m] != i) { mark[m] = i; n++; }
+				}
+			}
+			pc[i + 1] = n;
+		}
+	}
+	for (int i = 0; i < nr; ++i) pc[i + 1] += pc[i];
+
+	std::vector<int>& ic = C.indices(); ic.resize(pc[nr]);
+	std::vector<double>& vc = C.values(); vc.resize(pc[nr]);
+
+	// evaluate the entries
+#pragma omp parallel
+	{
+		std::vector<int> pos(nc, -1);
+#pragma omp for schedule(dynamic, 256)
+		for (int i = 0; i < nr; ++i)
+		{
+			int n0 = pc[i], n = n0;
+			for (int k = pa[i]; k < pa[i + 1]; ++k)
+			{
+				int j = ia[k];
+				double ajk = va[k];
+				for (int l = pb[j]; l < pb[j + 1]; ++l)
+				{
+					int m = ib[l];
+					if (pos[m] < n0) { pos[m] = n; ic[n] = m; vc[n] = ajk*vb[l]; n++; }
+					else vc[pos[m]] += ajk*vb[l];
+				}
+			}
+		}
+	}
+}
+
+// B = A^T
+static void transpose(CSRMatrix& A, CSRMatrix& B)
+{
+	int nr = A.rows();
+	int nc = A.cols();
+	std::vector<int>& pa = A.pointers(); std::vector<int>& ia = A.indices(); std::vector<double>& va = A.values();
+
+	B.create(nc, nr);
+	std::vector<int>& pb = B.pointers();
+	pb.assign(nc + 1, 0);
+	for (int k = 0; k < pa[nr]; ++k) pb[ia[k] + 1]++;
+	for (int i = 0; i < nc; ++i) pb[i + 1] += pb[i];
+
+	std::vector<int>& ib = B.indices(); ib.resize(pa[nr]);
+	std::vector<double>& vb = B.values(); vb.resize(pa[nr]);
+	std::vector<int> pos(pb.begin(), pb.end() - 1);
+	for (int i = 0; i < nr; ++i)
+	{
+		for (int k = pa[i]; k < pa[i + 1]; ++k)
+		{
+			int n = pos[ia[k]]++;
+			ib[n] = i;
+			vb[n] = va[k];
+		}
+	}
+}
+
+// copy a FEBio sparse matrix to a (full) zero-based CSR matrix
+static bool copyMatrix(SparseMatrix* K, CSRMatrix& A)
+{
+	CompactMatrix* C = dynamic_cast<CompactMatrix*>(K);
+	if (C == nullptr) return false;
+
+	int N = C->Rows();
+	int offset = C->Offset();
+	const int* pk = C->Pointers();
+	const int* ik = C->Indices();
+	const double* vk = C->Values();
+
+	// copy the compact storage
+	CSRMatrix T;
+	T.create(N, N);
+	std::vector<int>& pt = T.pointers();
+	for (int i = 0; i <= N; ++i) pt[i] = pk[i] - offset;
+	T.indices().resize(pt[N]);
+	T.values().resize(pt[N]);
+	for (int i = 0; i < pt[N]; ++i) { T.indices()[i] = ik[i] - offset; T.values()[i] = vk[i]; }
+
+	if (C->isSymmetric())
+	{
+		// The symmetric matrix only stores the lower triangular part (column major), 
+		// so each off-diagonal entry is added twice.
+		A.create(N, N);
+		std::vector<int>& pa = A.pointers();
+		pa.assign(N + 1, 0);
+		for (int j = 0; j < N; ++j)
+			for (int k = pt[j]; k < pt[j + 1]; ++k)
+			{
+				int i = T.indices()[k];
+				pa[i + 1]++;
+				if (i != j) pa[j + 1]++;
+			}
+		for (int i = 0; i < N; ++i) pa[i + 1] += pa[i];
+
+		std::vector<int>& ia = A.indices(); ia.resize(pa[N]);
+		std::vector<double>& va = A.values(); va.resize(pa[N]);
+		std::vector<int> pos(pa.begin(), pa.end() - 1);
+		for (int j = 0; j < N; ++j)
+			for (int k = pt[j]; k < pt[j + 1]; ++k)
+			{
+				int i = T.indices()[k];
+				double v = T.values()[k];
+				int n = pos[i]++; ia[n] = j; va[n] = v;
+				if (i != j) { n = pos[j]++; ia[n] = i; va[n] = v; }
+			}
+	}
+	else if (C->isRowBased() == false)
+	{
+		// compact column storage is the transpose of compact row storage
+		transpose(T, A);
+	}
+	else A = T;
+
+	return true;
+}
+
+//=============================================================================
+AMG_Preconditioner::AMG_Preconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_maxLevels = 10;
+	m_coarseSize = 1000;
+	m_theta = 0.0;
+	m_nsmooth = 2;
+	m_printLevel = 0;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* AMG_Preconditioner::CreateSparseMatrix(Matrix_Type ntype)
+{
+	SparseMatrix* K = nullptr;
+	switch (ntype)
+	{
+	case REAL_SYMMETRIC     : K = new CompactSymmMatrix(0); break;
+	case REAL_UNSYMMETRIC   : K = new CRSSparseMatrix(0); break;
+	case REAL_SYMM_STRUCTURE: K = new CRSSparseMatrix(0); break;
+	}
+	SetSparseMatrix(K);
+	return K;
+}
+
+//-----------------------------------------------------------------------------
+bool AMG_Preconditioner::Factor()
+{
+	SparseMatrix* K = GetSparseMatrix();
+	if (K == nullptr) return false;
+
+	m_level.clear();
+	m_level.reserve(m_maxLevels > 1 ? m_maxLevels : 1);
+	m_level.push_back(Level());
+
+	// setup the finest level
+	Level& L0 = m_level[0];
+	if (copyMatrix(K, L0.A) == false) return false;
+	if (BuildFineLevel(L0) == false) return false;
+
+	// create the coarser levels
+	while ((int)m_level.size() < m_maxLevels)
+	{
+		Level& L = m_level.back();
+		if (L.A.rows() <= m_coarseSize) break;
+
+		m_level.push_back(Level());
+		Level& C = m_level.back();
+		Level& F = m_level[m_level.size() - 2];
+		if (Coarsen(F, C) == false)
+		{
+			m_level.pop_back();
+			break;
+		}
+	}
+
+	// factor the coarsest level
+	if (FactorCoarse(m_level.back()) == false) return false;
+
+	// allocate the work vectors
+	for (Level& L : m_level)
+	{
+		int n = L.A.rows();
+		L.x.assign(n, 0.0);
+		L.b.assign(n, 0.0);
+		L.r.assign(n, 0.0);
+	}
+
+	if (m_printLevel > 0)
+	{
+		double nnz0 = (double)m_level[0].A.nonzeroes();
+		double nnz = 0.0;
+		feLog("AMG hierarchy:\n");
+		for (size_t i = 0; i < m_level.size(); ++i)
+		{
+			CSRMatrix& A = m_level[i].A;
+			feLog("\tlevel %d: %d equations, %d nonzeroes\n", (int)i, A.rows(), A.nonzeroes());
+			nnz += A.nonzeroes();
+		}
+		feLog("\toperator complexity: %lg\n", nnz / nnz0);
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// The equations of a mesh node form one block. The rigid body modes are evaluated
+// from the node positions, which are centered for better conditioning. Equations 
+// that are not displacement equations get the last near-nullspace vector.
+bool AMG_Preconditioner::BuildFineLevel(Level& L)
+{
+	int N = L.A.rows();
+	L.node.assign(N, -1);
+	L.B.assign((size_t)N*NNS, 0.0);
+	L.nodes = 0;
+
+	FEModel* fem = GetFEModel();
+	if (fem)
+	{
+		FEMesh& mesh = fem->GetMesh();
+		int dofs[3] = { fem->GetDOFIndex("x"), fem->GetDOFIndex("y"), fem->GetDOFIndex("z") };
+
+		vec3d rc(0, 0, 0);
+		for (int i = 0; i < mesh.Nodes(); ++i) rc += mesh.Node(i).m_rt;
+		if (mesh.Nodes() > 0) rc /= (double)mesh.Nodes();
+
+		for (int i = 0; i < mesh.Nodes(); ++i)
+		{
+			FENode& node = mesh.Node(i);
+			vec3d r = node.m_rt - rc;
+			int neq = 0;
+			for (int j = 0; j < (int)node.m_ID.size(); ++j)
+			{
+				int eq = node.m_ID[j];
+				if ((eq < 0) || (eq >= N) || (L.node[eq] >= 0)) continue;
+				L.node[eq] = L.nodes;
+				neq++;
+
+				double* b = &L.B[(size_t)eq*NNS];
+				if      (j == dofs[0]) { b[0] = 1; b[4] =  r.z; b[5] = -r.y; }
+				else if (j == dofs[1]) { b[1] = 1; b[3] = -r.z; b[5] =  r.x; }
+				else if (j == dofs[2]) { b[2] = 1; b[3] =  r.y; b[4] = -r.x; }
+				else b[6] = 1;
+			}
+			if (neq > 0) L.nodes++;
+		}
+	}
+
+	// all remaining equations are their own node
+	for (int i = 0; i < N; ++i)
+	{
+		if (L.node[i] < 0)
+		{
+			L.node[i] = L.nodes++;
+			L.B[(size_t)i*NNS + 6] = 1.0;
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Aggregate the nodes of a level, using the strong connections of the node graph.
+// The connection strength between two nodes is the Frobenius norm of their block.
+void AMG_Preconditioner::Aggregate(Level& L, std::vector<int>& agg, int& nagg)
+{
+	CSRMatrix& A = L.A;
+	int N = A.rows();
+	int NN = L.nodes;
+	std::vector<int>& pa = A.pointers(); std::vector<int>& ia = A.indices(); std::vector<double>& va = A.values();
+
+	// equations of each node
+	std::vector<int> np(NN + 1, 0), ne(N);
+	for (int i = 0; i < N; ++i) np[L.node[i] + 1]++;
+	for (int i = 0; i < NN; ++i) np[i + 1] += np[i];
+	{
+		std::vector<int> pos(np.begin(), np.end() - 1);
+		for (int i = 0; i < N; ++i) ne[pos[L.node[i]]++] = i;
+	}
+
+	// (squared) norms of the node blocks
+	std::vector<int> gp(NN + 1, 0);
+	std::vector< std::vector<std::pair<int, double> > > G(NN);
+	std::vector<double> S(NN, 0.0);
+#pragma omp parallel
+	{
+		std::vector<double> acc(NN, 0.0);
+		std::vector<int> nbr;
+#pragma omp for schedule(dynamic, 256)
+		for (int I = 0; I < NN; ++I)
+		{
+			nbr.clear();
+			for (int k = np[I]; k < np[I + 1]; ++k)
+			{
+				int i = ne[k];
+				for (int l = pa[i]; l < pa[i + 1]; ++l)
+				{
+					int J = L.node[ia[l]];
+					if (acc[J] == 0.0) nbr.push_back(J);
+					acc[J] += va[l] * va[l] + 1e-300;
+				}
+			}
+			for (int J : nbr)
+			{
+				if (J == I) S[I] = acc[J];
+				else G[I].push_back(std::pair<int, double>(J, acc[J]));
+				acc[J] = 0.0;
+			}
+		}
+	}
+
+	// strong connections
+	double theta2 = m_theta*m_theta;
+	std::vector<int> sa;
+	for (int I = 0; I < NN; ++I)
+	{
+		for (auto& c : G[I])
+		{
+			int J = c.first;
+			if (c.second >= theta2*sqrt(S[I] * S[J])) sa.push_back(J);
+		}
+		gp[I + 1] = (int)sa.size();
+		std::vector<std::pair<int, double> >().swap(G[I]);
+	}
+
+	// phase 1: nodes that are not adjacent to any aggregate form a new aggregate with their neighbors
+	agg.assign(NN, -1);
+	nagg = 0;
+	for (int I = 0; I < NN; ++I)
+	{
+		if (agg[I] >= 0) continue;
+		bool bfree = true;
+		for (int k = gp[I]; k < gp[I + 1]; ++k) if (agg[sa[k]] >= 0) { bfree = false; break; }
+		if (bfree)
+		{
+			agg[I] = nagg;
+			for (int k = gp[I]; k < gp[I + 1]; ++k) agg[sa[k]] = nagg;
+			nagg++;
+		}
+	}
+
+	// phase 2: add the remaining nodes to a neighboring aggregate
+	std::vector<int> agg1(agg);
+	for (int I = 0; I < NN; ++I)
+	{
+		if (agg[I] >= 0) continue;
+		for (int k = gp[I]; k < gp[I + 1]; ++k)
+		{
+			if (agg1[sa[k]] >= 0) { agg[I] = agg1[sa[k]]; break; }
+		}
+	}
+
+	// phase 3: whatever is left forms new aggregates
+	for (int I = 0; I < NN; ++I)
+	{
+		if (agg[I] >= 0) continue;
+		agg[I] = nagg;
+		for (int k = gp[I]; k < gp[I + 1]; ++k) if (agg[sa[k]] < 0) agg[sa[k]] = nagg;
+		nagg++;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Estimate the spectral radius of D^-1*A with a few power iterations
+static double spectralRadius(CSRMatrix& A, std::vector<double>& Dinv)
+{
+	int N = A.rows();
+	std::vector<double> v(N), w(N);
+	for (int i = 0; i < N; ++i) v[i] = 1.0 + 0.1*(i % 7);
+	double rho = 0.0;
+	for (int n = 0; n < 15; ++n)
+	{
+		double vv = 0.0;
+		for (int i = 0; i < N; ++i) vv += v[i] * v[i];
+		vv = sqrt(vv);
+		if (vv == 0.0) break;
+		for (int i = 0; i < N; ++i) v[i] /= vv;
+		spmv(A, &v[0], &w[0]);
+		double ww = 0.0;
+		for (int i = 0; i < N; ++i) { w[i] *= Dinv[i]; ww += w[i] * w[i]; }
+		rho = sqrt(ww);
+		v.swap(w);
+	}
+	return rho;
+}
+
+//-----------------------------------------------------------------------------
+// Calculate the inverse diagonal and the Jacobi weight w = 4/(3*rho(D^-1*A))
+static bool setupSmoother(CSRMatrix& A, std::vector<double>& Dinv, double& omega)
+{
+	int N = A.rows();
+	Dinv.assign(N, 0.0);
+	std::vector<int>& pa = A.pointers(); std::vector<int>& ia = A.indices(); std::vector<double>& va = A.values();
+	for (int i = 0; i < N; ++i)
+	{
+		for (int k = pa[i]; k < pa[i + 1]; ++k)
+			if ((ia[k] == i) && (va[k] != 0.0)) Dinv[i] = 1.0 / va[k];
+	}
+	double rho = 1.05*spectralRadius(A, Dinv);
+	if (rho <= 0.0) return false;
+	omega = 4.0 / (3.0*rho);
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Create the next coarser level C from level L
+bool AMG_Preconditioner::Coarsen(Level& L, Level& C)
+{
+	CSRMatrix& A = L.A;
+	int N = A.rows();
+
+	// inverse diagonal and smoother weight
+	if (setupSmoother(L.A, L.Dinv, L.omega) == false) return false;
+
+	// aggregate the nodes
+	std::vector<int> agg;
+	int nagg = 0;
+	Aggregate(L, agg, nagg);
+
+	// rows of each aggregate
+	std::vector<int> ap(nagg + 1, 0), ar(N);
+	for (int i = 0; i < N; ++i) ap[agg[L.node[i]] + 1]++;
+	for (int i = 0; i < nagg; ++i) ap[i + 1] += ap[i];
+	{
+		std::vector<int> pos(ap.begin(), ap.end() - 1);
+		for (int i = 0; i < N; ++i) ar[pos[agg[L.node[i]]]++] = i;
+	}
+
+	// Orthonormalize the near-nullspace vectors on each aggregate (B_a = Q*R) with 
+	// modified Gram-Schmidt. The columns of Q are the columns of the tentative 
+	// prolongator, and R are the coarse near-nullspace vectors.
+	std::vector<int> rank(nagg, 0);
+	std::vector<double> Q((size_t)N*NNS, 0.0);
+	std::vector<double> R((size_t)nagg*NNS*NNS, 0.0);
+#pragma omp parallel for schedule(dynamic, 64)
+	for (int a = 0; a < nagg; ++a)
+	{
+		int n0 = ap[a], m = ap[a + 1] - ap[a];
+		std::vector<double> q((size_t)m*NNS);
+		int r = 0;
+		double* Ra = &R[(size_t)a*NNS*NNS];
+		for (int j = 0; j < NNS; ++j)
+		{
+			// copy column j of B
+			double* qr = &q[(size_t)r*m];
+			double n0sq = 0.0;
+			for (int i = 0; i < m; ++i) { qr[i] = L.B[(size_t)ar[n0 + i] * NNS + j]; n0sq += qr[i] * qr[i]; }
+			if (n0sq == 0.0) continue;
+
+			// orthogonalize against previous columns
+			for (int k = 0; k < r; ++k)
+			{
+				double* qk = &q[(size_t)k*m];
+				double d = 0.0;
+				for (int i = 0; i < m; ++i) d += qk[i] * qr[i];
+				for (int i = 0; i < m; ++i) qr[i] -= d*qk[i];
+				Ra[k*NNS + j] = d;
+			}
+
+			// normalize, unless it is (nearly) linearly dependent
+			double nsq = 0.0;
+			for (int i = 0; i < m; ++i) nsq += qr[i] * qr[i];
+			if (nsq <= 1e-20*n0sq) continue;
+			double nr = sqrt(nsq);
+			for (int i = 0; i < m; ++i) qr[i] /= nr;
+			Ra[r*NNS + j] = nr;
+			r++;
+		}
+		rank[a] = r;
+		for (int i = 0; i < m; ++i)
+			for (int k = 0; k < r; ++k) Q[(size_t)ar[n0 + i] * NNS + k] = q[(size_t)k*m + i];
+	}
+
+	// coarse equations of each aggregate
+	std::vector<int> cp(nagg + 1, 0);
+	for (int a = 0; a < nagg; ++a) cp[a + 1] = cp[a] + rank[a];
+	int NC = cp[nagg];
+	// stop if the coarsening stagnates
+	if ((NC == 0) || (NC > 0.8*N)) return false;
+
+	// tentative prolongator
+	CSRMatrix T;
+	T.create(N, NC);
+	std::vector<int>& pt = T.pointers();
+	pt.assign(N + 1, 0);
+	for (int i = 0; i < N; ++i) pt[i + 1] = pt[i] + rank[agg[L.node[i]]];
+	T.indices().resize(pt[N]);
+	T.values().resize(pt[N]);
+	for (int i = 0; i < N; ++i)
+	{
+		int a = agg[L.node[i]];
+		for (int k = 0; k < rank[a]; ++k)
+		{
+			T.indices()[pt[i] + k] = cp[a] + k;
+			T.values()[pt[i] + k] = Q[(size_t)i*NNS + k];
+		}
+	}
+
+	// smooth the prolongator: P = (I - w*D^-1*A)*T
+	CSRMatrix AT;
+	spgemm(A, T, AT);
+	{
+		CSRMatrix& P = L.P;
+		P.create(N, NC);
+		std::vector<int>& pp = P.pointers();
+		pp.assign(N + 1, 0);
+		std::vector<int>& pat = AT.pointers();
+		for (int i = 0; i < N; ++i) pp[i + 1] = pp[i] + (pt[i + 1] - pt[i]) + (pat[i + 1] - pat[i]);
+		std::vector<int>& ip = P.indices(); ip.resize(pp[N]);
+		std::vector<double>& vp = P.values(); vp.resize(pp[N]);
+		std::vector<int> len(N, 0);
+
+#pragma omp parallel
+		{
+			std::vector<int> pos(NC, -1);
+#pragma omp for schedule(dynamic, 256)
+			for (int i = 0; i < N; ++i)
+			{
+				int n0 = pp[i], n = n0;
+				for (int k = pt[i]; k < pt[i + 1]; ++k)
+				{
+					int j = T.indices()[k];
+					pos[j] = n; ip[n] = j; vp[n] = T.values()[k]; n++;
+				}
+				double s = -L.omega*L.Dinv[i];
+				for (int k = pat[i]; k < pat[i + 1]; ++k)
+				{
+					int j = AT.indices()[k];
+					if (pos[j] < n0) { pos[j] = n; ip[n] = j; vp[n] = s*AT.values()[k]; n++; }
+					else vp[pos[j]] += s*AT.values()[k];
+				}
+				len[i] = n - n0;
+			}
+		}
+
+		// compress
+		int m = 0;
+		for (int i = 0; i < N; ++i)
+		{
+			int n0 = pp[i];
+			pp[i] = m;
+			for (int k = 0; k < len[i]; ++k) { ip[m] = ip[n0 + k]; vp[m] = vp[n0 + k]; m++; }
+		}
+		pp[N] = m;
+		ip.resize(m);
+		vp.resize(m);
+	}
+	transpose(L.P, L.R);
+
+	// coarse matrix: Ac = R*A*P
+	CSRMatrix AP;
+	spgemm(A, L.P, AP);
+	spgemm(L.R, AP, C.A);
+
+	// coarse nodes and near-nullspace
+	C.nodes = nagg;
+	C.node.resize(NC);
+	C.B.assign((size_t)NC*NNS, 0.0);
+	for (int a = 0; a < nagg; ++a)
+	{
+		for (int k = 0; k < rank[a]; ++k)
+		{
+			int i = cp[a] + k;
+			C.node[i] = a;
+			for (int j = 0; j < NNS; ++j) C.B[(size_t)i*NNS + j] = R[(size_t)a*NNS*NNS + k*NNS + j];
+		}
+	}
+
+	// we don't need the near-nullspace on this level anymore
+	std::vector<double>().swap(L.B);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// LU factorization with partial pivoting of the (dense) coarsest matrix. If the 
+// coarsest level is too large for a dense factorization, it is only smoothed.
+bool AMG_Preconditioner::FactorCoarse(Level& L)
+{
+	int N = L.A.rows();
+	if (N > MAX_DENSE)
+	{
+		m_LU.clear();
+		m_piv.clear();
+		feLogWarning("AMG preconditioner: coarsest level is too large (%d equations) and will only be smoothed.", N);
+		return setupSmoother(L.A, L.Dinv, L.omega);
+	}
+
+	m_LU.assign((size_t)N*N, 0.0);
+	m_piv.assign(N, 0);
+	std::vector<int>& pa = L.A.pointers(); std::vector<int>& ia = L.A.indices(); std::vector<double>& va = L.A.values();
+	for (int i = 0; i < N; ++i)
+		for (int k = pa[i]; k < pa[i + 1]; ++k) m_LU[(size_t)i*N + ia[k]] += va[k];
+
+	double* a = (N > 0 ? &m_LU[0] : nullptr);
+	for (int k = 0; k < N; ++k)
+	{
+		int p = k;
+		double amax = fabs(a[(size_t)k*N + k]);
+		for (int i = k + 1; i < N; ++i)
+		{
+			double v = fabs(a[(size_t)i*N + k]);
+			if (v > amax) { amax = v; p = i; }
+		}
+		if (amax == 0.0)
+		{
+			feLogError("AMG preconditioner: singular coarse matrix.");
+			return false;
+		}
+		m_piv[k] = p;
+		if (p != k)
+		{
+			for (int j = 0; j < N; ++j) std::swap(a[(size_t)k*N + j], a[(size_t)p*N + j]);
+		}
+
+		double akk = a[(size_t)k*N + k];
+#pragma omp parallel for
+		for (int i = k + 1; i < N; ++i)
+		{
+			double* ai = a + (size_t)i*N;
+			double f = ai[k] / akk;
+			ai[k] = f;
+			if (f != 0.0)
+			{
+				const double* ak = a + (size_t)k*N;
+				for (int j = k + 1; j < N; ++j) ai[j] -= f*ak[j];
+			}
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void AMG_Preconditioner::SolveCoarse(Level& L)
+{
+	int N = L.A.rows();
+	std::vector<double>& x = L.x;
+	if (m_LU.empty())
+	{
+		x.assign(N, 0.0);
+		if (N > 0) Smooth(L, &L.b[0], &x[0], false);
+		return;
+	}
+	x = L.b;
+	const double* a = (N > 0 ? &m_LU[0] : nullptr);
+	for (int k = 0; k < N; ++k) if (m_piv[k] != k) std::swap(x[k], x[m_piv[k]]);
+	for (int i = 0; i < N; ++i)
+	{
+		double s = x[i];
+		for (int j = 0; j < i; ++j) s -= a[(size_t)i*N + j] * x[j];
+		x[i] = s;
+	}
+	for (int i = N - 1; i >= 0; --i)
+	{
+		double s = x[i];
+		for (int j = i + 1; j < N; ++j) s -= a[(size_t)i*N + j] * x[j];
+		x[i] = s / a[(size_t)i*N + i];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// damped Jacobi smoothing: x = x + w*D^-1*(b - A*x)
+void AMG_Preconditioner::Smooth(Level& L, const double* b, double* x, bool bzero)
+{
+	int N = L.A.rows();
+	double w = L.omega;
+	double* r = &L.r[0];
+	for (int n = 0; n < m_nsmooth; ++n)
+	{
+		if (bzero && (n == 0))
+		{
+#pragma omp parallel for
+			for (int i = 0; i < N; ++i) x[i] = w*L.Dinv[i] * b[i];
+		}
+		else
+		{
+			spmv(L.A, x, r);
+#pragma omp parallel for
+			for (int i = 0; i < N; ++i) x[i] += w*L.Dinv[i] * (b[i] - r[i]);
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// V-cycle for level l. The right-hand side is in L.b and the result is stored in L.x.
+void AMG_Preconditioner::VCycle(int l)
+{
+	Level& L = m_level[l];
+	if (l == (int)m_level.size() - 1)
+	{
+		SolveCoarse(L);
+		return;
+	}
+
+	int N = L.A.rows();
+	double* x = &L.x[0];
+	double* b = &L.b[0];
+	double* r = &L.r[0];
+
+	// pre-smoothing
+	if (m_nsmooth > 0) Smooth(L, b, x, true);
+	else L.x.assign(N, 0.0);
+
+	// restrict the residual
+	spmv(L.A, x, r);
+#pragma omp parallel for
+	for (int i = 0; i < N; ++i) r[i] = b[i] - r[i];
+	Level& C = m_level[l + 1];
+	spmv(L.R, r, &C.b[0]);
+
+	// coarse grid correction
+	VCycle(l + 1);
+	spmv(L.P, &C.x[0], r);
+#pragma omp parallel for
+	for (int i = 0; i < N; ++i) x[i] += r[i];
+
+	// post-smoothing
+	Smooth(L, b, x, false);
+}
+
+//-----------------------------------------------------------------------------
+bool AMG_Preconditioner::BackSolve(double* x, double* y)
+{
+	if (m_level.empty()) return false;
+	Level& L = m_level[0];
+	int N = L.A.rows();
+	for (int i = 0; i < N; ++i) L.b[i] = y[i];
+	VCycle(0);
+	for (int i = 0; i < N; ++i) x[i] = L.x[i];
+	return true;
+}
@@ -0,0 +1,89 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+#pragma once
+#include <FECore/Preconditioner.h>
+#include <FECore/CSRMatrix.h>
+
+//-----------------------------------------------------------------------------
+// Smoothed aggregation algebraic multigrid (AMG) preconditioner.
+// On the finest level, the equations of each mesh node form a block (i.e. the 
+// x,y,z displacement equations are aggregated together) and the near-nullspace 
+// is spanned by the rigid body modes, which are evaluated from the nodal coordinates.
+// Each application of the preconditioner performs one V-cycle, using damped 
+// Jacobi smoothing and a direct solve on the coarsest level.
+class AMG_Preconditioner : public Preconditioner
+{
+	// data for each level of the hierarchy
+	struct Level
+	{
+		CSRMatrix	A;			// level matrix
+		CSRMatrix	P;			// prolongation from the next (coarser) level
+		CSRMatrix	R;			// restriction to the next level (transpose of P)
+		std::vector<double>	Dinv;	// inverse of diagonal
+		double		omega;		// smoother weight
+
+		std::vector<int>	node;	// node (block) of each equation
+		int					nodes;	// number of nodes
+		std::vector<double>	B;		// near-nullspace vectors (row major)
+
+		std::vector<double>	x, b, r;	// work vectors
+	};
+
+public:
+	AMG_Preconditioner(FEModel* fem);
+
+	// create a sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+	// build the multigrid hierarchy
+	bool Factor() override;
+
+	// apply one V-cycle to y and store result in x
+	bool BackSolve(double* x, double* y) override;
+
+private:
+	bool BuildFineLevel(Level& L);
+	bool Coarsen(Level& L, Level& C);
+	void Aggregate(Level& L, std::vector<int>& agg, int& nagg);
+	void Smooth(Level& L, const double* b, double* x, bool bzero);
+	void VCycle(int l);
+	bool FactorCoarse(Level& L);
+	void SolveCoarse(Level& L);
+
+private:
+	int		m_maxLevels;	// max number of levels
+	int		m_coarseSize;	// max size of coarsest level
+	double	m_theta;		// strength of connection threshold
+	int		m_nsmooth;		// number of pre- and post-smoothing steps
+	int		m_printLevel;	// print level
+
+	std::vector<Level>	m_level;	// multigrid hierarchy
+	std::vector<double>	m_LU;		// factored coarsest matrix
+	std::vector<int>	m_piv;		// pivots of coarsest matrix
+
+	DECLARE_FECORE_CLASS();
+};
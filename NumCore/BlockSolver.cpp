@@ -28,6 +28,8 @@ SOFTWARE.*/
 
 #include "stdafx.h"
 #include "BlockSolver.h"
+#include <FECore/Preconditioner.h>
+#include <FECore/FECoreKernel.h>
 #include <FECore/log.h>
 
 BEGIN_FECORE_CLASS(BlockIterativeSolver, IterativeLinearSolver)
@@ -37,6 +39,7 @@ BEGIN_FECORE_CLASS(BlockIterativeSolver, IterativeLinearSolver)
 	ADD_PARAMETER(m_failMaxIter, "fail_max_iter");
 	ADD_PARAMETER(m_method     , "solution_method");
 	ADD_PARAMETER(m_zeroInitGuess, "zero_initial_guess");
+	ADD_PARAMETER(m_blockPC    , "block_pc");
 END_FECORE_CLASS()
 
 //-----------------------------------------------------------------------------
@@ -147,11 +150,21 @@ bool BlockIterativeSolver::PreProcess()
 	// get the number of partitions
 	int NP = m_pA->Partitions();
 
-	// allocate solvers for diagonal blocks
+	// allocate solvers for diagonal blocks. These are solved directly, unless 
+	// a preconditioner is defined, in which case the blocks are only solved approximately.
 	m_solver.resize(NP);
 	for (int i=0; i<NP; ++i)
 	{
-		m_solver[i] = new PardisoSolver(GetFEModel());
+		if (m_blockPC.empty()) m_solver[i] = new PardisoSolver(GetFEModel());
+		else
+		{
+			m_solver[i] = fecore_new<Preconditioner>(m_blockPC.c_str(), GetFEModel());
+			if (m_solver[i] == nullptr)
+			{
+				feLogError("Invalid block preconditioner: %s", m_blockPC.c_str());
+				return false;
+			}
+		}
 		BlockMatrix::BLOCK& Bi = m_pA->Block(i,i);
 		m_solver[i]->SetSparseMatrix(Bi.pA);
 		if (m_solver[i]->PreProcess() == false) return false;
@@ -95,7 +95,7 @@ public:
 
 private:
 	BlockMatrix*			m_pA;		//!< block matrices
-	vector<PardisoSolver*>	m_solver;	//!< solvers for solving diagonal blocks
+	vector<LinearSolver*>	m_solver;	//!< solvers for solving diagonal blocks
 
 private:
 	int		m_method;			//!< 0 = Jacobi, 1 = Gauss-Seidel
@@ -105,6 +105,7 @@ private:
 	int		m_printLevel;		//!< set print level
 	bool	m_failMaxIter;		//!< fail on max iterations reached
 	bool	m_zeroInitGuess;	//!< always use zero as the initial guess
+	std::string	m_blockPC;		//!< preconditioner for the diagonal blocks (empty = direct solve)
 
 	DECLARE_FECORE_CLASS();
 };
@@ -0,0 +1,157 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "ChebyshevPreconditioner.h"
+#include <FECore/EBEMatrix.h>
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/log.h>
+
+BEGIN_FECORE_CLASS(ChebyshevPreconditioner, Preconditioner)
+	ADD_PARAMETER(m_degree     , FE_RANGE_GREATER_OR_EQUAL(1), "degree");
+	ADD_PARAMETER(m_eigRatio   , FE_RANGE_GREATER(1.0), "eig_ratio");
+	ADD_PARAMETER(m_powerIters , FE_RANGE_GREATER_OR_EQUAL(1), "power_iters");
+	ADD_PARAMETER(m_matrixFree , "matrix_free");
+	ADD_PARAMETER(m_printLevel , "print_level");
+END_FECORE_CLASS();
+
+ChebyshevPreconditioner::ChebyshevPreconditioner(FEModel* fem) : Preconditioner(fem)
+{
+	m_degree = 3;
+	m_eigRatio = 30.0;
+	m_powerIters = 10;
+	m_matrixFree = true;
+	m_printLevel = 0;
+
+	m_lmax = m_lmin = 0.0;
+}
+
+SparseMatrix* ChebyshevPreconditioner::CreateSparseMatrix(Matrix_Type ntype)
+{
+	SparseMatrix* K = nullptr;
+	if (m_matrixFree) K = new EBEMatrix(ntype == REAL_SYMMETRIC);
+	else if (ntype == REAL_SYMMETRIC) K = new CompactSymmMatrix(1);
+	else K = new CRSSparseMatrix(1);
+	SetSparseMatrix(K);
+	return K;
+}
+
+// The largest eigenvalue of D^-1*A is estimated with a few power iterations. The 
+// polynomial then targets the interval [lmax/eig_ratio, lmax].
+bool ChebyshevPreconditioner::Factor()
+{
+	SparseMatrix* A = GetSparseMatrix();
+	if (A == nullptr) return false;
+
+	int N = A->Rows();
+	m_Dinv.resize(N);
+	for (int i = 0; i < N; ++i)
+	{
+		double dii = A->diag(i);
+		m_Dinv[i] = (dii != 0.0 ? 1.0 / dii : 1.0);
+	}
+
+	m_r.assign(N, 0.0);
+	m_d.assign(N, 0.0);
+	m_t.assign(N, 0.0);
+
+	// power iterations
+	std::vector<double>& v = m_d;
+	std::vector<double>& w = m_t;
+	for (int i = 0; i < N; ++i) v[i] = 1.0 + 0.1*(i % 7);
+	double lmax = 0.0;
+	for (int n = 0; n < m_powerIters; ++n)
+	{
+		double vv = 0.0;
+		for (int i = 0; i < N; ++i) vv += v[i] * v[i];
+		vv = sqrt(vv);
+		if (vv == 0.0) break;
+		for (int i = 0; i < N; ++i) v[i] /= vv;
+
+		if (A->mult_vector(&v[0], &w[0]) == false) return false;
+		double ww = 0.0;
+		for (int i = 0; i < N; ++i) { w[i] *= m_Dinv[i]; ww += w[i] * w[i]; }
+		lmax = sqrt(ww);
+		v.swap(w);
+	}
+	if (lmax <= 0.0) return false;
+
+	// the power iteration underestimates the largest eigenvalue
+	m_lmax = 1.1*lmax;
+	m_lmin = m_lmax / m_eigRatio;
+
+	if (m_printLevel > 0)
+	{
+		feLog("Chebyshev preconditioner: eigenvalue interval [%lg, %lg]\n", m_lmin, m_lmax);
+		EBEMatrix* K = dynamic_cast<EBEMatrix*>(A);
+		if (K) feLog("\telement matrices: %d (%lg MB)\n", (int)K->Blocks(), K->MemoryUsage() / 1048576.0);
+	}
+
+	return true;
+}
+
+// Chebyshev iterations for A*x = y, starting from x = 0
+bool ChebyshevPreconditioner::BackSolve(double* x, double* y)
+{
+	SparseMatrix* A = GetSparseMatrix();
+	int N = A->Rows();
+	double* r = &m_r[0];
+	double* d = &m_d[0];
+
+	double theta = 0.5*(m_lmax + m_lmin);
+	double delta = 0.5*(m_lmax - m_lmin);
+	double sigma = theta / delta;
+	double rho = 1.0 / sigma;
+
+#pragma omp parallel for
+	for (int i = 0; i < N; ++i)
+	{
+		d[i] = m_Dinv[i] * y[i] / theta;
+		x[i] = d[i];
+	}
+
+	for (int k = 1; k < m_degree; ++k)
+	{
+		// r = y - A*x
+		A->mult_vector(x, r);
+
+		double rho_new = 1.0 / (2.0*sigma - rho);
+		double a = rho_new*rho;
+		double b = 2.0*rho_new / delta;
+#pragma omp parallel for
+		for (int i = 0; i < N; ++i)
+		{
+			d[i] = a*d[i] + b*m_Dinv[i] * (y[i] - r[i]);
+			x[i] += d[i];
+		}
+		rho = rho_new;
+	}
+
+	return true;
+}
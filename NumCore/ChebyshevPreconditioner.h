@@ -0,0 +1,67 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/Preconditioner.h>
+
+//-----------------------------------------------------------------------------
+// Chebyshev polynomial preconditioner. It applies a fixed number of Chebyshev 
+// iterations for the Jacobi (i.e. diagonally) scaled matrix, so it only needs 
+// matrix-vector products and the matrix diagonal. With degree 1 this is a (scaled)
+// Jacobi preconditioner. Odd degrees are recommended for CG, since the polynomial 
+// stays positive when the largest eigenvalue is underestimated.
+// By default, the preconditioner creates an element-by-element matrix, so that the 
+// iterative solver does not need an assembled global matrix.
+class ChebyshevPreconditioner : public Preconditioner
+{
+public:
+	ChebyshevPreconditioner(FEModel* fem);
+
+	// create a sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
+	// estimate the eigenvalue bounds
+	bool Factor() override;
+
+	// apply to vector P x = y
+	bool BackSolve(double* x, double* y) override;
+
+private:
+	int		m_degree;		// degree of the polynomial
+	double	m_eigRatio;		// ratio of largest and smallest eigenvalue of the interval
+	int		m_powerIters;	// number of power iterations for estimating the largest eigenvalue
+	bool	m_matrixFree;	// use an element-by-element matrix
+	int		m_printLevel;	// print level
+
+	double				m_lmax;		// upper eigenvalue bound
+	double				m_lmin;		// lower eigenvalue bound
+	std::vector<double>	m_Dinv;		// inverse of the diagonal
+	std::vector<double>	m_r, m_d, m_t;
+
+	DECLARE_FECORE_CLASS();
+};
@@ -29,18 +29,11 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "ILU0_Preconditioner.h"
 #include <FECore/CompactUnSymmMatrix.h>
-
-// We must undef PARDISO since it is defined as a function in mkl_solver.h
-#ifdef MKL_ISS
-#ifdef PARDISO
-#undef PARDISO
-#endif
-#include "mkl_rci.h"
-#include "mkl_blas.h"
-#include "mkl_spblas.h"
-#endif // MKL_ISS
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/log.h>
 
 BEGIN_FECORE_CLASS(ILU0_Preconditioner, Preconditioner)
+	ADD_PARAMETER(m_fillLevel        , FE_RANGE_GREATER_OR_EQUAL(0), "fill_level");
 	ADD_PARAMETER(m_checkZeroDiagonal, "replace_zero_diagonal");
 	ADD_PARAMETER(m_zeroThreshold    , "zero_threshold");
 	ADD_PARAMETER(m_zeroReplace      , "zero_replace");
@@ -50,74 +43,46 @@ END_FECORE_CLASS();
 
 ILU0_Preconditioner::ILU0_Preconditioner(FEModel* fem) : Preconditioner(fem)
 {
+	m_fillLevel = 0;
 	m_checkZeroDiagonal = true;
 	m_zeroThreshold = 1e-16;
 	m_zeroReplace = 1e-10;
-
-	m_K = 0;
 }
 
 SparseMatrix* ILU0_Preconditioner::CreateSparseMatrix(Matrix_Type ntype)
 {
-	if (ntype != REAL_UNSYMMETRIC) return nullptr;
-	m_K = new CRSSparseMatrix(1);
-	return m_K;
+	SparseMatrix* K = nullptr;
+	if (ntype == REAL_SYMMETRIC) K = new CompactSymmMatrix(1);
+	else K = new CRSSparseMatrix(1);
+	SetSparseMatrix(K);
+	return K;
 }
 
-#ifdef MKL_ISS
 bool ILU0_Preconditioner::Factor()
 {
+	SparseMatrix* K = GetSparseMatrix();
+	if (K == nullptr) return false;
 
-	if (m_K == 0) return false;
-	assert(m_K->Offset() == 1);
-
-	int N = m_K->Rows();
-	int NNZ = m_K->NonZeroes();
-
-	double* pa = m_K->Values();
-	int* ia = m_K->Pointers();
-	int* ja = m_K->Indices();
-
-	MKL_INT ipar[128] = { 0 };
-	double dpar[128] = { 0.0 };
-
-	// parameters affecting the pre-conditioner
-	if (m_checkZeroDiagonal)
+	m_ilu.SetZeroPivotReplacement(m_checkZeroDiagonal, m_zeroThreshold, m_zeroReplace);
+	switch (m_ilu.FactorILUK(K, m_fillLevel))
 	{
-		ipar[30] = 1;
-		dpar[30] = m_zeroThreshold;
-		dpar[31] = m_zeroReplace;
+	case IncompleteLU::ILU_OK: break;
+	case IncompleteLU::ILU_ZERO_PIVOT:
+		feLogError("Fatal error in ILU preconditioner:\nZero pivot at row %d.", m_ilu.ErrorRow());
+		return false;
+	default:
+		feLogError("Fatal error in ILU preconditioner:\nInvalid matrix format.");
+		return false;
 	}
 
-	m_tmp.resize(N, 0.0);
-
-	m_bilu0.resize(NNZ);
-	int ierr = 0;
-	dcsrilu0(&N, pa, ia, ja, &m_bilu0[0], ipar, dpar, &ierr);
-	if (ierr != 0) return false;
+	// zero pivots are common in mixed problems, so this is only reported in debug mode
+	if (m_ilu.ReplacedPivots() > 0) feLogDebug("ILU preconditioner: %d zero pivots were replaced.", m_ilu.ReplacedPivots());
 
 	return true;
 } 
 
 bool ILU0_Preconditioner::BackSolve(double* x, double* y)
 {
-	int ivar = m_K->Rows();
-	int* ia = m_K->Pointers();
-	int* ja = m_K->Indices();
-
-	char cvar1 = 'L';
-	char cvar = 'N';
-	char cvar2 = 'U';
-	mkl_dcsrtrsv(&cvar1, &cvar, &cvar2, &ivar, &m_bilu0[0], ia, ja, &y[0], &m_tmp[0]);
-	cvar1 = 'U';
-	cvar = 'N';
-	cvar2 = 'N';
-	mkl_dcsrtrsv(&cvar1, &cvar, &cvar2, &ivar, &m_bilu0[0], ia, ja, &m_tmp[0], &x[0]);
-
+	m_ilu.Solve(x, y);
 	return true;
 }
-
-#else
-bool ILU0_Preconditioner::Factor() { return false; }
-bool ILU0_Preconditioner::BackSolve(double* x, double* y) { return false; }
-#endif
@@ -28,8 +28,11 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/Preconditioner.h>
+#include "IncompleteLU.h"
 
 //-----------------------------------------------------------------------------
+// Incomplete LU preconditioner. By default this is ILU(0), i.e. the factors have the 
+// same pattern as the matrix, but additional fill can be allowed with the fill level.
 class ILU0_Preconditioner : public Preconditioner
 {
 public:
@@ -45,14 +48,13 @@ public:
 	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
 
 public:
+	int		m_fillLevel;			// level of fill (k in ILU(k))
 	bool	m_checkZeroDiagonal;	// check for zero diagonals
 	double	m_zeroThreshold;		// threshold for zero diagonal check
 	double	m_zeroReplace;			// replacement value for zero diagonal
 
 private:
-	vector<double>		m_bilu0;
-	vector<double>		m_tmp;
-	CRSSparseMatrix*	m_K;
+	IncompleteLU	m_ilu;
 
 	DECLARE_FECORE_CLASS();
 };
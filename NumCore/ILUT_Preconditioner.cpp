@@ -29,16 +29,8 @@ SOFTWARE.*/
 #include "stdafx.h"
 #include "ILUT_Preconditioner.h"
 #include <FECore/CompactUnSymmMatrix.h>
-
-// We must undef PARDISO since it is defined as a function in mkl_solver.h
-#ifdef MKL_ISS
-#ifdef PARDISO
-#undef PARDISO
-#endif
-#include "mkl_rci.h"
-#include "mkl_blas.h"
-#include "mkl_spblas.h"
-#endif // MKL_ISS
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/log.h>
 
 BEGIN_FECORE_CLASS(ILUT_Preconditioner, Preconditioner)
 	ADD_PARAMETER(m_maxfill, "maxfill");
@@ -60,69 +52,38 @@ ILUT_Preconditioner::ILUT_Preconditioner(FEModel* fem) : Preconditioner(fem)
 
 SparseMatrix* ILUT_Preconditioner::CreateSparseMatrix(Matrix_Type ntype)
 {
-	if (ntype != REAL_UNSYMMETRIC) return nullptr;
-	m_K = new CRSSparseMatrix(1);
-	SetSparseMatrix(m_K);
-	return m_K;
+	SparseMatrix* K = nullptr;
+	if (ntype == REAL_SYMMETRIC) K = new CompactSymmMatrix(1);
+	else K = new CRSSparseMatrix(1);
+	SetSparseMatrix(K);
+	return K;
 }
 
-#ifdef MKL_ISS
-
 bool ILUT_Preconditioner::Factor()
 {
-	if (m_K == 0) return false;
-	assert(m_K->Offset() == 1);
-
-	int N = m_K->Rows();
-	int ivar = N;
-
-	double* pa = m_K->Values();
-	int* ia = m_K->Pointers();
-	int* ja = m_K->Indices();
-
-	MKL_INT ipar[128] = { 0 };
-	double dpar[128] = { 0.0 };
+	SparseMatrix* K = GetSparseMatrix();
+	if (K == nullptr) return false;
 
-	if (m_checkZeroDiagonal)
+	m_ilu.SetZeroPivotReplacement(m_checkZeroDiagonal, m_zeroThreshold, m_zeroReplace);
+	switch (m_ilu.FactorILUT(K, m_maxfill, m_fillTol))
 	{
-		ipar[30] = 1;
-		dpar[30] = m_zeroThreshold;
+	case IncompleteLU::ILU_OK: break;
+	case IncompleteLU::ILU_ZERO_PIVOT:
+		feLogError("Fatal error in ILUT preconditioner:\nZero pivot at row %d.", m_ilu.ErrorRow());
+		return false;
+	default:
+		feLogError("Fatal error in ILUT preconditioner:\nInvalid matrix format.");
+		return false;
 	}
-	else
-	{
-		// do this to avoid a warning from the preconditioner
-		dpar[30] = m_fillTol;
-	}
-
-	const int PCsize = (2 * m_maxfill + 1)*N - m_maxfill*(m_maxfill + 1) + 1;
-	m_bilut.resize(PCsize, 0.0);
-	m_jbilut.resize(PCsize, 0);
-	m_ibilut.resize(N + 1, 0);
 
-	m_tmp.resize(N, 0.0);
-
-	int ierr;
-	dcsrilut(&ivar, pa, ia, ja, &m_bilut[0], &m_ibilut[0], &m_jbilut[0], &m_fillTol, &m_maxfill, ipar, dpar, &ierr);
-	if (ierr != 0) return false;
+	// zero pivots are common in mixed problems, so this is only reported in debug mode
+	if (m_ilu.ReplacedPivots() > 0) feLogDebug("ILUT preconditioner: %d zero pivots were replaced.", m_ilu.ReplacedPivots());
 
 	return true;
 }
 
 bool ILUT_Preconditioner::BackSolve(double* x, double* y)
 {
-	int ivar = m_K->Rows();
-	char cvar1 = 'L';
-	char cvar = 'N';
-	char cvar2 = 'U';
-	mkl_dcsrtrsv(&cvar1, &cvar, &cvar2, &ivar, &m_bilut[0], &m_ibilut[0], &m_jbilut[0], y, &m_tmp[0]);
-	cvar1 = 'U';
-	cvar = 'N';
-	cvar2 = 'N';
-	mkl_dcsrtrsv(&cvar1, &cvar, &cvar2, &ivar, &m_bilut[0], &m_ibilut[0], &m_jbilut[0], &m_tmp[0], x);
-
+	m_ilu.Solve(x, y);
 	return true;
 }
-#else
-bool ILUT_Preconditioner::Factor() { return false; }
-bool ILUT_Preconditioner::BackSolve(double* x, double* y) { return false; }
-#endif
\ No newline at end of file
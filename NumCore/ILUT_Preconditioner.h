@@ -28,6 +28,7 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/Preconditioner.h>
+#include "IncompleteLU.h"
 
 //-----------------------------------------------------------------------------
 class ILUT_Preconditioner : public Preconditioner
@@ -51,11 +52,7 @@ public:
 	double	m_zeroReplace;			// replacement value for zero diagonal
 
 private:
-	CRSSparseMatrix*	m_K;
-	vector<double>	m_bilut;
-	vector<int>		m_jbilut;
-	vector<int>		m_ibilut;
-	vector<double>	m_tmp;
+	IncompleteLU	m_ilu;
 
 	DECLARE_FECORE_CLASS();
 };
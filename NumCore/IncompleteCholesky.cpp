@@ -31,24 +31,27 @@ SOFTWARE.*/
 #include <FECore/CompactSymmMatrix.h>
 #include <FECore/log.h>
 
-// We must undef PARDISO since it is defined as a function in mkl_solver.h
-#ifdef MKL_ISS
-#ifdef PARDISO
-#undef PARDISO
-#endif
-#include "mkl_rci.h"
-#include "mkl_blas.h"
-#include "mkl_spblas.h"
-#endif // MKL_ISS
+BEGIN_FECORE_CLASS(IncompleteCholesky, Preconditioner)
+	ADD_PARAMETER(m_checkZeroDiagonal, "replace_zero_diagonal");
+	ADD_PARAMETER(m_zeroThreshold    , "zero_threshold");
+	ADD_PARAMETER(m_zeroReplace      , "zero_replace");
+END_FECORE_CLASS();
 
 IncompleteCholesky::IncompleteCholesky(FEModel* fem) : Preconditioner(fem)
 {
-	m_L = nullptr;
+	m_checkZeroDiagonal = true;
+	m_zeroThreshold = 1e-16;
+	m_zeroReplace = 1e-10;
 }
 
-CompactSymmMatrix* IncompleteCholesky::getMatrix()
+// create sparse matrix
+SparseMatrix* IncompleteCholesky::CreateSparseMatrix(Matrix_Type ntype)
 {
-	return m_L;
+	// this preconditioner only works with symmetric matrices
+	if (ntype != REAL_SYMMETRIC) return nullptr;
+	SparseMatrix* K = new CompactSymmMatrix(1);
+	SetSparseMatrix(K);
+	return K;
 }
 
 // create a preconditioner for a sparse matrix
@@ -58,101 +61,24 @@ bool IncompleteCholesky::Factor()
 	CompactSymmMatrix* K = dynamic_cast<CompactSymmMatrix*>(GetSparseMatrix());
 	if (K == nullptr) return false;
 
-	if (K->Offset() != 1) return false;
-
-	int N = K->Rows();
-	int nnz = K->NonZeroes();
-
-	z.resize(N, 0.0);
-
-	// create the preconditioner
-	if (m_L) delete m_L;
-	m_L = new CompactSymmMatrix(K->Offset());
-	double* val = new double[nnz];
-	int* row = new int[nnz];
-	int* col = new int[N + 1];
-	m_L->alloc(N, N, nnz, val, row, col);
-
-	// copy the matrix
-	double* aval = K->Values();
-	int* arow = K->Indices();
-	int* acol = K->Pointers();
-	for (int i = 0; i < nnz; ++i)
+	m_ilu.SetZeroPivotReplacement(m_checkZeroDiagonal, m_zeroThreshold, m_zeroReplace);
+	switch (m_ilu.FactorIC(K))
 	{
-		val[i] = aval[i];
-		row[i] = arow[i];
+	case IncompleteLU::ILU_OK: break;
+	case IncompleteLU::ILU_ZERO_PIVOT:
+		feLogError("Fatal error in incomplete Cholesky preconditioner:\nZero diagonal element at row %d.", m_ilu.ErrorRow());
+		return false;
+	case IncompleteLU::ILU_NEGATIVE_PIVOT:
+		feLogError("Fatal error in incomplete Cholesky preconditioner:\nNegative diagonal element at row %d.", m_ilu.ErrorRow());
+		return false;
+	default:
+		feLogError("Fatal error in incomplete Cholesky preconditioner:\nMatrix format error.");
+		return false;
 	}
-	for (int i = 0; i <= N; ++i) col[i] = acol[i];
-
-	CompactSymmMatrix& L = *m_L;
-
-	vector<double> tmp(N, 0.0);
 
-	// fill in the values
-	int offset = m_L->Offset();
-	for (int k = 0; k < N; ++k)
+	if (m_ilu.ReplacedPivots() > 0)
 	{
-		// get the values for column k
-		double* ak = val + (col[k] - offset);
-		int* rowk = row + (col[k] - offset);
-		int Lk = col[k + 1] - col[k];
-
-		// sanity check
-		if (rowk[0] - offset != k)
-		{
-			feLogError("Fatal error in incomplete Cholesky preconditioner:\nMatrix format error at row %d.", k);
-			return false;
-		}
-
-		// make sure the diagonal element is not zero
-		if (ak[0] == 0.0)
-		{
-			feLogError("Fatal error in incomplete Cholesky preconditioner:\nZero diagonal element at row %d.", k);
-			return false;
-		}
-
-		// make sure the diagonal element is not negative either
-		if (ak[0] < 0.0)
-		{
-			feLogError("Fatal error in incomplete Cholesky preconditioner:\nNegative diagonal element at row %d (value = %lg).", k, ak[0]);
-			return false;
-		}
-
-		// set the diagonal element
-		double akk = sqrt(ak[0]);
-		ak[0] = akk;
-		tmp[rowk[0] - offset] = akk;
-
-		// divide column by akk
-		for (int j = 1; j < Lk; ++j)
-		{
-			ak[j] /= akk;
-			tmp[rowk[j] - offset] = ak[j];
-		}
-
-		// loop over all other columns
-		for (int _j = 1; _j < Lk; ++_j)
-		{
-			int j = rowk[_j] - offset;
-			double tjk = tmp[j];
-			if (tjk != 0.0)
-			{
-				double* aj = val + col[j] - offset;
-				int Lj = col[j + 1] - col[j];
-				int* rowj = row + col[j] - offset;
-
-				for (int i = 0; i < Lj; i ++) aj[i] -= tmp[rowj[i] - offset] * tjk;
-			}
-		}
-
-		// reset temp buffer
-		for (int j = 0; j < Lk; ++j) tmp[rowk[j] - offset] = 0.0;
-	}
-
-	for (int i = 0; i < N; ++i)
-	{
-		double Lii = L.diag(i);
-		assert(Lii != 0.0);
+		feLogWarning("Incomplete Cholesky preconditioner: %d small or negative pivots were replaced.", m_ilu.ReplacedPivots());
 	}
 
 	return true;
@@ -160,23 +86,6 @@ bool IncompleteCholesky::Factor()
 
 bool IncompleteCholesky::BackSolve(double* x, double* y)
 {
-#ifdef MKL_ISS
-	int ivar = m_L->Rows();
-	double* pa = m_L->Values();
-	int* ia = m_L->Pointers();
-	int* ja = m_L->Indices();
-
-	char cvar1 = 'U';
-	char cvar = 'T';
-	char cvar2 = 'N';
-	mkl_dcsrtrsv(&cvar1, &cvar, &cvar2, &ivar, pa, ia, ja, &y[0], &z[0]);
-	cvar1 = 'U';
-	cvar = 'N';
-	cvar2 = 'N';
-	mkl_dcsrtrsv(&cvar1, &cvar, &cvar2, &ivar, pa, ia, ja, &z[0], &x[0]);
-
-	return true;
-#else 
+	m_ilu.Solve(x, y);
 	return true;
-#endif
 }
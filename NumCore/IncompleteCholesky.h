@@ -28,9 +28,11 @@ SOFTWARE.*/
 
 #pragma once
 #include <FECore/Preconditioner.h>
+#include "IncompleteLU.h"
 
-class CompactSymmMatrix;
-
+//-----------------------------------------------------------------------------
+// Incomplete Cholesky preconditioner. The factorization can break down even if the 
+// matrix is positive definite. In that case, the small or negative pivots are replaced.
 class IncompleteCholesky : public Preconditioner
 {
 public:
@@ -42,10 +44,16 @@ public:
 	// apply to vector P x = y
 	bool BackSolve(double* x, double* y) override;
 
+	// create sparse matrix
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+
 public:
-	CompactSymmMatrix* getMatrix();
+	bool	m_checkZeroDiagonal;	// replace small and negative pivots
+	double	m_zeroThreshold;		// threshold for the pivot check
+	double	m_zeroReplace;			// replacement value for the pivots
 
 private:
-	CompactSymmMatrix*	m_L;
-	vector<double>		z;
+	IncompleteLU	m_ilu;
+
+	DECLARE_FECORE_CLASS();
 };
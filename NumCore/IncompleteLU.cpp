@@ -0,0 +1,647 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "IncompleteLU.h"
+#include <FECore/CompactMatrix.h>
+#include <FECore/sys.h>
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <math.h>
+#include <string.h>
+
+// symbolic modes that are not an ILU(k) fill level
+#define MODE_NONE	-1
+#define MODE_ILUT	-2
+#define MODE_IC		-3
+
+// The level loops are only done in parallel if the levels have this many rows on average
+#define MIN_LEVEL_ROWS	32
+
+//=============================================================================
+IncompleteLU::IncompleteLU()
+{
+	m_N = 0;
+	m_mode = MODE_NONE;
+	m_patFmt = 0;
+
+	m_replaceZero = false;
+	m_zeroThreshold = 1e-16;
+	m_zeroReplace = 1e-10;
+	m_nrep = 0;
+
+	m_err = ILU_OK;
+	m_errRow = -1;
+}
+
+//-----------------------------------------------------------------------------
+void IncompleteLU::SetZeroPivotReplacement(bool b, double threshold, double replace)
+{
+	m_replaceZero = b;
+	m_zeroThreshold = threshold;
+	m_zeroReplace = replace;
+}
+
+//-----------------------------------------------------------------------------
+void IncompleteLU::SetError(int err, int row)
+{
+#pragma omp critical (ilu_error)
+	{
+		if ((m_err == ILU_OK) || (row < m_errRow))
+		{
+			m_err = err;
+			m_errRow = row;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Copy the pattern of A to a full, zero-based row format with sorted rows. 
+// Returns true if the pattern (and the mode) did not change since the last call,
+// in which case nothing needs to be done.
+bool IncompleteLU::ExpandMatrix(CompactMatrix* A, int mode)
+{
+	int N = A->Rows();
+	int nnzA = A->NonZeroes();
+	int off = A->Offset();
+	const int* ptr = A->Pointers();
+	const int* ind = A->Indices();
+
+	// compare with the pattern of the last call
+	int fmt = (off << 2) | (A->isSymmetric() ? 1 : 0) | (A->isRowBased() ? 2 : 0);
+	if ((mode == m_mode) && (N == m_N) && (fmt == m_patFmt) &&
+		(m_patPtr.size() == (size_t)N + 1) && (m_patInd.size() == (size_t)nnzA) &&
+		(memcmp(ptr, m_patPtr.data(), (N + 1)*sizeof(int)) == 0) &&
+		((nnzA == 0) || (memcmp(ind, m_patInd.data(), nnzA*sizeof(int)) == 0))) return true;
+
+	m_mode = mode;
+	m_patFmt = fmt;
+	m_patPtr.assign(ptr, ptr + N + 1);
+	m_patInd.assign(ind, ind + nnzA);
+	m_N = N;
+
+	// count the entries of each row
+	m_Aptr.assign(N + 1, 0);
+	if (A->isSymmetric())
+	{
+		// lower triangle, stored by columns
+		for (int c = 0; c < N; ++c)
+			for (int k = ptr[c] - off; k < ptr[c + 1] - off; ++k)
+			{
+				int r = ind[k] - off;
+				m_Aptr[r + 1]++;
+				if (r != c) m_Aptr[c + 1]++;
+			}
+	}
+	else if (A->isRowBased())
+	{
+		for (int r = 0; r < N; ++r) m_Aptr[r + 1] = ptr[r + 1] - ptr[r];
+	}
+	else
+	{
+		for (int c = 0; c < N; ++c)
+			for (int k = ptr[c] - off; k < ptr[c + 1] - off; ++k) m_Aptr[ind[k] - off + 1]++;
+	}
+	for (int i = 0; i < N; ++i) m_Aptr[i + 1] += m_Aptr[i];
+
+	// fill the rows
+	int nnz = m_Aptr[N];
+	m_Acol.resize(nnz);
+	m_Asrc.resize(nnz);
+	std::vector<int> pos(m_Aptr.begin(), m_Aptr.end() - 1);
+	if (A->isSymmetric())
+	{
+		for (int c = 0; c < N; ++c)
+			for (int k = ptr[c] - off; k < ptr[c + 1] - off; ++k)
+			{
+				int r = ind[k] - off;
+				m_Acol[pos[r]] = c; m_Asrc[pos[r]++] = k;
+				if (r != c) { m_Acol[pos[c]] = r; m_Asrc[pos[c]++] = k; }
+			}
+	}
+	else if (A->isRowBased())
+	{
+		for (int k = 0; k < nnz; ++k) { m_Acol[k] = ind[k] - off; m_Asrc[k] = k; }
+	}
+	else
+	{
+		for (int c = 0; c < N; ++c)
+			for (int k = ptr[c] - off; k < ptr[c + 1] - off; ++k)
+			{
+				int r = ind[k] - off;
+				m_Acol[pos[r]] = c; m_Asrc[pos[r]++] = k;
+			}
+	}
+
+	// make sure the rows are sorted
+	std::vector<std::pair<int, int> > row;
+	for (int i = 0; i < N; ++i)
+	{
+		int n0 = m_Aptr[i], n1 = m_Aptr[i + 1];
+		if (std::is_sorted(m_Acol.begin() + n0, m_Acol.begin() + n1)) continue;
+		row.clear();
+		for (int k = n0; k < n1; ++k) row.push_back(std::pair<int, int>(m_Acol[k], m_Asrc[k]));
+		std::sort(row.begin(), row.end());
+		for (int k = n0; k < n1; ++k) { m_Acol[k] = row[k - n0].first; m_Asrc[k] = row[k - n0].second; }
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// Symbolic ILU(k) factorization, which determines the pattern of the factors.
+// An entry's level of fill is zero for the entries of A and 
+// lev(i,j) = min(lev(i,j), lev(i,k) + lev(k,j) + 1) for fill-in. Only the entries 
+// with a level not exceeding k are kept.
+void IncompleteLU::SymbolicILUK(int k)
+{
+	int N = m_N;
+	m_ptr.assign(N + 1, 0);
+	m_diag.assign(N, -1);
+	m_col.clear();
+	m_col.reserve(m_Aptr[N] + N);
+	std::vector<int> lev;
+	lev.reserve(m_Aptr[N] + N);
+
+	std::vector<int> next(N), levw(N, 0), mark(N, -1);
+	for (int i = 0; i < N; ++i)
+	{
+		// create a linked list of the columns of row i (including the diagonal)
+		int head = N;
+		bool bdiag = false;
+		for (int n = m_Aptr[i + 1] - 1; n >= m_Aptr[i]; --n)
+		{
+			int c = m_Acol[n];
+			if ((bdiag == false) && (c < i))
+			{
+				next[i] = head; head = i; levw[i] = 0; mark[i] = i;
+				bdiag = true;
+			}
+			if (c == i) bdiag = true;
+			next[c] = head; head = c; levw[c] = 0; mark[c] = i;
+		}
+		if (bdiag == false)
+		{
+			next[i] = head; head = i; levw[i] = 0; mark[i] = i;
+		}
+
+		// add the fill-in from the previous rows
+		if (k > 0)
+		{
+			for (int j = head; j < i; j = next[j])
+			{
+				int lj = levw[j];
+				int a = j;
+				for (int q = m_diag[j] + 1; q < m_ptr[j + 1]; ++q)
+				{
+					int m = m_col[q];
+					int nl = lj + lev[q] + 1;
+					if (nl > k) continue;
+					if (mark[m] == i)
+					{
+						if (nl < levw[m]) levw[m] = nl;
+					}
+					else
+					{
+						while (next[a] < m) a = next[a];
+						next[m] = next[a];
+						next[a] = m;
+						mark[m] = i;
+						levw[m] = nl;
+					}
+				}
+			}
+		}
+
+		// store the row
+		for (int j = head; j != N; j = next[j])
+		{
+			if (j == i) m_diag[i] = (int)m_col.size();
+			m_col.push_back(j);
+			lev.push_back(levw[j]);
+		}
+		m_ptr[i + 1] = (int)m_col.size();
+	}
+
+	// position of the entries of A in the factors
+	m_Apos.resize(m_Acol.size());
+	for (int i = 0; i < N; ++i)
+	{
+		int p = m_ptr[i];
+		for (int n = m_Aptr[i]; n < m_Aptr[i + 1]; ++n)
+		{
+			while (m_col[p] < m_Acol[n]) p++;
+			m_Apos[n] = p;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// For each entry (i,j) of the lower part of a symmetric pattern, find the position 
+// of entry (j,i) and vice versa.
+void IncompleteLU::TransposePositions()
+{
+	int N = m_N;
+	m_tpos.assign(m_col.size(), -1);
+	std::vector<int> cur(m_ptr.begin(), m_ptr.end() - 1);
+	for (int i = 0; i < N; ++i)
+	{
+		for (int q = m_diag[i] + 1; q < m_ptr[i + 1]; ++q)
+		{
+			int m = m_col[q];
+			int p = cur[m]++;
+			assert(m_col[p] == i);
+			m_tpos[p] = q;
+			m_tpos[q] = p;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// Find the levels for the forward and backward substitutions. The level of a row 
+// is one more than the max level of the rows it depends on.
+void IncompleteLU::BuildLevels()
+{
+	int N = m_N;
+	std::vector<int> level(N, 0);
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		std::vector<int>& lp = (pass == 0 ? m_flev : m_blev);
+		std::vector<int>& lr = (pass == 0 ? m_frow : m_brow);
+
+		int nlev = 0;
+		for (int n = 0; n < N; ++n)
+		{
+			int i = (pass == 0 ? n : N - 1 - n);
+			int p0 = (pass == 0 ? m_ptr[i] : m_diag[i] + 1);
+			int p1 = (pass == 0 ? m_diag[i] : m_ptr[i + 1]);
+			int l = 0;
+			for (int p = p0; p < p1; ++p) l = std::max(l, level[m_col[p]] + 1);
+			level[i] = l;
+			if (l + 1 > nlev) nlev = l + 1;
+		}
+
+		lp.assign(nlev + 1, 0);
+		for (int i = 0; i < N; ++i) lp[level[i] + 1]++;
+		for (int l = 0; l < nlev; ++l) lp[l + 1] += lp[l];
+		lr.resize(N);
+		std::vector<int> pos(lp.begin(), lp.end() - 1);
+		for (int i = 0; i < N; ++i) lr[pos[level[i]]++] = i;
+	}
+
+	m_dinv.assign(N, 0.0);
+	m_tmp.assign(N, 0.0);
+}
+
+//-----------------------------------------------------------------------------
+// copy the values of A into the factor
+void IncompleteLU::CopyValues(CompactMatrix* A)
+{
+	const double* val = A->Values();
+	m_val.assign(m_col.size(), 0.0);
+	int N = m_N;
+#pragma omp parallel for
+	for (int i = 0; i < N; ++i)
+	{
+		for (int n = m_Aptr[i]; n < m_Aptr[i + 1]; ++n) m_val[m_Apos[n]] = val[m_Asrc[n]];
+	}
+}
+
+//-----------------------------------------------------------------------------
+// ILU(k) factorization. The rows are factored with the IKJ variant of Gaussian
+// elimination, restricted to the pattern of the factors. A row only depends on the
+// rows in its L part, so the rows of one forward level can be factored in parallel.
+int IncompleteLU::FactorILUK(SparseMatrix* A, int k)
+{
+	m_err = ILU_OK;
+	m_errRow = -1;
+	m_nrep = 0;
+	CompactMatrix* K = dynamic_cast<CompactMatrix*>(A);
+	if ((K == nullptr) || (K->Rows() != K->Columns())) return (m_err = ILU_INVALID_MATRIX);
+
+	if (k < 0) k = 0;
+	if (ExpandMatrix(K, k) == false)
+	{
+		SymbolicILUK(k);
+		BuildLevels();
+	}
+	CopyValues(K);
+
+	int N = m_N;
+	int nlev = (int)m_flev.size() - 1;
+#pragma omp parallel if (N >= MIN_LEVEL_ROWS*nlev)
+	{
+		std::vector<int> pos(N, -1);
+		for (int l = 0; l < nlev; ++l)
+		{
+#pragma omp for schedule(dynamic, 16)
+			for (int n = m_flev[l]; n < m_flev[l + 1]; ++n)
+			{
+				int i = m_frow[n];
+				for (int p = m_ptr[i]; p < m_ptr[i + 1]; ++p) pos[m_col[p]] = p;
+
+				for (int p = m_ptr[i]; p < m_diag[i]; ++p)
+				{
+					int j = m_col[p];
+					double f = m_val[p] * m_dinv[j];
+					m_val[p] = f;
+					if (f == 0.0) continue;
+					for (int q = m_diag[j] + 1; q < m_ptr[j + 1]; ++q)
+					{
+						int pm = pos[m_col[q]];
+						if (pm >= 0) m_val[pm] -= f*m_val[q];
+					}
+				}
+
+				double piv = m_val[m_diag[i]];
+				if (m_replaceZero && (fabs(piv) < m_zeroThreshold))
+				{
+					piv = (piv < 0.0 ? -m_zeroReplace : m_zeroReplace);
+					m_val[m_diag[i]] = piv;
+#pragma omp atomic
+					m_nrep++;
+				}
+				if (piv == 0.0) SetError(ILU_ZERO_PIVOT, i);
+				else m_dinv[i] = 1.0 / piv;
+
+				for (int p = m_ptr[i]; p < m_ptr[i + 1]; ++p) pos[m_col[p]] = -1;
+			}
+		}
+	}
+
+	return m_err;
+}
+
+//-----------------------------------------------------------------------------
+// Incomplete Cholesky factorization, in the form A ~ L*U with U = D*L^T. Only the 
+// U part of each row is eliminated, and L follows from U.
+int IncompleteLU::FactorIC(SparseMatrix* A)
+{
+	m_err = ILU_OK;
+	m_errRow = -1;
+	m_nrep = 0;
+	CompactMatrix* K = dynamic_cast<CompactMatrix*>(A);
+	if ((K == nullptr) || (K->isSymmetric() == false)) return (m_err = ILU_INVALID_MATRIX);
+
+	if (ExpandMatrix(K, MODE_IC) == false)
+	{
+		SymbolicILUK(0);
+		TransposePositions();
+		BuildLevels();
+	}
+	CopyValues(K);
+
+	int N = m_N;
+	int nlev = (int)m_flev.size() - 1;
+#pragma omp parallel if (N >= MIN_LEVEL_ROWS*nlev)
+	{
+		std::vector<int> pos(N, -1);
+		for (int l = 0; l < nlev; ++l)
+		{
+#pragma omp for schedule(dynamic, 16)
+			for (int n = m_flev[l]; n < m_flev[l + 1]; ++n)
+			{
+				int i = m_frow[n];
+				for (int p = m_diag[i]; p < m_ptr[i + 1]; ++p) pos[m_col[p]] = p;
+
+				for (int p = m_ptr[i]; p < m_diag[i]; ++p)
+				{
+					// L(i,k) = U(k,i)/U(k,k)
+					int k = m_col[p];
+					int t = m_tpos[p];
+					double f = m_val[t] * m_dinv[k];
+					m_val[p] = f;
+					if (f == 0.0) continue;
+
+					// the entries of row k after (k,i) update the U part of row i
+					for (int q = t; q < m_ptr[k + 1]; ++q)
+					{
+						int pm = pos[m_col[q]];
+						if (pm >= 0) m_val[pm] -= f*m_val[q];
+					}
+				}
+
+				// Small and negative pivots are replaced, since the factorization 
+				// of a positive definite matrix can still break down. 
+				double piv = m_val[m_diag[i]];
+				if (m_replaceZero && (piv < m_zeroThreshold))
+				{
+					piv = m_zeroReplace;
+					m_val[m_diag[i]] = piv;
+#pragma omp atomic
+					m_nrep++;
+				}
+				if (piv == 0.0) SetError(ILU_ZERO_PIVOT, i);
+				else if (piv < 0.0) SetError(ILU_NEGATIVE_PIVOT, i);
+				else m_dinv[i] = 1.0 / piv;
+
+				for (int p = m_diag[i]; p < m_ptr[i + 1]; ++p) pos[m_col[p]] = -1;
+			}
+		}
+	}
+
+	return m_err;
+}
+
+//-----------------------------------------------------------------------------
+// Dual threshold ILUT factorization (Saad). Entries smaller than droptol times the 
+// norm of the row are dropped, and of the remaining entries only the maxfill 
+// largest ones of the L and U parts are kept. Since the pattern depends on the 
+// values, the rows are factored serially and the levels are rebuilt every time.
+int IncompleteLU::FactorILUT(SparseMatrix* A, int maxfill, double droptol)
+{
+	m_err = ILU_OK;
+	m_errRow = -1;
+	m_nrep = 0;
+	CompactMatrix* K = dynamic_cast<CompactMatrix*>(A);
+	if ((K == nullptr) || (K->Rows() != K->Columns())) return (m_err = ILU_INVALID_MATRIX);
+	if (maxfill < 0) maxfill = 0;
+
+	ExpandMatrix(K, MODE_ILUT);
+	const double* val = K->Values();
+
+	int N = m_N;
+	m_ptr.assign(N + 1, 0);
+	m_diag.assign(N, -1);
+	m_dinv.assign(N, 0.0);
+	m_col.clear();
+	m_val.clear();
+	m_col.reserve((size_t)N*(2 * maxfill + 1));
+	m_val.reserve((size_t)N*(2 * maxfill + 1));
+
+	std::vector<double> w(N, 0.0);
+	std::vector<int> mark(N, -1);
+	std::vector<int> lcols, ucols;
+	std::priority_queue<int, std::vector<int>, std::greater<int> > heap;
+	auto bigger = [&w](int a, int b) { return fabs(w[a]) > fabs(w[b]); };
+	for (int i = 0; i < N; ++i)
+	{
+		lcols.clear();
+		ucols.clear();
+
+		// scatter row i
+		double nrm = 0.0;
+		for (int n = m_Aptr[i]; n < m_Aptr[i + 1]; ++n)
+		{
+			int c = m_Acol[n];
+			double v = val[m_Asrc[n]];
+			w[c] = v;
+			mark[c] = i;
+			nrm += v*v;
+			if (c < i) heap.push(c);
+			else if (c > i) ucols.push_back(c);
+		}
+		if (mark[i] != i) { mark[i] = i; w[i] = 0.0; }
+		double tau = droptol*sqrt(nrm);
+
+		// eliminate the L part in increasing column order
+		while (heap.empty() == false)
+		{
+			int k = heap.top(); heap.pop();
+			double f = w[k] * m_dinv[k];
+			if (fabs(f) <= tau) continue;
+			w[k] = f;
+			lcols.push_back(k);
+			for (int q = m_diag[k] + 1; q < m_ptr[k + 1]; ++q)
+			{
+				int m = m_col[q];
+				if (mark[m] != i)
+				{
+					mark[m] = i;
+					w[m] = 0.0;
+					if (m < i) heap.push(m);
+					else if (m > i) ucols.push_back(m);
+				}
+				w[m] -= f*m_val[q];
+			}
+		}
+
+		// drop small entries of U and keep the largest ones
+		int nu = 0;
+		for (int c : ucols) if (fabs(w[c]) > tau) ucols[nu++] = c;
+		ucols.resize(nu);
+		if ((int)lcols.size() > maxfill)
+		{
+			std::nth_element(lcols.begin(), lcols.begin() + maxfill, lcols.end(), bigger);
+			lcols.resize(maxfill);
+		}
+		if ((int)ucols.size() > maxfill)
+		{
+			std::nth_element(ucols.begin(), ucols.begin() + maxfill, ucols.end(), bigger);
+			ucols.resize(maxfill);
+		}
+		std::sort(lcols.begin(), lcols.end());
+		std::sort(ucols.begin(), ucols.end());
+
+		// pivot
+		double piv = w[i];
+		if (m_replaceZero && (fabs(piv) < m_zeroThreshold))
+		{
+			piv = (piv < 0.0 ? -m_zeroReplace : m_zeroReplace);
+			m_nrep++;
+		}
+		if (piv == 0.0) SetError(ILU_ZERO_PIVOT, i);
+		else m_dinv[i] = 1.0 / piv;
+
+		// store row i
+		for (int c : lcols) { m_col.push_back(c); m_val.push_back(w[c]); }
+		m_diag[i] = (int)m_col.size();
+		m_col.push_back(i); m_val.push_back(piv);
+		for (int c : ucols) { m_col.push_back(c); m_val.push_back(w[c]); }
+		m_ptr[i + 1] = (int)m_col.size();
+	}
+
+	// the levels depend on the pattern, so rebuild them
+	std::vector<double> dinv(m_dinv);
+	BuildLevels();
+	m_dinv = dinv;
+
+	return m_err;
+}
+
+//-----------------------------------------------------------------------------
+// x = U^-1 * L^-1 * y. The rows of each level are solved in parallel. On a single
+// thread, the rows are solved in their natural order instead, which accesses the 
+// factors sequentially.
+void IncompleteLU::Solve(double* x, const double* y)
+{
+	int N = m_N;
+	double* z = (N > 0 ? &m_tmp[0] : nullptr);
+	int nf = (int)m_flev.size() - 1;
+	int nb = (int)m_blev.size() - 1;
+
+	if ((omp_get_max_threads() == 1) || (N < MIN_LEVEL_ROWS*std::max(nf, nb)))
+	{
+		// forward substitution with unit lower triangle
+		for (int i = 0; i < N; ++i)
+		{
+			double s = y[i];
+			for (int p = m_ptr[i]; p < m_diag[i]; ++p) s -= m_val[p] * z[m_col[p]];
+			z[i] = s;
+		}
+
+		// backward substitution
+		for (int i = N - 1; i >= 0; --i)
+		{
+			double s = z[i];
+			for (int p = m_diag[i] + 1; p < m_ptr[i + 1]; ++p) s -= m_val[p] * x[m_col[p]];
+			x[i] = s*m_dinv[i];
+		}
+		return;
+	}
+
+#pragma omp parallel
+	{
+		// forward substitution with unit lower triangle
+		for (int l = 0; l < nf; ++l)
+		{
+#pragma omp for schedule(static)
+			for (int n = m_flev[l]; n < m_flev[l + 1]; ++n)
+			{
+				int i = m_frow[n];
+				double s = y[i];
+				for (int p = m_ptr[i]; p < m_diag[i]; ++p) s -= m_val[p] * z[m_col[p]];
+				z[i] = s;
+			}
+		}
+
+		// backward substitution
+		for (int l = 0; l < nb; ++l)
+		{
+#pragma omp for schedule(static)
+			for (int n = m_blev[l]; n < m_blev[l + 1]; ++n)
+			{
+				int i = m_brow[n];
+				double s = z[i];
+				for (int p = m_diag[i] + 1; p < m_ptr[i + 1]; ++p) s -= m_val[p] * x[m_col[p]];
+				x[i] = s*m_dinv[i];
+			}
+		}
+	}
+}
@@ -0,0 +1,124 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/SparseMatrix.h>
+#include <vector>
+
+class CompactMatrix;
+
+//-----------------------------------------------------------------------------
+// Native incomplete factorization A ~ L*U of a sparse matrix, where L is unit lower
+// triangular. Both factors are stored row-wise (zero-based) in one array. This is
+// the same layout as the MKL ILU routines use.
+// The rows are grouped in levels, so that rows in the same level do not depend on
+// each other. The numerical factorization and the triangular solves then process 
+// one level at a time, in parallel.
+// The symbolic data (the pattern of the factors and the levels) is only rebuilt
+// when the pattern of the matrix changes.
+class IncompleteLU
+{
+public:
+	enum ErrorCode {
+		ILU_OK,
+		ILU_INVALID_MATRIX,
+		ILU_ZERO_PIVOT,
+		ILU_NEGATIVE_PIVOT
+	};
+
+public:
+	IncompleteLU();
+
+	// set the replacement of (nearly) zero pivots
+	void SetZeroPivotReplacement(bool b, double threshold, double replace);
+
+	// ILU(k) factorization. Symmetric matrices are expanded to full storage.
+	int FactorILUK(SparseMatrix* A, int k);
+
+	// dual threshold ILUT factorization. At most maxfill entries are kept 
+	// in each row of L and U.
+	int FactorILUT(SparseMatrix* A, int maxfill, double droptol);
+
+	// incomplete Cholesky factorization (A ~ U^T*D^-1*U) of a symmetric matrix
+	int FactorIC(SparseMatrix* A);
+
+	// apply the preconditioner: x = (L*U)^-1 * y
+	void Solve(double* x, const double* y);
+
+	// the row where the last error occurred
+	int ErrorRow() const { return m_errRow; }
+
+	// number of pivots that were replaced in the last factorization
+	int ReplacedPivots() const { return m_nrep; }
+
+	// number of nonzeroes of the factors
+	int NonZeroes() const { return (int)m_col.size(); }
+
+private:
+	bool ExpandMatrix(CompactMatrix* A, int mode);
+	void SymbolicILUK(int k);
+	void TransposePositions();
+	void CopyValues(CompactMatrix* A);
+	void BuildLevels();
+	void SetError(int err, int row);
+
+private:
+	int		m_N;
+
+	// full, zero-based pattern of A
+	std::vector<int>	m_Aptr, m_Acol;
+	std::vector<int>	m_Asrc;		// index into the values of A
+	std::vector<int>	m_Apos;		// position in factor
+
+	// factors
+	std::vector<int>	m_ptr, m_col;
+	std::vector<double>	m_val;
+	std::vector<int>	m_diag;		// position of diagonal in each row
+	std::vector<double>	m_dinv;		// inverse of pivots
+	std::vector<int>	m_tpos;		// position of transposed entry (IC only)
+
+	// level scheduling
+	std::vector<int>	m_flev, m_frow;	// forward solve levels
+	std::vector<int>	m_blev, m_brow;	// backward solve levels
+
+	std::vector<double>	m_tmp;
+
+	// used to check if the symbolic data can be reused
+	std::vector<int>	m_patPtr, m_patInd;	// copy of the pattern of A
+	int					m_patFmt;	// offset and storage flags of A
+	int					m_mode;
+
+	bool	m_replaceZero;
+	double	m_zeroThreshold;
+	double	m_zeroReplace;
+
+	int		m_nrep;		// number of replaced pivots
+
+	int		m_err;
+	int		m_errRow;
+};
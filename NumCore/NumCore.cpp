@@ -36,6 +36,8 @@ SOFTWARE.*/
 #include "Hypre_PCG_AMG.h"
 #include "SchurSolver.h"
 #include "IncompleteCholesky.h"
+#include "AMG_Preconditioner.h"
+#include "ChebyshevPreconditioner.h"
 #include "BoomerAMGSolver.h"
 #include "BlockSolver.h"
 #include "BiCGStabSolver.h"
@@ -48,6 +50,7 @@ SOFTWARE.*/
 #include "AccelerateSparseSolver.h"
 #include "SuperLU_MT.h"
 #include "MKLDSSolver.h"
+#include "SupernodalSolver.h"
 #include "numcore_api.h"
 
 //=============================================================================
@@ -71,11 +74,14 @@ NUMCORE_API void NumCore::InitModule()
     REGISTER_FECORE_CLASS(AccelerateSparseSolver, "accelerate");
     REGISTER_FECORE_CLASS(SuperLU_MT_Solver     , "superlu_mt");
     REGISTER_FECORE_CLASS(MKLDSSolver           , "mkl_dss");
+	REGISTER_FECORE_CLASS(SupernodalSolver      , "supernodal");
 
 	// register preconditioners
 	REGISTER_FECORE_CLASS(ILU0_Preconditioner, "ilu0");
 	REGISTER_FECORE_CLASS(ILUT_Preconditioner, "ilut");
 	REGISTER_FECORE_CLASS(IncompleteCholesky , "ichol");
+	REGISTER_FECORE_CLASS(AMG_Preconditioner , "amg");
+	REGISTER_FECORE_CLASS(ChebyshevPreconditioner, "chebyshev");
 
 	// register eigen solvers
 	REGISTER_FECORE_CLASS(FEASTEigenSolver, "feast");
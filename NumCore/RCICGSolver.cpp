@@ -64,8 +64,14 @@ SparseMatrix* RCICGSolver::CreateSparseMatrix(Matrix_Type ntype)
 {
 #ifdef MKL_ISS
 	if (ntype != REAL_SYMMETRIC) return 0;
-	m_pA = new CompactSymmMatrix(1);
-	if (m_P) m_P->SetSparseMatrix(m_pA);
+
+	// let the preconditioner decide (e.g. for matrix-free preconditioners)
+	m_pA = (m_P ? m_P->CreateSparseMatrix(ntype) : nullptr);
+	if (m_pA == nullptr)
+	{
+		m_pA = new CompactSymmMatrix(1);
+		if (m_P) m_P->SetSparseMatrix(m_pA);
+	}
 	return m_pA;
 #else
 	return 0;
@@ -0,0 +1,849 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#include "stdafx.h"
+#include "SupernodalSolver.h"
+#include <FECore/CompactSymmMatrix.h>
+#include <FECore/CompactUnSymmMatrix.h>
+#include <FECore/FEFillReducingOrdering.h>
+#include <FECore/log.h>
+#include <FECore/sys.h>
+#include <algorithm>
+#include <string.h>
+
+//-----------------------------------------------------------------------------
+class SupernodalSolver::Imp
+{
+public:
+	CompactMatrix*	A = nullptr;
+	bool	bsymm = true;		// symmetric (LDL^T) or unsymmetric (LDU)
+	int		ordering = FEFillReducingOrdering::AUTO_ORDERING;
+	int		method = FEFillReducingOrdering::AUTO_ORDERING;	// ordering that was used
+
+	int		neq = 0;
+	vector<int>	perm;	// perm[new] = old
+	vector<int>	iperm;	// iperm[old] = new
+
+	// supernodes
+	int				nsn = 0;
+	vector<int>		first;	// first column of supernode (size nsn + 1)
+	vector<int>		colsn;	// supernode of each column
+	vector<int>		rowPtr;	// start of row structure of supernode (size nsn + 1)
+	vector<int>		rows;	// row structure of supernodes (starts with the columns of the supernode)
+	vector<size_t>	valPtr;	// start of supernode values (size nsn + 1)
+
+	// update lists: supernode J is updated by supernode updSn[k] with rows updStart[k] to updEnd[k]
+	vector<int>		updPtr;
+	vector<int>		updSn, updStart, updEnd;
+
+	// supernodes grouped by their height in the supernodal elimination tree
+	vector<int>		lvlPtr;
+	vector<int>		lvlSn;
+
+	// maps the nonzeroes of A to the factor (negative values refer to U)
+	vector<long long>	scatter;
+
+	// factor values
+	vector<double>	L;
+	vector<double>	U;
+
+	// stats
+	double	nnzL = 0.0;
+	double	flops = 0.0;
+
+	// thread workspaces
+	struct Workspace
+	{
+		vector<int>		relmap;
+		vector<double>	W;
+	};
+	vector<Workspace>	ws;
+
+public:
+	void Clear();
+	bool Analyze();
+	bool Factor();
+	void Solve(double* x, const double* b);
+
+private:
+	bool FactorSupernode(int J, Workspace& ws, bool bpar);
+	void BuildGraph(vector<int>& xadj, vector<int>& adj);
+};
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Imp::Clear()
+{
+	neq = 0;
+	nsn = 0;
+	perm.clear(); iperm.clear();
+	first.clear(); colsn.clear();
+	rowPtr.clear(); rows.clear(); valPtr.clear();
+	updPtr.clear(); updSn.clear(); updStart.clear(); updEnd.clear();
+	lvlPtr.clear(); lvlSn.clear();
+	scatter.clear();
+	vector<double>().swap(L);
+	vector<double>().swap(U);
+	ws.clear();
+	nnzL = flops = 0.0;
+}
+
+//-----------------------------------------------------------------------------
+// build the graph of the symmetrized matrix structure (excluding the diagonal)
+void SupernodalSolver::Imp::BuildGraph(vector<int>& xadj, vector<int>& adj)
+{
+	int n = neq;
+	int off = A->Offset();
+	const int* pp = A->Pointers();
+	const int* pi = A->Indices();
+
+	xadj.assign(n + 1, 0);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = pp[j] - off; k < pp[j + 1] - off; ++k)
+		{
+			int i = pi[k] - off;
+			if (i != j) { xadj[i + 1]++; xadj[j + 1]++; }
+		}
+	}
+	for (int i = 0; i < n; ++i) xadj[i + 1] += xadj[i];
+
+	adj.resize(xadj[n]);
+	vector<int> pos(xadj.begin(), xadj.end() - 1);
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = pp[j] - off; k < pp[j + 1] - off; ++k)
+		{
+			int i = pi[k] - off;
+			if (i != j) { adj[pos[i]++] = j; adj[pos[j]++] = i; }
+		}
+	}
+
+	// remove duplicates (unsymmetric formats store both (i,j) and (j,i))
+	int m = 0;
+	int start = 0;
+	for (int i = 0; i < n; ++i)
+	{
+		int* a = &adj[0] + start;
+		int na = xadj[i + 1] - start;
+		std::sort(a, a + na);
+		int m0 = m;
+		for (int k = 0; k < na; ++k)
+		{
+			if ((k == 0) || (a[k] != a[k - 1])) adj[m++] = a[k];
+		}
+		start = xadj[i + 1];
+		xadj[i] = m0;
+	}
+	xadj[n] = m;
+	adj.resize(m);
+}
+
+//-----------------------------------------------------------------------------
+// Ordering and symbolic factorization
+bool SupernodalSolver::Imp::Analyze()
+{
+	Clear();
+	if (A == nullptr) return false;
+	int n = neq = A->Rows();
+	if (n == 0) return true;
+
+	// get the graph of the matrix
+	vector<int> xadj, adj;
+	BuildGraph(xadj, adj);
+
+	// fill-reducing ordering
+	FEFillReducingOrdering ord;
+	ord.Create(n, xadj.data(), adj.data());
+	if (ord.Apply(perm, ordering) == false) return false;
+	method = ord.Method();
+	iperm.resize(n);
+	for (int i = 0; i < n; ++i) iperm[perm[i]] = i;
+
+	// elimination tree of the permuted matrix
+	vector<int> parent(n, -1), anc(n, -1);
+	for (int k = 0; k < n; ++k)
+	{
+		int p = perm[k];
+		for (int l = xadj[p]; l < xadj[p + 1]; ++l)
+		{
+			int i = iperm[adj[l]];
+			if (i >= k) continue;
+			int r = i;
+			while ((anc[r] != -1) && (anc[r] != k))
+			{
+				int t = anc[r];
+				anc[r] = k;
+				r = t;
+			}
+			if (anc[r] == -1) { anc[r] = k; parent[r] = k; }
+		}
+	}
+
+	// postorder the elimination tree, so that the supernodes become contiguous
+	vector<int> chead(n, -1), cnext(n, -1);
+	for (int j = n - 1; j >= 0; --j)
+	{
+		int p = parent[j];
+		if (p >= 0) { cnext[j] = chead[p]; chead[p] = j; }
+	}
+	vector<int> post; post.reserve(n);
+	vector<int> stack;
+	for (int j = 0; j < n; ++j)
+	{
+		if (parent[j] != -1) continue;
+		stack.push_back(j);
+		while (stack.empty() == false)
+		{
+			int p = stack.back();
+			int c = chead[p];
+			if (c == -1) { stack.pop_back(); post.push_back(p); }
+			else { chead[p] = cnext[c]; stack.push_back(c); }
+		}
+	}
+	assert((int)post.size() == n);
+
+	vector<int> ipost(n);
+	for (int k = 0; k < n; ++k) ipost[post[k]] = k;
+	vector<int> tmp(n);
+	for (int k = 0; k < n; ++k) tmp[k] = perm[post[k]];
+	perm = tmp;
+	for (int k = 0; k < n; ++k) tmp[k] = (parent[post[k]] >= 0 ? ipost[parent[post[k]]] : -1);
+	parent = tmp;
+	for (int i = 0; i < n; ++i) iperm[perm[i]] = i;
+
+	// column counts (including the diagonal)
+	vector<int> cc(n, 1), flag(n, -1);
+	for (int i = 0; i < n; ++i)
+	{
+		flag[i] = i;
+		int p = perm[i];
+		for (int l = xadj[p]; l < xadj[p + 1]; ++l)
+		{
+			int j = iperm[adj[l]];
+			if (j >= i) continue;
+			while (flag[j] != i)
+			{
+				cc[j]++;
+				flag[j] = i;
+				j = parent[j];
+			}
+		}
+	}
+
+	// fundamental supernodes
+	vector<int> nchild(n, 0);
+	for (int j = 0; j < n; ++j) if (parent[j] >= 0) nchild[parent[j]]++;
+
+	struct SNODE {
+		int		first;	// first column
+		int		nc;		// nr of columns
+		int		nr;		// nr of rows (including the diagonal block)
+		double	nz;		// nr of true nonzeroes in L
+	};
+	vector<SNODE> sn;
+	for (int j = 0; j < n;)
+	{
+		SNODE s;
+		s.first = j;
+		s.nc = 1;
+		s.nr = cc[j];
+		s.nz = cc[j];
+		while ((j + s.nc < n) && (parent[j + s.nc - 1] == j + s.nc) && (cc[j + s.nc] == cc[j + s.nc - 1] - 1) && (nchild[j + s.nc] == 1))
+		{
+			s.nz += cc[j + s.nc];
+			s.nc++;
+		}
+		sn.push_back(s);
+		j += s.nc;
+	}
+
+	// relaxed amalgamation: merge a supernode with the preceding one if that is one of 
+	// its children and not too many explicit zeroes are introduced. 
+	vector<SNODE> rsn;
+	for (size_t k = 0; k < sn.size(); ++k)
+	{
+		SNODE s = sn[k];
+		while (rsn.empty() == false)
+		{
+			SNODE& c = rsn.back();
+			int pc = parent[c.first + c.nc - 1];
+			if ((pc < s.first) || (pc >= s.first + s.nc)) break;
+
+			double nc = c.nc + s.nc;
+			double nr = c.nc + s.nr;
+			double stored = nc*nr - nc*(nc - 1.0)*0.5;
+			double z = (stored - (c.nz + s.nz)) / stored;
+			bool bmerge = (nc <= 4) || ((nc <= 16) && (z < 0.8)) || ((nc <= 48) && (z < 0.1)) || (z < 0.05);
+			if (bmerge == false) break;
+
+			s.first = c.first;
+			s.nr += c.nc;
+			s.nc += c.nc;
+			s.nz += c.nz;
+			rsn.pop_back();
+		}
+		rsn.push_back(s);
+	}
+
+	nsn = (int)rsn.size();
+	first.resize(nsn + 1);
+	colsn.resize(n);
+	for (int s = 0; s < nsn; ++s)
+	{
+		first[s] = rsn[s].first;
+		for (int j = 0; j < rsn[s].nc; ++j) colsn[rsn[s].first + j] = s;
+	}
+	first[nsn] = n;
+
+	// supernodal elimination tree
+	vector<int> snparent(nsn, -1);
+	for (int s = 0; s < nsn; ++s)
+	{
+		int p = parent[first[s + 1] - 1];
+		if (p >= 0) snparent[s] = colsn[p];
+	}
+	vector<int> snchead(nsn, -1), sncnext(nsn, -1);
+	for (int s = nsn - 1; s >= 0; --s)
+	{
+		int p = snparent[s];
+		if (p >= 0) { sncnext[s] = snchead[p]; snchead[p] = s; }
+	}
+
+	// row structures of the supernodes
+	rowPtr.assign(nsn + 1, 0);
+	flag.assign(n, -1);
+	vector<int> rs;
+	for (int s = 0; s < nsn; ++s)
+	{
+		int j0 = first[s], j1 = first[s + 1];
+		rs.clear();
+		for (int j = j0; j < j1; ++j)
+		{
+			int p = perm[j];
+			for (int l = xadj[p]; l < xadj[p + 1]; ++l)
+			{
+				int i = iperm[adj[l]];
+				if ((i >= j1) && (flag[i] != s)) { flag[i] = s; rs.push_back(i); }
+			}
+		}
+		for (int c = snchead[s]; c >= 0; c = sncnext[c])
+		{
+			for (int k = rowPtr[c] + (first[c + 1] - first[c]); k < rowPtr[c + 1]; ++k)
+			{
+				int i = rows[k];
+				if ((i >= j1) && (flag[i] != s)) { flag[i] = s; rs.push_back(i); }
+			}
+		}
+		std::sort(rs.begin(), rs.end());
+		rowPtr[s] = (int)rows.size();
+		for (int j = j0; j < j1; ++j) rows.push_back(j);
+		rows.insert(rows.end(), rs.begin(), rs.end());
+		rowPtr[s + 1] = (int)rows.size();
+	}
+
+	// value offsets and stats
+	valPtr.assign(nsn + 1, 0);
+	for (int s = 0; s < nsn; ++s)
+	{
+		size_t nc = first[s + 1] - first[s];
+		size_t nr = rowPtr[s + 1] - rowPtr[s];
+		valPtr[s + 1] = valPtr[s] + nc*nr;
+
+		for (size_t j = 0; j < nc; ++j)
+		{
+			double c = (double)(nr - j);
+			nnzL += c;
+			flops += c*c;
+		}
+	}
+
+	// update lists
+	updPtr.assign(nsn + 1, 0);
+	for (int pass = 0; pass < 2; ++pass)
+	{
+		for (int K = 0; K < nsn; ++K)
+		{
+			int nc = first[K + 1] - first[K];
+			int nr = rowPtr[K + 1] - rowPtr[K];
+			const int* rk = &rows[rowPtr[K]];
+			for (int p = nc; p < nr;)
+			{
+				int J = colsn[rk[p]];
+				int q = p + 1;
+				while ((q < nr) && (rk[q] < first[J + 1])) q++;
+				if (pass == 0) updPtr[J + 1]++;
+				else
+				{
+					int m = updPtr[J]++;
+					updSn[m] = K;
+					updStart[m] = p;
+					updEnd[m] = q;
+				}
+				p = q;
+			}
+		}
+
+		if (pass == 0)
+		{
+			for (int J = 0; J < nsn; ++J) updPtr[J + 1] += updPtr[J];
+			updSn.resize(updPtr[nsn]);
+			updStart.resize(updPtr[nsn]);
+			updEnd.resize(updPtr[nsn]);
+		}
+		else
+		{
+			for (int J = nsn; J > 0; --J) updPtr[J] = updPtr[J - 1];
+			updPtr[0] = 0;
+		}
+	}
+
+	// group the supernodes by their height in the tree
+	vector<int> height(nsn, 0);
+	int maxh = 0;
+	for (int s = 0; s < nsn; ++s)
+	{
+		int p = snparent[s];
+		if ((p >= 0) && (height[p] < height[s] + 1)) height[p] = height[s] + 1;
+		if (height[s] > maxh) maxh = height[s];
+	}
+	lvlPtr.assign(maxh + 2, 0);
+	for (int s = 0; s < nsn; ++s) lvlPtr[height[s] + 1]++;
+	for (int l = 0; l <= maxh; ++l) lvlPtr[l + 1] += lvlPtr[l];
+	lvlSn.resize(nsn);
+	tmp.assign(lvlPtr.begin(), lvlPtr.end() - 1);
+	for (int s = 0; s < nsn; ++s) lvlSn[tmp[height[s]]++] = s;
+
+	// map the nonzeroes of A to the factor
+	int off = A->Offset();
+	const int* pp = A->Pointers();
+	const int* pi = A->Indices();
+	bool browBased = A->isRowBased();
+	scatter.resize(A->NonZeroes());
+	for (int j = 0; j < n; ++j)
+	{
+		for (int k = pp[j] - off; k < pp[j + 1] - off; ++k)
+		{
+			int i = pi[k] - off;
+			int r = iperm[browBased ? j : i];
+			int c = iperm[browBased ? i : j];
+
+			bool bupper = false;
+			if (r < c)
+			{
+				if (bsymm || (colsn[r] == colsn[c])) { if (bsymm) std::swap(r, c); }
+				else { std::swap(r, c); bupper = true; }
+			}
+
+			int s = colsn[c];
+			const int* rb = &rows[rowPtr[s]];
+			const int* re = &rows[rowPtr[s + 1]];
+			long long lr = std::lower_bound(rb, re, r) - rb;
+			assert((rb + lr < re) && (rb[lr] == r));
+			long long nr = re - rb;
+			long long d = (long long)valPtr[s] + (c - first[s])*nr + lr;
+			scatter[k] = (bupper ? -d - 1 : d);
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Numerical factorization
+bool SupernodalSolver::Imp::Factor()
+{
+	if (neq == 0) return true;
+
+	// allocate the factor
+	size_t nval = valPtr[nsn];
+	L.assign(nval, 0.0);
+	if (bsymm == false) U.assign(nval, 0.0);
+
+	// copy the matrix values
+	const double* pv = A->Values();
+	int nnz = A->NonZeroes();
+	for (int k = 0; k < nnz; ++k)
+	{
+		long long d = scatter[k];
+		if (d >= 0) L[d] += pv[k];
+		else U[-d - 1] += pv[k];
+	}
+
+	// allocate workspace
+	int nt = omp_get_max_threads();
+	if ((int)ws.size() < nt) ws.resize(nt);
+	for (int i = 0; i < nt; ++i) ws[i].relmap.resize(neq);
+
+	// process the tree level by level, starting at the leaves
+	bool bok = true;
+	int nlvl = (int)lvlPtr.size() - 1;
+	for (int l = 0; l < nlvl; ++l)
+	{
+		int n0 = lvlPtr[l];
+		int n1 = lvlPtr[l + 1];
+		if (n1 - n0 > 1)
+		{
+#pragma omp parallel for schedule(dynamic)
+			for (int k = n0; k < n1; ++k)
+			{
+				if (FactorSupernode(lvlSn[k], ws[omp_get_thread_num()], false) == false) bok = false;
+			}
+		}
+		else if (n1 > n0)
+		{
+			// use parallelism inside the supernode
+			if (FactorSupernode(lvlSn[n0], ws[0], true) == false) bok = false;
+		}
+		if (bok == false) return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// Apply the updates of all descendants to supernode J and factor it.
+bool SupernodalSolver::Imp::FactorSupernode(int J, Workspace& w, bool bpar)
+{
+	const int fJ = first[J];
+	const int nc = first[J + 1] - fJ;
+	const int nr = rowPtr[J + 1] - rowPtr[J];
+	const int* rj = &rows[rowPtr[J]];
+	double* LJ = &L[valPtr[J]];
+	double* UJ = (bsymm ? LJ : &U[valPtr[J]]);
+
+	int* relmap = &w.relmap[0];
+	for (int a = 0; a < nr; ++a) relmap[rj[a]] = a;
+
+	// apply updates
+	for (int u = updPtr[J]; u < updPtr[J + 1]; ++u)
+	{
+		const int K = updSn[u];
+		const int p = updStart[u];
+		const int q = updEnd[u];
+		const int ncK = first[K + 1] - first[K];
+		const int nrK = rowPtr[K + 1] - rowPtr[K];
+		const int* rk = &rows[rowPtr[K]];
+		const double* LK = &L[valPtr[K]];
+		const double* UK = (bsymm ? LK : &U[valPtr[K]]);
+
+		const int m = nrK - p;
+		const int nw = q - p;
+		w.W.assign((size_t)m*nw, 0.0);
+		double* W = &w.W[0];
+
+		// W = L(p:,:) * D * U(p:q,:)^T
+#pragma omp parallel for if (bpar && (m*nw > 4096))
+		for (int b = 0; b < nw; ++b)
+		{
+			double* Wb = W + (size_t)b*m;
+			int a0 = (bsymm ? b : 0);
+			for (int k = 0; k < ncK; ++k)
+			{
+				const double* lk = LK + (size_t)k*nrK;
+				double s = lk[k] * UK[(size_t)k*nrK + p + b];
+				if (s == 0.0) continue;
+				lk += p;
+				for (int a = a0; a < m; ++a) Wb[a] += lk[a] * s;
+			}
+
+			double* Lc = LJ + (size_t)(rk[p + b] - fJ)*nr;
+			for (int a = a0; a < m; ++a) Lc[relmap[rk[p + a]]] -= Wb[a];
+		}
+
+		if (bsymm == false)
+		{
+			// W = U(q:,:) * D * L(p:q,:)^T
+			const int m2 = nrK - q;
+			if (m2 == 0) continue;
+#pragma omp parallel for if (bpar && (m2*nw > 4096))
+			for (int b = 0; b < nw; ++b)
+			{
+				double* Wb = W + (size_t)b*m;
+				for (int a = 0; a < m2; ++a) Wb[a] = 0.0;
+				for (int k = 0; k < ncK; ++k)
+				{
+					double s = LK[(size_t)k*nrK + k] * LK[(size_t)k*nrK + p + b];
+					if (s == 0.0) continue;
+					const double* uk = UK + (size_t)k*nrK + q;
+					for (int a = 0; a < m2; ++a) Wb[a] += uk[a] * s;
+				}
+
+				double* Uc = UJ + (size_t)(rk[p + b] - fJ)*nr;
+				for (int a = 0; a < m2; ++a) Uc[relmap[rk[q + a]]] -= Wb[a];
+			}
+		}
+	}
+
+	// factor the supernode (blocked, right-looking)
+	const int NB = 32;
+	for (int c0 = 0; c0 < nc; c0 += NB)
+	{
+		const int c1 = (c0 + NB < nc ? c0 + NB : nc);
+
+		// factor the columns in this block
+		for (int k = c0; k < c1; ++k)
+		{
+			double* Pk = LJ + (size_t)k*nr;
+			double d = Pk[k];
+			if (d == 0.0) return false;
+			double di = 1.0 / d;
+			for (int i = k + 1; i < nr; ++i) Pk[i] *= di;
+			if (bsymm == false)
+			{
+				double* Uk = UJ + (size_t)k*nr;
+				for (int r = nc; r < nr; ++r) Uk[r] *= di;
+			}
+
+			for (int j = k + 1; j < c1; ++j)
+			{
+				double* Pj = LJ + (size_t)j*nr;
+				if (bsymm)
+				{
+					double s = Pk[j] * d;
+					for (int i = j; i < nr; ++i) Pj[i] -= Pk[i] * s;
+				}
+				else
+				{
+					double s = Pj[k];
+					Pj[k] = s * di;
+					for (int i = k + 1; i < nr; ++i) Pj[i] -= Pk[i] * s;
+
+					double t = Pk[j] * d;
+					const double* Uk = UJ + (size_t)k*nr;
+					double* Uj = UJ + (size_t)j*nr;
+					for (int r = nc; r < nr; ++r) Uj[r] -= Uk[r] * t;
+				}
+			}
+		}
+
+		// update the remaining columns
+#pragma omp parallel for if (bpar && ((nc - c1)*nr > 4096))
+		for (int j = c1; j < nc; ++j)
+		{
+			double* Pj = LJ + (size_t)j*nr;
+			for (int k = c0; k < c1; ++k)
+			{
+				const double* Pk = LJ + (size_t)k*nr;
+				double d = Pk[k];
+				if (bsymm)
+				{
+					double s = Pk[j] * d;
+					for (int i = j; i < nr; ++i) Pj[i] -= Pk[i] * s;
+				}
+				else
+				{
+					double s = Pj[k];
+					Pj[k] = s / d;
+					for (int i = k + 1; i < nr; ++i) Pj[i] -= Pk[i] * s;
+
+					double t = Pk[j] * d;
+					const double* Uk = UJ + (size_t)k*nr;
+					double* Uj = UJ + (size_t)j*nr;
+					for (int r = nc; r < nr; ++r) Uj[r] -= Uk[r] * t;
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Imp::Solve(double* x, const double* b)
+{
+	int n = neq;
+	vector<double> y(n);
+	for (int k = 0; k < n; ++k) y[k] = b[perm[k]];
+
+	// forward substitution (L)
+	for (int J = 0; J < nsn; ++J)
+	{
+		const int fJ = first[J];
+		const int nc = first[J + 1] - fJ;
+		const int nr = rowPtr[J + 1] - rowPtr[J];
+		const int* rj = &rows[rowPtr[J]];
+		const double* LJ = &L[valPtr[J]];
+		for (int c = 0; c < nc; ++c)
+		{
+			const double* Pc = LJ + (size_t)c*nr;
+			double yc = y[fJ + c];
+			if (yc == 0.0) continue;
+			for (int i = c + 1; i < nc; ++i) y[fJ + i] -= Pc[i] * yc;
+			for (int r = nc; r < nr; ++r) y[rj[r]] -= Pc[r] * yc;
+		}
+	}
+
+	// diagonal (D)
+	for (int J = 0; J < nsn; ++J)
+	{
+		const int fJ = first[J];
+		const int nc = first[J + 1] - fJ;
+		const int nr = rowPtr[J + 1] - rowPtr[J];
+		const double* LJ = &L[valPtr[J]];
+		for (int c = 0; c < nc; ++c) y[fJ + c] /= LJ[(size_t)c*nr + c];
+	}
+
+	// backward substitution (L^T or U)
+	for (int J = nsn - 1; J >= 0; --J)
+	{
+		const int fJ = first[J];
+		const int nc = first[J + 1] - fJ;
+		const int nr = rowPtr[J + 1] - rowPtr[J];
+		const int* rj = &rows[rowPtr[J]];
+		const double* LJ = &L[valPtr[J]];
+		const double* UJ = (bsymm ? LJ : &U[valPtr[J]]);
+		for (int c = nc - 1; c >= 0; --c)
+		{
+			const double* Uc = UJ + (size_t)c*nr;
+			double s = y[fJ + c];
+			for (int r = nc; r < nr; ++r) s -= Uc[r] * y[rj[r]];
+			if (bsymm)
+			{
+				for (int k = c + 1; k < nc; ++k) s -= Uc[k] * y[fJ + k];
+			}
+			else
+			{
+				for (int k = c + 1; k < nc; ++k) s -= LJ[(size_t)k*nr + c] * y[fJ + k];
+			}
+			y[fJ + c] = s;
+		}
+	}
+
+	for (int k = 0; k < n; ++k) x[perm[k]] = y[k];
+}
+
+//=============================================================================
+BEGIN_FECORE_CLASS(SupernodalSolver, LinearSolver)
+	ADD_PARAMETER(m_print_level, "print_level");
+	ADD_PARAMETER(m->ordering, "ordering", 0, "auto\0amd\0nd\0");
+END_FECORE_CLASS();
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::SupernodalSolver(FEModel* fem) : LinearSolver(fem), m(new SupernodalSolver::Imp)
+{
+	m_print_level = 0;
+}
+
+//-----------------------------------------------------------------------------
+SupernodalSolver::~SupernodalSolver()
+{
+	Destroy();
+	delete m;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::SetPrintLevel(int n)
+{
+	m_print_level = n;
+}
+
+//-----------------------------------------------------------------------------
+SparseMatrix* SupernodalSolver::CreateSparseMatrix(Matrix_Type ntype)
+{
+	// allocate the correct matrix format depending on matrix symmetry type
+	switch (ntype)
+	{
+	case REAL_SYMMETRIC     : m->A = new CompactSymmMatrix(); m->bsymm = true; break;
+	case REAL_UNSYMMETRIC   : 
+	case REAL_SYMM_STRUCTURE: m->A = new CRSSparseMatrix(); m->bsymm = false; break;
+	default:
+		assert(false);
+		m->A = nullptr;
+	}
+
+	return m->A;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::SetSparseMatrix(SparseMatrix* pA)
+{
+	CompactMatrix* A = dynamic_cast<CompactMatrix*>(pA);
+	if (A == nullptr) return false;
+
+	m->A = A;
+	m->bsymm = A->isSymmetric();
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::PreProcess()
+{
+	if (m->A == nullptr) return false;
+
+	// do the ordering and symbolic factorization
+	if (m->Analyze() == false) return false;
+
+	if (m_print_level > 0)
+	{
+		feLog("Supernodal solver:\n");
+		feLog("\tNr of equations ........................... : %d\n", m->neq);
+		const char* szord[] = { "auto", "amd", "nd" };
+		feLog("\tOrdering .................................. : %s\n", szord[m->method]);
+		feLog("\tNr of supernodes .......................... : %d\n", m->nsn);
+		feLog("\tNr of nonzeroes in factor ................. : %lg\n", m->nnzL);
+		feLog("\tNr of floating point operations ........... : %lg\n\n", m->flops);
+	}
+
+	return LinearSolver::PreProcess();
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::Factor()
+{
+	// make sure we have work to do
+	if ((m->A == nullptr) || (m->A->Rows() == 0)) return true;
+
+	if (m->Factor() == false)
+	{
+		feLogError("Zero pivot encountered in supernodal solver.");
+		return false;
+	}
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+bool SupernodalSolver::BackSolve(double* x, double* b)
+{
+	// make sure we have work to do
+	if ((m->A == nullptr) || (m->A->Rows() == 0)) return true;
+
+	m->Solve(x, b);
+
+	// update stats
+	UpdateStats(1);
+
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+void SupernodalSolver::Destroy()
+{
+	m->Clear();
+	LinearSolver::Destroy();
+}
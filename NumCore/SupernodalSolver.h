@@ -0,0 +1,62 @@
+/*This file is part of the FEBio source code and is licensed under the MIT license
+listed below.
+
+See Copyright-FEBio.txt for details.
+
+Copyright (c) 2021 University of Utah, The Trustees of Columbia University in
+the City of New York, and others.
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.*/
+
+
+
+#pragma once
+#include <FECore/LinearSolver.h>
+#include <FECore/CompactMatrix.h>
+
+//-----------------------------------------------------------------------------
+// A native multithreaded supernodal sparse direct solver. Symmetric matrices 
+// are factored as L*D*L^T and unsymmetric matrices (with a symmetric structure)
+// as L*D*U without pivoting. The equations are first reordered with a fill-reducing
+// ordering. Independent subtrees of the elimination tree are factored in parallel.
+// This solver does not depend on any third-party libraries.
+class SupernodalSolver : public LinearSolver
+{
+	class Imp;
+
+public:
+	SupernodalSolver(FEModel* fem);
+	~SupernodalSolver();
+	bool PreProcess() override;
+	bool Factor() override;
+	bool BackSolve(double* x, double* y) override;
+	void Destroy() override;
+
+	SparseMatrix* CreateSparseMatrix(Matrix_Type ntype) override;
+	bool SetSparseMatrix(SparseMatrix* pA) override;
+
+	void SetPrintLevel(int n) override;
+
+protected:
+	Imp*	m;
+
+	int		m_print_level;	//!< output level
+
+	DECLARE_FECORE_CLASS();
+};